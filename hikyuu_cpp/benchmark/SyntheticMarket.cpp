@@ -0,0 +1,352 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#include <cmath>
+#include <hikyuu/StockTypeInfo.h>
+#include "SyntheticMarket.h"
+
+namespace hku {
+
+namespace {
+
+// splitmix64，结果不依赖标准库实现，保证跨平台可复现
+inline uint64_t nextRandom(uint64_t& state) {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// [0, 1) 均匀分布
+inline double nextUniform(uint64_t& state) {
+    return double(nextRandom(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+inline price_t round2(price_t x) {
+    return std::round(x * 100.0) / 100.0;
+}
+
+inline bool isWorkday(const Datetime& d) {
+    int week = d.dayOfWeek();
+    return week != 0 && week != 6;
+}
+
+// 日内分钟线每个交易时段（120分钟）内的K线时刻偏移（分钟）
+vector<int64_t> intradayOffsets(int64_t minutes) {
+    vector<int64_t> result;
+    if (minutes <= 0 || minutes > 120 || 120 % minutes != 0) {
+        return result;
+    }
+    for (int64_t open : {9 * 60 + 30, 13 * 60}) {
+        for (int64_t m = minutes; m <= 120; m += minutes) {
+            result.push_back(open + m);
+        }
+    }
+    return result;
+}
+
+}  // namespace
+
+SyntheticMarket::SyntheticMarket(size_t stocks, size_t bars, uint64_t seed, const Datetime& start)
+: m_stocks(stocks), m_bars(bars), m_seed(seed), m_start(start.startOfDay()) {
+    HKU_CHECK(stocks < 100000, "Too many synthetic stocks: {}", stocks);
+    HKU_CHECK(!m_start.isNull(), "Invalid start date!");
+}
+
+SyntheticMarket::SyntheticMarket(const Parameter& param)
+: SyntheticMarket(size_t(param.tryGet<int>("stocks", 100)), size_t(param.tryGet<int>("bars", 2500)),
+                  uint64_t(param.tryGet<int64_t>("seed", 20260101)),
+                  Datetime(uint64_t(param.tryGet<int64_t>("start", 20000103)))) {}
+
+void SyntheticMarket::saveParam(Parameter& param) const {
+    param.set<int>("stocks", int(m_stocks));
+    param.set<int>("bars", int(m_bars));
+    param.set<int64_t>("seed", int64_t(m_seed));
+    param.set<int64_t>("start", int64_t(m_start.ymd()));
+}
+
+string SyntheticMarket::stockCode(size_t i) {
+    return fmt::format("{}", 600000 + i);
+}
+
+vector<StockInfo> SyntheticMarket::getAllStockInfo() const {
+    vector<StockInfo> result;
+    result.reserve(m_stocks + 1);
+
+    StockInfo info;
+    info.market = MARKET;
+    info.valid = 1;
+    info.startDate = m_start.ymd();
+    info.endDate = 99999999;  // 无效日期，即尚未退市
+    info.precision = 2;
+    info.tick = 0.01;
+    info.tickValue = 0.01;
+
+    info.code = INDEX_CODE;
+    info.name = "synthetic index";
+    info.type = STOCKTYPE_INDEX;
+    info.minTradeNumber = 1;
+    info.maxTradeNumber = 1000000;
+    result.push_back(info);
+
+    info.type = STOCKTYPE_A;
+    info.minTradeNumber = 100;
+    info.maxTradeNumber = 1000000;
+    for (size_t i = 0; i < m_stocks; i++) {
+        info.code = stockCode(i);
+        info.name = fmt::format("synthetic {}", i);
+        result.push_back(info);
+    }
+    return result;
+}
+
+bool SyntheticMarket::have(const string& market, const string& code) const {
+    string nmarket(market);
+    to_upper(nmarket);
+    HKU_IF_RETURN(nmarket != MARKET, false);
+    HKU_IF_RETURN(code == INDEX_CODE, true);
+    HKU_IF_RETURN(code.size() != 6 || code[0] != '6', false);
+    size_t i = 0;
+    try {
+        i = std::stoul(code) - 600000;
+    } catch (...) {
+        return false;
+    }
+    return i < m_stocks;
+}
+
+DatetimeList SyntheticMarket::getDatetimeList(const KQuery::KType& ktype) const {
+    DatetimeList result;
+    result.reserve(m_bars);
+    Datetime d = m_start;
+    if (ktype == KQuery::DAY) {
+        for (; result.size() < m_bars; d = d + Days(1)) {
+            if (isWorkday(d)) {
+                result.push_back(d);
+            }
+        }
+
+    } else if (ktype == KQuery::WEEK) {
+        // 以每周五为周线日期
+        for (; result.size() < m_bars; d = d + Days(1)) {
+            if (d.dayOfWeek() == 5) {
+                result.push_back(d);
+            }
+        }
+
+    } else if (ktype == KQuery::MONTH) {
+        // 以每月最后一个工作日为月线日期
+        for (d = d.endOfMonth(); result.size() < m_bars; d = (d + Days(1)).endOfMonth()) {
+            Datetime last = d.startOfDay();
+            while (!isWorkday(last)) {
+                last = last - Days(1);
+            }
+            result.push_back(last);
+        }
+
+    } else {
+        vector<int64_t> offsets = intradayOffsets(KQuery::getKTypeInMin(ktype));
+        HKU_IF_RETURN(offsets.empty(), result);
+        for (; result.size() < m_bars; d = d + Days(1)) {
+            if (!isWorkday(d)) {
+                continue;
+            }
+            for (size_t i = 0; i < offsets.size() && result.size() < m_bars; i++) {
+                result.push_back(d + Minutes(offsets[i]));
+            }
+        }
+    }
+    return result;
+}
+
+uint64_t SyntheticMarket::_stockSeed(const string& code, const KQuery::KType& ktype) const {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    string key = fmt::format("{}{}{}", MARKET, code, ktype);
+    to_upper(key);
+    for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash ^ m_seed;
+}
+
+KRecordList SyntheticMarket::getKRecordList(const string& market, const string& code,
+                                            const KQuery::KType& ktype) const {
+    return getKRecordList(market, code, ktype, 0, m_bars);
+}
+
+KRecordList SyntheticMarket::getKRecordList(const string& market, const string& code,
+                                            const KQuery::KType& ktype, size_t start,
+                                            size_t end) const {
+    KRecordList result;
+    end = std::min(end, m_bars);
+    HKU_IF_RETURN(start >= end || !have(market, code), result);
+
+    DatetimeList dates = getDatetimeList(ktype);
+    HKU_IF_RETURN(dates.size() < end, result);
+
+    // 随机游走需从首根K线依次生成
+    uint64_t state = _stockSeed(code, ktype);
+    price_t pre_close = round2(10.0 + nextUniform(state) * 90.0);
+    result.reserve(end - start);
+    for (size_t i = 0; i < end; i++) {
+        price_t open = round2(pre_close * (1.0 + (nextUniform(state) - 0.5) * 0.01));
+        price_t close = round2(pre_close * (1.0 + (nextUniform(state) - 0.5) * 0.04));
+        open = std::max(open, 0.01);
+        close = std::max(close, 0.01);
+        price_t high = round2(std::max(open, close) * (1.0 + nextUniform(state) * 0.01));
+        price_t low = round2(std::min(open, close) * (1.0 - nextUniform(state) * 0.01));
+        low = std::max(low, 0.01);
+        price_t vol = std::round(1000.0 + nextUniform(state) * 100000.0);
+        if (i >= start) {
+            price_t amount = round2(vol * (open + close) * 0.05);
+            result.emplace_back(dates[i], open, high, low, close, amount, vol);
+        }
+        pre_close = close;
+    }
+    return result;
+}
+
+vector<KRecord> SyntheticMarket::getSpotList(const string& code, const Datetime& day,
+                                             size_t ticks) const {
+    vector<KRecord> result;
+    HKU_IF_RETURN(ticks == 0, result);
+
+    DatetimeList dates = getDatetimeList(KQuery::DAY);
+    auto iter = std::lower_bound(dates.begin(), dates.end(), day.startOfDay());
+    HKU_IF_RETURN(iter == dates.end() || *iter != day.startOfDay(), result);
+    size_t pos = iter - dates.begin();
+    KRecordList ks = getKRecordList(MARKET, code, KQuery::DAY, pos, pos + 1);
+    HKU_IF_RETURN(ks.empty(), result);
+    const KRecord& k = ks.front();
+
+    // 由开盘价线性逼近收盘价，最高、最低价逐步展开，成交量与成交金额逐步累计
+    result.reserve(ticks);
+    price_t high = k.openPrice, low = k.openPrice;
+    for (size_t i = 0; i < ticks; i++) {
+        double ratio = double(i + 1) / double(ticks);
+        int64_t minute = int64_t(i * 240 / ticks);
+        Datetime d =
+          day.startOfDay() + (minute < 120 ? Minutes(9 * 60 + 31 + minute)
+                                           : Minutes(13 * 60 + 1 + minute - 120));
+        price_t close = round2(k.openPrice + (k.closePrice - k.openPrice) * ratio);
+        high = std::max(high, round2(k.openPrice + (k.highPrice - k.openPrice) * ratio));
+        low = std::min(low, round2(k.openPrice + (k.lowPrice - k.openPrice) * ratio));
+        result.emplace_back(d, k.openPrice, std::max(high, close), std::min(low, close), close,
+                            round2(k.transAmount * ratio), std::round(k.transCount * ratio));
+    }
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+// SyntheticBaseInfoDriver
+//-----------------------------------------------------------------------------
+
+bool SyntheticBaseInfoDriver::_init() {
+    m_market = std::make_unique<SyntheticMarket>(m_params);
+    return true;
+}
+
+vector<StockInfo> SyntheticBaseInfoDriver::getAllStockInfo() {
+    return m_market->getAllStockInfo();
+}
+
+StockInfo SyntheticBaseInfoDriver::getStockInfo(string market, const string& code) {
+    to_upper(market);
+    HKU_IF_RETURN(!m_market->have(market, code), StockInfo());
+    auto infos = m_market->getAllStockInfo();
+    for (const auto& info : infos) {
+        if (info.code == code) {
+            return info;
+        }
+    }
+    return StockInfo();
+}
+
+MarketInfo SyntheticBaseInfoDriver::getMarketInfo(const string& market) {
+    string nmarket(market);
+    to_upper(nmarket);
+    HKU_IF_RETURN(nmarket != SyntheticMarket::MARKET, Null<MarketInfo>());
+    return MarketInfo(SyntheticMarket::MARKET, "Synthetic", "Synthetic market for benchmark",
+                      SyntheticMarket::INDEX_CODE, Null<Datetime>(), TimeDelta(0, 9, 30),
+                      TimeDelta(0, 11, 30), TimeDelta(0, 13), TimeDelta(0, 15));
+}
+
+vector<MarketInfo> SyntheticBaseInfoDriver::getAllMarketInfo() {
+    return vector<MarketInfo>{getMarketInfo(SyntheticMarket::MARKET)};
+}
+
+vector<StockTypeInfo> SyntheticBaseInfoDriver::getAllStockTypeInfo() {
+    return vector<StockTypeInfo>{getStockTypeInfo(STOCKTYPE_A), getStockTypeInfo(STOCKTYPE_INDEX)};
+}
+
+StockTypeInfo SyntheticBaseInfoDriver::getStockTypeInfo(uint32_t type) {
+    if (STOCKTYPE_A == type) {
+        return StockTypeInfo(STOCKTYPE_A, "A股", 0.01, 0.01, 2, 100, 1000000);
+    }
+    if (STOCKTYPE_INDEX == type) {
+        return StockTypeInfo(STOCKTYPE_INDEX, "指数", 0.01, 0.01, 2, 1, 1000000);
+    }
+    return Null<StockTypeInfo>();
+}
+
+std::unordered_set<Datetime> SyntheticBaseInfoDriver::getAllHolidays() {
+    return std::unordered_set<Datetime>();
+}
+
+ZhBond10List SyntheticBaseInfoDriver::getAllZhBond10() {
+    return ZhBond10List();
+}
+
+//-----------------------------------------------------------------------------
+// SyntheticKDataDriver
+//-----------------------------------------------------------------------------
+
+bool SyntheticKDataDriver::_init() {
+    m_market = std::make_unique<SyntheticMarket>(m_params);
+    return true;
+}
+
+size_t SyntheticKDataDriver::getCount(const string& market, const string& code,
+                                      const KQuery::KType& kType) {
+    HKU_IF_RETURN(!m_market->have(market, code), 0);
+    return m_market->getDatetimeList(kType).size();
+}
+
+bool SyntheticKDataDriver::getIndexRangeByDate(const string& market, const string& code,
+                                               const KQuery& query, size_t& out_start,
+                                               size_t& out_end) {
+    out_start = 0;
+    out_end = 0;
+    HKU_IF_RETURN(query.queryType() != KQuery::DATE || !m_market->have(market, code), false);
+    DatetimeList dates = m_market->getDatetimeList(query.kType());
+    out_start =
+      std::lower_bound(dates.begin(), dates.end(), query.startDatetime()) - dates.begin();
+    out_end = std::lower_bound(dates.begin(), dates.end(), query.endDatetime()) - dates.begin();
+    if (out_start >= out_end) {
+        out_start = 0;
+        out_end = 0;
+        return false;
+    }
+    return true;
+}
+
+KRecordList SyntheticKDataDriver::getKRecordList(const string& market, const string& code,
+                                                 const KQuery& query) {
+    size_t start = 0, end = 0;
+    if (query.queryType() == KQuery::INDEX) {
+        HKU_IF_RETURN(query.start() < 0 || query.end() < 0, KRecordList());
+        start = size_t(query.start());
+        end = size_t(query.end());
+    } else if (!getIndexRangeByDate(market, code, query, start, end)) {
+        return KRecordList();
+    }
+    return m_market->getKRecordList(market, code, query.kType(), start, end);
+}
+
+}  // namespace hku
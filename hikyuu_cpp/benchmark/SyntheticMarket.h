@@ -0,0 +1,172 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#pragma once
+
+#include <hikyuu/data_driver/BaseInfoDriver.h>
+#include <hikyuu/data_driver/BlockInfoDriver.h>
+#include <hikyuu/data_driver/KDataDriver.h>
+
+namespace hku {
+
+/**
+ * 可复现的合成行情
+ * @details
+ * <pre>
+ * 生成一个名为 SH 的合成市场：指数 SH000001 及 stocks 只股票（SH600000 起顺序编号），
+ * 每只证券每种K线类型各 bars 根K线，K线日期自 start 起按交易日（周一至周五）排列，
+ * 分钟线按 9:30-11:30、13:00-15:00 的交易时段排列。
+ * 价格为随机游走，随机数由自实现的 splitmix64 生成并只使用整数及基本浮点运算，
+ * 相同的 seed 在不同平台、不同运行之间生成完全相同的数据。
+ * 支持的K线类型：日线、周线、月线及日内分钟线（MIN、MIN5、MIN15、MIN30、MIN60 等）。
+ * </pre>
+ */
+class SyntheticMarket {
+public:
+    static constexpr const char* MARKET = "SH";
+    static constexpr const char* INDEX_CODE = "000001";
+
+    /**
+     * 构造函数
+     * @param stocks 股票数量（不含指数）
+     * @param bars 每种K线类型的K线数量
+     * @param seed 随机数种子
+     * @param start 起始日期
+     */
+    SyntheticMarket(size_t stocks, size_t bars, uint64_t seed,
+                    const Datetime& start = Datetime(20000103));
+
+    /** 从驱动参数构造，参数 stocks、bars、seed、start（YYYYMMDD） */
+    explicit SyntheticMarket(const Parameter& param);
+
+    size_t stocks() const noexcept {
+        return m_stocks;
+    }
+
+    size_t bars() const noexcept {
+        return m_bars;
+    }
+
+    uint64_t seed() const noexcept {
+        return m_seed;
+    }
+
+    /** 将合成行情的配置写入驱动参数 */
+    void saveParam(Parameter& param) const;
+
+    /** 第 i 只股票的代码 */
+    static string stockCode(size_t i);
+
+    /** 全部证券的基本信息，首个为指数 */
+    vector<StockInfo> getAllStockInfo() const;
+
+    /** 市场是否包含指定证券 */
+    bool have(const string& market, const string& code) const;
+
+    /** 指定K线类型的全部K线日期 */
+    DatetimeList getDatetimeList(const KQuery::KType& ktype) const;
+
+    /** 指定证券、K线类型的全部K线，证券不存在时返回空 */
+    KRecordList getKRecordList(const string& market, const string& code,
+                               const KQuery::KType& ktype) const;
+
+    /** 指定证券、K线类型的 [start, end) 范围内的K线 */
+    KRecordList getKRecordList(const string& market, const string& code,
+                               const KQuery::KType& ktype, size_t start, size_t end) const;
+
+    /** 指定证券的交易时刻行情序列，每个交易日 ticks 个时刻，按时间顺序排列 */
+    vector<KRecord> getSpotList(const string& code, const Datetime& day, size_t ticks) const;
+
+private:
+    uint64_t _stockSeed(const string& code, const KQuery::KType& ktype) const;
+
+private:
+    size_t m_stocks;
+    size_t m_bars;
+    uint64_t m_seed;
+    Datetime m_start;
+};
+
+/** 合成行情基础信息驱动 */
+class SyntheticBaseInfoDriver : public BaseInfoDriver {
+public:
+    SyntheticBaseInfoDriver() : BaseInfoDriver("SYNTHETIC") {}
+    virtual ~SyntheticBaseInfoDriver() = default;
+
+    virtual bool _init() override;
+    virtual vector<StockInfo> getAllStockInfo() override;
+    virtual StockInfo getStockInfo(string market, const string& code) override;
+    virtual MarketInfo getMarketInfo(const string& market) override;
+    virtual vector<MarketInfo> getAllMarketInfo() override;
+    virtual vector<StockTypeInfo> getAllStockTypeInfo() override;
+    virtual StockTypeInfo getStockTypeInfo(uint32_t type) override;
+    virtual std::unordered_set<Datetime> getAllHolidays() override;
+    virtual ZhBond10List getAllZhBond10() override;
+
+private:
+    unique_ptr<SyntheticMarket> m_market;
+};
+
+/** 合成行情板块驱动，不包含任何板块 */
+class SyntheticBlockInfoDriver : public BlockInfoDriver {
+public:
+    SyntheticBlockInfoDriver() : BlockInfoDriver("SYNTHETIC") {}
+    virtual ~SyntheticBlockInfoDriver() = default;
+
+    virtual bool _init() override {
+        return true;
+    }
+
+    virtual Block getBlock(const string& category, const string& name) override {
+        return Block();
+    }
+
+    virtual BlockList getBlockList(const string& category) override {
+        return BlockList();
+    }
+
+    virtual BlockList getBlockList() override {
+        return BlockList();
+    }
+
+    virtual void save(const Block& block) override {}
+    virtual void remove(const string& category, const string& name) override {}
+};
+
+/** 合成行情K线驱动 */
+class SyntheticKDataDriver : public KDataDriver {
+public:
+    SyntheticKDataDriver() : KDataDriver("SYNTHETIC") {}
+    virtual ~SyntheticKDataDriver() = default;
+
+    virtual KDataDriverPtr _clone() override {
+        return make_shared<SyntheticKDataDriver>();
+    }
+
+    virtual bool _init() override;
+
+    virtual bool isIndexFirst() override {
+        return true;
+    }
+
+    virtual bool canParallelLoad() override {
+        return true;
+    }
+
+    virtual size_t getCount(const string& market, const string& code,
+                            const KQuery::KType& kType) override;
+    virtual bool getIndexRangeByDate(const string& market, const string& code,
+                                     const KQuery& query, size_t& out_start,
+                                     size_t& out_end) override;
+    virtual KRecordList getKRecordList(const string& market, const string& code,
+                                       const KQuery& query) override;
+
+private:
+    unique_ptr<SyntheticMarket> m_market;
+};
+
+}  // namespace hku
@@ -0,0 +1,489 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+/*************************************************************
+ *
+ * hikyuu 性能基准测试
+ *
+ * 使用可复现的合成行情（见 SyntheticMarket.h），不依赖本地数据，
+ * 覆盖 K线加载、KData 切片、原生K线文件读写、常用指标、System::run、Portfolio::run、
+ * 多因子及实时行情更新，
+ * 测试结果以 JSON 格式输出，便于不同版本、不同机器之间比较。
+ *
+ * 用法：
+ * benchmark [--stocks=100] [--bars=2500] [--ktypes=day,min5] [--seed=20260101]
+ *           [--repeat=5] [--filter=ind_] [--output=benchmark.json]
+ *
+ *************************************************************/
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <nlohmann/json.hpp>
+#include <hikyuu/hikyuu.h>
+#include <hikyuu/global/sysinfo.h>
+#include <hikyuu/trade_sys/portfolio/build_in.h>
+#include <hikyuu/data_driver/DataDriverFactory.h>
+#include <hikyuu/utilities/os.h>
+#include <hikyuu/data_driver/kdata/native/NativeKDataDriver.h>
+#include "SyntheticMarket.h"
+
+using namespace hku;
+using json = nlohmann::json;
+
+struct BenchmarkConfig {
+    size_t stocks = 100;
+    size_t bars = 2500;
+    uint64_t seed = 20260101;
+    size_t repeat = 5;
+    vector<string> ktypes{"DAY"};
+    string filter;
+    string output;
+};
+
+/** 单个测试用例 */
+struct BenchmarkCase {
+    string name;
+    string ktype;
+    size_t items;                 // 每次执行处理的数据量（K线数、记录数等）
+    std::function<void()> func;   // 被测函数
+    std::function<void()> setup;  // 准备数据，不计入耗时，用例被过滤时不执行
+};
+
+static vector<string> splitArg(const string& arg) {
+    vector<string> result;
+    size_t start = 0;
+    while (start <= arg.size()) {
+        size_t pos = arg.find(',', start);
+        if (pos == string::npos) {
+            pos = arg.size();
+        }
+        if (pos > start) {
+            result.push_back(arg.substr(start, pos - start));
+            to_upper(result.back());
+        }
+        start = pos + 1;
+    }
+    return result;
+}
+
+static void printUsage() {
+    std::cout << "Usage: benchmark [options]\n"
+                 "  --stocks=N      number of synthetic stocks (default 100)\n"
+                 "  --bars=N        number of bars per stock and ktype (default 2500)\n"
+                 "  --ktypes=LIST   comma separated ktypes, e.g. day,week,min5 (default day)\n"
+                 "  --seed=N        random seed (default 20260101)\n"
+                 "  --repeat=N      repeat times of each case (default 5)\n"
+                 "  --filter=TEXT   only run cases whose name contains TEXT\n"
+                 "  --output=FILE   write json result to FILE (default stdout)\n";
+}
+
+static bool parseArgs(int argc, char* argv[], BenchmarkConfig& config) {
+    for (int i = 1; i < argc; i++) {
+        string arg(argv[i]);
+        if (arg == "-h" || arg == "--help") {
+            return false;
+        }
+
+        size_t pos = arg.find('=');
+        string key = arg.substr(0, pos);
+        string value;
+        if (pos != string::npos) {
+            value = arg.substr(pos + 1);
+        } else if (i + 1 < argc) {
+            value = argv[++i];
+        }
+
+        try {
+            if (key == "--stocks") {
+                config.stocks = std::stoul(value);
+            } else if (key == "--bars") {
+                config.bars = std::stoul(value);
+            } else if (key == "--seed") {
+                config.seed = std::stoull(value);
+            } else if (key == "--repeat") {
+                config.repeat = std::max<size_t>(1, std::stoul(value));
+            } else if (key == "--ktypes") {
+                config.ktypes = splitArg(value);
+            } else if (key == "--filter") {
+                config.filter = value;
+            } else if (key == "--output") {
+                config.output = value;
+            } else {
+                std::cerr << "Unknown option: " << arg << std::endl;
+                return false;
+            }
+        } catch (...) {
+            std::cerr << "Invalid value of " << key << ": " << value << std::endl;
+            return false;
+        }
+    }
+
+    HKU_ERROR_IF_RETURN(config.stocks == 0 || config.bars == 0 || config.ktypes.empty(), false,
+                        "stocks, bars and ktypes must not be empty!");
+    for (const auto& ktype : config.ktypes) {
+        HKU_ERROR_IF_RETURN(!KQuery::isKType(ktype), false, "Invalid ktype: {}", ktype);
+    }
+    return true;
+}
+
+static void initStockManager(const BenchmarkConfig& config) {
+    DataDriverFactory::regBaseInfoDriver(make_shared<SyntheticBaseInfoDriver>());
+    DataDriverFactory::regBlockDriver(make_shared<SyntheticBlockInfoDriver>());
+    DataDriverFactory::regKDataDriver(make_shared<SyntheticKDataDriver>());
+
+    SyntheticMarket market(config.stocks, config.bars, config.seed);
+    Parameter baseParam, blockParam, kdataParam, preloadParam, hkuParam;
+    baseParam.set<string>("type", "synthetic");
+    market.saveParam(baseParam);
+    blockParam.set<string>("type", "synthetic");
+    kdataParam.set<string>("type", "synthetic");
+    market.saveParam(kdataParam);
+
+    for (auto ktype : config.ktypes) {
+        to_lower(ktype);
+        preloadParam.set<bool>(ktype, true);
+        preloadParam.set<int>(fmt::format("{}_max", ktype), int(config.bars));
+    }
+
+    hkuParam.set<string>("tmpdir", ".");
+    hkuParam.set<string>("datadir", ".");
+    hkuParam.set<bool>("load_history_finance", false);
+    hkuParam.set<bool>("load_stock_weight", false);
+
+    StockManager& sm = StockManager::instance();
+    sm.init(baseParam, blockParam, kdataParam, preloadParam, hkuParam);
+    while (!sm.dataReady()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+static StockList getSyntheticStocks(const BenchmarkConfig& config) {
+    StockManager& sm = StockManager::instance();
+    StockList result;
+    result.reserve(config.stocks);
+    for (size_t i = 0; i < config.stocks; i++) {
+        result.push_back(sm.getStock(
+          fmt::format("{}{}", SyntheticMarket::MARKET, SyntheticMarket::stockCode(i))));
+    }
+    return result;
+}
+
+/** 常用指标，以收盘价或K线数据为输入 */
+static vector<std::pair<string, Indicator>> getIndicatorCases() {
+    Indicator c = CLOSE();
+    return vector<std::pair<string, Indicator>>{
+      {"MA", MA(c, 20)},
+      {"EMA", EMA(c, 20)},
+      {"SMA", SMA(c, 20, 2.0)},
+      {"WMA", WMA(c, 20)},
+      {"AMA", AMA(c, 10, 2, 30)},
+      {"MACD", MACD(c, 12, 26, 9)},
+      {"STDEV", STDEV(c, 20)},
+      {"VAR", VAR(c, 20)},
+      {"DEVSQ", DEVSQ(c, 20)},
+      {"HHV", HHV(c, 20)},
+      {"LLV", LLV(c, 20)},
+      {"HHVBARS", HHVBARS(c, 20)},
+      {"LLVBARS", LLVBARS(c, 20)},
+      {"SUM", SUM(c, 20)},
+      {"COUNT", COUNT(c > MA(c, 20), 20)},
+      {"EVERY", EVERY(c > MA(c, 20), 5)},
+      {"EXIST", EXIST(c > MA(c, 20), 5)},
+      {"REF", REF(c, 5)},
+      {"DIFF", DIFF(c)},
+      {"ROC", ROC(c, 10)},
+      {"ROCP", ROCP(c, 10)},
+      {"ROCR", ROCR(c, 10)},
+      {"SLOPE", SLOPE(c, 20)},
+      {"CORR", CORR(c, VOL(), 20)},
+      {"ZSCORE", ZSCORE(c)},
+      {"KALMAN", KALMAN(c)},
+      {"MDD", MDD(c)},
+      {"MRR", MRR(c)},
+      {"ATR", ATR(14)},
+      {"TR", TR()},
+      {"AD", AD()},
+      {"VIGOR", VIGOR(2)},
+      {"SAFTYLOSS", SAFTYLOSS(c, 10, 3, 2.0)},
+    };
+}
+
+static string nativeDir() {
+    return fmt::format("{}/native_benchmark", StockManager::instance().tmpdir());
+}
+
+/** 原生K线文件的写入及读取，数据文件位于临时目录下 */
+static void addNativeCases(const BenchmarkConfig& config, const KQuery::KType& ktype,
+                           vector<BenchmarkCase>& cases) {
+    Parameter param;
+    param.set<string>("type", "native");
+    param.set<string>("dir", nativeDir());
+    auto driver = make_shared<NativeKDataDriver>();
+    HKU_ERROR_IF_RETURN(!driver->init(param), void(), "Failed init native kdata driver!");
+
+    // 生成数据并写入文件，由首个被执行的用例触发
+    struct NativeData {
+        vector<std::pair<string, KRecordList>> records;
+        DatetimeList dates;
+    };
+    auto data = make_shared<NativeData>();
+    auto setup = [config, ktype, driver, data]() {
+        HKU_IF_RETURN(!data->records.empty(), void());
+        SyntheticMarket market(config.stocks, config.bars, config.seed);
+        for (size_t i = 0; i < config.stocks; i++) {
+            string code = SyntheticMarket::stockCode(i);
+            data->records.emplace_back(code,
+                                       market.getKRecordList(SyntheticMarket::MARKET, code, ktype));
+            driver->appendKRecordList(SyntheticMarket::MARKET, code, ktype,
+                                      data->records.back().second);
+        }
+        data->dates = market.getDatetimeList(ktype);
+    };
+    size_t total_bars = config.stocks * config.bars;
+
+    // 每次先删除原文件，保证写入的是完整的全部K线
+    cases.push_back({"native_write", ktype, total_bars,
+                     [driver, data, ktype]() {
+                         for (const auto& item : data->records) {
+                             removeFile(
+                               driver->getFileName(SyntheticMarket::MARKET, item.first, ktype));
+                             driver->appendKRecordList(SyntheticMarket::MARKET, item.first, ktype,
+                                                       item.second);
+                         }
+                     },
+                     setup});
+
+    cases.push_back({"native_read", ktype, total_bars,
+                     [driver, data, ktype]() {
+                         KQuery query(0, Null<int64_t>(), ktype);
+                         for (const auto& item : data->records) {
+                             KRecordList ks =
+                               driver->getKRecordList(SyntheticMarket::MARKET, item.first, query);
+                             ks.size();
+                         }
+                     },
+                     setup});
+
+    // 按日期各取100段，每段250根
+    cases.push_back({"native_read_date", ktype, config.stocks * 100,
+                     [driver, data, ktype]() {
+                         const DatetimeList& dates = data->dates;
+                         for (const auto& item : data->records) {
+                             for (size_t i = 0; i < 100; i++) {
+                                 size_t start = i * dates.size() / 100;
+                                 size_t end = std::min(start + 250, dates.size() - 1);
+                                 KRecordList ks = driver->getKRecordList(
+                                   SyntheticMarket::MARKET, item.first,
+                                   KQueryByDate(dates[start], dates[end], ktype));
+                                 ks.size();
+                             }
+                         }
+                     },
+                     setup});
+
+    cases.push_back({"native_read_close", ktype, total_bars,
+                     [driver, data, ktype]() {
+                         for (const auto& item : data->records) {
+                             PriceList closes = driver->getField(
+                               SyntheticMarket::MARKET, item.first, ktype, NativeKDataFile::CLOSE);
+                             closes.size();
+                         }
+                     },
+                     setup});
+}
+
+static vector<BenchmarkCase> buildCases(const BenchmarkConfig& config) {
+    vector<BenchmarkCase> cases;
+    StockManager& sm = StockManager::instance();
+    StockList stks = getSyntheticStocks(config);
+    Stock ref_stk = sm.getStock(
+      fmt::format("{}{}", SyntheticMarket::MARKET, SyntheticMarket::INDEX_CODE));
+    size_t total_bars = config.stocks * config.bars;
+
+    for (const auto& ktype : config.ktypes) {
+        KQuery query(0, Null<int64_t>(), ktype);
+
+        // K线加载
+        cases.push_back({"kdata_load", ktype, total_bars, [stks, ktype]() {
+                             for (auto stk : stks) {
+                                 stk.releaseKDataBuffer(ktype);
+                                 stk.loadKDataToBuffer(ktype);
+                             }
+                         }});
+
+        addNativeCases(config, ktype, cases);
+
+        // KData 切片，按索引及日期各取100段
+        cases.push_back({"getkdata_index", ktype, stks.size() * 100, [stks, ktype, config]() {
+                             for (const auto& stk : stks) {
+                                 for (int64_t i = 0; i < 100; i++) {
+                                     int64_t start = i * int64_t(config.bars) / 100;
+                                     KData k = stk.getKData(KQuery(start, start + 250, ktype));
+                                     k.size();
+                                 }
+                             }
+                         }});
+
+        DatetimeList dates = ref_stk.getDatetimeList(query);
+        cases.push_back(
+          {"getkdata_date", ktype, stks.size() * 100, [stks, ktype, dates]() {
+               for (const auto& stk : stks) {
+                   for (size_t i = 0; i < 100; i++) {
+                       size_t start = i * dates.size() / 100;
+                       size_t end = std::min(start + 250, dates.size() - 1);
+                       KData k = stk.getKData(KQueryByDate(dates[start], dates[end], ktype));
+                       k.size();
+                   }
+               }
+           }});
+
+        // 指标计算
+        for (auto& ind_case : getIndicatorCases()) {
+            cases.push_back({fmt::format("ind_{}", ind_case.first), ktype, total_bars,
+                             [stks, query, ind = ind_case.second]() mutable {
+                                 for (const auto& stk : stks) {
+                                     Indicator result = ind(stk.getKData(query));
+                                     result.size();
+                                 }
+                             }});
+        }
+
+        // 系统运行
+        cases.push_back({"system_run", ktype, total_bars, [stks, query]() {
+                             for (const auto& stk : stks) {
+                                 auto sys = SYS_Simple(
+                                   crtTM(Datetime(199001010000LL), 1000000), MM_FixedCount(100),
+                                   EnvironmentPtr(), ConditionPtr(),
+                                   SG_Cross(EMA(CLOSE(), 5), EMA(CLOSE(), 20)),
+                                   ST_FixedPercent(0.05));
+                                 sys->run(stk, query);
+                             }
+                         }});
+
+        // 组合运行
+        cases.push_back({"portfolio_run", ktype, total_bars, [stks, query]() {
+                             auto sys = SYS_Simple(
+                               TradeManagerPtr(), MM_FixedCount(100), EnvironmentPtr(),
+                               ConditionPtr(), SG_Cross(EMA(CLOSE(), 5), EMA(CLOSE(), 20)),
+                               ST_FixedPercent(0.05));
+                             auto pf = PF_Simple(crtTM(Datetime(199001010000LL), 10000000),
+                                                 SE_Fixed(stks, sys), AF_EqualWeight());
+                             pf->run(query);
+                         }});
+
+        // 多因子合成及截面评分
+        cases.push_back({"multifactor", ktype, total_bars, [stks, query, ref_stk]() {
+                             IndicatorList src{MA(CLOSE(), 20), ROC(CLOSE(), 10),
+                                               STDEV(CLOSE(), 20)};
+                             auto mf = MF_EqualWeight(src, stks, query, ref_stk);
+                             mf->getAllFactors();
+                             auto dates = mf->getDatetimeList();
+                             for (size_t i = 0; i < dates.size(); i += 10) {
+                                 mf->getScores(dates[i]);
+                             }
+                         }});
+    }
+
+    // 实时行情更新：以最后一个交易日的逐笔快照更新日线缓存，与行情接收时的更新路径一致
+    if (std::find(config.ktypes.begin(), config.ktypes.end(), string(KQuery::DAY)) !=
+        config.ktypes.end()) {
+        const size_t ticks = 240;
+        SyntheticMarket market(config.stocks, config.bars, config.seed);
+        DatetimeList dates = market.getDatetimeList(KQuery::DAY);
+        Datetime last_day = dates.back();
+        vector<std::pair<Stock, vector<KRecord>>> spots;
+        for (const auto& stk : stks) {
+            spots.emplace_back(stk, market.getSpotList(stk.code(), last_day, ticks));
+        }
+        cases.push_back({"spot_update", KQuery::DAY, stks.size() * ticks, [spots]() {
+                             for (const auto& item : spots) {
+                                 Stock stk = item.first;
+                                 for (const auto& k : item.second) {
+                                     stk.realtimeUpdate(KRecord(k.datetime.startOfDay(),
+                                                                k.openPrice, k.highPrice,
+                                                                k.lowPrice, k.closePrice,
+                                                                k.transAmount, k.transCount),
+                                                        KQuery::DAY);
+                                 }
+                             }
+                         }});
+    }
+
+    return cases;
+}
+
+static json runCase(const BenchmarkCase& bench, size_t repeat) {
+    using clock = std::chrono::steady_clock;
+    if (bench.setup) {
+        bench.setup();
+    }
+
+    double total = 0.0, min_ms = std::numeric_limits<double>::max();
+    for (size_t i = 0; i < repeat; i++) {
+        auto start = clock::now();
+        bench.func();
+        double ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        total += ms;
+        min_ms = std::min(min_ms, ms);
+    }
+
+    double mean = total / repeat;
+    json result;
+    result["name"] = bench.name;
+    result["ktype"] = bench.ktype;
+    result["repeat"] = repeat;
+    result["items"] = bench.items;
+    result["total_ms"] = total;
+    result["min_ms"] = min_ms;
+    result["mean_ms"] = mean;
+    result["ns_per_item"] = bench.items > 0 ? min_ms * 1.0e6 / bench.items : 0.0;
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    BenchmarkConfig config;
+    if (!parseArgs(argc, argv, config)) {
+        printUsage();
+        return 1;
+    }
+
+    initStockManager(config);
+
+    json result;
+    result["version"] = getVersionWithBuild();
+    result["datetime"] = Datetime::now().str();
+    result["config"] = {{"stocks", config.stocks}, {"bars", config.bars},
+                        {"seed", config.seed},     {"repeat", config.repeat},
+                        {"ktypes", config.ktypes}, {"filter", config.filter}};
+
+    json& results = result["results"] = json::array();
+    for (const auto& bench : buildCases(config)) {
+        if (!config.filter.empty() && bench.name.find(config.filter) == string::npos) {
+            continue;
+        }
+        json item = runCase(bench, config.repeat);
+        std::cerr << fmt::format("{:<20} {:<6} min: {:>10.3f} ms, mean: {:>10.3f} ms",
+                                 bench.name, bench.ktype, item["min_ms"].get<double>(),
+                                 item["mean_ms"].get<double>())
+                  << std::endl;
+        results.push_back(std::move(item));
+    }
+
+    if (config.output.empty()) {
+        std::cout << result.dump(2) << std::endl;
+    } else {
+        std::ofstream out(config.output);
+        HKU_ERROR_IF_RETURN(!out, 1, "Failed open output file: {}", config.output);
+        out << result.dump(2) << std::endl;
+    }
+
+    removeDir(nativeDir());
+    StockManager::quit();
+    return 0;
+}
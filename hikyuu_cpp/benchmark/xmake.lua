@@ -0,0 +1,22 @@
+target("benchmark")
+    set_kind("binary")
+    set_default(false)
+    
+    add_packages("boost", "spdlog", "fmt", "nlohmann_json")
+    add_includedirs("..")
+
+    if is_plat("windows") then
+        add_cxflags("-wd4267")
+        add_cxflags("-wd4251")
+    end
+
+    if is_plat("windows") and get_config("kind") == "shared" then
+        add_defines("HKU_API=__declspec(dllimport)")
+        add_defines("HKU_UTILS_API=__declspec(dllimport)")
+        add_defines("SQLITE_API=__declspec(dllimport)")
+    end
+   
+    add_deps("hikyuu")
+
+    add_files("./*.cpp")
+target_end()
@@ -31,6 +31,7 @@
 #include "StockManager.h"
 #include "global/GlobalSpotAgent.h"
 #include "global/schedule/scheduler.h"
+#include "trade_manage/OrderDispatcher.h"
 #include "indicator/IndicatorImp.h"
 #include "global/sysinfo.h"
 #include "debug.h"
@@ -95,6 +96,7 @@ void GlobalInitializer::clean() {
 
     releaseScheduler();
     releaseGlobalSpotAgent();
+    releaseGlobalOrderDispatcher();
 
     IndicatorImp::releaseDynEngine();
 
@@ -7,6 +7,7 @@
 
 #include <functional>
 #include "StockManager.h"
+#include "KRecordResampler.h"
 #include "KDataImp.h"
 
 namespace hku {
@@ -25,39 +26,25 @@ KDataImp::KDataImp(const Stock& stock, const KQuery& query)
     if (query.recoverType() == KQuery::NO_RECOVER)
         return;
 
+    if (query.recoverType() >= KQuery::INVALID_RECOVER_TYPE) {
+        HKU_ERROR("Invalid RecvoerType!");
+        return;
+    }
+
+    // 复权因子表由 Stock 缓存，无除权时无需处理
+    RecoverFactorListPtr factors = m_stock.getRecoverFactors();
+    if (!factors || factors->size() <= 1)
+        return;
+
     // 日线以上复权处理
     if (query.kType() == KQuery::WEEK || query.kType() == KQuery::MONTH ||
         query.kType() == KQuery::QUARTER || query.kType() == KQuery::HALFYEAR ||
         query.kType() == KQuery::YEAR) {
-        _recoverForUpDay();
+        _recoverForUpDay(*factors);
         return;
     }
 
-    switch (query.recoverType()) {
-        case KQuery::NO_RECOVER:
-            // do nothing
-            break;
-
-        case KQuery::FORWARD:
-            _recoverForward();
-            break;
-
-        case KQuery::BACKWARD:
-            _recoverBackward();
-            break;
-
-        case KQuery::EQUAL_FORWARD:
-            _recoverEqualForward();
-            break;
-
-        case KQuery::EQUAL_BACKWARD:
-            _recoverEqualBackward();
-            break;
-
-        default:
-            HKU_ERROR("Invalid RecvoerType!");
-            return;
-    }
+    _recover(*factors);
 }
 
 KDataImp::~KDataImp() {}
@@ -101,13 +88,9 @@ void KDataImp::_getPosInStock() {
 }
 
 size_t KDataImp::getPos(const Datetime& datetime) {
-    KRecordList::const_iterator iter;
-    KRecord comp_record;
-    comp_record.datetime = datetime;
-    iter = lower_bound(
-      m_buffer.begin(), m_buffer.end(), comp_record,
-      std::bind(std::less<Datetime>(), std::bind(&KRecord::datetime, std::placeholders::_1),
-                std::bind(&KRecord::datetime, std::placeholders::_2)));
+    auto iter = std::lower_bound(
+      m_buffer.cbegin(), m_buffer.cend(), datetime,
+      [](const KRecord& record, const Datetime& date) { return record.datetime < date; });
     if (iter == m_buffer.end() || iter->datetime != datetime) {
         return Null<size_t>();
     }
@@ -115,7 +98,22 @@ size_t KDataImp::getPos(const Datetime& datetime) {
     return (iter - m_buffer.begin());
 }
 
-void KDataImp::_recoverForUpDay() {
+/******************************************************************************
+ * 前复权以区间最后一根K线为基准（即其价格不变），将之前的股价降下来；
+ * 后复权以区间第一根K线为基准（即其价格不变），将之后的股价升上去。
+ * K线与基准K线之间的各次除权逐次计算并舍入，见 RecoverFactor
+ *****************************************************************************/
+void KDataImp::_recover(const RecoverFactorList& factors) {
+    HKU_IF_RETURN(empty(), void());
+    KQuery::RecoverType recoverType = m_query.recoverType();
+    bool forward = recoverType == KQuery::FORWARD || recoverType == KQuery::EQUAL_FORWARD;
+    const Datetime& ref_date = forward ? m_buffer.back().datetime : m_buffer.front().datetime;
+    size_t ref_pos = getRecoverFactorPos(factors, ref_date);
+    recoverKRecords(m_buffer.data(), m_buffer.size(), factors, recoverType, ref_pos,
+                    m_stock.precision());
+}
+
+void KDataImp::_recoverForUpDay(const RecoverFactorList& factors) {
     HKU_IF_RETURN(empty(), void());
     std::function<Datetime(const Datetime&)> startOfPhase;
     if (m_query.kType() == KQuery::WEEK) {
@@ -130,285 +128,52 @@ void KDataImp::_recoverForUpDay() {
         startOfPhase = &Datetime::startOfYear;
     }
 
-    Datetime startDate = startOfPhase(m_buffer.front().datetime);
-    Datetime endDate = m_buffer.back().datetime.nextDay();
-    KQuery query = KQueryByDate(startDate, endDate, KQuery::DAY, m_query.recoverType());
-    KData day_list = m_stock.getKData(query);
-    if (day_list.empty())
-        return;
+    // 基准与对应的日线区间 [startOfPhase(第一根K线), 最后一根K线] 复权时一致
+    KQuery::RecoverType recoverType = m_query.recoverType();
+    bool forward = recoverType == KQuery::FORWARD || recoverType == KQuery::EQUAL_FORWARD;
+    Datetime ref_date =
+      forward ? m_buffer.back().datetime : startOfPhase(m_buffer.front().datetime);
+    size_t ref_pos = getRecoverFactorPos(factors, ref_date);
+    int precision = m_stock.precision();
 
-    size_t day_pos = 0;
-    size_t day_total = day_list.size();
+    // 周期内存在除权的K线需由复权后的日线重新合成，先收集，再一次读取所需的日线
+    vector<size_t> rebuild;
     size_t length = size();
     for (size_t i = 0; i < length; i++) {
-        Datetime phase_start_date = startOfPhase(m_buffer[i].datetime);
-        Datetime phase_end_date = m_buffer[i].datetime;
-        if (day_pos >= day_total)
-            break;
-
-        while (day_list[day_pos].datetime < phase_start_date) {
-            day_pos++;
-        }
-        KRecord record = day_list[day_pos];
-        int pre_day_pos = day_pos;
-        while (day_pos < day_total && day_list[day_pos].datetime <= phase_end_date) {
-            if (day_list[day_pos].lowPrice < record.lowPrice) {
-                record.lowPrice = day_list[day_pos].lowPrice;
-            } else if (day_list[day_pos].highPrice > record.highPrice) {
-                record.highPrice = day_list[day_pos].highPrice;
-            }
-            record.closePrice = day_list[day_pos].closePrice;
-            day_pos++;
-        }
-        if (pre_day_pos != day_pos) {
-            m_buffer[i].openPrice = record.openPrice;
-            m_buffer[i].highPrice = record.highPrice;
-            m_buffer[i].lowPrice = record.lowPrice;
-            m_buffer[i].closePrice = record.closePrice;
-        }
-    }
-
-    return;
-}
-
-/******************************************************************************
- * 前复权公式:复权后价格＝[(复权前价格-现金红利)＋配(新)股价格×流通股份变动比例]÷(1＋流通股份变动比例)
- * 向前复权指以除权后的股价为基准（即除权后的股价不变），将除权前的股价降下来。
- * 复权计算时首先从上市日开始，逐日向后判断，遇到除权日，则将上市日到除权日之间（不包括除权日）的
- * 全部股价通过复权计算降下来；然后再继续向后判断，遇到下一个除权日，则再次将上市日到该除权日之间
- * （不包括除权日）的全部股价通过复权计算降下来。
- *****************************************************************************/
-void KDataImp::_recoverForward() {
-    size_t total = m_buffer.size();
-    HKU_IF_RETURN(total == 0, void());
-
-    Datetime start_date(m_buffer.front().datetime.date());
-    Datetime end_date(m_buffer.back().datetime.date() + bd::days(1));
-    StockWeightList weightList = m_stock.getWeight(start_date, end_date);
-    StockWeightList::const_iterator weightIter = weightList.begin();
-
-    size_t pre_pos = 0;
-    for (; weightIter != weightList.end(); ++weightIter) {
-        // 计算流通股份变动比例,但不处理仅仅只有流通股本改变的情况
-        if ((weightIter->countAsGift() == 0.0 && weightIter->countForSell() == 0.0 &&
-             weightIter->priceForSell() == 0.0 && weightIter->bonus() == 0.0 &&
-             weightIter->increasement() == 0.0 && weightIter->suogu() == 0.0))
-            continue;
-
-        size_t i = pre_pos;
-        while (i < total && m_buffer[i].datetime < weightIter->datetime()) {
-            i++;
-        }
-        pre_pos = i;  // 除权日
-
-        price_t denominator = 0.0, temp = 0.0;
-        if (weightIter->suogu() != 0.0) {
-            denominator = weightIter->suogu();
+        KRecord& record = m_buffer[i];
+        size_t start_factor_pos = getRecoverFactorPos(factors, startOfPhase(record.datetime));
+        if (start_factor_pos == getRecoverFactorPos(factors, record.datetime)) {
+            // 周期内没有除权，直接按周期K线复权
+            recoverKRecords(&record, 1, factors, recoverType, ref_pos, precision);
         } else {
-            price_t change = 0.1 * (weightIter->countAsGift() + weightIter->countForSell() +
-                                    weightIter->increasement());
-            // change 小于 0 时为缩股
-            denominator = 1.0 + change;  // 分母 = (1+流通股份变动比例)
-            temp = weightIter->priceForSell() * change - 0.1 * weightIter->bonus();
-        }
-
-        if (denominator == 1.0 && temp == 0.0)
-            continue;
-
-        for (i = 0; i < pre_pos; ++i) {
-            m_buffer[i].openPrice =
-              roundEx((m_buffer[i].openPrice + temp) / denominator, m_stock.precision());
-            m_buffer[i].highPrice =
-              roundEx((m_buffer[i].highPrice + temp) / denominator, m_stock.precision());
-            m_buffer[i].lowPrice =
-              roundEx((m_buffer[i].lowPrice + temp) / denominator, m_stock.precision());
-            m_buffer[i].closePrice =
-              roundEx((m_buffer[i].closePrice + temp) / denominator, m_stock.precision());
-        }
-    }
-}
-
-/******************************************************************************
- * 后复权公式:复权后价格＝复权前价格×(1＋流通股份变动比例)-配(新)股价格×流通股份变动比例＋现金红利
- * 向后复权指以除权前的股价为基准（即除权前的股价不变），将除权后的股价升上去。复权计算时首先从最新日开始，
- * 逐日向前判断，遇到除权日，则将除权日到最新日之间（包括除权日）的全部股价通过复权计算升上去；然后再继续
- * 向前判断，遇到下一个除权日，则再次将除权日到最新日之间（包括除权日）的全部股价通过复权计算升上去。
- *****************************************************************************/
-void KDataImp::_recoverBackward() {
-    size_t total = m_buffer.size();
-    HKU_IF_RETURN(total == 0, void());
-
-    Datetime start_date(m_buffer.front().datetime.date());
-    Datetime end_date(m_buffer.back().datetime.date() + bd::days(1));
-    StockWeightList weightList = m_stock.getWeight(start_date, end_date);
-    StockWeightList::const_reverse_iterator weightIter = weightList.rbegin();
-
-    size_t pre_pos = total - 1;
-    for (; weightIter != weightList.rend(); ++weightIter) {
-        // 计算流通股份变动比例,但不处理仅仅只有流通股本改变的情况
-        if ((weightIter->countAsGift() == 0.0 && weightIter->countForSell() == 0.0 &&
-             weightIter->priceForSell() == 0.0 && weightIter->bonus() == 0.0 &&
-             weightIter->increasement() == 0.0 && weightIter->suogu() == 0.0))
+            rebuild.push_back(i);
+        }
+    }
+    HKU_IF_RETURN(rebuild.empty(), void());
+
+    KRecordList day_list = m_stock.getKRecordList(
+      KQueryByDate(startOfPhase(m_buffer[rebuild.front()].datetime),
+                   m_buffer[rebuild.back()].datetime.nextDay(), KQuery::DAY));
+    HKU_IF_RETURN(day_list.empty(), void());
+    recoverKRecords(day_list.data(), day_list.size(), factors, recoverType, ref_pos,
+                    precision);
+
+    KRecordResampler resampler(m_query.kType(), MarketInfo());
+    resampler.append(day_list.data(), day_list.size());
+    const KRecordList& phase_list = resampler.getKRecordList();
+    for (size_t i : rebuild) {
+        KRecord& record = m_buffer[i];
+        Datetime phase_end_date = resampler.getPeriodEnd(record.datetime);
+        auto iter = std::lower_bound(
+          phase_list.cbegin(), phase_list.cend(), phase_end_date,
+          [](const KRecord& k, const Datetime& date) { return k.datetime < date; });
+        if (iter == phase_list.cend() || iter->datetime != phase_end_date) {
             continue;
-
-        size_t i = pre_pos;
-        while (i > 0 && m_buffer[i].datetime > weightIter->datetime()) {
-            i--;
-        }
-        pre_pos = i;
-
-        price_t denominator = 0.0, temp = 0.0;
-        if (weightIter->suogu() != 0.0) {
-            denominator = weightIter->suogu();
-        } else {
-            // 流通股份变动比例
-            price_t change = 0.1 * (weightIter->countAsGift() + weightIter->countForSell() +
-                                    weightIter->increasement());
-            // change 小于 0 时为缩股
-            denominator = 1.0 + change;  //(1+流通股份变动比例)
-            temp = 0.1 * weightIter->bonus() - weightIter->priceForSell() * change;
-        }
-
-        if (denominator == 1.0 && temp == 0.0)
-            continue;
-
-        for (i = pre_pos; i < total; ++i) {
-            m_buffer[i].openPrice =
-              roundEx(m_buffer[i].openPrice * denominator + temp, m_stock.precision());
-            m_buffer[i].highPrice =
-              roundEx(m_buffer[i].highPrice * denominator + temp, m_stock.precision());
-            m_buffer[i].lowPrice =
-              roundEx(m_buffer[i].lowPrice * denominator + temp, m_stock.precision());
-            m_buffer[i].closePrice =
-              roundEx(m_buffer[i].closePrice * denominator + temp, m_stock.precision());
-        }
-    }
-}
-
-/******************************************************************************
- * 等比前复权公式:复权后价格＝复权前价格*复权率
- * 复权率＝｛[(股权登记日收盘价-现金红利)＋配(新)股价格×流通股份变动比例]÷(1＋流通股份变动比例)｝÷股权登记日收盘价
- * 向前复权指以除权后的股价为基准（即除权后的股价不变），将除权前的股价降下来。
- * 复权计算时首先从上市日开始，逐日向后判断，遇到除权日，则将上市日到除权日之间（不包括除权日）的
- * 全部股价通过复权计算降下来；然后再继续向后判断，遇到下一个除权日，则再次将上市日到该除权日之间
- * （不包括除权日）的全部股价通过复权计算降下来。
- *****************************************************************************/
-void KDataImp::_recoverEqualForward() {
-    size_t total = m_buffer.size();
-    HKU_IF_RETURN(total == 0, void());
-
-    Datetime start_date(m_buffer.front().datetime.date());
-    Datetime end_date(m_buffer.back().datetime.date() + bd::days(1));
-    StockWeightList weightList = m_stock.getWeight(start_date, end_date);
-    if (weightList.empty()) {
-        return;
-    }
-
-    KRecordList kdata = m_buffer;  // 防止同一天两条权息记录
-    StockWeightList::const_iterator weightIter = weightList.begin();
-    size_t pre_pos = 0;
-    for (; weightIter != weightList.end(); ++weightIter) {
-        // 计算流通股份变动比例,但不处理仅仅只有流通股本改变的情况
-        if ((weightIter->countAsGift() == 0.0 && weightIter->countForSell() == 0.0 &&
-             weightIter->priceForSell() == 0.0 && weightIter->bonus() == 0.0 &&
-             weightIter->increasement() == 0.0 && weightIter->suogu() == 0.0))
-            continue;
-
-        size_t i = pre_pos;
-        while (i < total && m_buffer[i].datetime < weightIter->datetime()) {
-            i++;
-        }
-        pre_pos = i;  // 除权日
-
-        // 股权登记日（即除权日的前一天数据）收盘价
-        if (pre_pos == 0) {
-            continue;
-        }
-        price_t closePrice = kdata[pre_pos - 1].closePrice;
-        if (closePrice == 0.0) {
-            continue;  // 除零保护
-        }
-
-        price_t denominator = 0.0, temp = 0.0;
-        if (weightIter->suogu() != 0.0) {
-            denominator = weightIter->suogu();
-        } else {
-            // 流通股份变动比例
-            price_t change = 0.1 * (weightIter->countAsGift() + weightIter->countForSell() +
-                                    weightIter->increasement());
-            // change 小于 0 时为缩股
-            denominator = 1.0 + change;  //(1+流通股份变动比例)
-            temp = weightIter->priceForSell() * change - 0.1 * weightIter->bonus();
-        }
-
-        if (denominator == 0.0 || (denominator == 1.0 && temp == 0.0))
-            continue;
-
-        price_t k = (closePrice + temp) / (denominator * closePrice);
-
-        for (i = 0; i < pre_pos; ++i) {
-            m_buffer[i].openPrice = roundEx(k * m_buffer[i].openPrice, m_stock.precision());
-            m_buffer[i].highPrice = roundEx(k * m_buffer[i].highPrice, m_stock.precision());
-            m_buffer[i].lowPrice = roundEx(k * m_buffer[i].lowPrice, m_stock.precision());
-            m_buffer[i].closePrice = roundEx(k * m_buffer[i].closePrice, m_stock.precision());
-        }
-    }
-}
-
-/******************************************************************************
- * 等比后复权公式:复权后价格＝复权前价格÷复权率
- * 复权率＝｛[(股权登记日收盘价-现金红利)＋配(新)股价格×流通股份变动比例]÷(1＋流通股份变动比例)｝÷股权登记日收盘价
- * 向后复权指以除权前的股价为基准（即除权前的股价不变），将除权后的股价升上去。复权计算时首先从最新日开始，
- * 逐日向前判断，遇到除权日，则将除权日到最新日之间（包括除权日）的全部股价通过复权计算升上去；然后再继续
- * 向前判断，遇到下一个除权日，则再次将除权日到最新日之间（包括除权日）的全部股价通过复权计算升上去。
- *****************************************************************************/
-void KDataImp::_recoverEqualBackward() {
-    size_t total = m_buffer.size();
-    HKU_IF_RETURN(total == 0, void());
-
-    Datetime start_date(m_buffer.front().datetime.date());
-    Datetime end_date(m_buffer.back().datetime.date() + bd::days(1));
-    StockWeightList weightList = m_stock.getWeight(start_date, end_date);
-    StockWeightList::const_reverse_iterator weightIter = weightList.rbegin();
-
-    size_t pre_pos = total - 1;
-    for (; weightIter != weightList.rend(); ++weightIter) {
-        size_t i = pre_pos;
-        while (i > 0 && m_buffer[i].datetime > weightIter->datetime()) {
-            i--;
-        }
-        pre_pos = i;  // 除权日
-
-        // 股权登记日（即除权日的前一天数据）收盘价
-        if (pre_pos == 0) {
-            continue;
-        }
-
-        price_t closePrice = m_buffer[pre_pos - 1].closePrice;
-
-        price_t denominator = 0.0, temp = closePrice;
-        if (weightIter->suogu() != 0.0) {
-            denominator = weightIter->suogu();
-        } else {
-            // 流通股份变动比例
-            price_t change = 0.1 * (weightIter->countAsGift() + weightIter->countForSell() +
-                                    weightIter->increasement());
-            // change 小于 0 时为缩股
-            denominator = 1.0 + change;  //(1+流通股份变动比例)
-            temp = closePrice + weightIter->priceForSell() * change - 0.1 * weightIter->bonus();
-        }
-
-        if (temp == 0.0 || denominator == 0.0) {
-            continue;
-        }
-        price_t k = (denominator * closePrice) / temp;
-
-        for (i = pre_pos; i < total; ++i) {
-            m_buffer[i].openPrice = roundEx(k * m_buffer[i].openPrice, m_stock.precision());
-            m_buffer[i].highPrice = roundEx(k * m_buffer[i].highPrice, m_stock.precision());
-            m_buffer[i].lowPrice = roundEx(k * m_buffer[i].lowPrice, m_stock.precision());
-            m_buffer[i].closePrice = roundEx(k * m_buffer[i].closePrice, m_stock.precision());
         }
+        record.openPrice = iter->openPrice;
+        record.highPrice = iter->highPrice;
+        record.lowPrice = iter->lowPrice;
+        record.closePrice = iter->closePrice;
     }
 }
 
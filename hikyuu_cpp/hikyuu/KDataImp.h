@@ -73,11 +73,8 @@ public:
 
 private:
     void _getPosInStock();
-    void _recoverForward();
-    void _recoverBackward();
-    void _recoverEqualForward();
-    void _recoverEqualBackward();
-    void _recoverForUpDay();
+    void _recover(const RecoverFactorList& factors);
+    void _recoverForUpDay(const RecoverFactorList& factors);
 
 private:
     KRecordList m_buffer;
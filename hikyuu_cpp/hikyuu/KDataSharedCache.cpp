@@ -0,0 +1,447 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#include <cstring>
+#include <random>
+#include <thread>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include "KDataSharedCache.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <cerrno>
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+namespace bip = boost::interprocess;
+
+namespace hku {
+
+namespace {
+
+enum SegmentState : uint32_t {
+    STATE_BUILDING = 0,
+    STATE_READY = 1,
+    STATE_STALE = 2,  // 数据版本已过期，即将被删除重建
+};
+
+// 共享内存段头，创建段后即写入所有者信息，所有者写入全部数据后才将 state 置为 STATE_READY
+struct SegmentHeader {
+    char magic[4];
+    uint32_t version;
+    std::atomic<uint32_t> state;
+    uint32_t record_size;
+    uint64_t stock_count;
+    uint64_t record_count;
+    uint64_t entry_offset;
+    uint64_t data_offset;
+    uint64_t total_bytes;
+    uint64_t create_time;   // YYYYMMDDhhmmss
+    uint64_t data_version;  // 发布时的数据版本，见 KDataSharedCache::open
+    uint64_t owner_token;   // 所有者标识，所有者退出时据此确认未被其他进程重建
+    uint64_t owner_pid;     // 所有者进程号，等待者据此判断所有者是否在写入完成前异常退出
+    char ktype[16];
+    unsigned char probe[sizeof(KRecord)];  // 校验记录内存布局的样本
+};
+
+struct SegmentEntry {
+    char market_code[KDataSharedCache::MAX_MARKET_CODE_LENGTH + 1];
+    uint64_t offset;  // 首条记录在数据区中的位置（记录数）
+    uint64_t count;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "Shared memory state requires lock free atomic!");
+
+const char SEGMENT_MAGIC[4] = {'H', 'K', 'U', 'M'};
+const size_t SEGMENT_ALIGN = 64;
+
+inline uint64_t alignSize(uint64_t n) {
+    return (n + SEGMENT_ALIGN - 1) / SEGMENT_ALIGN * SEGMENT_ALIGN;
+}
+
+void makeProbe(unsigned char* out) {
+    KRecord probe(Datetime(202001020931LL), 1.25, 2.5, 0.125, 1.75, 12345.5, 678.0);
+    std::memcpy(out, (const void*)&probe, sizeof(KRecord));
+}
+
+string upperKType(const KQuery::KType& ktype) {
+    string result(ktype);
+    to_upper(result);
+    return result;
+}
+
+uint64_t makeOwnerToken() {
+    std::random_device rd;
+    return (uint64_t(rd()) << 32) ^ uint64_t(rd()) ^ Datetime::now().ticks();
+}
+
+uint64_t currentProcessId() {
+#if defined(_WIN32)
+    return uint64_t(GetCurrentProcessId());
+#else
+    return uint64_t(getpid());
+#endif
+}
+
+// 判断进程是否仍在运行，无法确定时（如无权限）视为仍在运行
+bool isProcessAlive(uint64_t pid) {
+#if defined(_WIN32)
+    HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, DWORD(pid));
+    if (!process) {
+        return GetLastError() != ERROR_INVALID_PARAMETER;
+    }
+    DWORD code = 0;
+    bool alive = !GetExitCodeProcess(process, &code) || code == STILL_ACTIVE;
+    CloseHandle(process);
+    return alive;
+#else
+    return kill(pid_t(pid), 0) == 0 || errno != ESRCH;
+#endif
+}
+
+// 写入段头中的格式及所有者信息，state 为 STATE_BUILDING
+void initHeader(SegmentHeader* h, uint64_t owner_token) {
+    h->state.store(STATE_BUILDING, std::memory_order_relaxed);
+    std::memcpy(h->magic, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC));
+    h->version = KDataSharedCache::FORMAT_VERSION;
+    h->record_size = sizeof(KRecord);
+    h->owner_token = owner_token;
+    h->owner_pid = currentProcessId();
+}
+
+// 读取段头中的所有者标识，段不存在或段头无效时返回 0
+uint64_t readOwnerToken(const char* name) {
+    try {
+        bip::shared_memory_object shm(bip::open_only, name, bip::read_only);
+        bip::offset_t size = 0;
+        HKU_IF_RETURN(!shm.get_size(size) || size < bip::offset_t(sizeof(SegmentHeader)), 0);
+        bip::mapped_region head(shm, bip::read_only, 0, sizeof(SegmentHeader));
+        const SegmentHeader* h = static_cast<const SegmentHeader*>(head.get_address());
+        HKU_IF_RETURN(std::memcmp(h->magic, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC)) != 0 ||
+                        h->version != KDataSharedCache::FORMAT_VERSION,
+                      0);
+        return h->owner_token;
+    } catch (const bip::interprocess_exception&) {
+    }
+    return 0;
+}
+
+// 将数据版本不一致的就绪段标记为过期并删除。仅标记成功的进程执行删除，
+// 避免多个进程同时发现过期时误删其他进程刚重建的段
+bool expireSegment(const char* name, uint64_t data_version) {
+    try {
+        bip::shared_memory_object shm(bip::open_only, name, bip::read_write);
+        bip::offset_t size = 0;
+        HKU_IF_RETURN(!shm.get_size(size) || size < bip::offset_t(sizeof(SegmentHeader)), false);
+        bip::mapped_region head(shm, bip::read_write, 0, sizeof(SegmentHeader));
+        SegmentHeader* h = static_cast<SegmentHeader*>(head.get_address());
+        uint32_t expected = STATE_READY;
+        HKU_IF_RETURN(h->data_version == data_version ||
+                        !h->state.compare_exchange_strong(expected, STATE_STALE,
+                                                          std::memory_order_acq_rel),
+                      false);
+    } catch (const bip::interprocess_exception&) {
+        return false;
+    }
+    return bip::shared_memory_object::remove(name);
+}
+
+// 删除所有者在写入完成前异常退出而遗留的段，仅在段仍属于该所有者且标记成功时删除
+bool expireAbandonedSegment(const char* name, uint64_t owner_token) {
+    try {
+        bip::shared_memory_object shm(bip::open_only, name, bip::read_write);
+        bip::offset_t size = 0;
+        HKU_IF_RETURN(!shm.get_size(size) || size < bip::offset_t(sizeof(SegmentHeader)), false);
+        bip::mapped_region head(shm, bip::read_write, 0, sizeof(SegmentHeader));
+        SegmentHeader* h = static_cast<SegmentHeader*>(head.get_address());
+        uint32_t expected = STATE_BUILDING;
+        HKU_IF_RETURN(h->owner_token != owner_token ||
+                        !h->state.compare_exchange_strong(expected, STATE_STALE,
+                                                          std::memory_order_acq_rel),
+                      false);
+    } catch (const bip::interprocess_exception&) {
+        return false;
+    }
+    return bip::shared_memory_object::remove(name);
+}
+
+}  // namespace
+
+struct KDataSharedCache::Segment {
+    string name;
+    KDataSharedCache::Role role{KDataSharedCache::NONE};
+    uint64_t data_version{0};
+    uint64_t owner_token{0};
+    shared_ptr<bip::mapped_region> region;  // 就绪后的整段映射，由引用它的K线缓存共同持有
+
+    const SegmentHeader* header() const {
+        return region ? static_cast<const SegmentHeader*>(region->get_address()) : nullptr;
+    }
+};
+
+KDataSharedCache::KDataSharedCache(const string& name, bool keep) : m_name(name), m_keep(keep) {
+    HKU_CHECK(!name.empty(), "The name of shared memory is empty!");
+}
+
+KDataSharedCache::~KDataSharedCache() {
+    if (m_keep) {
+        return;
+    }
+    for (auto& item : m_segments) {
+        const Segment& segment = *item.second;
+        // 段可能因过期已被其他进程删除重建，只删除仍属于本实例的段
+        if (segment.role == OWNER && readOwnerToken(segment.name.c_str()) == segment.owner_token) {
+            // 已映射的进程不受影响，映射在最后一个引用者释放后回收
+            bip::shared_memory_object::remove(segment.name.c_str());
+        }
+    }
+}
+
+string KDataSharedCache::segmentName(const string& name, const KQuery::KType& ktype) {
+    string low_ktype(ktype);
+    to_lower(low_ktype);
+    return fmt::format("hku_{}_{}", name, low_ktype);
+}
+
+bool KDataSharedCache::remove(const string& name, const KQuery::KType& ktype) {
+    return bip::shared_memory_object::remove(segmentName(name, ktype).c_str());
+}
+
+KDataSharedCache::SegmentPtr KDataSharedCache::_getSegment(const KQuery::KType& ktype) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto iter = m_segments.find(upperKType(ktype));
+    return iter != m_segments.end() ? iter->second : SegmentPtr();
+}
+
+KDataSharedCache::Role KDataSharedCache::role(const KQuery::KType& ktype) const {
+    SegmentPtr segment = _getSegment(ktype);
+    return segment ? segment->role : NONE;
+}
+
+KDataSharedCache::Role KDataSharedCache::open(const KQuery::KType& ktype, int64_t timeout_ms,
+                                              uint64_t data_version) {
+    string nktype = upperKType(ktype);
+    SegmentPtr segment = _getSegment(nktype);
+    HKU_IF_RETURN(segment, segment->role);
+
+    segment = make_shared<Segment>();
+    segment->name = segmentName(m_name, nktype);
+    segment->data_version = data_version;
+    const char* name = segment->name.c_str();
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (true) {
+        bool exist = true;
+        bool stale = false;
+        uint64_t abandoned_token = 0;
+        try {
+            bip::shared_memory_object shm(bip::open_only, name, bip::read_only);
+            bip::offset_t size = 0;
+            if (shm.get_size(size) && size >= bip::offset_t(sizeof(SegmentHeader))) {
+                // 所有者完成写入前段大小可能变化，先只映射段头
+                bip::mapped_region head(shm, bip::read_only, 0, sizeof(SegmentHeader));
+                const SegmentHeader* h = static_cast<const SegmentHeader*>(head.get_address());
+                if (h->state.load(std::memory_order_acquire) == STATE_READY) {
+                    unsigned char probe[sizeof(KRecord)];
+                    makeProbe(probe);
+                    HKU_ERROR_IF_RETURN(
+                      std::memcmp(h->magic, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC)) != 0 ||
+                        h->version != FORMAT_VERSION || h->record_size != sizeof(KRecord) ||
+                        std::memcmp(h->probe, probe, sizeof(KRecord)) != 0 ||
+                        h->total_bytes > uint64_t(size),
+                      NONE, "Incompatible shared memory: {}", segment->name);
+                    if (h->data_version != data_version) {
+                        HKU_INFO(
+                          "Shared kdata {} is stale (version: {}, expected: {}, created: {})",
+                          segment->name, h->data_version, data_version, h->create_time);
+                        stale = true;
+                    } else {
+                        segment->region = make_shared<bip::mapped_region>(
+                          shm, bip::read_only, 0, size_t(h->total_bytes));
+                        segment->role = ATTACHED;
+                        HKU_INFO("Attached shared kdata {} (stocks: {}, records: {}, created: {})",
+                                 segment->name, h->stock_count, h->record_count, h->create_time);
+                    }
+                } else if (std::memcmp(h->magic, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC)) == 0 &&
+                           h->version == FORMAT_VERSION && h->owner_pid != 0 &&
+                           !isProcessAlive(h->owner_pid)) {
+                    // 所有者在写入完成前异常退出，无需等待至超时
+                    HKU_WARN("The owner (pid: {}) of shared kdata {} has exited before publishing!",
+                             h->owner_pid, segment->name);
+                    abandoned_token = h->owner_token;
+                }
+            }
+        } catch (const bip::interprocess_exception&) {
+            exist = false;
+        }
+
+        // 过期或被遗弃的段删除后由本进程重建，已附着的进程仍可继续使用原映射
+        if ((stale && expireSegment(name, data_version)) ||
+            (abandoned_token != 0 && expireAbandonedSegment(name, abandoned_token))) {
+            exist = false;
+        }
+
+        if (!exist) {
+            try {
+                // create_only 保证只有一个进程成为所有者，创建后立即写入段头供等待者识别所有者，
+                // 段大小在发布时按数据量重新设定
+                bip::shared_memory_object shm(bip::create_only, name, bip::read_write);
+                segment->role = OWNER;
+                segment->owner_token = makeOwnerToken();
+                shm.truncate(bip::offset_t(sizeof(SegmentHeader)));
+                bip::mapped_region head(shm, bip::read_write, 0, sizeof(SegmentHeader));
+                initHeader(new (head.get_address()) SegmentHeader, segment->owner_token);
+            } catch (const bip::interprocess_exception& e) {
+                // 其他进程抢先创建时继续等待其就绪；已创建但写入段头失败时由所有者删除
+                if (segment->role == OWNER) {
+                    HKU_ERROR("Failed init shared kdata {}! {}", segment->name, e.what());
+                    bip::shared_memory_object::remove(name);
+                    return NONE;
+                }
+            }
+        }
+
+        if (segment->role != NONE) {
+            break;
+        }
+
+        if (std::chrono::steady_clock::now() >= deadline) {
+            HKU_WARN(
+              "Timeout waiting for shared kdata {}! If its owner has exited abnormally, please "
+              "remove it with KDataSharedCache::remove.",
+              segment->name);
+            return NONE;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_segments[nktype] = segment;
+    return segment->role;
+}
+
+size_t KDataSharedCache::attach(const KQuery::KType& ktype,
+                                const StockMapIterator::stock_map_t& stocks) {
+    SegmentPtr segment = _getSegment(ktype);
+    HKU_IF_RETURN(!segment || !segment->region, 0);
+
+    const SegmentHeader* h = segment->header();
+    HKU_IF_RETURN(h->state.load(std::memory_order_acquire) != STATE_READY, 0);
+
+    const char* base = static_cast<const char*>(segment->region->get_address());
+    const SegmentEntry* entries = reinterpret_cast<const SegmentEntry*>(base + h->entry_offset);
+    const KRecord* data = reinterpret_cast<const KRecord*>(base + h->data_offset);
+
+    // 各证券的K线缓存共同持有映射，全部释放后才解除映射
+    std::shared_ptr<const void> owner = segment->region;
+    size_t count = 0;
+    for (uint64_t i = 0; i < h->stock_count; i++) {
+        const SegmentEntry& entry = entries[i];
+        HKU_ERROR_IF_RETURN(entry.offset + entry.count > h->record_count, count,
+                            "Invalid shared kdata entry: {}", segment->name);
+        auto iter = stocks.find(string(entry.market_code));
+        if (iter == stocks.end()) {
+            continue;
+        }
+        Stock stk = iter->second;
+        if (stk.attachKDataBuffer(ktype, data + entry.offset, entry.count, owner)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+size_t KDataSharedCache::publish(const KQuery::KType& ktype,
+                                 const StockMapIterator::stock_map_t& stocks) {
+    SegmentPtr segment = _getSegment(ktype);
+    HKU_CHECK(segment && segment->role == OWNER && !segment->region,
+              "Only the owner can publish shared kdata once!");
+
+    struct Item {
+        string market_code;
+        Stock stock;
+        size_t count;
+    };
+    vector<Item> items;
+    uint64_t record_count = 0;
+    for (auto iter = stocks.begin(); iter != stocks.end(); ++iter) {
+        const Stock& stk = iter->second;
+        if (!stk.isBuffer(ktype) || iter->first.size() > MAX_MARKET_CODE_LENGTH) {
+            continue;
+        }
+        size_t count = stk.getCount(ktype);
+        items.push_back(Item{iter->first, stk, count});
+        record_count += count;
+    }
+
+    uint64_t entry_offset = alignSize(sizeof(SegmentHeader));
+    uint64_t data_offset = alignSize(entry_offset + items.size() * sizeof(SegmentEntry));
+    uint64_t total_bytes = data_offset + record_count * sizeof(KRecord);
+
+    size_t published = 0;
+    try {
+        bip::shared_memory_object shm(bip::open_only, segment->name.c_str(), bip::read_write);
+        shm.truncate(bip::offset_t(total_bytes));
+        auto region =
+          make_shared<bip::mapped_region>(shm, bip::read_write, 0, size_t(total_bytes));
+        char* base = static_cast<char*>(region->get_address());
+
+        SegmentHeader* h = new (base) SegmentHeader;
+        initHeader(h, segment->owner_token);
+        h->stock_count = items.size();
+        h->entry_offset = entry_offset;
+        h->data_offset = data_offset;
+        h->total_bytes = total_bytes;
+        h->create_time = Datetime::now().ymdhms();
+        h->data_version = segment->data_version;
+        std::memset(h->ktype, 0, sizeof(h->ktype));
+        string nktype = upperKType(ktype);
+        std::memcpy(h->ktype, nktype.data(), std::min(nktype.size(), sizeof(h->ktype) - 1));
+        makeProbe(h->probe);
+
+        SegmentEntry* entries = reinterpret_cast<SegmentEntry*>(base + entry_offset);
+        KRecord* data = reinterpret_cast<KRecord*>(base + data_offset);
+        uint64_t offset = 0;
+        for (const auto& item : items) {
+            KRecordList ks =
+              item.count > 0 ? item.stock.getKRecordList(KQuery(0, int64_t(item.count), ktype))
+                             : KRecordList();
+            size_t count = std::min(ks.size(), item.count);
+            SegmentEntry& entry = entries[published++];
+            std::memset(entry.market_code, 0, sizeof(entry.market_code));
+            std::memcpy(entry.market_code, item.market_code.data(), item.market_code.size());
+            entry.offset = offset;
+            entry.count = count;
+            if (count > 0) {
+                std::memcpy((void*)(data + offset), ks.data(), count * sizeof(KRecord));
+            }
+            offset += count;
+        }
+        h->stock_count = published;
+        h->record_count = offset;
+        h->state.store(STATE_READY, std::memory_order_release);
+
+        segment->region = region;
+    } catch (const std::exception& e) {
+        HKU_ERROR("Failed publish shared kdata {}! {}", segment->name, e.what());
+        bip::shared_memory_object::remove(segment->name.c_str());
+        segment->role = NONE;
+        return 0;
+    }
+
+    // 本进程同样改为引用共享数据，释放私有缓存
+    size_t attached = attach(ktype, stocks);
+    HKU_INFO("Published shared kdata {} (stocks: {}, attached: {})", segment->name, published,
+             attached);
+    return published;
+}
+
+}  // namespace hku
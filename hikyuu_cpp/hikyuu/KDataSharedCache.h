@@ -0,0 +1,126 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#pragma once
+#ifndef HIKYUU_KDATA_SHARED_CACHE_H_
+#define HIKYUU_KDATA_SHARED_CACHE_H_
+
+#include "StockMapIterator.h"
+
+namespace hku {
+
+/**
+ * 跨进程共享的K线缓存
+ * @details
+ * <pre>
+ * 同一主机上的多个进程共享预加载的K线数据，避免每个进程各自加载并持有一份相同的数据。
+ * 每种K线类型对应一个命名共享内存段，段内依次为带版本信息的段头、证券目录及全部K线记录。
+ *
+ * 使用方式：
+ *   - open 打开指定K线类型的共享内存段：已有数据就绪时返回 ATTACHED，可调用 attach
+ *     使各证券的K线缓存直接引用共享内存（只读）；共享内存段不存在时由本进程创建并返回 OWNER，
+ *     本进程正常加载K线缓存后调用 publish 写入共享内存，随后本进程的证券同样改为引用共享数据；
+ *     其他进程正在写入时等待其就绪，超时后返回 NONE，由调用者自行加载；段头中记录所有者的
+ *     进程号，所有者在写入完成前异常退出时，等待的进程删除该段后重建，无需等待至超时。
+ *   - 引用共享数据的K线缓存在接收实时行情时复制为本进程私有数据（写时复制），不影响其他进程。
+ *   - 段头中记录发布时的数据版本（StockManager 使用各市场指数该类型K线的记录数及最后时间），
+ *     与 open 时指定的版本不一致的段视为过期，由发现的进程删除后重建，避免 keep 保留的旧段
+ *     被一直引用。
+ *   - StockManager::reload 仅重新加载本进程的私有K线缓存，不重新发布或附着共享内存段，
+ *     需要更新共享数据时请重新启动使用共享缓存的进程。
+ *   - 所有者析构时删除其创建的共享内存段（keep 为 true 时保留，可由常驻进程持有），
+ *     已附着的进程仍可继续使用已映射的数据。
+ *
+ * StockManager 通过 hikyuu 参数启用：
+ *   - shm_kdata: 共享内存段名称前缀，为空时不启用
+ *   - shm_kdata_keep: 所有者退出时是否保留共享内存段，默认 false
+ *   - shm_kdata_timeout: 等待其他进程写入完成的超时时长（秒），默认 300
+ * 记录以本进程内存布局直接存放，段头中的布局校验不一致时拒绝附着。
+ * </pre>
+ * @ingroup StockManage
+ */
+class HKU_API KDataSharedCache {
+public:
+    /** 共享内存段格式版本 */
+    static constexpr uint32_t FORMAT_VERSION = 3;
+
+    /** 支持的最长证券标识（市场简称+证券代码）长度 */
+    static constexpr size_t MAX_MARKET_CODE_LENGTH = 23;
+
+    /** 本进程在共享内存段中的角色 */
+    enum Role {
+        NONE = 0,      ///< 不可用，需自行加载
+        ATTACHED = 1,  ///< 已打开就绪的共享数据
+        OWNER = 2,     ///< 本进程创建了共享内存段，需加载后发布
+    };
+
+    /**
+     * 构造函数
+     * @param name 共享内存段名称前缀
+     * @param keep 析构时是否保留本实例创建的共享内存段
+     */
+    explicit KDataSharedCache(const string& name, bool keep = false);
+    ~KDataSharedCache();
+
+    KDataSharedCache(const KDataSharedCache&) = delete;
+    KDataSharedCache& operator=(const KDataSharedCache&) = delete;
+
+    const string& name() const noexcept {
+        return m_name;
+    }
+
+    /**
+     * 打开指定K线类型的共享内存段，不存在时创建
+     * @param ktype K线类型
+     * @param timeout_ms 等待其他进程写入完成的最长时间（毫秒）
+     * @param data_version 数据版本，已就绪段的版本与之不一致时删除该段并重建
+     * @return 本进程的角色
+     */
+    Role open(const KQuery::KType& ktype, int64_t timeout_ms = 300000, uint64_t data_version = 0);
+
+    /** 获取已打开的共享内存段中本进程的角色 */
+    Role role(const KQuery::KType& ktype) const;
+
+    /**
+     * 使证券的K线缓存引用已就绪的共享数据，未包含在共享内存段中的证券不受影响
+     * @param ktype K线类型
+     * @param stocks 证券字典
+     * @return 附着的证券数
+     */
+    size_t attach(const KQuery::KType& ktype, const StockMapIterator::stock_map_t& stocks);
+
+    /**
+     * 将已缓存的K线写入共享内存段并标记就绪，仅所有者可调用
+     * @details 写入后本进程证券的K线缓存同样改为引用共享数据
+     * @param ktype K线类型
+     * @param stocks 证券字典
+     * @return 写入的证券数，失败时删除共享内存段并返回 0
+     */
+    size_t publish(const KQuery::KType& ktype, const StockMapIterator::stock_map_t& stocks);
+
+    /** 共享内存段名称 */
+    static string segmentName(const string& name, const KQuery::KType& ktype);
+
+    /** 删除指定的共享内存段（如异常退出的所有者遗留的内存段） */
+    static bool remove(const string& name, const KQuery::KType& ktype);
+
+private:
+    struct Segment;
+    using SegmentPtr = shared_ptr<Segment>;
+
+    SegmentPtr _getSegment(const KQuery::KType& ktype) const;
+
+private:
+    string m_name;
+    bool m_keep;
+    unordered_map<string, SegmentPtr> m_segments;  // ktype -> 共享内存段
+    mutable std::mutex m_mutex;
+};
+
+}  // namespace hku
+
+#endif /* HIKYUU_KDATA_SHARED_CACHE_H_ */
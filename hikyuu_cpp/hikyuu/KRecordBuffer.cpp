@@ -0,0 +1,421 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#include <algorithm>
+#include <thread>
+#include "KRecordBuffer.h"
+
+namespace hku {
+
+// 整体替换数据时预留的追加空间（记录数）
+static const size_t APPEND_RESERVE = 32;
+
+// 日期位置索引预留的自然日数
+static const size_t DAY_INDEX_RESERVE = 64;
+
+// 超过此跨度（自然日）时不建立日期位置索引
+static const int64_t MAX_DAY_INDEX_SPAN = 1000000;
+
+static inline int64_t dayNumber(const Datetime& d) {
+    return static_cast<int64_t>(d.date().day_number());
+}
+
+/*
+ * 数据块，创建后 records/day_index 的容量不再改变，读者仅通过 data/day_data 指针访问，
+ * 写入者在容量范围内追加后再发布新的 size/day_size
+ */
+struct KRecordBuffer::Block {
+    KRecordList records;
+    const KRecord* data{nullptr};
+    std::shared_ptr<const void> shared;  // 外部数据的持有者，非空时 data 指向外部只读数据
+    std::atomic<size_t> size{0};
+    std::atomic<uint64_t> seq{0};  // 最后一条记录的顺序锁，奇数表示正在写入
+
+    int64_t day_start{0};  // 首条记录的日序号
+    vector<uint32_t> day_index;  // 自首条记录起，每个自然日零点对应的 lower_bound 位置
+    const uint32_t* day_data{nullptr};
+    std::atomic<size_t> day_size{0};
+
+    // 读取指定位置的记录，pos 为读者看到的最后一条记录时需通过顺序锁读取
+    KRecord read(size_t pos, size_t total) const {
+        if (pos + 1 < total) {
+            return data[pos];
+        }
+
+        KRecord result;
+        while (true) {
+            uint64_t start_seq = seq.load(std::memory_order_acquire);
+            if (start_seq & 1) {
+                std::this_thread::yield();
+                continue;
+            }
+            result = data[pos];
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq.load(std::memory_order_relaxed) == start_seq) {
+                break;
+            }
+        }
+        return result;
+    }
+
+    // 第一个 >= date 的位置
+    size_t lowerBound(const Datetime& date, size_t total) const {
+        HKU_IF_RETURN(date.isNull(), total);
+
+        size_t day_total = day_size.load(std::memory_order_acquire);
+        if (day_total > 0) {
+            int64_t offset = dayNumber(date) - day_start;
+            HKU_IF_RETURN(offset < 0, 0);
+            HKU_IF_RETURN(offset >= static_cast<int64_t>(day_total), total);
+
+            // 索引对应当日零点，带有时分秒时需跳过当日更早的记录
+            size_t pos = day_data[offset];
+            while (pos < total && data[pos].datetime < date) {
+                pos++;
+            }
+            return pos < total ? pos : total;
+        }
+
+        auto iter = std::lower_bound(
+          data, data + total, date,
+          [](const KRecord& k, const Datetime& d) { return k.datetime < d; });
+        return iter - data;
+    }
+};
+
+/*
+ * 读者槽位，每个线程独占一个，按缓存行对齐，读者之间不竞争同一缓存行。
+ * epoch 为读者进入时的全局纪元，0 表示当前线程不在读取中。
+ * 槽位只增不减，线程退出后归还，由之后的新线程复用。
+ */
+struct alignas(64) ReaderSlot {
+    std::atomic<uint64_t> epoch{0};
+    std::atomic<bool> used{false};
+    ReaderSlot* next{nullptr};
+};
+
+// 全局纪元，每替换一个数据块递增
+static std::atomic<uint64_t> g_epoch{1};
+
+// 所有读者槽位的链表，仅在头部插入
+static std::atomic<ReaderSlot*> g_slots{nullptr};
+
+static ReaderSlot* acquireReaderSlot() {
+    for (ReaderSlot* slot = g_slots.load(std::memory_order_acquire); slot; slot = slot->next) {
+        bool expected = false;
+        if (!slot->used.load(std::memory_order_relaxed) &&
+            slot->used.compare_exchange_strong(expected, true)) {
+            return slot;
+        }
+    }
+
+    ReaderSlot* slot = new ReaderSlot;
+    slot->used.store(true, std::memory_order_relaxed);
+    slot->next = g_slots.load(std::memory_order_relaxed);
+    while (!g_slots.compare_exchange_weak(slot->next, slot, std::memory_order_release,
+                                          std::memory_order_relaxed)) {
+    }
+    return slot;
+}
+
+// 正在读取的读者中最早的纪元，没有读者时返回 UINT64_MAX
+static uint64_t minActiveEpoch() {
+    uint64_t result = UINT64_MAX;
+    for (ReaderSlot* slot = g_slots.load(std::memory_order_acquire); slot; slot = slot->next) {
+        uint64_t epoch = slot->epoch.load();
+        if (epoch != 0 && epoch < result) {
+            result = epoch;
+        }
+    }
+    return result;
+}
+
+// 当前线程的读者槽位，depth 为嵌套的读者数，仅最外层读者设置和清除纪元
+struct ThreadReader {
+    ReaderSlot* slot{acquireReaderSlot()};
+    size_t depth{0};
+
+    ~ThreadReader() {
+        slot->epoch.store(0, std::memory_order_release);
+        slot->used.store(false, std::memory_order_release);
+    }
+};
+
+static thread_local ThreadReader t_reader;
+
+/*
+ * 读者访问期间阻止释放其可能看到的数据块。
+ * 先以 seq_cst 记录纪元再读取 m_block，与写入者的 exchange、纪元递增及回收时的扫描
+ * 构成全序：读到旧数据块的读者，其纪元不晚于该数据块被替换时的纪元。
+ * 退出时先清除纪元再检查是否有待释放的数据块，与写入者相反的顺序保证最后退出的读者
+ * 或写入者二者之一能看到对方，被替换的数据块不会滞留到下一次写入。
+ */
+class KRecordBuffer::ReadGuard {
+public:
+    explicit ReadGuard(const KRecordBuffer& buffer) : m_buffer(buffer), m_reader(t_reader) {
+        if (m_reader.depth++ == 0) {
+            m_reader.slot->epoch.store(g_epoch.load());
+        }
+        block = buffer.m_block.load();
+    }
+
+    ~ReadGuard() {
+        if (--m_reader.depth == 0) {
+            m_reader.slot->epoch.store(0);
+        }
+        if (m_buffer.m_has_retired.load()) {
+            m_buffer._reclaim();
+        }
+    }
+
+    ReadGuard(const ReadGuard&) = delete;
+    ReadGuard& operator=(const ReadGuard&) = delete;
+
+    const Block* block;
+
+private:
+    const KRecordBuffer& m_buffer;
+    ThreadReader& m_reader;
+};
+
+KRecordBuffer::KRecordBuffer(bool day_index) : m_with_day_index(day_index) {}
+
+KRecordBuffer::~KRecordBuffer() {
+    delete m_block.load();
+    for (auto& retired : m_retired) {
+        delete retired.block;
+    }
+}
+
+bool KRecordBuffer::isShared() const {
+    ReadGuard guard(*this);
+    return guard.block && guard.block->shared;
+}
+
+size_t KRecordBuffer::size() const {
+    ReadGuard guard(*this);
+    return guard.block ? guard.block->size.load(std::memory_order_acquire) : 0;
+}
+
+KRecord KRecordBuffer::get(size_t pos) const {
+    ReadGuard guard(*this);
+    HKU_IF_RETURN(!guard.block, KRecord());
+    size_t total = guard.block->size.load(std::memory_order_acquire);
+    return pos >= total ? KRecord() : guard.block->read(pos, total);
+}
+
+KRecord KRecordBuffer::back() const {
+    ReadGuard guard(*this);
+    HKU_IF_RETURN(!guard.block, KRecord());
+    size_t total = guard.block->size.load(std::memory_order_acquire);
+    return total == 0 ? KRecord() : guard.block->read(total - 1, total);
+}
+
+KRecordList KRecordBuffer::getKRecordList(size_t start_ix, size_t end_ix) const {
+    KRecordList result;
+    ReadGuard guard(*this);
+    HKU_IF_RETURN(!guard.block, result);
+
+    const Block* block = guard.block;
+    size_t total = block->size.load(std::memory_order_acquire);
+    HKU_IF_RETURN(total == 0, result);
+    HKU_WARN_IF_RETURN(start_ix >= end_ix || start_ix >= total, result,
+                       "Invalid param (start_ix: {}, end_ix: {})! current total: {}", start_ix,
+                       end_ix, total);
+
+    size_t length = end_ix > total ? total - start_ix : end_ix - start_ix;
+    result.resize(length);
+
+    // 除读者所见的最后一条记录外，其余记录发布后不再改变，可直接复制
+    size_t stable = start_ix + length < total ? length : length - 1;
+    if (stable > 0) {
+        std::copy(block->data + start_ix, block->data + start_ix + stable, result.begin());
+    }
+    if (stable < length) {
+        result[stable] = block->read(total - 1, total);
+    }
+    return result;
+}
+
+bool KRecordBuffer::getIndexRangeByDate(const Datetime& start, const Datetime& end,
+                                        size_t& out_start, size_t& out_end) const {
+    out_start = 0;
+    out_end = 0;
+    HKU_IF_RETURN(start >= end, false);
+
+    ReadGuard guard(*this);
+    HKU_IF_RETURN(!guard.block, false);
+
+    // 已发布记录的日期不会改变，无需顺序锁
+    size_t total = guard.block->size.load(std::memory_order_acquire);
+    HKU_IF_RETURN(0 == total, false);
+
+    size_t startpos = guard.block->lowerBound(start, total);
+    HKU_IF_RETURN(startpos >= total, false);
+    size_t endpos = guard.block->lowerBound(end, total);
+    HKU_IF_RETURN(startpos >= endpos, false);
+
+    out_start = startpos;
+    out_end = endpos;
+    return true;
+}
+
+KRecordBuffer::Block* KRecordBuffer::_createBlock(KRecordList&& ks, size_t reserve) const {
+    Block* block = new Block;
+    block->records = std::move(ks);
+    size_t total = block->records.size();
+    block->records.reserve(total + reserve);
+    block->data = block->records.data();
+    block->size.store(total, std::memory_order_relaxed);
+    _buildDayIndex(block);
+    return block;
+}
+
+void KRecordBuffer::_buildDayIndex(Block* block) const {
+    size_t total = block->size.load(std::memory_order_relaxed);
+    HKU_IF_RETURN(!m_with_day_index || total == 0, void());
+
+    const KRecord* data = block->data;
+    HKU_IF_RETURN(data[total - 1].datetime.isNull(), void());
+    block->day_start = dayNumber(data[0].datetime);
+    int64_t span = dayNumber(data[total - 1].datetime) - block->day_start + 1;
+    HKU_IF_RETURN(span <= 0 || span > MAX_DAY_INDEX_SPAN, void());
+
+    block->day_index.reserve(span + DAY_INDEX_RESERVE);
+    size_t pos = 0;
+    for (int64_t i = 0; i < span; i++) {
+        int64_t day = block->day_start + i;
+        while (pos < total && dayNumber(data[pos].datetime) < day) {
+            pos++;
+        }
+        block->day_index.push_back(static_cast<uint32_t>(pos));
+    }
+    block->day_data = block->day_index.data();
+    block->day_size.store(span, std::memory_order_relaxed);
+}
+
+void KRecordBuffer::_publish(Block* block) {
+    Block* old = m_block.exchange(block);
+    if (old) {
+        // 此后进入的读者纪元均晚于 epoch，看不到 old
+        uint64_t epoch = g_epoch.fetch_add(1);
+        std::lock_guard<std::mutex> lock(m_retired_mutex);
+        m_retired.push_back({old, epoch});
+        m_has_retired.store(true);
+    }
+    _reclaim();
+}
+
+void KRecordBuffer::_reclaim() const {
+    HKU_IF_RETURN(!m_has_retired.load(), void());
+
+    // 仅在有待释放的数据块时加锁，之后的回收者可看到之前退出的读者已清除的纪元
+    std::lock_guard<std::mutex> lock(m_retired_mutex);
+    HKU_IF_RETURN(m_retired.empty(), void());
+
+    uint64_t min_epoch = minActiveEpoch();
+    auto iter = std::remove_if(m_retired.begin(), m_retired.end(), [&](const Retired& retired) {
+        if (retired.epoch < min_epoch) {
+            delete retired.block;
+            return true;
+        }
+        return false;
+    });
+    m_retired.erase(iter, m_retired.end());
+    m_has_retired.store(!m_retired.empty());
+}
+
+void KRecordBuffer::assign(KRecordList&& ks) {
+    _publish(_createBlock(std::move(ks), APPEND_RESERVE));
+}
+
+void KRecordBuffer::assign(const KRecordList& ks) {
+    _publish(_createBlock(KRecordList(ks), APPEND_RESERVE));
+}
+
+void KRecordBuffer::attach(const KRecord* data, size_t total,
+                           const std::shared_ptr<const void>& owner) {
+    HKU_CHECK(data || total == 0, "data is null!");
+    Block* block = new Block;
+    block->data = data;
+    block->shared = owner;
+    block->size.store(total, std::memory_order_relaxed);
+    _buildDayIndex(block);
+    _publish(block);
+}
+
+void KRecordBuffer::clear() {
+    _publish(nullptr);
+}
+
+void KRecordBuffer::append(const KRecord& record) {
+    _reclaim();
+    Block* block = m_block.load(std::memory_order_relaxed);
+    HKU_IF_RETURN(!block, void());
+
+    // 外部只读数据不可修改，需复制为私有数据块
+    size_t total = block->size.load(std::memory_order_relaxed);
+    bool rebuild = block->shared || total >= block->records.capacity();
+
+    int64_t span = 0;
+    size_t day_total = block->day_size.load(std::memory_order_relaxed);
+    if (m_with_day_index && !rebuild) {
+        if (day_total == 0) {
+            // 首条记录时需整体重建以建立索引，其他情况说明跨度过大未建立索引
+            rebuild = total == 0;
+        } else {
+            span = dayNumber(record.datetime) - block->day_start + 1;
+            rebuild = span > static_cast<int64_t>(block->day_index.capacity());
+        }
+    }
+
+    if (rebuild) {
+        KRecordList ks;
+        ks.reserve(total + 1);
+        ks.assign(block->data, block->data + total);
+        ks.push_back(record);
+        _publish(_createBlock(std::move(ks), std::max(total / 2, APPEND_RESERVE)));
+        return;
+    }
+
+    // 先写入未发布的位置，再依次发布日期索引和记录数
+    block->records.push_back(record);
+    if (span > static_cast<int64_t>(day_total)) {
+        for (int64_t i = day_total; i < span; i++) {
+            block->day_index.push_back(static_cast<uint32_t>(total));
+        }
+        block->day_size.store(span, std::memory_order_release);
+    }
+    block->size.store(total + 1, std::memory_order_release);
+}
+
+void KRecordBuffer::updateBack(const KRecord& record) {
+    _reclaim();
+    Block* block = m_block.load(std::memory_order_relaxed);
+    HKU_IF_RETURN(!block || block->size.load(std::memory_order_relaxed) == 0, void());
+
+    if (block->shared) {
+        size_t total = block->size.load(std::memory_order_relaxed);
+        block = _createBlock(KRecordList(block->data, block->data + total), APPEND_RESERVE);
+        _publish(block);
+    }
+
+    // 日期不变，只更新价格及成交量字段
+    KRecord& tail = block->records.back();
+    uint64_t seq = block->seq.load(std::memory_order_relaxed);
+    block->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    tail.openPrice = record.openPrice;
+    tail.highPrice = record.highPrice;
+    tail.lowPrice = record.lowPrice;
+    tail.closePrice = record.closePrice;
+    tail.transAmount = record.transAmount;
+    tail.transCount = record.transCount;
+    block->seq.store(seq + 2, std::memory_order_release);
+}
+
+}  // namespace hku
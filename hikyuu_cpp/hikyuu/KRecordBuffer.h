@@ -0,0 +1,134 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#pragma once
+#ifndef HIKYUU_KRECORD_BUFFER_H_
+#define HIKYUU_KRECORD_BUFFER_H_
+
+#include <atomic>
+#include <mutex>
+#include "KRecord.h"
+
+namespace hku {
+
+/**
+ * 单写多读的 K 线内存缓存
+ * @details
+ * <pre>
+ * 读操作不加锁，可在任意线程中并发调用；写操作（assign/append/updateBack/clear）
+ * 同一时刻只能有一个线程调用，由调用者负责串行化。
+ *
+ * 实现说明：
+ * - 数据存放于固定容量的数据块中，已发布的记录位置不会移动。追加记录时先写入数据块尾部，
+ *   再发布新的记录数，容量不足时复制到新数据块后整体替换（RCU 方式）。
+ * - 仅最后一条记录会被原地更新（同一时刻实时行情），通过顺序锁（seqlock）保证读者
+ *   获取到的最后一条记录是一致的；其余记录一经发布即不再改变。
+ * - 被替换的数据块按纪元（epoch）回收：每个线程有独立的读者槽位，读者进入时记录当前纪元，
+ *   退出时清除，读者之间不共享计数。替换时数据块标记为当时的纪元，在所有正在读取的读者的
+ *   纪元都晚于该纪元后释放，由替换时或之后退出的读者回收，无需等待下一次写入。
+ * - 通过 attach 引用的外部数据不会被修改，首次追加或更新时复制为私有数据块（写时复制）。
+ * </pre>
+ * @ingroup StockManage
+ */
+class HKU_API KRecordBuffer {
+public:
+    /**
+     * 构造函数
+     * @param day_index 是否建立以自然日为下标的日期位置索引，仅适用于日线
+     */
+    explicit KRecordBuffer(bool day_index = false);
+    ~KRecordBuffer();
+
+    KRecordBuffer(const KRecordBuffer&) = delete;
+    KRecordBuffer& operator=(const KRecordBuffer&) = delete;
+
+    //----------------------------------------------------------------
+    // 读操作，无锁
+    //----------------------------------------------------------------
+
+    /** 是否已缓存数据（缓存可以为空） */
+    bool isBuffered() const {
+        return m_block.load(std::memory_order_acquire) != nullptr;
+    }
+
+    /** 是否引用外部只读数据（如共享内存），写操作时将先复制为私有数据 */
+    bool isShared() const;
+
+    /** 记录数 */
+    size_t size() const;
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    /** 获取指定位置的记录，pos 无效时返回 KRecord() */
+    KRecord get(size_t pos) const;
+
+    /** 获取最后一条记录，为空时返回 KRecord() */
+    KRecord back() const;
+
+    /** 获取 [start_ix, end_ix) 范围内的记录，end_ix 超出时截断至末尾 */
+    KRecordList getKRecordList(size_t start_ix, size_t end_ix) const;
+
+    /**
+     * 获取日期范围 [start, end) 对应的记录位置范围
+     * @return true 成功 | false 失败
+     */
+    bool getIndexRangeByDate(const Datetime& start, const Datetime& end, size_t& out_start,
+                             size_t& out_end) const;
+
+    //----------------------------------------------------------------
+    // 写操作，同一时刻只允许一个写入者
+    //----------------------------------------------------------------
+
+    /** 替换全部缓存数据 */
+    void assign(KRecordList&& ks);
+    void assign(const KRecordList& ks);
+
+    /**
+     * 以外部只读数据替换全部缓存数据，不复制记录
+     * @param data 记录起始位置，在 owner 释放前须保持有效且内容不变
+     * @param total 记录数
+     * @param owner 数据的持有者，缓存不再引用该数据时释放
+     */
+    void attach(const KRecord* data, size_t total, const std::shared_ptr<const void>& owner);
+
+    /** 追加记录，调用者需保证其日期大于最后一条记录 */
+    void append(const KRecord& record);
+
+    /** 更新最后一条记录，调用者需保证其日期与最后一条记录相同 */
+    void updateBack(const KRecord& record);
+
+    /** 释放缓存，之后 isBuffered() 返回 false */
+    void clear();
+
+private:
+    struct Block;
+    class ReadGuard;
+
+    Block* _createBlock(KRecordList&& ks, size_t reserve) const;
+    void _buildDayIndex(Block* block) const;
+    void _publish(Block* block);
+    void _reclaim() const;
+
+    // 已替换待释放的数据块
+    struct Retired {
+        Block* block;
+        uint64_t epoch;  // 替换时的纪元
+    };
+
+private:
+    bool m_with_day_index;
+    std::atomic<Block*> m_block{nullptr};
+    mutable std::mutex m_retired_mutex;  // 保护 m_retired，读者与写入者均可回收
+    mutable vector<Retired> m_retired;
+    mutable std::atomic<bool> m_has_retired{false};  // m_retired 是否非空，读者退出时检查
+};
+
+}  // namespace hku
+
+#endif /* HIKYUU_KRECORD_BUFFER_H_ */
@@ -0,0 +1,206 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#include "KRecordResampler.h"
+
+namespace hku {
+
+static const int64_t g_minutes_of_day = 24 * 60;
+
+static int64_t toMinutes(const TimeDelta& delta) {
+    return delta.ticks() / 60000000LL;
+}
+
+// 开高低收任一为 0 或 Null 时视为无效K线
+static bool isInvalidKRecord(const KRecord& k) {
+    return k.openPrice == 0.0 || k.highPrice == 0.0 || k.lowPrice == 0.0 ||
+           k.closePrice == 0.0 || std::isnan(k.openPrice) || std::isnan(k.highPrice) ||
+           std::isnan(k.lowPrice) || std::isnan(k.closePrice);
+}
+
+// 将 k 并入 agg，agg 的开盘价为 0 时表示尚无数据
+static void mergeKRecord(KRecord& agg, const KRecord& k) {
+    if (agg.openPrice == 0.0) {
+        agg.openPrice = k.openPrice;
+        agg.highPrice = k.highPrice;
+        agg.lowPrice = k.lowPrice;
+        agg.closePrice = k.closePrice;
+        agg.transAmount = k.transAmount;
+        agg.transCount = k.transCount;
+        return;
+    }
+
+    if (k.highPrice > agg.highPrice) {
+        agg.highPrice = k.highPrice;
+    }
+    if (k.lowPrice < agg.lowPrice) {
+        agg.lowPrice = k.lowPrice;
+    }
+    agg.closePrice = k.closePrice;
+    agg.transAmount += k.transAmount;
+    agg.transCount += k.transCount;
+}
+
+KRecordResampler::KRecordResampler(const KQuery::KType& ktype, const MarketInfo& market)
+: m_ktype(ktype) {
+    to_upper(m_ktype);
+    HKU_CHECK(KQuery::isKType(m_ktype), "Invalid ktype: {}", ktype);
+    int32_t minutes = KQuery::getKTypeInMin(m_ktype);
+    m_minutes = minutes < g_minutes_of_day ? minutes : 0;
+    _initSession(market);
+}
+
+KRecordResampler::KRecordResampler(int32_t minutes, const MarketInfo& market)
+: m_minutes(minutes) {
+    HKU_CHECK(minutes > 0 && minutes < g_minutes_of_day, "Invalid minutes: {}", minutes);
+    _initSession(market);
+}
+
+void KRecordResampler::_initSession(const MarketInfo& market) {
+    m_open1 = toMinutes(market.openTime1());
+    m_open2 = toMinutes(market.openTime2());
+    m_session_len1 = std::max<int64_t>(toMinutes(market.closeTime1()) - m_open1, 0);
+    m_session_len2 = std::max<int64_t>(toMinutes(market.closeTime2()) - m_open2, 0);
+    if (m_session_len1 == 0) {
+        // 仅有一个交易时段时统一作为第一时段处理
+        m_open1 = m_open2;
+        m_session_len1 = m_session_len2;
+        m_session_len2 = 0;
+    }
+    if (m_session_len2 > 0 && m_open2 < m_open1 + m_session_len1) {
+        HKU_WARN("Overlapping trading sessions in market {}, ignore the second session!",
+                 market.market());
+        m_session_len2 = 0;
+    }
+}
+
+Datetime KRecordResampler::_getIntradayPeriodEnd(const Datetime& datetime) const {
+    Datetime day = datetime.startOfDay();
+    int64_t minute = datetime.hour() * 60 + datetime.minute();
+    int64_t total = m_session_len1 + m_session_len2;
+    if (total == 0) {
+        int64_t end = (minute + m_minutes - 1) / m_minutes * m_minutes;
+        return day + Minutes(end);
+    }
+
+    // 交易分钟序号，从 1 开始
+    int64_t pos = 0;
+    if (m_session_len2 == 0 || minute < m_open2) {
+        pos = std::min(minute - m_open1, m_session_len1);
+    } else {
+        pos = m_session_len1 + std::min(minute - m_open2, m_session_len2);
+        if (pos <= m_session_len1) {
+            pos = m_session_len1 + 1;
+        }
+    }
+    if (pos < 1) {
+        pos = 1;
+    }
+
+    int64_t end = std::min((pos + m_minutes - 1) / m_minutes * m_minutes, total);
+    return end <= m_session_len1 ? day + Minutes(m_open1 + end)
+                                 : day + Minutes(m_open2 + end - m_session_len1);
+}
+
+int64_t KRecordResampler::getMinutesPerDay() const noexcept {
+    int64_t total = m_session_len1 + m_session_len2;
+    return total > 0 ? total : g_minutes_of_day;
+}
+
+int64_t KRecordResampler::getPeriodsPerDay() const noexcept {
+    HKU_IF_RETURN(m_minutes <= 0, 0);
+    return (getMinutesPerDay() + m_minutes - 1) / m_minutes;
+}
+
+Datetime KRecordResampler::getPeriodEnd(const Datetime& datetime) const {
+    HKU_IF_RETURN(datetime.isNull(), datetime);
+    HKU_IF_RETURN(m_minutes > 0, _getIntradayPeriodEnd(datetime));
+
+    if (m_ktype == KQuery::WEEK) {
+        return datetime.startOfWeek() + Days(4);
+    } else if (m_ktype == KQuery::MONTH) {
+        return datetime.endOfMonth();
+    } else if (m_ktype == KQuery::QUARTER) {
+        return datetime.endOfQuarter();
+    } else if (m_ktype == KQuery::HALFYEAR) {
+        return datetime.endOfHalfyear();
+    } else if (m_ktype == KQuery::YEAR) {
+        return datetime.endOfYear();
+    }
+    return datetime.startOfDay();
+}
+
+void KRecordResampler::append(const KRecord& record) {
+    HKU_IF_RETURN(isInvalidKRecord(record), void());
+
+    if (!m_result.empty()) {
+        if (record.datetime == m_last_datetime) {
+            // 最后一根基础K线的更新，替换其之前的贡献
+            KRecord agg = m_prev;
+            mergeKRecord(agg, record);
+            m_result.back() = agg;
+            return;
+        }
+
+        HKU_IF_RETURN(record.datetime < m_last_datetime, void());
+    }
+
+    m_last_datetime = record.datetime;
+    Datetime end = getPeriodEnd(record.datetime);
+    if (!m_result.empty() && m_result.back().datetime == end) {
+        m_prev = m_result.back();
+        mergeKRecord(m_result.back(), record);
+        return;
+    }
+
+    m_prev = KRecord(end);
+    m_result.emplace_back(end);
+    mergeKRecord(m_result.back(), record);
+}
+
+void KRecordResampler::append(const KRecord* records, size_t total) {
+    m_result.reserve(m_result.size() + (m_minutes > 0 ? total : total / 4 + 1));
+    for (size_t i = 0; i < total; i++) {
+        append(records[i]);
+    }
+}
+
+KRecordList KRecordResampler::take() {
+    KRecordList result;
+    result.swap(m_result);
+    clear();
+    return result;
+}
+
+void KRecordResampler::clear() {
+    m_result.clear();
+    m_prev = KRecord();
+    m_last_datetime = Null<Datetime>();
+}
+
+KQuery::KType KRecordResampler::getBaseKType(const KQuery::KType& ktype) {
+    string nktype(ktype);
+    to_upper(nktype);
+    if (nktype == KQuery::DAY || nktype == KQuery::MIN || nktype == KQuery::MIN5) {
+        return nktype;
+    }
+
+    int32_t minutes = KQuery::getKTypeInMin(nktype);
+    if (minutes >= g_minutes_of_day) {
+        return KQuery::DAY;
+    }
+    return minutes % 5 == 0 ? KQuery::MIN5 : KQuery::MIN;
+}
+
+KRecordList KRecordResampler::resample(const KRecordList& records, const KQuery::KType& ktype,
+                                       const MarketInfo& market) {
+    KRecordResampler resampler(ktype, market);
+    resampler.append(records.data(), records.size());
+    return resampler.take();
+}
+
+}  // namespace hku
@@ -0,0 +1,116 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#pragma once
+#ifndef KRECORD_RESAMPLER_H_
+#define KRECORD_RESAMPLER_H_
+
+#include "KRecord.h"
+#include "KQuery.h"
+#include "MarketInfo.h"
+
+namespace hku {
+
+/**
+ * K线周期合成器，由基础周期K线（如日线、1分钟线、5分钟线）合成更大周期的K线
+ * @details
+ * <pre>
+ * 合成K线的日期为其所在周期的结束时刻，与数据导入时生成的扩展K线保持一致：
+ * - 日线以上：周线为该周周五，月线、季线、半年线、年线为对应周期的最后一天，日线为当日零时；
+ * - 日线以下：按市场的开闭市时间将每日交易时段顺序编号为交易分钟，以 N 分钟为步长切分，
+ *   日期为该段最后一分钟对应的时刻（跨午休时顺延至下午时段），最后一段截止于闭市时间；
+ *   开市前的K线并入第一段，午休及闭市后的K线并入之前的一段，市场信息无效时按自然时间切分。
+ * 开高低收任一为 0 或 Null 的无效K线被忽略。
+ * 支持增量追加：日期与最后追加的K线相同时视为该K线的更新（如实时行情），替换其之前的贡献。
+ * </pre>
+ * @ingroup StockManage
+ */
+class HKU_API KRecordResampler {
+public:
+    /**
+     * 构造函数
+     * @param ktype 目标K线类型
+     * @param market 市场信息，用于确定日内交易时段
+     */
+    KRecordResampler(const KQuery::KType& ktype, const MarketInfo& market);
+
+    /**
+     * 构造按任意 N 分钟合成的合成器
+     * @param minutes 目标周期分钟数，须大于 0 且小于 1440
+     * @param market 市场信息，用于确定日内交易时段
+     */
+    KRecordResampler(int32_t minutes, const MarketInfo& market);
+
+    /** 目标K线类型，按任意分钟数构造时为空 */
+    const KQuery::KType& kType() const noexcept {
+        return m_ktype;
+    }
+
+    /** 每个交易日的交易分钟数，市场信息无效（按自然时间切分）时为全天分钟数 */
+    int64_t getMinutesPerDay() const noexcept;
+
+    /**
+     * 每个完整交易日合成的日内K线数量，日线及以上为 0
+     * @note 最后一段截止于闭市时间，周期长于全天交易时长时（如 A 股的 HOUR6、HOUR12）每日一根
+     */
+    int64_t getPeriodsPerDay() const noexcept;
+
+    /** 获取指定时刻所在周期的结束时刻，即该时刻所在合成K线的日期 */
+    Datetime getPeriodEnd(const Datetime& datetime) const;
+
+    /**
+     * 增量追加一根基础周期K线，须按日期升序追加
+     * @note 日期小于最后追加的K线时忽略
+     */
+    void append(const KRecord& record);
+
+    /** 按顺序追加一组基础周期K线 */
+    void append(const KRecord* records, size_t total);
+
+    /** 已合成的K线，最后一根可能尚未完结 */
+    const KRecordList& getKRecordList() const noexcept {
+        return m_result;
+    }
+
+    /** 取出已合成的K线并清空 */
+    KRecordList take();
+
+    /** 清空 */
+    void clear();
+
+    /**
+     * 获取合成指定K线类型时使用的基础K线类型
+     * @note 基础类型（DAY、MIN、MIN5）返回自身
+     */
+    static KQuery::KType getBaseKType(const KQuery::KType& ktype);
+
+    /** 一次性合成 */
+    static KRecordList resample(const KRecordList& records, const KQuery::KType& ktype,
+                                const MarketInfo& market);
+
+private:
+    void _initSession(const MarketInfo& market);
+    Datetime _getIntradayPeriodEnd(const Datetime& datetime) const;
+
+private:
+    KQuery::KType m_ktype;
+    int32_t m_minutes{0};  // 日内周期分钟数，日线及以上为 0
+
+    // 日内交易时段（距零时的分钟数），m_session_len1 + m_session_len2 为 0 时按自然时间切分
+    int64_t m_open1{0};
+    int64_t m_open2{0};
+    int64_t m_session_len1{0};
+    int64_t m_session_len2{0};
+
+    KRecordList m_result;
+    KRecord m_prev;            // 当前周期中除最后追加的K线之外的合成结果
+    Datetime m_last_datetime;  // 最后追加的基础K线日期
+};
+
+}  // namespace hku
+
+#endif /* KRECORD_RESAMPLER_H_ */
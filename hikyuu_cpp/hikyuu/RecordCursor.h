@@ -0,0 +1,152 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#pragma once
+#ifndef RECORD_CURSOR_H_
+#define RECORD_CURSOR_H_
+
+#include <functional>
+#include <future>
+#include "TimeLineRecord.h"
+#include "TransRecord.h"
+
+namespace hku {
+
+/**
+ * 记录游标，按固定批量分批读取分笔、分时等大量记录，避免一次性载入全部数据
+ * @details
+ * <pre>
+ * 游标持有记录位置范围 [start, end) 及按位置读取的函数，每次 next 读取下一批记录；
+ * 开启预读时，返回当前批次的同时在后台读取下一批，使读取与计算重叠，
+ * 同一时刻最多只有一个读取任务，内存占用不超过两个批次。
+ * 驱动不支持按位置读取时，可由已载入的全部记录构造，此时仅按批次切分返回。
+ * 示例：
+ *     TransListCursor cursor = stk.getTransListCursor(query);
+ *     TransList batch;
+ *     while (cursor.next(batch)) {
+ *         ...
+ *     }
+ * </pre>
+ * @ingroup StockManage
+ */
+template <class RecordT>
+class RecordCursor {
+public:
+    typedef vector<RecordT> RecordList;
+
+    /** 按位置范围 [start, end) 读取记录的函数 */
+    typedef std::function<RecordList(size_t start, size_t end)> fetch_func_t;
+
+    /** 默认的批量大小 */
+    static constexpr size_t DEFAULT_BATCH_SIZE = 65536;
+
+    /** 构造空游标 */
+    RecordCursor() = default;
+
+    /**
+     * 构造按位置分批读取的游标
+     * @param fetch 按位置范围读取记录的函数
+     * @param start 起始位置
+     * @param end 结束位置（不包含）
+     * @param batch_size 每批记录数，为 0 时使用 DEFAULT_BATCH_SIZE
+     * @param read_ahead 是否在后台预读下一批，fetch 须可在其他线程中调用
+     */
+    RecordCursor(fetch_func_t fetch, size_t start, size_t end,
+                 size_t batch_size = DEFAULT_BATCH_SIZE, bool read_ahead = false)
+    : m_fetch(std::move(fetch)),
+      m_start(start),
+      m_end(end > start ? end : start),
+      m_pos(start),
+      m_batch_size(batch_size > 0 ? batch_size : DEFAULT_BATCH_SIZE),
+      m_read_ahead(read_ahead) {}
+
+    /**
+     * 由已载入的全部记录构造游标，按批次切分返回
+     * @param records 全部记录
+     * @param batch_size 每批记录数，为 0 时使用 DEFAULT_BATCH_SIZE
+     */
+    explicit RecordCursor(RecordList&& records, size_t batch_size = DEFAULT_BATCH_SIZE)
+    : m_start(0),
+      m_end(records.size()),
+      m_pos(0),
+      m_batch_size(batch_size > 0 ? batch_size : DEFAULT_BATCH_SIZE) {
+        auto all = std::make_shared<RecordList>(std::move(records));
+        m_fetch = [all](size_t start, size_t end) {
+            return RecordList(all->begin() + start, all->begin() + end);
+        };
+    }
+
+    RecordCursor(const RecordCursor&) = delete;
+    RecordCursor& operator=(const RecordCursor&) = delete;
+    RecordCursor(RecordCursor&&) = default;
+    RecordCursor& operator=(RecordCursor&&) = default;
+
+    ~RecordCursor() {
+        // 等待尚未完成的预读，避免后台任务访问已释放的资源
+        if (m_ahead.valid()) {
+            m_ahead.wait();
+        }
+    }
+
+    /** 记录总数 */
+    size_t total() const noexcept {
+        return m_end - m_start;
+    }
+
+    /** 已读取的记录数 */
+    size_t position() const noexcept {
+        return m_pos - m_start;
+    }
+
+    /** 是否已读取完毕 */
+    bool done() const noexcept {
+        return m_pos >= m_end;
+    }
+
+    /**
+     * 读取下一批记录
+     * @param out [out] 下一批记录，原有内容被替换
+     * @return 已读取完毕时返回 false
+     */
+    bool next(RecordList& out) {
+        out.clear();
+        HKU_IF_RETURN(done(), false);
+
+        size_t batch_end = std::min(m_pos + m_batch_size, m_end);
+        if (m_ahead.valid()) {
+            out = m_ahead.get();
+        } else {
+            out = m_fetch(m_pos, batch_end);
+        }
+        m_pos = batch_end;
+
+        if (m_read_ahead && m_pos < m_end) {
+            m_ahead = std::async(std::launch::async, m_fetch, m_pos,
+                                 std::min(m_pos + m_batch_size, m_end));
+        }
+        return true;
+    }
+
+private:
+    fetch_func_t m_fetch;
+    size_t m_start{0};
+    size_t m_end{0};
+    size_t m_pos{0};
+    size_t m_batch_size{DEFAULT_BATCH_SIZE};
+    bool m_read_ahead{false};
+    std::future<RecordList> m_ahead;  // 预读的下一批记录
+};
+
+/** 分笔记录游标 @ingroup StockManage */
+typedef RecordCursor<TransRecord> TransListCursor;
+
+/** 分时记录游标 @ingroup StockManage */
+typedef RecordCursor<TimeLineRecord> TimeLineListCursor;
+
+}  // namespace hku
+
+#endif /* RECORD_CURSOR_H_ */
@@ -0,0 +1,123 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#include "RecoverFactor.h"
+
+namespace hku {
+
+/******************************************************************************
+ * 前复权公式:
+ *   复权后价格＝[(复权前价格-现金红利)＋配(新)股价格×流通股份变动比例]÷(1＋流通股份变动比例)
+ * 后复权公式（前复权的逆变换）:
+ *   复权后价格＝复权前价格×(1＋流通股份变动比例)-配(新)股价格×流通股份变动比例＋现金红利
+ * 等比前复权率＝｛[(股权登记日收盘价-现金红利)＋配(新)股价格×流通股份变动比例]÷(1＋流通股份变动比例)｝
+ *            ÷股权登记日收盘价
+ * 等比后复权率为等比前复权率的倒数
+ * 各复权率的计算顺序与逐次除权的计算保持一致，以保证舍入结果相同
+ *****************************************************************************/
+RecoverFactorList makeRecoverFactorList(const StockWeightList& weights,
+                                        const PriceList& pre_closes) {
+    HKU_CHECK(weights.size() == pre_closes.size(), "weights.size() != pre_closes.size()");
+    RecoverFactorList result;
+    result.emplace_back();
+    result.back().datetime = Datetime::min();
+
+    for (size_t i = 0, total = weights.size(); i < total; i++) {
+        const StockWeight& w = weights[i];
+        price_t denominator = 0.0, temp = 0.0, change = 0.0;
+        if (w.suogu() != 0.0) {
+            denominator = w.suogu();
+        } else {
+            // 流通股份变动比例，小于 0 时为缩股
+            change = 0.1 * (w.countAsGift() + w.countForSell() + w.increasement());
+            denominator = 1.0 + change;
+            temp = w.priceForSell() * change - 0.1 * w.bonus();
+        }
+        if (denominator <= 0.0) {
+            HKU_WARN("Invalid stock weight at {}, ignored!", w.datetime());
+            continue;
+        }
+
+        RecoverFactor factor;
+        factor.datetime = w.datetime();
+        factor.denominator = denominator;
+        factor.addend = temp;
+
+        price_t close = pre_closes[i];
+        if (!std::isnan(close) && close != 0.0) {
+            if ((denominator != 1.0 || temp != 0.0) && close + temp != 0.0) {
+                factor.equalForward = (close + temp) / (denominator * close);
+            }
+            price_t back_temp = w.suogu() != 0.0
+                                  ? close
+                                  : close + w.priceForSell() * change - 0.1 * w.bonus();
+            if (back_temp != 0.0) {
+                factor.equalBackward = (denominator * close) / back_temp;
+            }
+        }
+        result.emplace_back(factor);
+    }
+
+    return result;
+}
+
+size_t getRecoverFactorPos(const RecoverFactorList& factors, const Datetime& datetime) {
+    auto iter = std::upper_bound(
+      factors.cbegin(), factors.cend(), datetime,
+      [](const Datetime& date, const RecoverFactor& factor) { return date < factor.datetime; });
+    return iter == factors.cbegin() ? 0 : iter - factors.cbegin() - 1;
+}
+
+template <typename Func>
+static inline void recoverPrices(KRecord& k, int precision, Func&& func) {
+    k.openPrice = roundEx(func(k.openPrice), precision);
+    k.highPrice = roundEx(func(k.highPrice), precision);
+    k.lowPrice = roundEx(func(k.lowPrice), precision);
+    k.closePrice = roundEx(func(k.closePrice), precision);
+}
+
+void recoverKRecords(KRecord* data, size_t total, const RecoverFactorList& factors,
+                     KQuery::RecoverType recoverType, size_t ref_pos, int precision) {
+    HKU_IF_RETURN(total == 0 || factors.size() <= 1 || recoverType == KQuery::NO_RECOVER,
+                  void());
+
+    // K线与因子均按日期升序，顺序合并即可
+    size_t pos = getRecoverFactorPos(factors, data[0].datetime);
+    size_t factor_total = factors.size();
+    for (size_t i = 0; i < total; i++) {
+        KRecord& k = data[i];
+        while (pos + 1 < factor_total && factors[pos + 1].datetime <= k.datetime) {
+            pos++;
+        }
+
+        // 前复权：K线之后至基准K线（含）之间的除权，按日期升序
+        for (size_t j = pos + 1; j <= ref_pos; j++) {
+            const RecoverFactor& f = factors[j];
+            if (recoverType == KQuery::FORWARD && (f.denominator != 1.0 || f.addend != 0.0)) {
+                recoverPrices(k, precision,
+                              [&f](price_t price) { return (price + f.addend) / f.denominator; });
+            } else if (recoverType == KQuery::EQUAL_FORWARD && !std::isnan(f.equalForward)) {
+                recoverPrices(k, precision,
+                              [&f](price_t price) { return f.equalForward * price; });
+            }
+        }
+
+        // 后复权：基准K线之后至K线（含）之间的除权，按日期降序
+        for (size_t j = pos; j > ref_pos; j--) {
+            const RecoverFactor& f = factors[j];
+            if (recoverType == KQuery::BACKWARD && (f.denominator != 1.0 || f.addend != 0.0)) {
+                recoverPrices(k, precision,
+                              [&f](price_t price) { return price * f.denominator - f.addend; });
+            } else if (recoverType == KQuery::EQUAL_BACKWARD && !std::isnan(f.equalBackward)) {
+                recoverPrices(k, precision,
+                              [&f](price_t price) { return f.equalBackward * price; });
+            }
+        }
+    }
+}
+
+}  // namespace hku
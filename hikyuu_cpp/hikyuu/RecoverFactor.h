@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#pragma once
+#ifndef RECOVERFACTOR_H_
+#define RECOVERFACTOR_H_
+
+#include "StockWeight.h"
+#include "KRecord.h"
+#include "KQuery.h"
+
+namespace hku {
+
+/**
+ * 复权因子，记录一次除权的复权参数，自除权日起生效
+ * @details
+ * <pre>
+ * 前复权：除权日之前的价格 = (价格 + addend) / denominator
+ * 后复权：除权日及之后的价格 = 价格 * denominator - addend
+ * 等比前复权：除权日之前的价格 = 价格 * equalForward
+ * 等比后复权：除权日及之后的价格 = 价格 * equalBackward
+ * 区间复权时，对K线与区间基准K线之间的各次除权依次计算，每次计算后按价格精度舍入：
+ * 前复权以区间最后一根K线为基准，按除权日升序计算；后复权以区间第一根K线为基准，按除权日降序计算。
+ * denominator 为 1 且 addend 为 0 时前/后复权不做调整，等比复权率为 Null 时等比复权不做调整
+ * </pre>
+ * @ingroup StockManage
+ */
+struct HKU_API RecoverFactor {
+    Datetime datetime;                       ///< 除权日
+    price_t denominator{1.0};                ///< 1＋流通股份变动比例，缩股时为缩股比例
+    price_t addend{0.0};                     ///< 配(新)股价格×流通股份变动比例－现金红利
+    price_t equalForward{Null<price_t>()};   ///< 等比前复权率
+    price_t equalBackward{Null<price_t>()};  ///< 等比后复权率
+};
+
+/**
+ * 复权因子表，按日期升序排列，首个因子为上市时的占位因子（日期为 Datetime::min()，不做调整）
+ * @ingroup StockManage
+ */
+typedef vector<RecoverFactor> RecoverFactorList;
+typedef shared_ptr<const RecoverFactorList> RecoverFactorListPtr;
+
+/**
+ * 由权息列表构建复权因子表，每条权息对应一个因子
+ * @note 仅流通股本变化的权息不做前/后复权及等比前复权，但与原逐次复权一致，等比后复权时
+ *       仍以复权率 1 参与舍入
+ * @param weights 按日期升序排列的权息列表
+ * @param pre_closes 各权息股权登记日（除权日前一交易日）的收盘价，与 weights 一一对应，
+ *                   为 Null 或 0 时不计算该权息的等比复权
+ */
+RecoverFactorList HKU_API makeRecoverFactorList(const StockWeightList& weights,
+                                                const PriceList& pre_closes);
+
+/**
+ * 获取指定时刻之前最后一次生效的复权因子在因子表中的位置
+ * @param factors 复权因子表，不能为空
+ * @param datetime 指定时刻
+ */
+size_t HKU_API getRecoverFactorPos(const RecoverFactorList& factors, const Datetime& datetime);
+
+/**
+ * 对K线记录的开高低收价格进行复权
+ * @param data K线记录
+ * @param total K线记录数
+ * @param factors 复权因子表，不能为空
+ * @param recoverType 复权类型
+ * @param ref_pos 基准K线的因子位置，前复权时为区间最后一根K线，后复权时为区间第一根K线
+ * @param precision 价格精度
+ */
+void HKU_API recoverKRecords(KRecord* data, size_t total, const RecoverFactorList& factors,
+                             KQuery::RecoverType recoverType, size_t ref_pos, int precision);
+
+}  // namespace hku
+
+#endif /* RECOVERFACTOR_H_ */
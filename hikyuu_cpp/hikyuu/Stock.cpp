@@ -96,8 +96,8 @@ Stock::Data::Data(const string& market, const string& code, const string& name,
 
     const auto& ktype_list = KQuery::getAllKType();
     for (const auto& ktype : ktype_list) {
-        pMutex[ktype] = new std::shared_mutex();
-        pKData[ktype] = nullptr;
+        pMutex[ktype] = new std::mutex();
+        pKData[ktype] = new KRecordBuffer(ktype == KQuery::DAY);
     }
 }
 
@@ -380,9 +380,8 @@ void Stock::setKDataDriver(const KDataDriverConnectPoolPtr& kdataDriver) {
     if (m_data) {
         auto& ktype_list = KQuery::getAllKType();
         for (auto& ktype : ktype_list) {
-            std::unique_lock<std::shared_mutex> lock(*(m_data->pMutex[ktype]));
-            delete m_data->pKData[ktype];
-            m_data->pKData[ktype] = nullptr;
+            std::lock_guard<std::mutex> lock(*(m_data->pMutex[ktype]));
+            m_data->pKData[ktype]->clear();
         }
     }
 }
@@ -395,6 +394,7 @@ void Stock::setWeightList(const StockWeightList& weightList) {
     if (m_data) {
         std::lock_guard<std::mutex> lock(m_data->m_weight_mutex);
         m_data->m_weightList = weightList;
+        m_data->resetRecoverFactors();
     }
 }
 
@@ -402,8 +402,8 @@ bool Stock::isBuffer(KQuery::KType ktype) const {
     HKU_IF_RETURN(!m_data, false);
     string nktype(ktype);
     to_upper(nktype);
-    std::shared_lock<std::shared_mutex> lock(*(m_data->pMutex[ktype]));
-    return m_data->pKData.find(nktype) != m_data->pKData.end() && m_data->pKData[nktype];
+    KRecordBuffer* buffer = m_data->getBuffer(nktype);
+    return buffer && buffer->isBuffered();
 }
 
 bool Stock::isNull() const {
@@ -417,12 +417,26 @@ void Stock::releaseKDataBuffer(KQuery::KType inkType) {
     to_upper(ktype);
     HKU_IF_RETURN(m_data->pMutex.find(ktype) == m_data->pMutex.end(), void());
 
-    std::unique_lock<std::shared_mutex> lock(*(m_data->pMutex[ktype]));
-    auto iter = m_data->pKData.find(ktype);
-    if (iter->second) {
-        delete iter->second;
-        iter->second = nullptr;
+    std::lock_guard<std::mutex> lock(*(m_data->pMutex[ktype]));
+    m_data->pKData[ktype]->clear();
+}
+
+bool Stock::attachKDataBuffer(const KQuery::KType& inkType, const KRecord* data, size_t count,
+                              const std::shared_ptr<const void>& owner) {
+    HKU_IF_RETURN(!m_data, false);
+    string ktype(inkType);
+    to_upper(ktype);
+    KRecordBuffer* buffer = m_data->getBuffer(ktype);
+    HKU_IF_RETURN(!buffer, false);
+
+    std::lock_guard<std::mutex> lock(*(m_data->pMutex[ktype]));
+    if (buffer->isBuffered()) {
+        // 缓存期间可能已接收实时行情，此时保留本地数据
+        HKU_IF_RETURN(buffer->size() != count, false);
+        HKU_IF_RETURN(count > 0 && buffer->back() != data[count - 1], false);
     }
+    buffer->attach(data, count, owner);
+    return true;
 }
 
 // 仅在初始化时调用
@@ -451,17 +465,18 @@ void Stock::loadKDataToBuffer(KQuery::KType inkType) {
     }
 
     {
-        std::unique_lock<std::shared_mutex> lock(*(m_data->pMutex[kType]));
+        std::lock_guard<std::mutex> lock(*(m_data->pMutex[kType]));
         // 需要对是否已缓存进行二次判定，防止加锁之前已被缓存
-        if (m_data->pKData.find(kType) != m_data->pKData.end() && m_data->pKData[kType]) {
+        KRecordBuffer* buffer = m_data->pKData[kType];
+        if (buffer->isBuffered()) {
             return;
         }
-        KRecordList* ptr_klist = new KRecordList;
-        m_data->pKData[kType] = ptr_klist;
+        KRecordList klist;
         if (total != 0) {
-            (*ptr_klist) = driver->getKRecordList(m_data->m_market, m_data->m_code,
-                                                  KQuery(start, Null<int64_t>(), kType));
+            klist = driver->getKRecordList(m_data->m_market, m_data->m_code,
+                                           KQuery(start, Null<int64_t>(), kType));
         }
+        buffer->assign(std::move(klist));
     }
 }
 
@@ -485,13 +500,52 @@ StockWeightList Stock::getWeight(const Datetime& start, const Datetime& end) con
     return result;
 }
 
+RecoverFactorListPtr Stock::getRecoverFactors() const {
+    HKU_IF_RETURN(isNull(), RecoverFactorListPtr());
+    StockWeightList weights;
+    uint64_t version = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_data->m_weight_mutex);
+        HKU_IF_RETURN(m_data->m_recoverFactors, m_data->m_recoverFactors);
+        weights = m_data->m_weightList;
+        version = m_data->m_recoverFactorsVersion;
+    }
+
+    // 读取日线及构建因子表时不持有权息锁，避免阻塞其他读取权息的线程
+    PriceList pre_closes(weights.size(), Null<price_t>());
+    if (!weights.empty()) {
+        // 股权登记日收盘价：除权日之前最后一个交易日的收盘价
+        KRecordList day_list =
+          getKRecordList(KQueryByDate(Datetime::min(), weights.back().datetime(), KQuery::DAY));
+        size_t day_pos = 0, day_total = day_list.size();
+        for (size_t i = 0, total = weights.size(); i < total; i++) {
+            while (day_pos < day_total && day_list[day_pos].datetime < weights[i].datetime()) {
+                day_pos++;
+            }
+            if (day_pos > 0) {
+                pre_closes[i] = day_list[day_pos - 1].closePrice;
+            }
+        }
+    }
+    auto result = make_shared<const RecoverFactorList>(makeRecoverFactorList(weights, pre_closes));
+
+    // 构建期间权息或日线发生变化时不发布，本次调用仍返回按调用时数据构建的因子表
+    std::lock_guard<std::mutex> lock(m_data->m_weight_mutex);
+    if (m_data->m_recoverFactors) {
+        return m_data->m_recoverFactors;
+    }
+    if (version == m_data->m_recoverFactorsVersion) {
+        m_data->m_recoverFactors = result;
+    }
+    return result;
+}
+
 KData Stock::getKData(const KQuery& query) const {
     return KData(*this, query);
 }
 
 size_t Stock::_getCountFromBuffer(KQuery::KType ktype) const {
-    std::shared_lock<std::shared_mutex> lock(*(m_data->pMutex[ktype]));
-    return m_data->pKData[ktype]->size();
+    return m_data->getBuffer(ktype)->size();
 }
 
 size_t Stock::getCount(KQuery::KType kType) const {
@@ -645,77 +699,12 @@ bool Stock::_getIndexRangeByIndex(const KQuery& query, size_t& out_start, size_t
 
 bool Stock::_getIndexRangeByDateFromBuffer(const KQuery& query, size_t& out_start,
                                            size_t& out_end) const {
-    std::shared_lock<std::shared_mutex> lock(*(m_data->pMutex[query.kType()]));
-    out_start = 0;
-    out_end = 0;
-
-    const KRecordList& kdata = *(m_data->pKData[query.kType()]);
-    size_t total = kdata.size();
-    HKU_IF_RETURN(0 == total, false);
-
-    size_t mid = total, low = 0, high = total - 1;
-    size_t startpos, endpos;
-    while (low <= high) {
-        if (query.startDatetime() > kdata[high].datetime) {
-            mid = high + 1;
-            break;
-        }
-
-        if (kdata[low].datetime >= query.startDatetime()) {
-            mid = low;
-            break;
-        }
-
-        mid = (low + high) / 2;
-        if (query.startDatetime() > kdata[mid].datetime) {
-            low = mid + 1;
-        } else {
-            high = mid - 1;
-        }
-    }
-
-    if (mid >= total) {
-        return false;
-    }
-
-    startpos = mid;
-
-    low = mid;
-    high = total - 1;
-    while (low <= high) {
-        if (query.endDatetime() > kdata[high].datetime) {
-            mid = high + 1;
-            break;
-        }
-
-        if (kdata[low].datetime >= query.endDatetime()) {
-            mid = low;
-            break;
-        }
-
-        mid = (low + high) / 2;
-        if (query.endDatetime() > kdata[mid].datetime) {
-            low = mid + 1;
-        } else {
-            high = mid - 1;
-        }
-    }
-
-    endpos = (mid >= total) ? total : mid;
-    if (startpos >= endpos) {
-        return false;
-    }
-
-    out_start = startpos;
-    out_end = endpos;
-
-    return true;
+    return m_data->getBuffer(query.kType())
+      ->getIndexRangeByDate(query.startDatetime(), query.endDatetime(), out_start, out_end);
 }
 
 KRecord Stock::_getKRecordFromBuffer(size_t pos, const KQuery::KType& ktype) const {
-    std::shared_lock<std::shared_mutex> lock(*(m_data->pMutex[ktype]));
-    const auto& buf = *(m_data->pKData[ktype]);
-    return pos >= buf.size() ? KRecord() : buf[pos];
+    return m_data->getBuffer(ktype)->get(pos);
 }
 
 KRecord Stock::getKRecord(size_t pos, const KQuery::KType& kType) const {
@@ -747,18 +736,7 @@ KRecord Stock::getKRecord(const Datetime& datetime, const KQuery::KType& ktype)
 
 KRecordList Stock::_getKRecordListFromBuffer(size_t start_ix, size_t end_ix,
                                              KQuery::KType ktype) const {
-    std::shared_lock<std::shared_mutex> lock(*(m_data->pMutex[ktype]));
-    KRecordList result;
-    size_t total = m_data->pKData[ktype]->size();
-    HKU_IF_RETURN(total == 0, result);
-    HKU_WARN_IF_RETURN(start_ix >= end_ix || start_ix >= total, result,
-                       "Invalid param (start_ix: {}, end_ix: {})! current total: {}", start_ix,
-                       end_ix, total);
-    size_t length = end_ix > total ? total - start_ix : end_ix - start_ix;
-    result.resize(length);
-    std::memcpy((void*)&(result.front()), &((*m_data->pKData[ktype])[start_ix]),
-                sizeof(KRecord) * length);
-    return result;
+    return m_data->getBuffer(ktype)->getKRecordList(start_ix, end_ix);
 }
 
 KRecordList Stock::getKRecordList(const KQuery& query) const {
@@ -830,6 +808,38 @@ TransList Stock::getTransList(const KQuery& query) const {
                          : TransList();
 }
 
+TimeLineListCursor Stock::getTimeLineListCursor(const KQuery& query, size_t batch_size) const {
+    HKU_IF_RETURN(!m_kdataDriver, TimeLineListCursor());
+    auto driver = m_kdataDriver->getConnect();
+    size_t start = 0, end = 0;
+    if (!driver->getTimeLineIndexRange(market(), code(), query, start, end)) {
+        return TimeLineListCursor(driver->getTimeLineList(market(), code(), query), batch_size);
+    }
+
+    string mkt = market(), stk_code = code();
+    auto fetch = [driver, mkt, stk_code](size_t s, size_t e) {
+        return driver->getTimeLineList(mkt, stk_code, KQuery(int64_t(s), int64_t(e)));
+    };
+    return TimeLineListCursor(fetch, start, end, batch_size,
+                              m_kdataDriver->getPrototype()->canParallelLoad());
+}
+
+TransListCursor Stock::getTransListCursor(const KQuery& query, size_t batch_size) const {
+    HKU_IF_RETURN(!m_kdataDriver, TransListCursor());
+    auto driver = m_kdataDriver->getConnect();
+    size_t start = 0, end = 0;
+    if (!driver->getTransIndexRange(market(), code(), query, start, end)) {
+        return TransListCursor(driver->getTransList(market(), code(), query), batch_size);
+    }
+
+    string mkt = market(), stk_code = code();
+    auto fetch = [driver, mkt, stk_code](size_t s, size_t e) {
+        return driver->getTransList(mkt, stk_code, KQuery(int64_t(s), int64_t(e)));
+    };
+    return TransListCursor(fetch, start, end, batch_size,
+                           m_kdataDriver->getPrototype()->canParallelLoad());
+}
+
 Parameter Stock::getFinanceInfo() const {
     Parameter result;
     HKU_IF_RETURN(type() != STOCKTYPE_A && type() != STOCKTYPE_GEM && type() != STOCKTYPE_START &&
@@ -881,20 +891,21 @@ void Stock::realtimeUpdate(KRecord record, KQuery::KType inktype) {
     string ktype(inktype);
     to_upper(ktype);
 
-    // 加写锁
-    std::unique_lock<std::shared_mutex> lock(*(m_data->pMutex[ktype]));
+    // 写锁仅与其他写操作互斥，不阻塞读取
+    std::lock_guard<std::mutex> lock(*(m_data->pMutex[ktype]));
 
     // 需要对是否已缓存进行二次判定，防止加锁之前缓存被释放
-    if (m_data->pKData.find(ktype) == m_data->pKData.end() || !m_data->pKData[ktype]) {
+    KRecordBuffer* buffer = m_data->getBuffer(ktype);
+    if (!buffer || !buffer->isBuffered()) {
         return;
     }
 
-    if (m_data->pKData[ktype]->empty()) {
-        m_data->pKData[ktype]->push_back(record);
+    if (buffer->empty()) {
+        buffer->append(record);
         return;
     }
 
-    KRecord& tmp = m_data->pKData[ktype]->back();
+    KRecord tmp = buffer->back();
 
     // 如果传入的记录日期等于最后一条记录日期，则更新最后一条记录；否则，追加入缓存
     if (tmp.datetime == record.datetime) {
@@ -907,9 +918,15 @@ void Stock::realtimeUpdate(KRecord record, KQuery::KType inktype) {
         tmp.closePrice = record.closePrice;
         tmp.transAmount = record.transAmount;
         tmp.transCount = record.transCount;
+        buffer->updateBack(tmp);
 
     } else if (tmp.datetime < record.datetime) {
-        m_data->pKData[ktype]->push_back(record);
+        buffer->append(record);
+        if (ktype == KQuery::DAY) {
+            // 新增日线后，此前以当时最后收盘价作为股权登记日收盘价的复权因子需重建
+            std::lock_guard<std::mutex> weight_lock(m_data->m_weight_mutex);
+            m_data->resetRecoverFactors();
+        }
     } else {
         HKU_DEBUG("Ignore record, datetime({}) < last record.datetime({})! {} {}", record.datetime,
                   tmp.datetime, market_code(), inktype);
@@ -926,16 +943,18 @@ void Stock::setKRecordList(const KRecordList& ks, const KQuery::KType& ktype) {
     string nktype(ktype);
     to_upper(nktype);
 
+    KRecordBuffer* buffer = m_data->getBuffer(nktype);
+    HKU_CHECK(buffer, "Invalid ktype: {}", ktype);
+
     // 写锁
-    std::unique_lock<std::shared_mutex> lock(*(m_data->pMutex[ktype]));
-    HKU_CHECK(m_data->pKData.find(nktype) != m_data->pKData.end(), "Invalid ktype: {}", ktype);
+    std::lock_guard<std::mutex> lock(*(m_data->pMutex[nktype]));
+    buffer->assign(ks);
 
-    if (!m_data->pKData[nktype]) {
-        m_data->pKData[nktype] = new KRecordList();
+    if (nktype == KQuery::DAY) {
+        std::lock_guard<std::mutex> weight_lock(m_data->m_weight_mutex);
+        m_data->resetRecoverFactors();
     }
 
-    (*(m_data->pKData[nktype])) = ks;
-
     Parameter param;
     param.set<string>("type", "DoNothing");
     m_kdataDriver = DataDriverFactory::getKDataDriverPool(param);
@@ -955,23 +974,25 @@ void Stock::setKRecordList(KRecordList&& ks, const KQuery::KType& ktype) {
     string nktype(ktype);
     to_upper(nktype);
 
+    KRecordBuffer* buffer = m_data->getBuffer(nktype);
+    HKU_CHECK(buffer, "Invalid ktype: {}", ktype);
+
     // 写锁
-    std::unique_lock<std::shared_mutex> lock(*(m_data->pMutex[ktype]));
-    HKU_CHECK(m_data->pKData.find(nktype) != m_data->pKData.end(), "Invalid ktype: {}", ktype);
+    std::lock_guard<std::mutex> lock(*(m_data->pMutex[nktype]));
+    buffer->assign(std::move(ks));
 
-    if (!m_data->pKData[nktype]) {
-        m_data->pKData[nktype] = new KRecordList();
+    if (nktype == KQuery::DAY) {
+        std::lock_guard<std::mutex> weight_lock(m_data->m_weight_mutex);
+        m_data->resetRecoverFactors();
     }
 
-    (*m_data->pKData[nktype]) = std::move(ks);
-
     Parameter param;
     param.set<string>("type", "DoNothing");
     m_kdataDriver = DataDriverFactory::getKDataDriverPool(param);
 
     m_data->m_valid = true;
-    m_data->m_startDate = (*m_data->pKData[nktype]).front().datetime;
-    m_data->m_lastDate = (*m_data->pKData[nktype]).back().datetime;
+    m_data->m_startDate = buffer->get(0).datetime;
+    m_data->m_lastDate = buffer->back().datetime;
 }
 
 const vector<HistoryFinanceInfo>& Stock::getHistoryFinance() const {
@@ -11,9 +11,12 @@
 
 #include <shared_mutex>
 #include "StockWeight.h"
+#include "RecoverFactor.h"
 #include "KQuery.h"
+#include "KRecordBuffer.h"
 #include "TimeLineRecord.h"
 #include "TransRecord.h"
+#include "RecordCursor.h"
 #include "HistoryFinanceInfo.h"
 
 namespace hku {
@@ -147,6 +150,12 @@ public:
     StockWeightList getWeight(const Datetime& start = Datetime::min(),
                               const Datetime& end = Null<Datetime>()) const;
 
+    /**
+     * 获取复权因子表，首次调用时由权息信息构建并缓存，权息变更或新增日线时失效
+     * @return 复权因子表，Stock 为 Null 时返回空指针
+     */
+    RecoverFactorListPtr getRecoverFactors() const;
+
     /** 获取不同类型K线数据量 */
     size_t getCount(KQuery::KType dataType = KQuery::DAY) const;
 
@@ -187,6 +196,24 @@ public:
     /** 获取历史分笔数据 */
     TransList getTransList(const KQuery& query) const;
 
+    /**
+     * 获取分时线游标，按批次读取分时线，避免一次性载入大量数据
+     * @param query 查询条件
+     * @param batch_size 每批记录数
+     * @note 驱动不支持按位置分批读取时一次性读取全部记录后按批次返回
+     */
+    TimeLineListCursor getTimeLineListCursor(
+      const KQuery& query, size_t batch_size = TimeLineListCursor::DEFAULT_BATCH_SIZE) const;
+
+    /**
+     * 获取历史分笔数据游标，按批次读取分笔数据，避免一次性载入大量数据
+     * @param query 查询条件
+     * @param batch_size 每批记录数
+     * @note 驱动不支持按位置分批读取时一次性读取全部记录后按批次返回
+     */
+    TransListCursor getTransListCursor(
+      const KQuery& query, size_t batch_size = TransListCursor::DEFAULT_BATCH_SIZE) const;
+
     /**
      * 获取当前财务信息
      */
@@ -238,6 +265,18 @@ public:
     /** 指定类型的K线数据是否被缓存 */
     bool isBuffer(KQuery::KType) const;
 
+    /**
+     * 使K线缓存直接引用外部只读数据（如跨进程共享内存），不复制记录
+     * @note 已有缓存且与外部数据不一致（记录数或最后一条记录不同）时不替换
+     * @param ktype K线类型
+     * @param data 记录起始位置
+     * @param count 记录数
+     * @param owner 外部数据的持有者，缓存不再引用时释放
+     * @return 是否已替换
+     */
+    bool attachKDataBuffer(const KQuery::KType& ktype, const KRecord* data, size_t count,
+                           const std::shared_ptr<const void>& owner);
+
     /** 是否为Null */
     bool isNull() const;
 
@@ -257,7 +296,7 @@ public:
 private:
     bool _getIndexRangeByIndex(const KQuery&, size_t& out_start, size_t& out_end) const;
 
-    // 以下函数属于基础操作添加了读锁
+    // 以下函数直接访问K线缓存，读取无锁
     size_t _getCountFromBuffer(KQuery::KType ktype) const;
     KRecord _getKRecordFromBuffer(size_t pos, const KQuery::KType& ktype) const;
     KRecordList _getKRecordListFromBuffer(size_t start_ix, size_t end_ix,
@@ -280,9 +319,17 @@ struct HKU_API Stock::Data {
     Datetime m_startDate;  // 证券起始日期
     Datetime m_lastDate;   // 证券最后日期
 
-    StockWeightList m_weightList;  // 权息信息列表
+    StockWeightList m_weightList;           // 权息信息列表
+    RecoverFactorListPtr m_recoverFactors;  // 复权因子缓存，由 m_weight_mutex 保护
+    uint64_t m_recoverFactorsVersion{0};    // 复权因子缓存失效计数，由 m_weight_mutex 保护
     std::mutex m_weight_mutex;
 
+    // 复权因子缓存失效，调用者需持有 m_weight_mutex
+    void resetRecoverFactors() {
+        m_recoverFactors.reset();
+        m_recoverFactorsVersion++;
+    }
+
     mutable vector<HistoryFinanceInfo>
       m_history_finance;  // 历史财务信息 [财务报告日期, 字段1, 字段2, ...]
     mutable std::atomic_bool m_history_finance_ready{false};
@@ -295,14 +342,22 @@ struct HKU_API Stock::Data {
     double m_minTradeNumber;
     double m_maxTradeNumber;
 
-    unordered_map<string, KRecordList*> pKData;
-    unordered_map<string, std::shared_mutex*> pMutex;
+    // K线缓存，读取无锁；pMutex 仅用于串行化同一K线类型的写操作
+    unordered_map<string, KRecordBuffer*> pKData;
+    unordered_map<string, std::mutex*> pMutex;
 
     Data();
     Data(const string& market, const string& code, const string& name, uint32_t type, bool valid,
          const Datetime& startDate, const Datetime& lastDate, price_t tick, price_t tickValue,
          int precision, double minTradeNumber, double maxTradeNumber);
     string marketCode() const;
+
+    /** 获取指定K线类型的缓存，类型无效时返回 nullptr */
+    KRecordBuffer* getBuffer(const string& ktype) const {
+        auto iter = pKData.find(ktype);
+        return iter != pKData.end() ? iter->second : nullptr;
+    }
+
     virtual ~Data();
 };
 
@@ -25,6 +25,15 @@ namespace hku {
 
 StockManager* StockManager::m_sm = nullptr;
 
+// StockInfo 中的日期为 YYYYMMDD 格式，无效时返回 Null
+static Datetime stockInfoDate(uint64_t date) {
+    try {
+        return Datetime(date * 10000LL);
+    } catch (...) {
+        return Null<Datetime>();
+    }
+}
+
 void StockManager::quit() {
     if (m_sm) {
         delete m_sm;
@@ -37,6 +46,9 @@ StockManager::StockManager() : m_initializing(false), m_data_ready(false) {
     m_marketInfoDict_mutex = new std::shared_mutex;
     m_stockTypeInfo_mutex = new std::shared_mutex;
     m_holidays_mutex = new std::shared_mutex;
+    m_calendars_mutex = new std::shared_mutex;
+    m_zh_bond10_mutex = new std::shared_mutex;
+    m_field_mutex = new std::shared_mutex;
 }
 
 StockManager::~StockManager() {
@@ -44,6 +56,9 @@ StockManager::~StockManager() {
     delete m_marketInfoDict_mutex;
     delete m_stockTypeInfo_mutex;
     delete m_holidays_mutex;
+    delete m_calendars_mutex;
+    delete m_zh_bond10_mutex;
+    delete m_field_mutex;
     fmt::print("Quit Hikyuu system!\n\n");
 }
 
@@ -92,7 +107,11 @@ void StockManager::init(const Parameter& baseInfoParam, const Parameter& blockPa
         m_kdataDriverParam = driver->getPrototype()->getParameter();
     }
 
-    loadData();
+    // 指定了快照文件时优先从快照恢复
+    string snapshot = hikyuuParam.tryGet<string>("snapshot", "");
+    if (snapshot.empty() || !loadSnapshot(snapshot)) {
+        loadData();
+    }
     initInnerTask();
 
     m_initializing = false;
@@ -102,27 +121,77 @@ void StockManager::loadData() {
     std::chrono::system_clock::time_point start_time = std::chrono::system_clock::now();
     m_data_ready = false;
 
-    loadAllHolidays();
-    loadAllMarketInfos();
-    loadAllStockTypeInfo();
-    loadAllStocks();
-    loadAllStockWeights();
-    loadAllZhBond10();
-    loadHistoryFinanceField();
+    {
+        std::unique_lock<std::shared_mutex> lock(*m_calendars_mutex);
+        m_calendars.clear();
+    }
 
-    HKU_INFO("Loading block...");
-    m_blockDriver->load();
+    // 记录各加载阶段耗时
+    std::mutex phase_mutex;
+    vector<std::pair<string, double>> phase_times;
+    auto run_phase = [&](const string& name, const std::function<void()>& func) {
+        std::chrono::system_clock::time_point phase_start = std::chrono::system_clock::now();
+        func();
+        std::chrono::duration<double> sec = std::chrono::system_clock::now() - phase_start;
+        std::lock_guard<std::mutex> lock(phase_mutex);
+        phase_times.emplace_back(name, sec.count());
+    };
+
+    // 相互独立的基础信息并行加载，证券列表仅依赖市场信息，板块及权息信息依赖证券列表
+    ThreadPool tg(std::max<size_t>(4, std::thread::hardware_concurrency()));
+    vector<std::future<void>> tasks;
+    auto market_task =
+      tg.submit([&]() { run_phase("market info", [this]() { loadAllMarketInfos(); }); });
+    tasks.emplace_back(
+      tg.submit([&]() { run_phase("holidays", [this]() { loadAllHolidays(); }); }));
+    tasks.emplace_back(
+      tg.submit([&]() { run_phase("stock type info", [this]() { loadAllStockTypeInfo(); }); }));
+    tasks.emplace_back(
+      tg.submit([&]() { run_phase("zh bond10", [this]() { loadAllZhBond10(); }); }));
+    tasks.emplace_back(tg.submit(
+      [&]() { run_phase("history finance field", [this]() { loadHistoryFinanceField(); }); }));
+
+    market_task.get();
+    run_phase("stock info", [this]() { loadAllStocks(); });
+
+    // 板块成分需通过 getStock 查找证券，须在证券列表加载完毕后加载
+    tasks.emplace_back(tg.submit([&]() {
+        run_phase("block", [this]() {
+            HKU_INFO("Loading block...");
+            m_blockDriver->load();
+        });
+    }));
+    tasks.emplace_back(
+      tg.submit([&]() { run_phase("stock weight", [this]() { loadAllStockWeights(); }); }));
 
     // 获取K线数据驱动并预加载指定的数据
-    HKU_INFO("Loading KData...");
-
     auto driver = DataDriverFactory::getKDataDriverPool(m_kdataDriverParam);
+    bool async_load = driver->getPrototype()->canParallelLoad();
+    if (async_load) {
+        // K线在后台异步加载，此处仅需等待基础信息加载完毕
+        for (auto& task : tasks) {
+            task.get();
+        }
+        HKU_INFO("Loading KData...");
+        loadAllKData();
+
+    } else {
+        // 不支持并行加载的驱动，K线加载与尚未完成的基础信息加载同时进行
+        HKU_INFO("Loading KData...");
+        run_phase("kdata", [this]() { loadAllKData(); });
+        for (auto& task : tasks) {
+            task.get();
+        }
+        m_data_ready = true;
+    }
 
-    // 加载K线及历史财务信息
-    loadAllKData();
+    for (const auto& phase : phase_times) {
+        HKU_INFO("{:<.3f}s Loaded {}.", phase.second, phase.first);
+    }
 
     std::chrono::duration<double> sec = std::chrono::system_clock::now() - start_time;
-    HKU_INFO("{:<.2f}s Loaded Data.", sec.count());
+    HKU_INFO("{:<.2f}s Loaded Data{}.", sec.count(),
+             async_load ? " (kdata loading in background)" : "");
 }
 
 void StockManager::loadAllKData() {
@@ -163,41 +232,77 @@ void StockManager::loadAllKData() {
                     m_preloadParam.tryGet<int>(preload_key, 0));
     }
 
+    // 指定了共享内存名称时，优先引用其他进程已加载的K线
+    string shm_name = m_hikyuuParam.tryGet<string>("shm_kdata", "");
+    if (shm_name.empty()) {
+        m_shm_kdata.reset();
+    } else if (!m_shm_kdata || m_shm_kdata->name() != shm_name) {
+        m_shm_kdata = std::make_unique<KDataSharedCache>(
+          shm_name, m_hikyuuParam.tryGet<bool>("shm_kdata_keep", false));
+    }
+
     // 先加载同类K线
     auto driver = DataDriverFactory::getKDataDriverPool(m_kdataDriverParam);
     if (!driver->getPrototype()->canParallelLoad()) {
-        for (size_t i = 0, len = ktypes.size(); i < len; i++) {
+        // 历史财务信息不依赖K线驱动，在K线串行加载的同时于线程池中加载
+        ThreadPool tg;
+        if (m_hikyuuParam.tryGet<bool>("load_history_finance", true)) {
             for (auto iter = m_stockDict.begin(); iter != m_stockDict.end(); ++iter) {
-                const auto& low_ktype = low_ktypes[i];
-                if (m_preloadParam.tryGet<bool>(low_ktype, false)) {
-                    iter->second.loadKDataToBuffer(ktypes[i]);
-                }
+                tg.submit([stk = iter->second]() { stk.getHistoryFinance(); });
             }
         }
 
-        if (m_hikyuuParam.tryGet<bool>("load_history_finance", true)) {
-            ThreadPool tg;
+        for (size_t i = 0, len = ktypes.size(); i < len; i++) {
+            if (!m_preloadParam.tryGet<bool>(low_ktypes[i], false)) {
+                continue;
+            }
+            auto role = openSharedKData(ktypes[i]);
             for (auto iter = m_stockDict.begin(); iter != m_stockDict.end(); ++iter) {
-                tg.submit([stk = iter->second]() { stk.getHistoryFinance(); });
+                // 已引用共享数据的证券无需加载
+                if (role != KDataSharedCache::ATTACHED || !iter->second.isBuffer(ktypes[i])) {
+                    iter->second.loadKDataToBuffer(ktypes[i]);
+                }
+            }
+            if (role == KDataSharedCache::OWNER) {
+                m_shm_kdata->publish(ktypes[i], m_stockDict);
             }
-            tg.join();
         }
-
-        m_data_ready = true;
+        tg.join();
 
     } else {
         // 异步并行加载
         std::thread t = std::thread([this, ktypes, low_ktypes]() {
             this->m_load_tg = std::make_unique<ThreadPool>();
             for (size_t i = 0, len = ktypes.size(); i < len; i++) {
-                std::shared_lock<std::shared_mutex> lock(*m_stockDict_mutex);
-                for (auto iter = m_stockDict.begin(); iter != m_stockDict.end(); ++iter) {
-                    if (m_preloadParam.tryGet<bool>(low_ktypes[i], false)) {
-                        m_load_tg->submit(
-                          [stk = iter->second, ktype = std::move(ktypes[i])]() mutable {
+                if (!m_preloadParam.tryGet<bool>(low_ktypes[i], false)) {
+                    continue;
+                }
+                auto role = openSharedKData(ktypes[i]);
+                vector<std::future<void>> tasks;
+                {
+                    std::shared_lock<std::shared_mutex> lock(*m_stockDict_mutex);
+                    for (auto iter = m_stockDict.begin(); iter != m_stockDict.end(); ++iter) {
+                        if (role == KDataSharedCache::ATTACHED &&
+                            iter->second.isBuffer(ktypes[i])) {
+                            continue;
+                        }
+                        auto task = m_load_tg->submit(
+                          [stk = iter->second, ktype = ktypes[i]]() mutable {
                               stk.loadKDataToBuffer(ktype);
                           });
+                        if (role == KDataSharedCache::OWNER) {
+                            tasks.emplace_back(std::move(task));
+                        }
+                    }
+                }
+
+                // 所有者需等待该类型K线全部加载后写入共享内存
+                if (role == KDataSharedCache::OWNER) {
+                    for (auto& task : tasks) {
+                        task.get();
                     }
+                    std::shared_lock<std::shared_mutex> lock(*m_stockDict_mutex);
+                    m_shm_kdata->publish(ktypes[i], m_stockDict);
                 }
             }
 
@@ -216,15 +321,232 @@ void StockManager::loadAllKData() {
     }
 }
 
+KDataSharedCache::Role StockManager::openSharedKData(const KQuery::KType& ktype) {
+    HKU_IF_RETURN(!m_shm_kdata, KDataSharedCache::NONE);
+    int64_t timeout = m_hikyuuParam.tryGet<int>("shm_kdata_timeout", 300);
+
+    // 以各市场指数该类型K线的记录数及最后时间作为共享数据的版本，数据源中该类型K线更新后的
+    // 进程将重建共享内存段。按市场排序，保证各进程计算的结果一致
+    vector<MarketInfo> markets;
+    {
+        std::shared_lock<std::shared_mutex> lock(*m_marketInfoDict_mutex);
+        for (auto iter = m_marketInfoDict.begin(); iter != m_marketInfoDict.end(); ++iter) {
+            markets.push_back(iter->second);
+        }
+    }
+    std::sort(markets.begin(), markets.end(),
+              [](const MarketInfo& a, const MarketInfo& b) { return a.market() < b.market(); });
+
+    uint64_t data_version = 14695981039346656037ULL;
+    auto mix = [&data_version](uint64_t value) {
+        data_version = (data_version ^ value) * 1099511628211ULL;
+    };
+    string nktype(ktype);
+    to_upper(nktype);
+    for (const char c : nktype) {
+        mix(uint64_t(c));
+    }
+    auto driver = DataDriverFactory::getKDataDriverPool(m_kdataDriverParam)->getConnect();
+    for (const auto& info : markets) {
+        for (const char c : info.market()) {
+            mix(uint64_t(c));
+        }
+        size_t count = driver->getCount(info.market(), info.code(), ktype);
+        mix(count);
+        if (count > 0) {
+            KRecordList last = driver->getKRecordList(
+              info.market(), info.code(), KQuery(int64_t(count) - 1, int64_t(count), ktype));
+            mix(last.empty() ? 0 : last.back().datetime.ymdhms());
+        }
+    }
+
+    auto role = m_shm_kdata->open(ktype, timeout * 1000, data_version);
+    if (role == KDataSharedCache::ATTACHED) {
+        std::shared_lock<std::shared_mutex> lock(*m_stockDict_mutex);
+        size_t count = m_shm_kdata->attach(ktype, m_stockDict);
+        HKU_INFO("{} stocks attached shared {} kdata.", count, ktype);
+    }
+    return role;
+}
+
 void StockManager::reload() {
     HKU_IF_RETURN(m_initializing, void());
     m_initializing = true;
 
     HKU_INFO("start reload ...");
-    loadData();
+    try {
+        reloadData();
+    } catch (const std::exception& e) {
+        HKU_ERROR("Failed reload! {}", e.what());
+    } catch (...) {
+        HKU_ERROR("Failed reload! Unknown error!");
+    }
     m_initializing = false;
 }
 
+void StockManager::reloadData() {
+    std::chrono::system_clock::time_point start_time = std::chrono::system_clock::now();
+
+    // 基础信息各自在锁外加载，再在锁内整体替换
+    {
+        ThreadPool tg(4);
+        tg.submit([this]() { loadAllHolidays(); });
+        tg.submit([this]() { loadAllStockTypeInfo(); });
+        tg.submit([this]() { loadAllZhBond10(); });
+        tg.submit([this]() { loadHistoryFinanceField(); });
+        loadAllMarketInfos();
+        tg.join();
+    }
+
+    // 在新的证券实例上加载数据，期间原有证券实例仍正常提供查询及接收实时行情
+    HKU_INFO("Loading stock information...");
+    auto kdriver = DataDriverFactory::getKDataDriverPool(m_kdataDriverParam);
+    StockMapIterator::stock_map_t stock_dict;
+    vector<StockInfo> stockInfos = getNeedLoadStockInfoList();
+    stock_dict.reserve(stockInfos.size());
+    for (const auto& info : stockInfos) {
+        string market_code = fmt::format("{}{}", info.market, info.code);
+        to_upper(market_code);
+        Stock stk(info.market, info.code, info.name, info.type, info.valid,
+                  stockInfoDate(info.startDate), stockInfoDate(info.endDate), info.tick,
+                  info.tickValue, info.precision, info.minTradeNumber, info.maxTradeNumber);
+        stk.setKDataDriver(kdriver);
+        stock_dict[market_code] = std::move(stk);
+    }
+
+    if (m_hikyuuParam.tryGet<bool>("load_stock_weight", true)) {
+        HKU_INFO("Loading stock weight...");
+        loadStockWeights(stock_dict);
+    }
+
+    StockMapIterator::stock_map_t old_dict;
+    {
+        std::shared_lock<std::shared_mutex> lock(*m_stockDict_mutex);
+        old_dict = m_stockDict;
+    }
+
+    // 预加载参数指定的K线，以及原实例中已缓存的K线（如手工加载的缓存）
+    HKU_INFO("Loading KData...");
+    bool load_finance = m_hikyuuParam.tryGet<bool>("load_history_finance", true);
+    size_t work_num =
+      kdriver->getPrototype()->canParallelLoad() ? std::thread::hardware_concurrency() : 1;
+    ThreadPool tg(std::max<size_t>(1, work_num));
+    for (auto iter = stock_dict.begin(); iter != stock_dict.end(); ++iter) {
+        auto old_iter = old_dict.find(iter->first);
+        const Stock* old_stk = old_iter != old_dict.end() ? &old_iter->second : nullptr;
+        for (const auto& item : iter->second.m_data->pKData) {
+            string low_ktype = item.first;
+            to_lower(low_ktype);
+            if (m_preloadParam.tryGet<bool>(low_ktype, false) ||
+                (old_stk && old_stk->isBuffer(item.first))) {
+                tg.submit([stk = iter->second, ktype = item.first]() mutable {
+                    stk.loadKDataToBuffer(ktype);
+                });
+            }
+        }
+        if (load_finance) {
+            tg.submit([stk = iter->second]() { stk.getHistoryFinance(); });
+        }
+    }
+    tg.join();
+
+    // 不在数据源中的证券（如临时 CSV 证券、手工添加的证券）沿用原实例
+    for (auto iter = old_dict.begin(); iter != old_dict.end(); ++iter) {
+        if (stock_dict.find(iter->first) == stock_dict.end()) {
+            stock_dict[iter->first] = iter->second;
+        }
+    }
+
+    // 补入加载期间原实例通过实时行情追加的K线后，整体替换证券列表
+    mergeRealtimeKData(old_dict, stock_dict);
+    {
+        std::unique_lock<std::shared_mutex> lock(*m_stockDict_mutex);
+        m_stockDict.swap(stock_dict);
+    }
+    stock_dict.clear();
+
+    // 替换前已获取原实例的行情更新可能在替换后才写入，需再次补入
+    {
+        std::shared_lock<std::shared_mutex> lock(*m_stockDict_mutex);
+        mergeRealtimeKData(old_dict, m_stockDict);
+    }
+
+    // 交易日历及板块引用的是原证券实例，需重建
+    {
+        std::unique_lock<std::shared_mutex> lock(*m_calendars_mutex);
+        m_calendars.clear();
+    }
+    if (m_blockDriver) {
+        HKU_INFO("Loading block...");
+        m_blockDriver->load();
+    }
+
+    std::chrono::duration<double> sec = std::chrono::system_clock::now() - start_time;
+    HKU_INFO("{:<.2f}s Reloaded Data.", sec.count());
+}
+
+// 同一时刻的K线，成交量及成交额在周期内累计，更大者为更新的行情
+static bool isNewerSameBar(const KRecord& k, const KRecord& current) {
+    return k.transCount > current.transCount ||
+           (k.transCount == current.transCount && k.transAmount > current.transAmount);
+}
+
+void StockManager::mergeRealtimeKData(const StockMapIterator::stock_map_t& from,
+                                      const StockMapIterator::stock_map_t& to) {
+    for (auto iter = from.begin(); iter != from.end(); ++iter) {
+        const Stock& src_stk = iter->second;
+        auto to_iter = to.find(iter->first);
+        if (!src_stk.m_data || to_iter == to.end() || to_iter->second.m_data == src_stk.m_data) {
+            continue;
+        }
+
+        const Stock& dst_stk = to_iter->second;
+        for (const auto& item : src_stk.m_data->pKData) {
+            KRecordBuffer* src = item.second;
+            if (!src || !src->isBuffered() || src->empty()) {
+                continue;
+            }
+
+            auto mutex_iter = dst_stk.m_data->pMutex.find(item.first);
+            if (mutex_iter == dst_stk.m_data->pMutex.end() || !mutex_iter->second) {
+                continue;
+            }
+
+            // 与 realtimeUpdate 使用相同的写锁，追加晚于新缓存最后一条记录的K线；
+            // 同一时刻的K线仅在成交量（成交额）更大时更新，即只接受更新的行情，
+            // 替换后新实例已直接接收实时行情，原实例中较旧的K线不能覆盖新实例
+            std::lock_guard<std::mutex> lock(*mutex_iter->second);
+            KRecordBuffer* dst = dst_stk.m_data->getBuffer(item.first);
+            if (!dst || !dst->isBuffered()) {
+                continue;
+            }
+
+            size_t total = src->size();
+            size_t start = total;
+            if (dst->empty()) {
+                start = 0;
+            } else {
+                Datetime last = dst->back().datetime;
+                while (start > 0 && src->get(start - 1).datetime > last) {
+                    start--;
+                }
+                if (start > 0) {
+                    KRecord same = src->get(start - 1);
+                    if (same.datetime == last && isNewerSameBar(same, dst->back())) {
+                        dst->updateBack(same);
+                    }
+                }
+            }
+            if (start < total) {
+                KRecordList ks = src->getKRecordList(start, total);
+                for (const auto& k : ks) {
+                    dst->append(k);
+                }
+            }
+        }
+    }
+}
+
 string StockManager::tmpdir() const {
     return m_tmpdir;
 }
@@ -342,12 +664,43 @@ BlockList StockManager::getStockBelongs(const Stock& stk, const string& category
 }
 
 DatetimeList StockManager::getTradingCalendar(const KQuery& query, const string& market) {
+    if (query.kType() == KQuery::DAY) {
+        return getTradingCalendarIndex(market)->getDatetimeList(query);
+    }
+
     auto marketinfo = getMarketInfo(market);
     return getStock(fmt::format("{}{}", marketinfo.market(), marketinfo.code()))
       .getDatetimeList(query);
 }
 
-const ZhBond10List& StockManager::getZhBond10() const {
+TradingCalendarPtr StockManager::getTradingCalendarIndex(const string& market) {
+    auto marketinfo = getMarketInfo(market);
+    Stock stk = getStock(fmt::format("{}{}", marketinfo.market(), marketinfo.code()));
+    size_t count = stk.isNull() ? 0 : stk.getCount(KQuery::DAY);
+    Datetime last = count > 0 ? stk.getKRecord(count - 1, KQuery::DAY).datetime : Datetime();
+
+    {
+        std::shared_lock<std::shared_mutex> lock(*m_calendars_mutex);
+        auto iter = m_calendars.find(marketinfo.market());
+        if (iter != m_calendars.end() && iter->second.count == count &&
+            iter->second.last == last) {
+            return iter->second.calendar;
+        }
+    }
+
+    // 市场指数日线有变化（如实时更新追加了新交易日）时，重新生成交易日历
+    TradingCalendarPtr calendar = make_shared<const TradingCalendar>(
+      stk.isNull() ? DatetimeList() : stk.getDatetimeList(KQuery(0, Null<int64_t>(), KQuery::DAY)));
+    std::unique_lock<std::shared_mutex> lock(*m_calendars_mutex);
+    auto& cache = m_calendars[marketinfo.market()];
+    cache.calendar = calendar;
+    cache.count = count;
+    cache.last = last;
+    return calendar;
+}
+
+ZhBond10List StockManager::getZhBond10() const {
+    std::shared_lock<std::shared_mutex> lock(*m_zh_bond10_mutex);
     return m_zh_bond10;
 }
 
@@ -401,8 +754,7 @@ void StockManager::removeStock(const string& market_code) {
     }
 }
 
-void StockManager::loadAllStocks() {
-    HKU_INFO("Loading stock information...");
+vector<StockInfo> StockManager::getNeedLoadStockInfoList() {
     vector<StockInfo> stockInfos;
     if (m_context.isAll()) {
         stockInfos = m_baseInfoDriver->getAllStockInfo();
@@ -425,23 +777,19 @@ void StockManager::loadAllStocks() {
             HKU_WARN_IF(!find, "Invalid stock code: {}", stkcode);
         }
     }
+    return stockInfos;
+}
+
+void StockManager::loadAllStocks() {
+    HKU_INFO("Loading stock information...");
+    vector<StockInfo> stockInfos = getNeedLoadStockInfoList();
 
     auto kdriver = DataDriverFactory::getKDataDriverPool(m_kdataDriverParam);
 
     std::unique_lock<std::shared_mutex> lock(*m_stockDict_mutex);
     for (auto& info : stockInfos) {
-        Datetime startDate, endDate;
-        try {
-            startDate = Datetime(info.startDate * 10000LL);
-        } catch (...) {
-            startDate = Null<Datetime>();
-        }
-        try {
-            endDate = Datetime(info.endDate * 10000LL);
-        } catch (...) {
-            endDate = Null<Datetime>();
-        }
-
+        Datetime startDate = stockInfoDate(info.startDate);
+        Datetime endDate = stockInfoDate(info.endDate);
         string market_code = fmt::format("{}{}", info.market, info.code);
         to_upper(market_code);
 
@@ -519,47 +867,60 @@ void StockManager::loadAllHolidays() {
 void StockManager::loadAllStockWeights() {
     HKU_IF_RETURN(!m_hikyuuParam.tryGet<bool>("load_stock_weight", true), void());
     HKU_INFO("Loading stock weight...");
+    std::shared_lock<std::shared_mutex> lock(*m_stockDict_mutex);
+    loadStockWeights(m_stockDict);
+}
+
+void StockManager::loadStockWeights(StockMapIterator::stock_map_t& stock_dict) {
     if (m_context.isAll()) {
         auto all_stkweight_dict = m_baseInfoDriver->getAllStockWeightList();
-        std::shared_lock<std::shared_mutex> lock1(*m_stockDict_mutex);
-        for (auto iter = m_stockDict.begin(); iter != m_stockDict.end(); ++iter) {
+        for (auto iter = stock_dict.begin(); iter != stock_dict.end(); ++iter) {
             auto weight_iter = all_stkweight_dict.find(iter->first);
             if (weight_iter != all_stkweight_dict.end()) {
                 Stock& stock = iter->second;
-                std::lock_guard<std::mutex> lock2(stock.m_data->m_weight_mutex);
+                std::lock_guard<std::mutex> lock(stock.m_data->m_weight_mutex);
                 stock.m_data->m_weightList.swap(weight_iter->second);
+                stock.m_data->resetRecoverFactors();
             }
         }
     } else {
-        std::shared_lock<std::shared_mutex> lock1(*m_stockDict_mutex);
-        for (auto iter = m_stockDict.begin(); iter != m_stockDict.end(); ++iter) {
+        for (auto iter = stock_dict.begin(); iter != stock_dict.end(); ++iter) {
             Stock& stock = iter->second;
             auto sw_list = m_baseInfoDriver->getStockWeightList(
               stock.market(), stock.code(), m_context.startDatetime(), Null<Datetime>());
             {
-                std::lock_guard<std::mutex> lock2(stock.m_data->m_weight_mutex);
+                std::lock_guard<std::mutex> lock(stock.m_data->m_weight_mutex);
                 stock.m_data->m_weightList = std::move(sw_list);
+                stock.m_data->resetRecoverFactors();
             }
         }
     }
 }
 
 void StockManager::loadAllZhBond10() {
-    m_zh_bond10 = m_baseInfoDriver->getAllZhBond10();
+    ZhBond10List bonds = m_baseInfoDriver->getAllZhBond10();
+    std::unique_lock<std::shared_mutex> lock(*m_zh_bond10_mutex);
+    m_zh_bond10.swap(bonds);
 }
 
 void StockManager::loadHistoryFinanceField() {
-    if (m_hikyuuParam.tryGet<bool>("load_history_finance", true)) {
-        auto fields = m_baseInfoDriver->getHistoryFinanceField();
-        for (const auto& field : fields) {
-            m_field_ix_to_name[field.first - 1] = field.second;
-            m_field_name_to_ix[field.second] = field.first - 1;
-        }
+    HKU_IF_RETURN(!m_hikyuuParam.tryGet<bool>("load_history_finance", true), void());
+    unordered_map<size_t, string> ix_to_name;
+    unordered_map<string, size_t> name_to_ix;
+    auto fields = m_baseInfoDriver->getHistoryFinanceField();
+    for (const auto& field : fields) {
+        ix_to_name[field.first - 1] = field.second;
+        name_to_ix[field.second] = field.first - 1;
     }
+
+    std::unique_lock<std::shared_mutex> lock(*m_field_mutex);
+    m_field_ix_to_name.swap(ix_to_name);
+    m_field_name_to_ix.swap(name_to_ix);
 }
 
 vector<std::pair<size_t, string>> StockManager::getHistoryFinanceAllFields() const {
     vector<std::pair<size_t, string>> ret;
+    std::shared_lock<std::shared_mutex> lock(*m_field_mutex);
     for (auto iter = m_field_ix_to_name.begin(); iter != m_field_ix_to_name.end(); ++iter) {
         ret.emplace_back(iter->first, iter->second);
     }
@@ -18,6 +18,8 @@
 #include "MarketInfo.h"
 #include "StockTypeInfo.h"
 #include "StrategyContext.h"
+#include "KDataSharedCache.h"
+#include "TradingCalendar.h"
 
 namespace hku {
 
@@ -50,9 +52,35 @@ public:
               const Parameter& hikyuuParam,
               const StrategyContext& context = StrategyContext({"all"}));
 
-    /** 重新加载 */
+    /**
+     * 重新加载
+     * @details 在后台为全部证券创建新的实例并加载权息及K线缓存，补入加载期间实时行情追加的K线后，
+     *          一次性替换证券列表，期间查询及实时行情接收不中断。已获取的原证券实例仍可继续使用，
+     *          但不再接收实时行情更新，全部释放后回收。
+     * @note 替换前新旧两份K线缓存同时存在，需预留相应的内存。启用跨进程共享K线缓存（shm_kdata）
+     *       时，新实例加载为本进程私有的K线缓存，不重新发布或附着共享内存段
+     */
     void reload();
 
+    /**
+     * 将当前数据保存为快照文件，包括市场、证券类型、节假日、证券及其权息信息、板块，
+     * 以及所有已缓存的K线数据
+     * @note 需在数据加载完毕（dataReady() 为 true）后调用
+     * @param filename 快照文件名
+     * @return true 成功 | false 失败
+     */
+    bool saveSnapshot(const string& filename) const;
+
+    /**
+     * 从快照文件恢复数据，代替从各数据驱动加载
+     * @note 恢复时将替换全部证券实例，仅建议在初始化时使用。init 时可通过 hikyuu 参数
+     *       "snapshot" 指定快照文件，文件无效或数据源已更新（市场最后日期与快照不一致）时，
+     *       仍从数据驱动加载
+     * @param filename 快照文件名
+     * @return true 成功 | false 失败（当前数据不变）
+     */
+    bool loadSnapshot(const string& filename);
+
     /** 主动退出并释放资源 */
     static void quit();
 
@@ -169,10 +197,17 @@ public:
      */
     DatetimeList getTradingCalendar(const KQuery& query, const string& market = "SH");
 
+    /**
+     * 获取指定市场的共享日线交易日历，日期到交易日序号的查询为 O(1)
+     * @note 返回的实例不可修改，当市场指数日线数据更新后将重新生成新的实例
+     * @param market 市场简称
+     */
+    TradingCalendarPtr getTradingCalendarIndex(const string& market = "SH");
+
     /**
      * 获取10年期中国国债收益率
      */
-    const ZhBond10List& getZhBond10() const;
+    ZhBond10List getZhBond10() const;
 
     /**
      * 判断指定日期是否为节假日
@@ -180,7 +215,7 @@ public:
      */
     bool isHoliday(const Datetime& d) const;
 
-    const string& getHistoryFinanceFieldName(size_t ix) const;
+    string getHistoryFinanceFieldName(size_t ix) const;
     size_t getHistoryFinanceFieldIndex(const string& name) const;
     vector<std::pair<size_t, string>> getHistoryFinanceAllFields() const;
 
@@ -251,6 +286,9 @@ private:
     /* 加载 K线数据至缓存 */
     void loadAllKData();
 
+    /* 打开指定K线类型的共享K线缓存，已就绪时使各证券引用共享数据 */
+    KDataSharedCache::Role openSharedKData(const KQuery::KType& ktype);
+
     /* 加载节假日信息 */
     void loadAllHolidays();
 
@@ -260,12 +298,25 @@ private:
     /* 初始化时，添加证券类型信息 */
     void loadAllStockTypeInfo();
 
+    /* 热加载全部数据，替换当前的证券列表 */
+    void reloadData();
+
+    /* 获取需加载的证券信息列表 */
+    vector<StockInfo> getNeedLoadStockInfoList();
+
     /* 加载所有证券 */
     void loadAllStocks();
 
     /* 加载所有权息数据 */
     void loadAllStockWeights();
 
+    /* 加载指定证券列表的权息数据 */
+    void loadStockWeights(StockMapIterator::stock_map_t& stock_dict);
+
+    /* 将 from 中各证券已缓存且晚于 to 中同名证券缓存的K线追加至 to，同一时刻的K线取成交量更大者 */
+    void mergeRealtimeKData(const StockMapIterator::stock_map_t& from,
+                            const StockMapIterator::stock_map_t& to);
+
     /** 加载10年期中国国债收益率数据 */
     void loadAllZhBond10();
 
@@ -299,10 +350,20 @@ private:
     std::unordered_set<Datetime> m_holidays;  // 节假日
     std::shared_mutex* m_holidays_mutex;
 
+    struct TradingCalendarCache {
+        TradingCalendarPtr calendar;
+        size_t count{0};  // 生成时市场指数的日线数量
+        Datetime last;    // 生成时市场指数的最后日线日期
+    };
+    unordered_map<string, TradingCalendarCache> m_calendars;  // 市场 -> 共享交易日历
+    std::shared_mutex* m_calendars_mutex;
+
     ZhBond10List m_zh_bond10;  // 10年期中国国债收益率数据
+    std::shared_mutex* m_zh_bond10_mutex;
 
     unordered_map<string, size_t> m_field_name_to_ix;  // 财经字段名称到字段索引映射
     unordered_map<size_t, string> m_field_ix_to_name;  // 财经字段索引到字段名称映射
+    std::shared_mutex* m_field_mutex;
 
     Parameter m_baseInfoDriverParam;
     Parameter m_blockDriverParam;
@@ -311,7 +372,8 @@ private:
     Parameter m_hikyuuParam;
     StrategyContext m_context;
 
-    std::unique_ptr<ThreadPool> m_load_tg;  // 异步数据加载辅助线程组
+    std::unique_ptr<ThreadPool> m_load_tg;          // 异步数据加载辅助线程组
+    std::unique_ptr<KDataSharedCache> m_shm_kdata;  // 跨进程共享K线缓存
 };
 
 inline size_t StockManager::size() const {
@@ -354,11 +416,13 @@ inline BaseInfoDriverPtr StockManager::getBaseInfoDriver() const {
     return m_baseInfoDriver;
 }
 
-inline const string& StockManager::getHistoryFinanceFieldName(size_t ix) const {
+inline string StockManager::getHistoryFinanceFieldName(size_t ix) const {
+    std::shared_lock<std::shared_mutex> lock(*m_field_mutex);
     return m_field_ix_to_name.at(ix);
 }
 
 inline size_t StockManager::getHistoryFinanceFieldIndex(const string& name) const {
+    std::shared_lock<std::shared_mutex> lock(*m_field_mutex);
     return m_field_name_to_ix.at(name);
 }
 
@@ -0,0 +1,491 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#include <fstream>
+#include "hikyuu/utilities/MappedFile.h"
+#include "hikyuu/utilities/os.h"
+#include "StockManager.h"
+
+namespace hku {
+
+/*
+ * 快照文件格式（本机字节序）：
+ *   文件头: magic[8] | version(u32) | 字节序标记(u32) | sizeof(Datetime)(u32)
+ *           | sizeof(KRecord)(u32)
+ *   依次为: 市场信息、证券类型信息、节假日、10年期国债收益率、历史财务字段、证券列表、板块
+ * 每只证券包含其基本信息、权息信息及已缓存的各类型K线，K线数据按 8 字节对齐后原样存储，
+ * 恢复时映射整个文件，K线缓存直接引用映射中的数据（KRecordBuffer::attach），既不解析也不
+ * 复制，更新时由缓存复制为私有数据。映射在最后一个引用它的缓存释放后解除。
+ * 保存时先写入临时文件再改名，已映射的旧文件内容不受影响。
+ * 市场信息中的最后日期同时作为数据版本，恢复时与数据源比对，数据源已更新时快照视为过期。
+ */
+static const char SNAPSHOT_MAGIC[8] = {'H', 'K', 'U', 'S', 'N', 'A', 'P', '\0'};
+static const uint32_t SNAPSHOT_VERSION = 1;
+static const uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+
+namespace {
+
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(std::ofstream& out) : m_out(out) {}
+
+    void writeRaw(const void* data, size_t bytes) {
+        m_out.write(static_cast<const char*>(data), bytes);
+        m_pos += bytes;
+    }
+
+    template <typename T>
+    void write(const T& value) {
+        writeRaw(&value, sizeof(T));
+    }
+
+    void write(const string& value) {
+        write<uint32_t>(static_cast<uint32_t>(value.size()));
+        writeRaw(value.data(), value.size());
+    }
+
+    // 按 8 字节对齐后写入数据块
+    void writeBlock(const void* data, size_t bytes) {
+        static const char padding[8] = {0};
+        writeRaw(padding, (8 - m_pos % 8) % 8);
+        writeRaw(data, bytes);
+    }
+
+    bool good() const {
+        return m_out.good();
+    }
+
+private:
+    std::ofstream& m_out;
+    size_t m_pos{0};
+};
+
+class SnapshotReader {
+public:
+    SnapshotReader(const char* data, size_t size) : m_data(data), m_size(size) {}
+
+    template <typename T>
+    T read() {
+        T value;
+        readRaw(&value, sizeof(T));
+        return value;
+    }
+
+    string readString() {
+        uint32_t len = read<uint32_t>();
+        string value(len, '\0');
+        readRaw(value.data(), len);
+        return value;
+    }
+
+    // 按 8 字节对齐后返回数据块在映射中的位置，不复制
+    const char* mapBlock(size_t bytes) {
+        skip((8 - m_pos % 8) % 8);
+        const char* result = m_data + m_pos;
+        skip(bytes);
+        return result;
+    }
+
+    void readRaw(void* data, size_t bytes) {
+        HKU_IF_RETURN(bytes == 0, void());
+        HKU_CHECK(bytes <= m_size - m_pos, "Snapshot file is truncated!");
+        memcpy(data, m_data + m_pos, bytes);
+        m_pos += bytes;
+    }
+
+    void skip(size_t bytes) {
+        HKU_CHECK(bytes <= m_size - m_pos, "Snapshot file is truncated!");
+        m_pos += bytes;
+    }
+
+private:
+    const char* m_data;
+    size_t m_size;
+    size_t m_pos{0};
+};
+
+struct SnapshotBlock {
+    string category;
+    string name;
+    string index_code;
+    vector<string> stock_codes;
+};
+
+}  // namespace
+
+bool StockManager::saveSnapshot(const string& filename) const {
+    HKU_ERROR_IF_RETURN(!m_data_ready, false,
+                        "Data is still loading, can't save snapshot! Please try again later.");
+
+    // 目标文件可能正被映射使用（如由其恢复的缓存），不能原地截断改写
+    string tmp_filename = fmt::format("{}.tmp", filename);
+    std::ofstream out(tmp_filename, std::ios::binary | std::ios::trunc);
+    HKU_ERROR_IF_RETURN(!out, false, "Failed open snapshot file: {}", tmp_filename);
+
+    SnapshotWriter w(out);
+    w.writeRaw(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    w.write<uint32_t>(SNAPSHOT_VERSION);
+    w.write<uint32_t>(SNAPSHOT_BYTE_ORDER);
+    w.write<uint32_t>(sizeof(Datetime));
+    w.write<uint32_t>(sizeof(KRecord));
+
+    {
+        std::shared_lock<std::shared_mutex> lock(*m_marketInfoDict_mutex);
+        w.write<uint64_t>(m_marketInfoDict.size());
+        for (const auto& item : m_marketInfoDict) {
+            const MarketInfo& info = item.second;
+            w.write(info.market());
+            w.write(info.name());
+            w.write(info.description());
+            w.write(info.code());
+            w.write(info.lastDate());
+            w.write<int64_t>(info.openTime1().ticks());
+            w.write<int64_t>(info.closeTime1().ticks());
+            w.write<int64_t>(info.openTime2().ticks());
+            w.write<int64_t>(info.closeTime2().ticks());
+        }
+    }
+
+    {
+        std::shared_lock<std::shared_mutex> lock(*m_stockTypeInfo_mutex);
+        w.write<uint64_t>(m_stockTypeInfo.size());
+        for (const auto& item : m_stockTypeInfo) {
+            const StockTypeInfo& info = item.second;
+            w.write<uint32_t>(info.type());
+            w.write(info.description());
+            w.write<double>(info.tick());
+            w.write<double>(info.tickValue());
+            w.write<int32_t>(info.precision());
+            w.write<double>(info.minTradeNumber());
+            w.write<double>(info.maxTradeNumber());
+        }
+    }
+
+    {
+        std::shared_lock<std::shared_mutex> lock(*m_holidays_mutex);
+        w.write<uint64_t>(m_holidays.size());
+        for (const auto& d : m_holidays) {
+            w.write(d);
+        }
+    }
+
+    {
+        std::shared_lock<std::shared_mutex> lock(*m_zh_bond10_mutex);
+        w.write<uint64_t>(m_zh_bond10.size());
+        for (const auto& bond : m_zh_bond10) {
+            w.write(bond.date);
+            w.write<double>(bond.value);
+        }
+    }
+
+    {
+        std::shared_lock<std::shared_mutex> lock(*m_field_mutex);
+        w.write<uint64_t>(m_field_ix_to_name.size());
+        for (const auto& field : m_field_ix_to_name) {
+            w.write<uint64_t>(field.first);
+            w.write(field.second);
+        }
+    }
+
+    {
+        const auto& ktype_list = KQuery::getAllKType();
+        std::shared_lock<std::shared_mutex> lock(*m_stockDict_mutex);
+
+        // 临时加入的 CSV 证券使用独立的数据驱动，不保存
+        vector<const Stock*> stocks;
+        stocks.reserve(m_stockDict.size());
+        for (const auto& item : m_stockDict) {
+            if (item.second.m_data && item.second.market() != "TMP") {
+                stocks.push_back(&item.second);
+            }
+        }
+
+        w.write<uint64_t>(stocks.size());
+        for (const Stock* stk : stocks) {
+            const Stock::Data& data = *(stk->m_data);
+            w.write(data.m_market);
+            w.write(data.m_code);
+            w.write(data.m_name);
+            w.write<uint32_t>(data.m_type);
+            w.write<uint8_t>(data.m_valid ? 1 : 0);
+            w.write(data.m_startDate);
+            w.write(data.m_lastDate);
+            w.write<double>(data.m_tick);
+            w.write<double>(data.m_tickValue);
+            w.write<int32_t>(data.m_precision);
+            w.write<double>(data.m_minTradeNumber);
+            w.write<double>(data.m_maxTradeNumber);
+
+            StockWeightList weights = stk->getWeight();
+            w.write<uint64_t>(weights.size());
+            for (const auto& weight : weights) {
+                w.write(weight.datetime());
+                w.write<double>(weight.countAsGift());
+                w.write<double>(weight.countForSell());
+                w.write<double>(weight.priceForSell());
+                w.write<double>(weight.bonus());
+                w.write<double>(weight.increasement());
+                w.write<double>(weight.totalCount());
+                w.write<double>(weight.freeCount());
+                w.write<double>(weight.suogu());
+            }
+
+            vector<std::pair<string, KRecordList>> buffers;
+            for (const auto& ktype : ktype_list) {
+                KRecordBuffer* buffer = data.getBuffer(ktype);
+                if (buffer && buffer->isBuffered()) {
+                    buffers.emplace_back(ktype, buffer->getKRecordList(0, Null<size_t>()));
+                }
+            }
+            w.write<uint32_t>(static_cast<uint32_t>(buffers.size()));
+            for (const auto& buffer : buffers) {
+                w.write(buffer.first);
+                w.write<uint64_t>(buffer.second.size());
+                w.writeBlock(buffer.second.data(), sizeof(KRecord) * buffer.second.size());
+            }
+        }
+    }
+
+    BlockList blocks = m_blockDriver ? m_blockDriver->getBlockList() : BlockList();
+    w.write<uint64_t>(blocks.size());
+    for (const auto& block : blocks) {
+        w.write(block.category());
+        w.write(block.name());
+        Stock index_stock = block.getIndexStock();
+        w.write(index_stock.isNull() ? string() : index_stock.market_code());
+        w.write<uint64_t>(block.size());
+        for (auto iter = block.begin(); iter != block.end(); ++iter) {
+            w.write(iter->market_code());
+        }
+    }
+
+    out.close();
+    if (!w.good() || out.fail()) {
+        removeFile(tmp_filename);
+        HKU_ERROR("Failed write snapshot file: {}", tmp_filename);
+        return false;
+    }
+    if (!renameFile(tmp_filename, filename, true)) {
+        removeFile(tmp_filename);
+        HKU_ERROR("Failed replace snapshot file: {}", filename);
+        return false;
+    }
+    HKU_INFO("Saved snapshot: {}", filename);
+    return true;
+}
+
+bool StockManager::loadSnapshot(const string& filename) {
+    // 映射由引用其中K线数据的缓存共同持有
+    auto file = std::make_shared<MappedFile>();
+    HKU_WARN_IF_RETURN(!file->open(filename), false, "Failed open snapshot file: {}", filename);
+
+    std::chrono::system_clock::time_point start_time = std::chrono::system_clock::now();
+    MarketInfoMap market_infos;
+    StockTypeInfoMap stock_type_infos;
+    std::unordered_set<Datetime> holidays;
+    ZhBond10List zh_bond10;
+    unordered_map<size_t, string> field_ix_to_name;
+    StockMapIterator::stock_map_t stock_dict;
+    vector<SnapshotBlock> blocks;
+
+    // 先完整读取至临时变量，出错时不影响当前数据
+    try {
+        SnapshotReader r(file->data(), file->size());
+        char magic[sizeof(SNAPSHOT_MAGIC)];
+        r.readRaw(magic, sizeof(magic));
+        HKU_CHECK(std::equal(magic, magic + sizeof(magic), SNAPSHOT_MAGIC),
+                  "Not a hikyuu snapshot file!");
+
+        uint32_t version = r.read<uint32_t>();
+        HKU_CHECK(version == SNAPSHOT_VERSION, "Unsupported snapshot version: {}", version);
+        HKU_CHECK(r.read<uint32_t>() == SNAPSHOT_BYTE_ORDER, "Mismatched snapshot byte order!");
+        HKU_CHECK(r.read<uint32_t>() == sizeof(Datetime), "Mismatched snapshot Datetime size!");
+        HKU_CHECK(r.read<uint32_t>() == sizeof(KRecord), "Mismatched snapshot KRecord size!");
+
+        uint64_t total = r.read<uint64_t>();
+        for (uint64_t i = 0; i < total; i++) {
+            string market = r.readString();
+            string name = r.readString();
+            string description = r.readString();
+            string code = r.readString();
+            Datetime last_date = r.read<Datetime>();
+            TimeDelta open1 = TimeDelta::fromTicks(r.read<int64_t>());
+            TimeDelta close1 = TimeDelta::fromTicks(r.read<int64_t>());
+            TimeDelta open2 = TimeDelta::fromTicks(r.read<int64_t>());
+            TimeDelta close2 = TimeDelta::fromTicks(r.read<int64_t>());
+            market_infos[market] = MarketInfo(market, name, description, code, last_date, open1,
+                                              close1, open2, close2);
+        }
+
+        // 数据源中任一市场的最后日期与快照不一致时，说明数据已更新，快照过期
+        HKU_CHECK(m_baseInfoDriver, "Missing base info driver!");
+        for (const auto& info : m_baseInfoDriver->getAllMarketInfo()) {
+            string market = info.market();
+            to_upper(market);
+            auto iter = market_infos.find(market);
+            HKU_CHECK(iter != market_infos.end(), "Snapshot is stale! Missing market: {}", market);
+            HKU_CHECK(iter->second.lastDate() == info.lastDate(),
+                      "Snapshot is stale! The last date of market {} is {}, but source is {}",
+                      market, iter->second.lastDate(), info.lastDate());
+        }
+
+        total = r.read<uint64_t>();
+        for (uint64_t i = 0; i < total; i++) {
+            uint32_t type = r.read<uint32_t>();
+            string description = r.readString();
+            double tick = r.read<double>();
+            double tick_value = r.read<double>();
+            int32_t precision = r.read<int32_t>();
+            double min_num = r.read<double>();
+            double max_num = r.read<double>();
+            stock_type_infos[type] =
+              StockTypeInfo(type, description, tick, tick_value, precision, min_num, max_num);
+        }
+
+        total = r.read<uint64_t>();
+        for (uint64_t i = 0; i < total; i++) {
+            holidays.insert(r.read<Datetime>());
+        }
+
+        total = r.read<uint64_t>();
+        zh_bond10.resize(total);
+        for (uint64_t i = 0; i < total; i++) {
+            zh_bond10[i].date = r.read<Datetime>();
+            zh_bond10[i].value = r.read<double>();
+        }
+
+        total = r.read<uint64_t>();
+        for (uint64_t i = 0; i < total; i++) {
+            size_t ix = r.read<uint64_t>();
+            field_ix_to_name[ix] = r.readString();
+        }
+
+        auto kdriver = DataDriverFactory::getKDataDriverPool(m_kdataDriverParam);
+        HKU_CHECK(kdriver, "Failed get kdata driver!");
+        total = r.read<uint64_t>();
+        stock_dict.reserve(total);
+        for (uint64_t i = 0; i < total; i++) {
+            string market = r.readString();
+            string code = r.readString();
+            string name = r.readString();
+            uint32_t type = r.read<uint32_t>();
+            bool valid = r.read<uint8_t>() != 0;
+            Datetime start_date = r.read<Datetime>();
+            Datetime last_date = r.read<Datetime>();
+            double tick = r.read<double>();
+            double tick_value = r.read<double>();
+            int32_t precision = r.read<int32_t>();
+            double min_num = r.read<double>();
+            double max_num = r.read<double>();
+            Stock stk(market, code, name, type, valid, start_date, last_date, tick, tick_value,
+                      precision, min_num, max_num);
+            stk.setKDataDriver(kdriver);
+
+            uint64_t weight_total = r.read<uint64_t>();
+            StockWeightList weights;
+            weights.reserve(weight_total);
+            for (uint64_t n = 0; n < weight_total; n++) {
+                Datetime d = r.read<Datetime>();
+                double values[8];
+                for (auto& v : values) {
+                    v = r.read<double>();
+                }
+                weights.emplace_back(d, values[0], values[1], values[2], values[3], values[4],
+                                     values[5], values[6], values[7]);
+            }
+            stk.m_data->m_weightList = std::move(weights);
+
+            uint32_t buffer_total = r.read<uint32_t>();
+            for (uint32_t n = 0; n < buffer_total; n++) {
+                string ktype = r.readString();
+                uint64_t count = r.read<uint64_t>();
+                HKU_CHECK(count <= file->size() / sizeof(KRecord), "Snapshot file is truncated!");
+                const char* data = r.mapBlock(sizeof(KRecord) * count);
+                KRecordBuffer* buffer = stk.m_data->getBuffer(ktype);
+                HKU_CHECK(buffer, "Invalid ktype in snapshot: {}", ktype);
+                buffer->attach(reinterpret_cast<const KRecord*>(data), count, file);
+            }
+
+            stock_dict[stk.market_code()] = std::move(stk);
+        }
+
+        total = r.read<uint64_t>();
+        blocks.resize(total);
+        for (auto& block : blocks) {
+            block.category = r.readString();
+            block.name = r.readString();
+            block.index_code = r.readString();
+            block.stock_codes.resize(r.read<uint64_t>());
+            for (auto& stock_code : block.stock_codes) {
+                stock_code = r.readString();
+            }
+        }
+
+    } catch (const std::exception& e) {
+        HKU_ERROR("Failed load snapshot {}! {}", filename, e.what());
+        return false;
+    }
+
+    m_data_ready = false;
+    {
+        std::unique_lock<std::shared_mutex> lock(*m_calendars_mutex);
+        m_calendars.clear();
+    }
+    {
+        std::unique_lock<std::shared_mutex> lock(*m_marketInfoDict_mutex);
+        m_marketInfoDict.swap(market_infos);
+    }
+    {
+        std::unique_lock<std::shared_mutex> lock(*m_stockTypeInfo_mutex);
+        m_stockTypeInfo.swap(stock_type_infos);
+    }
+    {
+        std::unique_lock<std::shared_mutex> lock(*m_holidays_mutex);
+        m_holidays.swap(holidays);
+    }
+    {
+        std::unique_lock<std::shared_mutex> lock(*m_zh_bond10_mutex);
+        m_zh_bond10.swap(zh_bond10);
+    }
+    {
+        unordered_map<string, size_t> field_name_to_ix;
+        for (const auto& field : field_ix_to_name) {
+            field_name_to_ix[field.second] = field.first;
+        }
+        std::unique_lock<std::shared_mutex> lock(*m_field_mutex);
+        m_field_ix_to_name.swap(field_ix_to_name);
+        m_field_name_to_ix.swap(field_name_to_ix);
+    }
+    {
+        std::unique_lock<std::shared_mutex> lock(*m_stockDict_mutex);
+        m_stockDict.swap(stock_dict);
+    }
+
+    // 板块中的证券需在证券列表恢复后创建
+    if (m_blockDriver) {
+        BlockList block_list;
+        block_list.reserve(blocks.size());
+        for (const auto& item : blocks) {
+            Block block(item.category, item.name, item.index_code);
+            for (const auto& stock_code : item.stock_codes) {
+                block.add(stock_code);
+            }
+            block_list.emplace_back(std::move(block));
+        }
+        if (!m_blockDriver->loadFromBlockList(block_list)) {
+            m_blockDriver->load();
+        }
+    }
+
+    m_data_ready = true;
+
+    std::chrono::duration<double> sec = std::chrono::system_clock::now() - start_time;
+    HKU_INFO("{:<.2f}s Loaded snapshot: {}", sec.count(), filename);
+    return true;
+}
+
+}  // namespace hku
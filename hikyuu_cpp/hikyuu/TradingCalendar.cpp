@@ -0,0 +1,114 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#include "TradingCalendar.h"
+
+namespace hku {
+
+// 超过此跨度（自然日）时不建立辅助表，退化为二分查找
+static const int64_t MAX_CALENDAR_DAY_SPAN = 1000000;
+
+static inline int64_t dayNumber(const Datetime& d) {
+    return static_cast<int64_t>(d.date().day_number());
+}
+
+TradingCalendar::TradingCalendar(DatetimeList&& dates) : m_dates(std::move(dates)) {
+    _buildDayIndex();
+}
+
+TradingCalendar::TradingCalendar(const DatetimeList& dates) : m_dates(dates) {
+    _buildDayIndex();
+}
+
+void TradingCalendar::_buildDayIndex() {
+    HKU_IF_RETURN(m_dates.empty() || m_dates.back().isNull(), void());
+    m_first_day = dayNumber(m_dates.front());
+    int64_t span = dayNumber(m_dates.back()) - m_first_day + 1;
+    HKU_IF_RETURN(span <= 0 || span > MAX_CALENDAR_DAY_SPAN, void());
+
+    m_day_ordinals.resize(span);
+    size_t total = m_dates.size();
+    size_t pos = 0;
+    for (int64_t i = 0; i < span; i++) {
+        int64_t day = m_first_day + i;
+        while (pos < total && dayNumber(m_dates[pos]) < day) {
+            pos++;
+        }
+        m_day_ordinals[i] = static_cast<uint32_t>(pos);
+    }
+}
+
+size_t TradingCalendar::ordinal(const Datetime& date) const {
+    size_t total = m_dates.size();
+    HKU_IF_RETURN(total == 0, 0);
+    HKU_IF_RETURN(date.isNull(), total);
+
+    if (m_day_ordinals.empty()) {
+        return std::lower_bound(m_dates.begin(), m_dates.end(), date) - m_dates.begin();
+    }
+
+    int64_t offset = dayNumber(date) - m_first_day;
+    HKU_IF_RETURN(offset < 0, 0);
+    HKU_IF_RETURN(offset >= static_cast<int64_t>(m_day_ordinals.size()), total);
+
+    // 辅助表给出的是当日零点对应的位置，带有时分秒时需向后跳过当日之前的交易时间点
+    size_t pos = m_day_ordinals[offset];
+    while (pos < total && m_dates[pos] < date) {
+        pos++;
+    }
+    return pos;
+}
+
+bool TradingCalendar::getIndexRange(const KQuery& query, size_t& out_start,
+                                    size_t& out_end) const {
+    out_start = 0;
+    out_end = 0;
+    size_t total = m_dates.size();
+    HKU_IF_RETURN(0 == total, false);
+
+    if (KQuery::INDEX == query.queryType()) {
+        int64_t startix = query.start();
+        if (startix < 0) {
+            startix += total;
+            if (startix < 0)
+                startix = 0;
+        }
+
+        int64_t endix = query.end();
+        if (endix < 0) {
+            endix += total;
+            if (endix < 0)
+                endix = 0;
+        }
+
+        size_t startpos = static_cast<size_t>(startix);
+        size_t endpos = static_cast<size_t>(endix) > total ? total : static_cast<size_t>(endix);
+        HKU_IF_RETURN(startpos >= endpos, false);
+        out_start = startpos;
+        out_end = endpos;
+        return true;
+    }
+
+    HKU_IF_RETURN(query.startDatetime() >= query.endDatetime(), false);
+    size_t startpos = ordinal(query.startDatetime());
+    size_t endpos = ordinal(query.endDatetime());
+    HKU_IF_RETURN(startpos >= endpos, false);
+    out_start = startpos;
+    out_end = endpos;
+    return true;
+}
+
+DatetimeList TradingCalendar::getDatetimeList(const KQuery& query) const {
+    DatetimeList result;
+    size_t start = 0, end = 0;
+    if (getIndexRange(query, start, end)) {
+        result.assign(m_dates.begin() + start, m_dates.begin() + end);
+    }
+    return result;
+}
+
+}  // namespace hku
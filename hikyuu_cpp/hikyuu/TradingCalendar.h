@@ -0,0 +1,88 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#pragma once
+#ifndef HIKYUU_TRADING_CALENDAR_H_
+#define HIKYUU_TRADING_CALENDAR_H_
+
+#include "KQuery.h"
+
+namespace hku {
+
+/**
+ * 交易日历（日线级别）
+ * @details 将市场中的每个交易日映射为连续的整数序号，并通过以自然日为下标的辅助表，
+ * 使日期到序号的查询为 O(1)。实例创建后不可修改，可在多个使用者之间共享。
+ * @ingroup StockManage
+ */
+class HKU_API TradingCalendar {
+public:
+    TradingCalendar() = default;
+
+    /**
+     * 构造函数
+     * @param dates 按升序排列的交易日列表
+     */
+    explicit TradingCalendar(DatetimeList&& dates);
+    explicit TradingCalendar(const DatetimeList& dates);
+
+    /** 交易日数量 */
+    size_t size() const {
+        return m_dates.size();
+    }
+
+    bool empty() const {
+        return m_dates.empty();
+    }
+
+    /** 获取指定序号的交易日 */
+    const Datetime& operator[](size_t ordinal) const {
+        return m_dates[ordinal];
+    }
+
+    /** 获取全部交易日 */
+    const DatetimeList& getDatetimeList() const {
+        return m_dates;
+    }
+
+    /**
+     * 获取第一个大于等于指定日期的交易日序号
+     * @param date 指定日期
+     * @return 交易日序号，如果指定日期大于最后一个交易日，返回 size()
+     */
+    size_t ordinal(const Datetime& date) const;
+
+    /** 指定日期是否为交易日 */
+    bool contains(const Datetime& date) const {
+        size_t pos = ordinal(date);
+        return pos < m_dates.size() && m_dates[pos] == date;
+    }
+
+    /**
+     * 根据查询条件获取对应的序号范围 [out_start, out_end)
+     * @note 索引方式查询时，序号即为交易日历中的位置
+     * @return true 成功 | false 失败
+     */
+    bool getIndexRange(const KQuery& query, size_t& out_start, size_t& out_end) const;
+
+    /** 根据查询条件获取交易日列表 */
+    DatetimeList getDatetimeList(const KQuery& query) const;
+
+private:
+    void _buildDayIndex();
+
+private:
+    DatetimeList m_dates;
+    int64_t m_first_day{0};           // 第一个交易日的日序号（自然日）
+    vector<uint32_t> m_day_ordinals;  // 自第一个交易日起，每个自然日零点对应的交易日序号
+};
+
+typedef shared_ptr<const TradingCalendar> TradingCalendarPtr;
+
+}  // namespace hku
+
+#endif /* HIKYUU_TRADING_CALENDAR_H_ */
@@ -48,6 +48,14 @@ public:
      */
     virtual void load() {}
 
+    /**
+     * 使用指定的板块列表替换自身缓存，用于从数据快照中恢复
+     * @return 不支持缓存的驱动返回 false，此时应调用 load()
+     */
+    virtual bool loadFromBlockList(const BlockList& blocks) {
+        return false;
+    }
+
     /**
      * 驱动初始化，具体实现时应注意将之前打开的相关资源关闭。
      */
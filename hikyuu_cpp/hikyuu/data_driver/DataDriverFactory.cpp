@@ -10,6 +10,7 @@
 #include "block_info/qianlong/QLBlockInfoDriver.h"
 #include "kdata/DoNothingKDataDriver.h"
 #include "kdata/cvs/KDataTempCsvDriver.h"
+#include "kdata/native/NativeKDataDriver.h"
 #include "DataDriverFactory.h"
 #include "KDataDriver.h"
 
@@ -64,6 +65,7 @@ void DataDriverFactory::init() {
 
     DataDriverFactory::regKDataDriver(make_shared<DoNothingKDataDriver>());
     DataDriverFactory::regKDataDriver(make_shared<KDataTempCsvDriver>());
+    DataDriverFactory::regKDataDriver(make_shared<NativeKDataDriver>());
 
 #if HKU_ENABLE_TDX_KDATA
     DataDriverFactory::regKDataDriver(make_shared<TdxKDataDriver>());
@@ -96,4 +96,19 @@ TransList KDataDriver::getTransList(const string& market, const string& code, co
     return TransList();
 }
 
+bool KDataDriver::getTimeLineIndexRange(const string& market, const string& code,
+                                        const KQuery& query, size_t& out_start,
+                                        size_t& out_end) {
+    out_start = 0;
+    out_end = 0;
+    return false;
+}
+
+bool KDataDriver::getTransIndexRange(const string& market, const string& code,
+                                     const KQuery& query, size_t& out_start, size_t& out_end) {
+    out_start = 0;
+    out_end = 0;
+    return false;
+}
+
 } /* namespace hku */
@@ -119,6 +119,30 @@ public:
      */
     virtual TransList getTransList(const string& market, const string& code, const KQuery& query);
 
+    /**
+     * 获取分时线查询条件对应的记录位置范围 [out_start, out_end)，用于按位置分批读取
+     * @param market 市场简称
+     * @param code   证券代码
+     * @param query  查询条件
+     * @param out_start [out] 起始记录位置
+     * @param out_end [out] 结束记录位置（不包含）
+     * @return 驱动不支持按位置分批读取时返回 false
+     */
+    virtual bool getTimeLineIndexRange(const string& market, const string& code,
+                                       const KQuery& query, size_t& out_start, size_t& out_end);
+
+    /**
+     * 获取分笔数据查询条件对应的记录位置范围 [out_start, out_end)，用于按位置分批读取
+     * @param market 市场简称
+     * @param code   证券代码
+     * @param query  查询条件
+     * @param out_start [out] 起始记录位置
+     * @param out_end [out] 结束记录位置（不包含）
+     * @return 驱动不支持按位置分批读取时返回 false
+     */
+    virtual bool getTransIndexRange(const string& market, const string& code, const KQuery& query,
+                                    size_t& out_start, size_t& out_end);
+
 private:
     bool checkType();
 
@@ -185,6 +209,16 @@ public:
         return m_driver->getTransList(market, code, query);
     }
 
+    bool getTimeLineIndexRange(const string& market, const string& code, const KQuery& query,
+                               size_t& out_start, size_t& out_end) {
+        return m_driver->getTimeLineIndexRange(market, code, query, out_start, out_end);
+    }
+
+    bool getTransIndexRange(const string& market, const string& code, const KQuery& query,
+                            size_t& out_start, size_t& out_end) {
+        return m_driver->getTransIndexRange(market, code, query, out_start, out_end);
+    }
+
 private:
     KDataDriverPtr m_driver;
 };
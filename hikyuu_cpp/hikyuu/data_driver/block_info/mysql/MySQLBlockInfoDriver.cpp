@@ -60,19 +60,28 @@ void MySQLBlockInfoDriver::load() {
       "index_code from `hku_base`.`block` a left "
       "join `hku_base`.`BlockIndex` b on a.category=b.category and a.name = b.name");
 
-    std::unique_lock<std::shared_mutex> lock(m_buffer_mutex);
+    // 重新加载时整体替换原缓存，避免原板块继续持有已被替换的证券实例
+    unordered_map<string, unordered_map<string, Block>> buffer;
     for (auto& record : records) {
-        auto category_iter = m_buffer.find(record.category);
-        if (category_iter == m_buffer.end()) {
-            m_buffer[record.category] = {};
-        }
-        auto& name_dict = m_buffer[record.category];
+        auto& name_dict = buffer[record.category];
         auto name_iter = name_dict.find(record.name);
         if (name_iter == name_dict.end()) {
             name_dict[record.name] = {Block(record.category, record.name, record.index_code)};
         }
         name_dict[record.name].add(record.market_code);
     }
+
+    std::unique_lock<std::shared_mutex> lock(m_buffer_mutex);
+    m_buffer.swap(buffer);
+}
+
+bool MySQLBlockInfoDriver::loadFromBlockList(const BlockList& blocks) {
+    std::unique_lock<std::shared_mutex> lock(m_buffer_mutex);
+    m_buffer.clear();
+    for (const auto& block : blocks) {
+        m_buffer[block.category()][block.name()] = block;
+    }
+    return true;
 }
 
 Block MySQLBlockInfoDriver::getBlock(const string& category, const string& name) {
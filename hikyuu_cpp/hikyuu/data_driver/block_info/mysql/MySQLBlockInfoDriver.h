@@ -18,6 +18,7 @@ public:
     virtual ~MySQLBlockInfoDriver();
 
     virtual void load() override;
+    virtual bool loadFromBlockList(const BlockList& blocks) override;
     virtual bool _init() override;
     virtual Block getBlock(const string&, const string&) override;
     virtual BlockList getBlockList(const string& category) override;
@@ -0,0 +1,322 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#pragma once
+#ifndef HIKYUU_DATA_DRIVER_KDATA_KRECORDTABLEREADER_H
+#define HIKYUU_DATA_DRIVER_KDATA_KRECORDTABLEREADER_H
+
+#include "../../KQuery.h"
+#include "../../utilities/LRUCache11.h"
+#include "../../utilities/db_connect/DBConnectBase.h"
+
+namespace hku {
+
+/**
+ * K线表读取器，供 SQLite/MySQL K线数据驱动共用
+ * @details
+ * <pre>
+ * - 按 (连接, 表, 查询形式) 缓存预编译语句，查询时仅重新绑定参数。
+ *   连接重新建立后（DBConnectBase::generation 改变）清除全部缓存的语句；
+ *   执行出错且连接已断开时，重连后重试一次。
+ * - 按位置查询时，使用缓存的稀疏位置索引（每 INDEX_STEP 条记录保存一个日期）转换为
+ *   date >= ? 的键集查询，最多跳过 INDEX_STEP - 1 条记录，避免 limit start, n 从表头扫描。
+ *   位置索引按表增量建立，表的数据版本（DBConnectBase::dataVersion）改变后重建，
+ *   也可通过 invalidate 主动清除指定表的位置索引。连接无法提供数据版本时（如 MySQL）
+ *   不建立位置索引，直接使用 limit n offset start 查询。
+ * - 查询结果直接解码至 KRecordList。
+ * 非线程安全，每个驱动实例持有一个，与驱动实例的连接一一对应。
+ * </pre>
+ */
+class KRecordTableReader {
+public:
+    /** 位置索引间隔的记录数 */
+    static constexpr size_t INDEX_STEP = 1024;
+
+    /**
+     * 构造函数
+     * @param max_statements 最多缓存的预编译语句数
+     * @param max_tables 最多缓存位置索引的表数
+     */
+    explicit KRecordTableReader(size_t max_statements = 128, size_t max_tables = 256)
+    : m_statements(max_statements, max_statements / 4), m_indexes(max_tables, max_tables / 4) {}
+
+    /** 清除缓存的预编译语句及位置索引，须在关闭连接前调用 */
+    void clear() {
+        m_statements.clear();
+        m_indexes.clear();
+        m_connect_states.clear();
+    }
+
+    /** 清除指定表的位置索引，表中记录被修改后调用 */
+    void invalidate(const string& conn_key, const string& table) {
+        m_indexes.remove(fmt::format("{}|{}", conn_key, table));
+    }
+
+    /**
+     * 读取 [start_ix, end_ix) 范围内的K线记录
+     * @param connect 数据库连接
+     * @param conn_key 连接标识，同一标识须始终对应同一连接
+     * @param table 完整的表名（已包含必要的引号）
+     */
+    KRecordList getKRecordList(DBConnectBase* connect, const string& conn_key, const string& table,
+                               size_t start_ix, size_t end_ix) {
+        HKU_IF_RETURN(start_ix >= end_ix, KRecordList());
+
+        return _retry(connect, [&]() {
+            KRecordList result;
+            size_t total = end_ix - start_ix;
+
+            // 无法获取数据版本时不能判断位置索引是否有效，按偏移查询
+            int64_t version = start_ix < INDEX_STEP ? DBConnectBase::NO_DATA_VERSION
+                                                    : connect->dataVersion(table);
+            if (start_ix >= INDEX_STEP && version == DBConnectBase::NO_DATA_VERSION) {
+                if (total <= MAX_RESERVE) {
+                    result.reserve(total);
+                }
+                SQLStatementPtr st = _getStatement(
+                  connect, conn_key,
+                  fmt::format("{} order by date limit ? offset ?", _selectSQL(table)));
+                st->bind(0, _limit(total), int64_t(start_ix));
+                _load(conn_key, st, result);
+                return result;
+            }
+
+            int64_t anchor_date = 0;
+            size_t anchor_pos = 0;
+            HKU_IF_RETURN(
+              !_seek(connect, conn_key, table, version, start_ix, anchor_pos, anchor_date),
+              result);
+
+            if (total <= MAX_RESERVE) {
+                result.reserve(total);
+            }
+
+            SQLStatementPtr st = _getStatement(
+              connect, conn_key,
+              fmt::format("{} where date >= ? order by date limit ? offset ?", _selectSQL(table)));
+            st->bind(0, anchor_date, _limit(total), int64_t(start_ix - anchor_pos));
+            _load(conn_key, st, result);
+            return result;
+        });
+    }
+
+    /** 读取日期范围 [start_date, end_date) 内的K线记录 */
+    KRecordList getKRecordList(DBConnectBase* connect, const string& conn_key, const string& table,
+                               const Datetime& start_date, const Datetime& end_date) {
+        HKU_IF_RETURN(start_date >= end_date, KRecordList());
+        return _retry(connect, [&]() {
+            KRecordList result;
+            SQLStatementPtr st = _getStatement(
+              connect, conn_key,
+              fmt::format("{} where date >= ? and date < ? order by date", _selectSQL(table)));
+            st->bind(0, _dateNumber(start_date), _dateNumber(end_date));
+            _load(conn_key, st, result);
+            return result;
+        });
+    }
+
+    /** 获取记录总数 */
+    size_t getCount(DBConnectBase* connect, const string& conn_key, const string& table) {
+        return _retry(connect, [&]() {
+            SQLStatementPtr st =
+              _getStatement(connect, conn_key, fmt::format("select count(1) from {}", table));
+            return _queryCount(conn_key, st);
+        });
+    }
+
+    /** 获取日期小于 date 的记录数 */
+    size_t getCountBefore(DBConnectBase* connect, const string& conn_key, const string& table,
+                          const Datetime& date) {
+        return _retry(connect, [&]() {
+            SQLStatementPtr st = _getStatement(
+              connect, conn_key, fmt::format("select count(1) from {} where date < ?", table));
+            st->bind(0, _dateNumber(date));
+            return _queryCount(conn_key, st);
+        });
+    }
+
+private:
+    // 稀疏位置索引，dates[i] 为第 i * INDEX_STEP 条记录的日期
+    struct TableIndex {
+        int64_t version{DBConnectBase::NO_DATA_VERSION};  // 建立时表的数据版本
+        vector<int64_t> dates;
+        size_t covered{0};  // 已扫描的记录数
+        int64_t last_date{(std::numeric_limits<int64_t>::min)()};  // 最后扫描的记录日期
+    };
+
+    // 各连接上缓存内容的有效性标记
+    struct ConnectState {
+        uint64_t generation{0};  // 缓存的预编译语句所属的连接代数
+    };
+
+    // 数量未知（如结束位置为 Null）时不预分配
+    static constexpr size_t MAX_RESERVE = 1024 * 1024;
+
+    static string _selectSQL(const string& table) {
+        return fmt::format(
+          "select `date`,`open`,`high`, `low`, `close`, `amount`, `count` from {}", table);
+    }
+
+    static int64_t _dateNumber(const Datetime& d) {
+        return d.isNull() ? (std::numeric_limits<int64_t>::max)() : int64_t(d.number());
+    }
+
+    static int64_t _limit(size_t n) {
+        return n > size_t((std::numeric_limits<int64_t>::max)())
+                 ? (std::numeric_limits<int64_t>::max)()
+                 : int64_t(n);
+    }
+
+    /**
+     * 执行查询，出错时检测连接，连接已断开并成功重连时重新执行一次
+     * @note 重连后原连接上的预编译语句均已失效，由 _getStatement 据连接代数清除
+     */
+    template <typename Func>
+    auto _retry(DBConnectBase* connect, Func&& func) -> decltype(func()) {
+        uint64_t generation = connect->generation();
+        try {
+            return func();
+        } catch (...) {
+            if (!connect->ping() || connect->generation() == generation) {
+                throw;
+            }
+        }
+        return func();
+    }
+
+    SQLStatementPtr _getStatement(DBConnectBase* connect, const string& conn_key,
+                                  const string& sql) {
+        ConnectState& state = m_connect_states[conn_key];
+        if (connect->generation() != state.generation) {
+            _removeByConnect(m_statements, conn_key);
+            state.generation = connect->generation();
+        }
+
+        string key = fmt::format("{}|{}", conn_key, sql);
+        SQLStatementPtr st;
+        if (!m_statements.tryGet(key, st)) {
+            st = connect->getStatement(sql);
+            m_statements.insert(key, st);
+        }
+        return st;
+    }
+
+    // 移除指定连接的全部缓存项
+    template <typename Cache>
+    static void _removeByConnect(Cache& cache, const string& conn_key) {
+        string prefix = fmt::format("{}|", conn_key);
+        vector<string> keys;
+        auto collect = [&](const auto& node) {
+            if (node.key.compare(0, prefix.size(), prefix) == 0) {
+                keys.push_back(node.key);
+            }
+        };
+        cache.cwalk(collect);
+        for (const auto& key : keys) {
+            cache.remove(key);
+        }
+    }
+
+    // 执行出错时丢弃该语句，避免未结束的语句占用连接（如 SQLite 的读锁）
+    void _discard(const string& conn_key, const SQLStatementPtr& st) {
+        m_statements.remove(fmt::format("{}|{}", conn_key, st->getSqlString()));
+    }
+
+    void _load(const string& conn_key, const SQLStatementPtr& st, KRecordList& result) {
+        try {
+            st->exec();
+            int64_t date = 0;
+            price_t open = 0.0, high = 0.0, low = 0.0, close = 0.0, amount = 0.0, count = 0.0;
+            while (st->moveNext()) {
+                st->getColumn(0, date, open, high, low, close, amount, count);
+                result.emplace_back(date == 0 ? Null<Datetime>() : Datetime((uint64_t)date), open,
+                                    high, low, close, amount, count);
+            }
+        } catch (...) {
+            _discard(conn_key, st);
+            throw;
+        }
+    }
+
+    size_t _queryCount(const string& conn_key, const SQLStatementPtr& st) {
+        int64_t result = 0;
+        try {
+            st->exec();
+            if (st->moveNext()) {
+                st->getColumn(0, result);
+            }
+            // 读取至结束，以便释放语句占用的资源
+            while (st->moveNext()) {
+            }
+        } catch (...) {
+            _discard(conn_key, st);
+            throw;
+        }
+        return result > 0 ? size_t(result) : 0;
+    }
+
+    /**
+     * 查找不大于 pos 的最近索引点，必要时从上次扫描的位置继续扩展位置索引
+     * @param version 表当前的数据版本，pos 不小于 INDEX_STEP 时须为有效的版本
+     * @return pos 超出记录总数时返回 false
+     */
+    bool _seek(DBConnectBase* connect, const string& conn_key, const string& table,
+               int64_t version, size_t pos, size_t& out_pos, int64_t& out_date) {
+        out_pos = (pos / INDEX_STEP) * INDEX_STEP;
+        if (out_pos == 0) {
+            out_date = (std::numeric_limits<int64_t>::min)();
+            return true;
+        }
+
+        string key = fmt::format("{}|{}", conn_key, table);
+        if (!m_indexes.contains(key)) {
+            m_indexes.insert(key, TableIndex());
+        }
+        TableIndex& index = m_indexes.get(key);
+
+        // 表中数据被修改后，已建立的位置索引可能与表中记录不再对应，需重建
+        if (index.version != version) {
+            index = TableIndex();
+            index.version = version;
+        }
+
+        if (index.covered <= out_pos) {
+            SQLStatementPtr st = _getStatement(
+              connect, conn_key,
+              fmt::format("select `date` from {} where date > ? order by date limit ?", table));
+            st->bind(0, index.last_date, int64_t(out_pos + 1 - index.covered));
+            try {
+                st->exec();
+                int64_t date = 0;
+                while (st->moveNext()) {
+                    st->getColumn(0, date);
+                    if (index.covered % INDEX_STEP == 0) {
+                        index.dates.push_back(date);
+                    }
+                    index.covered++;
+                    index.last_date = date;
+                }
+            } catch (...) {
+                _discard(conn_key, st);
+                throw;
+            }
+            HKU_IF_RETURN(index.covered <= out_pos, false);
+        }
+
+        out_date = index.dates[out_pos / INDEX_STEP];
+        return true;
+    }
+
+private:
+    lru11::Cache<string, SQLStatementPtr> m_statements;
+    lru11::Cache<string, TableIndex> m_indexes;
+    unordered_map<string, ConnectState> m_connect_states;
+};
+
+}  // namespace hku
+
+#endif /* HIKYUU_DATA_DRIVER_KDATA_KRECORDTABLEREADER_H */
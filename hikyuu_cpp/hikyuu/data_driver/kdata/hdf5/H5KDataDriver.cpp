@@ -5,6 +5,7 @@
  *      Author: fasiondog
  */
 
+#include <mutex>
 #include <boost/algorithm/string.hpp>
 #include "hikyuu/utilities/os.h"
 #include "H5KDataDriver.h"
@@ -91,6 +92,12 @@ bool H5KDataDriver::_init() {
     // 关闭HDF异常自动打印
     H5::Exception::dontPrint();
 
+#if !defined(H5_HAVE_THREADSAFE)
+    // 每个连接均会调用 _init，仅提示一次
+    static std::once_flag warn_once;
+    std::call_once(warn_once, []() { HKU_WARN("Current hdf5 library is not thread-safe!"); });
+#endif
+
     StringList keys = m_params.getNameList();
     string filename;
     for (auto iter = keys.begin(); iter != keys.end(); ++iter) {
@@ -769,141 +776,11 @@ TimeLineList H5KDataDriver::_getTimeLine(const string& market, const string& cod
 
 TimeLineList H5KDataDriver::_getTimeLine(const string& market, const string& code,
                                          const Datetime& start, const Datetime& end) {
-    TimeLineList result;
-    HKU_IF_RETURN(start >= end || start > Datetime::max(), result);
-
-    H5FilePtr h5file;
-    H5::Group group;
-    bool success;
-    success = _getH5FileAndGroup(market, code, "TIME", h5file, group);
-    HKU_IF_RETURN(!success, result);
-
-    H5::DataSet dataset;
-    H5::DataSpace dataspace;
-    hsize_t startpos = 0, endpos = 0;
-    try {
-        uint64_t start_number = start.number();
-        uint64_t end_number = end.number();
-        string tablename(market + code);
-        CHECK_DATASET_EXISTS_RET(group, tablename, result);
-        dataset = group.openDataSet(tablename);
-        dataspace = dataset.getSpace();
-        hsize_t total = dataspace.getSelectNpoints();
-        if (0 == total) {
-            return result;
-        }
-
-        hsize_t mid, low = 0, high = total - 1;
-        H5TimeLineRecord h5record;
-        while (low <= high) {
-            H5ReadTimeLineRecords(dataset, high, 1, &h5record);
-            if (start_number > h5record.datetime) {
-                mid = high + 1;
-                break;
-            }
-
-            H5ReadTimeLineRecords(dataset, low, 1, &h5record);
-            if (h5record.datetime >= start_number) {
-                mid = low;
-                break;
-            }
-
-            mid = (low + high) / 2;
-            H5ReadTimeLineRecords(dataset, mid, 1, &h5record);
-            if (start_number > h5record.datetime) {
-                low = mid + 1;
-            } else {
-                high = mid - 1;
-            }
-        }
-
-        if (mid >= total) {
-            dataspace.close();
-            dataset.close();
-            return result;
-        }
-
-        startpos = mid;
-
-        low = mid;
-        high = total - 1;
-        while (low <= high) {
-            H5ReadTimeLineRecords(dataset, high, 1, &h5record);
-            if (end_number > h5record.datetime) {
-                mid = high + 1;
-                break;
-            }
-
-            H5ReadTimeLineRecords(dataset, low, 1, &h5record);
-            if (h5record.datetime >= end_number) {
-                mid = low;
-                break;
-            }
-
-            mid = (low + high) / 2;
-            H5ReadTimeLineRecords(dataset, mid, 1, &h5record);
-            if (end_number > h5record.datetime) {
-                low = mid + 1;
-            } else {
-                high = mid - 1;
-            }
-        }
-
-        endpos = mid >= total ? total : mid;
-        if (startpos >= endpos) {
-            dataspace.close();
-            dataset.close();
-            return result;
-        }
-
-        dataspace.close();
-        dataset.close();
-
-    } catch (std::out_of_range&) {
-        HKU_WARN("Invalid datetime!");
-        dataspace.close();
-        dataset.close();
-        return result;
-
-    } catch (...) {
-        HKU_INFO("error in {}{}", market, code);
-        dataspace.close();
-        dataset.close();
-        return result;
-    }
-
-    if (startpos >= endpos) {
-        return result;
-    }
-
-    try {
-        string tablename(market + code);
-        CHECK_DATASET_EXISTS_RET(group, tablename, result);
-        dataset = group.openDataSet(tablename);
-        size_t total = endpos - startpos;
-        std::unique_ptr<H5TimeLineRecord[]> pBuf = std::make_unique<H5TimeLineRecord[]>(total);
-        H5ReadTimeLineRecords(dataset, startpos, total, pBuf.get());
-
-        TimeLineRecord record;
-        result.reserve(total + 2);
-        for (hsize_t i = 0; i < total; i++) {
-            record.datetime = Datetime(pBuf[i].datetime);
-            record.price = price_t(pBuf[i].price) * 0.001;
-            record.vol = price_t(pBuf[i].vol);
-            result.push_back(record);
-        }
-
-    } catch (std::out_of_range& e) {
-        HKU_WARN("Invalid date! market_code({}{}) {}", market, code, e.what());
-
-    } catch (std::exception& e) {
-        HKU_WARN(e.what());
-
-    } catch (...) {
-        HKU_WARN("Unkown error!");
-    }
-
-    return result;
+    size_t startpos = 0, endpos = 0;
+    KQuery query = KQueryByDate(start, end);
+    HKU_IF_RETURN(!getTimeLineIndexRange(market, code, query, startpos, endpos) || startpos >= endpos,
+                  TimeLineList());
+    return _getTimeLine(market, code, int64_t(startpos), int64_t(endpos));
 }
 
 TransList H5KDataDriver::getTransList(const string& market, const string& code,
@@ -992,147 +869,109 @@ TransList H5KDataDriver::_getTransList(const string& market, const string& code,
 
 TransList H5KDataDriver::_getTransList(const string& market, const string& code,
                                        const Datetime& start, const Datetime& end) {
-    TransList result;
-    HKU_IF_RETURN(start >= end || start > Datetime::max(), result);
+    size_t startpos = 0, endpos = 0;
+    KQuery query = KQueryByDate(start, end);
+    HKU_IF_RETURN(!getTransIndexRange(market, code, query, startpos, endpos) || startpos >= endpos,
+                  TransList());
+    return _getTransList(market, code, int64_t(startpos), int64_t(endpos));
+}
+
+bool H5KDataDriver::getTimeLineIndexRange(const string& market, const string& code,
+                                          const KQuery& query, size_t& out_start,
+                                          size_t& out_end) {
+    return _getRecordIndexRange(market, code, "TIME", query, out_start, out_end);
+}
+
+bool H5KDataDriver::getTransIndexRange(const string& market, const string& code,
+                                       const KQuery& query, size_t& out_start, size_t& out_end) {
+    return _getRecordIndexRange(market, code, "TRANS", query, out_start, out_end);
+}
 
+bool H5KDataDriver::_getRecordIndexRange(const string& market, const string& code,
+                                         const KQuery::KType& kType, const KQuery& query,
+                                         size_t& out_start, size_t& out_end) {
+    out_start = 0;
+    out_end = 0;
     H5FilePtr h5file;
     H5::Group group;
-    bool success;
-    success = _getH5FileAndGroup(market, code, "TRANS", h5file, group);
-    HKU_IF_RETURN(!success, result);
+    HKU_IF_RETURN(!_getH5FileAndGroup(market, code, kType, h5file, group), false);
 
-    H5::DataSet dataset;
-    H5::DataSpace dataspace;
-    uint64_t start_number = start.number() * 100 + start.second();
-    uint64_t end_number = end.number() * 100 + (end.isNull() ? 0 : end.second());
-    hsize_t startpos = 0, endpos = 0;
     try {
         string tablename(market + code);
-        CHECK_DATASET_EXISTS_RET(group, tablename, result);
-        dataset = group.openDataSet(tablename);
-        dataspace = dataset.getSpace();
+        CHECK_DATASET_EXISTS_RET(group, tablename, false);
+        H5::DataSet dataset(group.openDataSet(tablename));
+        H5::DataSpace dataspace = dataset.getSpace();
         hsize_t total = dataspace.getSelectNpoints();
-        if (0 == total) {
-            return result;
-        }
-
-        hsize_t mid, low = 0, high = total - 1;
-        H5TransRecord h5record;
-        while (low <= high) {
-            H5ReadTransRecords(dataset, high, 1, &h5record);
-            if (start_number > h5record.datetime) {
-                mid = high + 1;
-                break;
-            }
-
-            H5ReadTransRecords(dataset, low, 1, &h5record);
-            if (h5record.datetime >= start_number) {
-                mid = low;
-                break;
-            }
+        dataspace.close();
 
-            mid = (low + high) / 2;
-            H5ReadTransRecords(dataset, mid, 1, &h5record);
-            if (start_number > h5record.datetime) {
-                low = mid + 1;
-            } else {
-                high = mid - 1;
+        if (query.queryType() == KQuery::INDEX) {
+            int64_t start_ix = query.start();
+            int64_t end_ix = query.end();
+            if (start_ix < 0) {
+                start_ix += total;
+                if (start_ix < 0)
+                    start_ix = 0;
             }
-        }
-
-        if (mid >= total) {
-            dataspace.close();
-            dataset.close();
-            return result;
-        }
-
-        startpos = mid;
-
-        low = mid;
-        high = total - 1;
-        while (low <= high) {
-            H5ReadTransRecords(dataset, high, 1, &h5record);
-            if (end_number > h5record.datetime) {
-                mid = high + 1;
-                break;
+            if (end_ix < 0) {
+                end_ix += total;
+                if (end_ix < 0)
+                    end_ix = 0;
             }
-
-            H5ReadTransRecords(dataset, low, 1, &h5record);
-            if (h5record.datetime >= end_number) {
-                mid = low;
-                break;
+            out_start = std::min<size_t>(size_t(start_ix), total);
+            out_end = std::max<size_t>(std::min<size_t>(size_t(end_ix), total), out_start);
+            return true;
+        }
+
+        Datetime start = query.startDatetime();
+        Datetime end = query.endDatetime();
+        HKU_IF_RETURN(start >= end || start > Datetime::max(), true);
+
+        // 分笔记录日期格式为 YYYYMMDDhhmmss，分时记录为 YYYYMMDDhhmm
+        bool is_trans = kType == "TRANS";
+        uint64_t start_number = is_trans ? start.number() * 100 + start.second() : start.number();
+        uint64_t end_number = end.isNull() ? Null<uint64_t>()
+                              : is_trans   ? end.number() * 100 + end.second()
+                                           : end.number();
+
+        auto read_number = [&](hsize_t pos) -> uint64_t {
+            if (is_trans) {
+                H5TransRecord record;
+                H5ReadTransRecords(dataset, pos, 1, &record);
+                return record.datetime;
             }
-
-            mid = (low + high) / 2;
-            H5ReadTransRecords(dataset, mid, 1, &h5record);
-            if (end_number > h5record.datetime) {
-                low = mid + 1;
-            } else {
-                high = mid - 1;
+            H5TimeLineRecord record;
+            H5ReadTimeLineRecords(dataset, pos, 1, &record);
+            return record.datetime;
+        };
+
+        // 二分查找首个日期不小于 number 的记录位置
+        auto lower_bound = [&](hsize_t first, uint64_t number) {
+            hsize_t last = total;
+            while (first < last) {
+                hsize_t mid = first + (last - first) / 2;
+                if (read_number(mid) < number) {
+                    first = mid + 1;
+                } else {
+                    last = mid;
+                }
             }
-        }
-
-        endpos = mid >= total ? total : mid;
-        if (startpos >= endpos) {
-            dataspace.close();
-            dataset.close();
-            return result;
-        }
+            return first;
+        };
 
-        dataspace.close();
-        dataset.close();
+        out_start = lower_bound(0, start_number);
+        out_end = lower_bound(out_start, end_number);
+        return true;
 
     } catch (std::out_of_range&) {
         HKU_WARN("Invalid datetime!");
-        dataspace.close();
-        dataset.close();
-        return result;
 
     } catch (...) {
         HKU_INFO("error in {}{}", market, code);
-        dataspace.close();
-        dataset.close();
-        return result;
     }
 
-    if (startpos == endpos) {
-        return result;
-    }
-
-    try {
-        string tablename(market + code);
-        CHECK_DATASET_EXISTS_RET(group, tablename, result);
-        dataset = group.openDataSet(tablename);
-
-        size_t total = endpos - startpos;
-        std::unique_ptr<H5TransRecord[]> pBuf = std::make_unique<H5TransRecord[]>(total);
-        H5ReadTransRecords(dataset, startpos, total, pBuf.get());
-
-        TransRecord record;
-        result.reserve(total + 2);
-        for (hsize_t i = 0; i < total; i++) {
-            uint64_t number = pBuf[i].datetime / 100;
-            uint64_t second = pBuf[i].datetime - number * 100;
-            Datetime d(number);
-            record.datetime =
-              Datetime(d.year(), d.month(), d.day(), d.hour(), d.minute(), (long)second);
-            record.price = price_t(pBuf[i].price) * 0.001;
-            record.vol = price_t(pBuf[i].vol);
-            record.direct = TransRecord::DIRECT(pBuf[i].buyorsell);
-            result.push_back(record);
-        }
-
-    } catch (std::out_of_range& e) {
-        HKU_WARN("Invalid date! market_code({}{}) {}", market, code, e.what());
-
-    } catch (std::exception& e) {
-        HKU_WARN(e.what());
-
-    } catch (...) {
-        HKU_WARN("Unkown error!");
-    }
-
-    return result;
+    out_start = 0;
+    out_end = 0;
+    return false;
 }
 
 } /* namespace hku */
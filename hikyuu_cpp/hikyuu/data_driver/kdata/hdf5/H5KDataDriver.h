@@ -33,7 +33,6 @@ public:
 #if defined(H5_HAVE_THREADSAFE)
         return true;
 #else
-        HKU_WARN("Current hdf5 library is not thread-safe!");
         return false;
 #endif
     }
@@ -48,6 +47,11 @@ public:
                                          const KQuery& query) override;
     virtual TransList getTransList(const string& market, const string& code,
                                    const KQuery& query) override;
+    virtual bool getTimeLineIndexRange(const string& market, const string& code,
+                                       const KQuery& query, size_t& out_start,
+                                       size_t& out_end) override;
+    virtual bool getTransIndexRange(const string& market, const string& code, const KQuery& query,
+                                    size_t& out_start, size_t& out_end) override;
 
 private:
     void H5ReadRecords(H5::DataSet&, hsize_t, hsize_t, void*);
@@ -76,6 +80,9 @@ private:
     TransList _getTransList(const string& market, const string& code, const Datetime& start,
                             const Datetime& end);
 
+    bool _getRecordIndexRange(const string& market, const string& code, const KQuery::KType& kType,
+                              const KQuery& query, size_t& out_start, size_t& out_end);
+
 private:
     H5::CompType m_h5DataType;
     H5::CompType m_h5IndexType;
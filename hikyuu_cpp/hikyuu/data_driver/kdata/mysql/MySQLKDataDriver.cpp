@@ -8,13 +8,14 @@
 #include <boost/lexical_cast.hpp>
 #include "hikyuu/utilities/Log.h"
 #include "MySQLKDataDriver.h"
-#include "KRecordTable.h"
 
 namespace hku {
 
 MySQLKDataDriver::MySQLKDataDriver() : KDataDriver("mysql"), m_connect(nullptr) {}
 
 MySQLKDataDriver::~MySQLKDataDriver() {
+    // 预编译语句须在连接关闭前释放
+    m_reader.clear();
     if (m_connect) {
         delete m_connect;
     }
@@ -60,28 +61,8 @@ KRecordList MySQLKDataDriver::_getKRecordList(const string& market, const string
     HKU_IF_RETURN(start_ix >= end_ix, result);
 
     try {
-        KRecordTable r(market, code, kType);
-        SQLStatementPtr st = m_connect->getStatement(fmt::format(
-          "{} order by date limit {}, {}", r.getSelectSQL(), start_ix, end_ix - start_ix));
-
-        st->exec();
-        while (st->moveNext()) {
-            KRecordTable record;
-            try {
-                record.load(st);
-                KRecord k;
-                k.datetime = record.date();
-                k.openPrice = record.open();
-                k.highPrice = record.high();
-                k.lowPrice = record.low();
-                k.closePrice = record.close();
-                k.transAmount = record.amount();
-                k.transCount = record.count();
-                result.push_back(k);
-            } catch (...) {
-                HKU_ERROR("Failed get record: {}", record.str());
-            }
-        }
+        result = m_reader.getKRecordList(m_connect, "", _getTableName(market, code, kType),
+                                         start_ix, end_ix);
     } catch (...) {
         // 表可能不存在
     }
@@ -95,28 +76,8 @@ KRecordList MySQLKDataDriver::_getKRecordList(const string& market, const string
     HKU_IF_RETURN(start_date >= end_date, result);
 
     try {
-        KRecordTable r(market, code, ktype);
-        SQLStatementPtr st = m_connect->getStatement(
-          fmt::format("{} where date >= {} and date < {} order by date", r.getSelectSQL(),
-                      start_date.number(), end_date.number()));
-        st->exec();
-        while (st->moveNext()) {
-            KRecordTable record;
-            try {
-                record.load(st);
-                KRecord k;
-                k.datetime = record.date();
-                k.openPrice = record.open();
-                k.highPrice = record.high();
-                k.lowPrice = record.low();
-                k.closePrice = record.close();
-                k.transAmount = record.amount();
-                k.transCount = record.count();
-                result.push_back(k);
-            } catch (...) {
-                HKU_ERROR("Failed get record: {}", record.str());
-            }
-        }
+        result = m_reader.getKRecordList(m_connect, "", _getTableName(market, code, ktype),
+                                         start_date, end_date);
     } catch (...) {
         // 表可能不存在
     }
@@ -128,8 +89,7 @@ size_t MySQLKDataDriver::getCount(const string& market, const string& code,
     size_t result = 0;
 
     try {
-        result = m_connect->queryNumber(
-          fmt::format("select count(1) from {}", _getTableName(market, code, kType)), 0);
+        result = m_reader.getCount(m_connect, "", _getTableName(market, code, kType));
     } catch (...) {
         // 表可能不存在, 不打印异常信息
         result = 0;
@@ -150,12 +110,8 @@ bool MySQLKDataDriver::getIndexRangeByDate(const string& market, const string& c
 
     string tablename = _getTableName(market, code, query.kType());
     try {
-        out_start = m_connect->queryInt(fmt::format("select count(1) from {} where date<{}",
-                                                    tablename, query.startDatetime().number()),
-                                        0);
-        out_end = m_connect->queryInt(fmt::format("select count(1) from {} where date<{}",
-                                                  tablename, query.endDatetime().number()),
-                                      0);
+        out_start = m_reader.getCountBefore(m_connect, "", tablename, query.startDatetime());
+        out_end = m_reader.getCountBefore(m_connect, "", tablename, query.endDatetime());
     } catch (...) {
         // 表可能不存在, 不打印异常信息
         out_start = 0;
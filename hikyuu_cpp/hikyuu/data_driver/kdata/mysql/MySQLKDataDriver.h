@@ -12,6 +12,7 @@
 #include "../../../utilities/db_connect/DBConnect.h"
 #include "../../../utilities/db_connect/mysql/MySQLConnect.h"
 #include "../../KDataDriver.h"
+#include "../KRecordTableReader.h"
 
 #if defined(_MSC_VER)
 #include <mysql.h>
@@ -71,6 +72,7 @@ private:
 
 private:
     MySQLConnect* m_connect;
+    KRecordTableReader m_reader;  // 预编译语句及位置索引缓存
 };
 
 } /* namespace hku */
@@ -0,0 +1,192 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#include <sys/stat.h>
+#include <boost/algorithm/string.hpp>
+#include "hikyuu/utilities/os.h"
+#include "NativeKDataDriver.h"
+
+namespace hku {
+
+NativeKDataDriver::NativeKDataDriver()
+: KDataDriver("native"), m_files(MAX_OPEN_FILES, MAX_OPEN_FILES / 4) {}
+
+NativeKDataDriver::~NativeKDataDriver() {}
+
+bool NativeKDataDriver::_init() {
+    try {
+        m_dirname = getParam<string>("dir");
+    } catch (...) {
+        return false;
+    }
+    m_files.clear();
+    return true;
+}
+
+string NativeKDataDriver::getFileName(const string& market, const string& code,
+                                      const KQuery::KType& kType) const {
+    string lower_market(market), lower_ktype(kType);
+    boost::to_lower(lower_market);
+    boost::to_lower(lower_ktype);
+    return fmt::format("{}/{}/{}/{}.hkd", m_dirname, lower_market, lower_ktype, code);
+}
+
+const NativeKDataFile* NativeKDataDriver::_getFile(const string& market, const string& code,
+                                                   const KQuery::KType& kType) {
+    string filename = getFileName(market, code, kType);
+    struct stat info;
+    if (0 != stat(filename.c_str(), &info)) {
+        m_files.remove(filename);
+        return nullptr;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    CachedFilePtr cached;
+    if (m_files.tryGet(filename, cached) && cached->size == int64_t(info.st_size) &&
+        cached->mtime == int64_t(info.st_mtime)) {
+        if (now - cached->checked < GENERATION_CHECK_INTERVAL) {
+            return &cached->file;
+        }
+
+        // mtime 精度较低时 compact 替换后的文件可能大小、mtime 均不变，定期核对文件头整理次数
+        size_t size = 0;
+        uint32_t generation = 0;
+        if (NativeKDataFile::peek(filename, size, generation) &&
+            generation == cached->file.generation()) {
+            cached->checked = now;
+            return &cached->file;
+        }
+    }
+
+    // 文件被追加或整理替换后重新映射
+    cached = make_shared<CachedFile>();
+    if (!cached->file.open(filename)) {
+        m_files.remove(filename);
+        return nullptr;
+    }
+    cached->size = int64_t(info.st_size);
+    cached->mtime = int64_t(info.st_mtime);
+    cached->checked = now;
+    m_files.insert(filename, cached);
+    return &cached->file;
+}
+
+size_t NativeKDataDriver::getCount(const string& market, const string& code,
+                                   const KQuery::KType& kType) {
+    const NativeKDataFile* file = _getFile(market, code, kType);
+    return file ? file->size() : 0;
+}
+
+bool NativeKDataDriver::getIndexRangeByDate(const string& market, const string& code,
+                                            const KQuery& query, size_t& out_start,
+                                            size_t& out_end) {
+    out_start = 0;
+    out_end = 0;
+    HKU_IF_RETURN(query.queryType() != KQuery::DATE, false);
+    const NativeKDataFile* file = _getFile(market, code, query.kType());
+    HKU_IF_RETURN(!file, false);
+
+    try {
+        return file->getIndexRangeByDate(query.startDatetime(), query.endDatetime(), out_start,
+                                         out_end);
+    } catch (const std::exception& e) {
+        HKU_ERROR("Failed read {}! {}", getFileName(market, code, query.kType()), e.what());
+    }
+    out_start = 0;
+    out_end = 0;
+    return false;
+}
+
+KRecordList NativeKDataDriver::getKRecordList(const string& market, const string& code,
+                                              const KQuery& query) {
+    KRecordList result;
+    const NativeKDataFile* file = _getFile(market, code, query.kType());
+    HKU_IF_RETURN(!file, result);
+
+    try {
+        if (query.queryType() == KQuery::INDEX) {
+            HKU_IF_RETURN(query.start() < 0 || query.end() < 0, result);
+            result = file->read(size_t(query.start()), size_t(query.end()));
+        } else {
+            size_t start = 0, end = 0;
+            if (file->getIndexRangeByDate(query.startDatetime(), query.endDatetime(), start,
+                                          end)) {
+                result = file->read(start, end);
+            }
+        }
+    } catch (const std::exception& e) {
+        HKU_ERROR("Failed read {}! {}", getFileName(market, code, query.kType()), e.what());
+        result.clear();
+    }
+    return result;
+}
+
+PriceList NativeKDataDriver::getField(const string& market, const string& code,
+                                      const KQuery::KType& kType, NativeKDataFile::Field field,
+                                      size_t start, size_t end) {
+    PriceList result;
+    const NativeKDataFile* file = _getFile(market, code, kType);
+    HKU_IF_RETURN(!file, result);
+    try {
+        result = file->readField(field, start, end);
+    } catch (const std::exception& e) {
+        HKU_ERROR("Failed read {}! {}", getFileName(market, code, kType), e.what());
+        result.clear();
+    }
+    return result;
+}
+
+size_t NativeKDataDriver::appendKRecordList(const string& market, const string& code,
+                                            const KQuery::KType& kType,
+                                            const KRecordList& records) {
+    HKU_IF_RETURN(records.empty(), 0);
+    string lower_market(market), lower_ktype(kType);
+    boost::to_lower(lower_market);
+    boost::to_lower(lower_ktype);
+    string path = fmt::format("{}/{}", m_dirname, lower_market);
+    HKU_ERROR_IF_RETURN(!createDir(m_dirname) || !createDir(path), 0, "Failed create dir: {}",
+                        path);
+    path = fmt::format("{}/{}", path, lower_ktype);
+    HKU_ERROR_IF_RETURN(!createDir(path), 0, "Failed create dir: {}", path);
+
+    string filename = getFileName(market, code, kType);
+    // 先释放本实例的映射，以便 windows 下可替换文件
+    m_files.remove(filename);
+    return NativeKDataFile::append(filename, records);
+}
+
+size_t NativeKDataDriver::importKData(KDataDriver& src, const string& market, const string& code,
+                                      const KQuery::KType& kType, size_t batch) {
+    HKU_CHECK(batch > 0, "Invalid batch!");
+    size_t total = src.getCount(market, code, kType);
+    HKU_IF_RETURN(total == 0, 0);
+
+    const NativeKDataFile* file = _getFile(market, code, kType);
+    Datetime last = file ? file->lastDatetime() : Null<Datetime>();
+
+    // 按位置读取源数据，TDX 等驱动不支持按日期查询K线记录
+    size_t start = 0;
+    if (!last.isNull()) {
+        size_t end = 0;
+        HKU_IF_RETURN(
+          !src.getIndexRangeByDate(market, code, KQueryByDate(last, Null<Datetime>(), kType),
+                                   start, end),
+          0);
+    }
+
+    size_t count = 0;
+    for (; start < total; start += batch) {
+        size_t end = total - start < batch ? total : start + batch;
+        KRecordList records =
+          src.getKRecordList(market, code, KQuery(int64_t(start), int64_t(end), kType));
+        HKU_IF_RETURN(records.empty(), count);
+        count += appendKRecordList(market, code, kType, records);
+    }
+    return count;
+}
+
+} /* namespace hku */
@@ -0,0 +1,121 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#pragma once
+#ifndef DATA_DRIVER_KDATA_NATIVE_NATIVEKDATADRIVER_H_
+#define DATA_DRIVER_KDATA_NATIVE_NATIVEKDATADRIVER_H_
+
+#include <chrono>
+#include "../../../utilities/LRUCache11.h"
+#include "../../KDataDriver.h"
+#include "NativeKDataFile.h"
+
+namespace hku {
+
+/**
+ * hikyuu 原生K线数据驱动
+ * @details
+ * <pre>
+ * 每只证券的每种K线类型保存为一个列式数据文件（见 NativeKDataFile），
+ * 路径为 {dir}/{market}/{ktype}/{code}.hkd（市场、K线类型均为小写）。
+ * 参数 dir 为数据根目录。
+ * 读取时通过只读内存映射访问，每个驱动实例最多保持 MAX_OPEN_FILES 个文件的映射，
+ * 每次查询仅检查文件大小及修改时间，变化时重新映射；
+ * 另每隔 GENERATION_CHECK_INTERVAL 核对一次文件头中的整理次数，
+ * 以发现大小、修改时间均未变化的整理替换。
+ * 可通过 importKData 从其他K线数据驱动（如 HDF5、TDX）增量导入。
+ * </pre>
+ * @ingroup DataDriver
+ */
+class HKU_API NativeKDataDriver : public KDataDriver {
+public:
+    /** 每个驱动实例最多保持映射的文件数 */
+    static constexpr size_t MAX_OPEN_FILES = 256;
+
+    /** 文件大小、修改时间均未变化时，核对文件头整理次数的最小间隔 */
+    static constexpr std::chrono::seconds GENERATION_CHECK_INTERVAL{1};
+
+    NativeKDataDriver();
+    virtual ~NativeKDataDriver();
+
+    virtual KDataDriverPtr _clone() override {
+        return std::make_shared<NativeKDataDriver>();
+    }
+
+    virtual bool _init() override;
+
+    virtual bool isIndexFirst() override {
+        return true;
+    }
+
+    virtual bool canParallelLoad() override {
+        return true;
+    }
+
+    virtual size_t getCount(const string& market, const string& code,
+                            const KQuery::KType& kType) override;
+    virtual bool getIndexRangeByDate(const string& market, const string& code, const KQuery& query,
+                                     size_t& out_start, size_t& out_end) override;
+    virtual KRecordList getKRecordList(const string& market, const string& code,
+                                       const KQuery& query) override;
+
+    /**
+     * 读取指定列，适用于只需单个字段的全历史扫描
+     * @param market 市场简称
+     * @param code 证券代码
+     * @param kType K线类型
+     * @param field 列
+     * @param start 起始位置
+     * @param end 结束位置（不包含），为 Null<size_t>() 时读取至末尾
+     */
+    PriceList getField(const string& market, const string& code, const KQuery::KType& kType,
+                       NativeKDataFile::Field field, size_t start = 0,
+                       size_t end = Null<size_t>());
+
+    /**
+     * 追加K线记录，不存在时创建数据文件
+     * @return 实际追加的记录数（日期不晚于已有数据的记录被忽略）
+     */
+    size_t appendKRecordList(const string& market, const string& code, const KQuery::KType& kType,
+                             const KRecordList& records);
+
+    /**
+     * 从其他K线数据驱动增量导入，只导入晚于本地最后一条记录的数据
+     * @param src 源驱动，须已初始化
+     * @param market 市场简称
+     * @param code 证券代码
+     * @param kType K线类型
+     * @param batch 每次从源驱动读取的记录数
+     * @return 导入的记录数
+     */
+    size_t importKData(KDataDriver& src, const string& market, const string& code,
+                       const KQuery::KType& kType, size_t batch = 100000);
+
+    /** 获取数据文件名 */
+    string getFileName(const string& market, const string& code,
+                       const KQuery::KType& kType) const;
+
+private:
+    struct CachedFile {
+        NativeKDataFile file;
+        int64_t size{0};
+        int64_t mtime{0};
+        std::chrono::steady_clock::time_point checked;  // 最近一次核对文件头的时刻
+    };
+    using CachedFilePtr = shared_ptr<CachedFile>;
+
+    const NativeKDataFile* _getFile(const string& market, const string& code,
+                                    const KQuery::KType& kType);
+
+private:
+    string m_dirname;
+    lru11::Cache<string, CachedFilePtr> m_files;
+};
+
+} /* namespace hku */
+
+#endif /* DATA_DRIVER_KDATA_NATIVE_NATIVEKDATADRIVER_H_ */
@@ -0,0 +1,608 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include "hikyuu/utilities/os.h"
+#include "NativeKDataFile.h"
+
+namespace hku {
+
+namespace {
+
+constexpr char FILE_MAGIC[4] = {'H', 'K', 'U', 'K'};
+constexpr uint16_t FILE_VERSION = 1;
+constexpr uint32_t BLOCK_MAGIC = 0x42434b48;  // "HKCB"
+constexpr int COLUMN_NUM = 7;
+
+// 列编码方式
+constexpr uint8_t ENC_DATE_DOD = 0;      // 日期二阶差分
+constexpr uint8_t ENC_SCALED_DELTA = 1;  // 定点整数一阶差分
+constexpr uint8_t ENC_XOR = 2;           // 与前值按位异或
+
+constexpr uint8_t XOR_SAME = 0xff;  // 异或编码中与前值相同的标记
+constexpr int MAX_SCALE = 4;
+const double SCALES[MAX_SCALE + 1] = {1.0, 10.0, 100.0, 1000.0, 10000.0};
+
+struct FileHeader {
+    char magic[4];
+    uint16_t version;
+    uint8_t flags;  // 最低位为 1 表示小端字节序
+    uint8_t reserved;
+    uint32_t block_capacity;
+    uint32_t generation;  // 整理次数，每次 compact 重写文件时加 1
+};
+static_assert(sizeof(FileHeader) == 16, "Invalid FileHeader size!");
+
+struct BlockHeader {
+    uint32_t magic;
+    uint32_t count;
+    uint64_t first_date;
+    uint64_t last_date;
+    uint32_t column_bytes[COLUMN_NUM];
+    uint8_t encoding[COLUMN_NUM];
+    uint8_t reserved[5];
+};
+static_assert(sizeof(BlockHeader) == 64, "Invalid BlockHeader size!");
+
+uint8_t platformFlags() {
+    const uint16_t probe = 1;
+    return *reinterpret_cast<const uint8_t*>(&probe) == 1 ? 1 : 0;
+}
+
+inline void putVarint(string& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(char(uint8_t(v) | 0x80));
+        v >>= 7;
+    }
+    out.push_back(char(v));
+}
+
+inline uint64_t getVarint(const char*& p, const char* end) {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        HKU_CHECK(p < end, "Corrupted native kdata block!");
+        uint8_t byte = uint8_t(*p++);
+        result |= uint64_t(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return result;
+        }
+    }
+    HKU_THROW("Corrupted native kdata block!");
+}
+
+inline uint64_t zigzag(int64_t v) {
+    return (uint64_t(v) << 1) ^ uint64_t(v >> 63);
+}
+
+inline int64_t unzigzag(uint64_t v) {
+    return int64_t(v >> 1) ^ -int64_t(v & 1);
+}
+
+inline uint64_t doubleBits(double v) {
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+
+inline double bitsDouble(uint64_t bits) {
+    double v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+void encodeDates(const KRecord* records, size_t n, string& out) {
+    uint64_t prev = 0;
+    int64_t prev_delta = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t date = records[i].datetime.number();
+        int64_t delta = int64_t(date - prev);
+        putVarint(out, zigzag(delta - prev_delta));
+        prev = date;
+        prev_delta = delta;
+    }
+}
+
+void decodeDates(const char* p, size_t bytes, size_t n, uint64_t* out) {
+    const char* end = p + bytes;
+    uint64_t prev = 0;
+    int64_t prev_delta = 0;
+    for (size_t i = 0; i < n; i++) {
+        int64_t delta = prev_delta + unzigzag(getVarint(p, end));
+        prev += uint64_t(delta);
+        prev_delta = delta;
+        out[i] = prev;
+    }
+}
+
+// 返回可无损表示为 10^k 整数倍的最小 k，不存在时返回 -1
+int findScale(const double* values, size_t n) {
+    for (int k = 0; k <= MAX_SCALE; k++) {
+        double scale = SCALES[k];
+        bool ok = true;
+        for (size_t i = 0; i < n; i++) {
+            double x = values[i] * scale;
+            if (!(std::fabs(x) < 4.0e15)) {
+                return -1;
+            }
+            int64_t r = std::llround(x);
+            if (double(r) / scale != values[i] ||
+                (r == 0 && std::signbit(values[i]))) {
+                ok = false;
+                break;
+            }
+        }
+        if (ok) {
+            return k;
+        }
+    }
+    return -1;
+}
+
+uint8_t encodeValues(const double* values, size_t n, string& out) {
+    int k = findScale(values, n);
+    if (k >= 0) {
+        out.push_back(char(k));
+        double scale = SCALES[k];
+        int64_t prev = 0;
+        for (size_t i = 0; i < n; i++) {
+            int64_t r = std::llround(values[i] * scale);
+            putVarint(out, zigzag(r - prev));
+            prev = r;
+        }
+        return ENC_SCALED_DELTA;
+    }
+
+    uint64_t prev = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t bits = doubleBits(values[i]);
+        uint64_t x = bits ^ prev;
+        prev = bits;
+        if (x == 0) {
+            out.push_back(char(XOR_SAME));
+            continue;
+        }
+        int lz = 0, tz = 0;
+        while (((x >> (56 - 8 * lz)) & 0xff) == 0) {
+            lz++;
+        }
+        while (((x >> (8 * tz)) & 0xff) == 0) {
+            tz++;
+        }
+        out.push_back(char((lz << 4) | tz));
+        x >>= 8 * tz;
+        for (int j = 8 - lz - tz; j > 0; j--) {
+            out.push_back(char(uint8_t(x)));
+            x >>= 8;
+        }
+    }
+    return ENC_XOR;
+}
+
+void decodeValues(uint8_t encoding, const char* p, size_t bytes, size_t n, double* out) {
+    const char* end = p + bytes;
+    if (encoding == ENC_SCALED_DELTA) {
+        HKU_CHECK(p < end || n == 0, "Corrupted native kdata block!");
+        HKU_IF_RETURN(n == 0, void());
+        int k = int(uint8_t(*p++));
+        HKU_CHECK(k <= MAX_SCALE, "Corrupted native kdata block!");
+        double scale = SCALES[k];
+        int64_t r = 0;
+        for (size_t i = 0; i < n; i++) {
+            r += unzigzag(getVarint(p, end));
+            out[i] = double(r) / scale;
+        }
+        return;
+    }
+
+    HKU_CHECK(encoding == ENC_XOR, "Unknown native kdata column encoding: {}", encoding);
+    uint64_t prev = 0;
+    for (size_t i = 0; i < n; i++) {
+        HKU_CHECK(p < end, "Corrupted native kdata block!");
+        uint8_t ctrl = uint8_t(*p++);
+        if (ctrl != XOR_SAME) {
+            int lz = ctrl >> 4, tz = ctrl & 0x0f;
+            int len = 8 - lz - tz;
+            HKU_CHECK(len > 0 && len <= end - p, "Corrupted native kdata block!");
+            uint64_t x = 0;
+            for (int j = len - 1; j >= 0; j--) {
+                x = (x << 8) | uint8_t(p[j]);
+            }
+            p += len;
+            prev ^= x << (8 * tz);
+        }
+        out[i] = bitsDouble(prev);
+    }
+}
+
+// 将记录按块写入文件，返回写入的块数，失败时返回 -1
+int64_t writeBlocks(FILE* fp, const KRecord* records, size_t n, uint32_t capacity) {
+    string payload;
+    vector<double> values(capacity);
+    int64_t blocks = 0;
+    for (size_t pos = 0; pos < n; pos += capacity) {
+        size_t count = n - pos < capacity ? n - pos : capacity;
+        const KRecord* rs = records + pos;
+
+        BlockHeader header;
+        memset(&header, 0, sizeof(header));
+        header.magic = BLOCK_MAGIC;
+        header.count = uint32_t(count);
+        header.first_date = rs[0].datetime.number();
+        header.last_date = rs[count - 1].datetime.number();
+
+        payload.clear();
+        size_t last_size = 0;
+        encodeDates(rs, count, payload);
+        header.encoding[0] = ENC_DATE_DOD;
+        header.column_bytes[0] = uint32_t(payload.size());
+        last_size = payload.size();
+
+        for (int col = 1; col < COLUMN_NUM; col++) {
+            for (size_t i = 0; i < count; i++) {
+                const KRecord& r = rs[i];
+                switch (col) {
+                    case NativeKDataFile::OPEN:
+                        values[i] = r.openPrice;
+                        break;
+                    case NativeKDataFile::HIGH:
+                        values[i] = r.highPrice;
+                        break;
+                    case NativeKDataFile::LOW:
+                        values[i] = r.lowPrice;
+                        break;
+                    case NativeKDataFile::CLOSE:
+                        values[i] = r.closePrice;
+                        break;
+                    case NativeKDataFile::AMOUNT:
+                        values[i] = r.transAmount;
+                        break;
+                    default:
+                        values[i] = r.transCount;
+                        break;
+                }
+            }
+            header.encoding[col] = encodeValues(values.data(), count, payload);
+            header.column_bytes[col] = uint32_t(payload.size() - last_size);
+            last_size = payload.size();
+        }
+
+        // 块头与块数据一次写入，未写完整的块在读取时被忽略
+        payload.insert(0, reinterpret_cast<const char*>(&header), sizeof(header));
+        HKU_IF_RETURN(fwrite(payload.data(), 1, payload.size(), fp) != payload.size(), -1);
+        blocks++;
+    }
+    return blocks;
+}
+
+bool writeFileHeader(FILE* fp, uint32_t capacity, uint32_t generation) {
+    FileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.version = FILE_VERSION;
+    header.flags = platformFlags();
+    header.block_capacity = capacity;
+    header.generation = generation;
+    return fwrite(&header, 1, sizeof(header), fp) == sizeof(header);
+}
+
+}  // namespace
+
+bool NativeKDataFile::open(const string& filename) {
+    close();
+    HKU_IF_RETURN(!m_file.open(filename), false);
+    HKU_IF_RETURN(m_file.size() == 0, true);
+
+    const char* data = m_file.data();
+    size_t total = m_file.size();
+    FileHeader file_header;
+    HKU_ERROR_IF_RETURN(total < sizeof(FileHeader), false, "Invalid native kdata file: {}",
+                        filename);
+    memcpy(&file_header, data, sizeof(file_header));
+    HKU_ERROR_IF_RETURN(memcmp(file_header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 ||
+                          file_header.version > FILE_VERSION ||
+                          file_header.flags != platformFlags() ||
+                          file_header.block_capacity == 0,
+                        false, "Invalid or incompatible native kdata file: {}", filename);
+    m_block_capacity = file_header.block_capacity;
+    m_generation = file_header.generation;
+
+    size_t offset = sizeof(FileHeader);
+    size_t start = 0;
+    BlockHeader header;
+    while (offset + sizeof(BlockHeader) <= total) {
+        memcpy(&header, data + offset, sizeof(header));
+        if (header.magic != BLOCK_MAGIC || header.count == 0 ||
+            header.first_date > header.last_date ||
+            (!m_blocks.empty() && header.first_date <= m_blocks.back().last_date)) {
+            break;
+        }
+
+        size_t bytes = 0;
+        for (int i = 0; i < COLUMN_NUM; i++) {
+            bytes += header.column_bytes[i];
+        }
+        if (bytes > total - offset - sizeof(BlockHeader)) {
+            break;
+        }
+
+        BlockInfo block;
+        const char* p = data + offset + sizeof(BlockHeader);
+        for (int i = 0; i < COLUMN_NUM; i++) {
+            block.columns[i] = p;
+            block.column_bytes[i] = header.column_bytes[i];
+            block.encoding[i] = header.encoding[i];
+            p += header.column_bytes[i];
+        }
+        block.start = start;
+        block.count = header.count;
+        block.first_date = header.first_date;
+        block.last_date = header.last_date;
+        m_blocks.push_back(block);
+
+        start += header.count;
+        offset += sizeof(BlockHeader) + bytes;
+    }
+
+    m_valid_end = offset;
+    return true;
+}
+
+void NativeKDataFile::close() noexcept {
+    m_blocks.clear();
+    m_file.close();
+    m_block_capacity = DEFAULT_BLOCK_CAPACITY;
+    m_generation = 0;
+    m_valid_end = 0;
+}
+
+bool NativeKDataFile::peek(const string& filename, size_t& size, uint32_t& generation) {
+    size = 0;
+    generation = 0;
+    FILE* fp = fopen(filename.c_str(), "rb");
+    HKU_IF_RETURN(!fp, false);
+
+    FileHeader header;
+    size_t bytes = fread(&header, 1, sizeof(header), fp);
+    bool ok = fseek(fp, 0, SEEK_END) == 0;
+    long end = ok ? ftell(fp) : -1;
+    fclose(fp);
+    HKU_IF_RETURN(end < 0, false);
+
+    size = size_t(end);
+    if (bytes == sizeof(header)) {
+        generation = header.generation;
+    }
+    return true;
+}
+
+Datetime NativeKDataFile::lastDatetime() const {
+    return m_blocks.empty() ? Null<Datetime>() : Datetime(m_blocks.back().last_date);
+}
+
+size_t NativeKDataFile::_findBlockByPos(size_t pos) const {
+    auto iter = std::upper_bound(m_blocks.begin(), m_blocks.end(), pos,
+                                 [](size_t p, const BlockInfo& block) { return p < block.start; });
+    return size_t(iter - m_blocks.begin()) - 1;
+}
+
+size_t NativeKDataFile::_findPosByDate(uint64_t date) const {
+    auto iter =
+      std::lower_bound(m_blocks.begin(), m_blocks.end(), date,
+                       [](const BlockInfo& block, uint64_t d) { return block.last_date < d; });
+    HKU_IF_RETURN(iter == m_blocks.end(), size());
+    HKU_IF_RETURN(iter->first_date >= date, iter->start);
+
+    vector<uint64_t> dates(iter->count);
+    decodeDates(iter->columns[0], iter->column_bytes[0], iter->count, dates.data());
+    auto pos = std::lower_bound(dates.begin(), dates.end(), date);
+    return iter->start + size_t(pos - dates.begin());
+}
+
+// 文件中日期精度为分钟，不足整分钟的查询日期向上取整，以便与 >= 比较等价
+static uint64_t queryDateKey(const Datetime& d) {
+    uint64_t key = d.number();
+    return Datetime(key) < d ? key + 1 : key;
+}
+
+bool NativeKDataFile::getIndexRangeByDate(const Datetime& start, const Datetime& end,
+                                          size_t& out_start, size_t& out_end) const {
+    out_start = 0;
+    out_end = 0;
+    HKU_IF_RETURN(m_blocks.empty(), false);
+    out_start = start.isNull() ? 0 : _findPosByDate(queryDateKey(start));
+    out_end = end.isNull() ? size() : _findPosByDate(queryDateKey(end));
+    if (out_start >= out_end) {
+        out_start = 0;
+        out_end = 0;
+        return false;
+    }
+    return true;
+}
+
+template <typename Func>
+void NativeKDataFile::_forEachBlock(size_t start, size_t end, Func&& func) const {
+    size_t total = size();
+    end = end > total ? total : end;
+    HKU_IF_RETURN(start >= end, void());
+    for (size_t i = _findBlockByPos(start); i < m_blocks.size(); i++) {
+        const BlockInfo& block = m_blocks[i];
+        HKU_IF_RETURN(block.start >= end, void());
+        size_t from = start > block.start ? start - block.start : 0;
+        size_t to = end - block.start < block.count ? end - block.start : block.count;
+        func(block, from, to);
+    }
+}
+
+KRecordList NativeKDataFile::read(size_t start, size_t end) const {
+    KRecordList result;
+    size_t total = size();
+    end = end > total ? total : end;
+    HKU_IF_RETURN(start >= end, result);
+
+    result.reserve(end - start);
+    vector<uint64_t> dates(m_block_capacity);
+    vector<double> columns[COLUMN_NUM];
+    for (int col = 1; col < COLUMN_NUM; col++) {
+        columns[col].resize(m_block_capacity);
+    }
+
+    _forEachBlock(start, end, [&](const BlockInfo& block, size_t from, size_t to) {
+        if (dates.size() < block.count) {
+            dates.resize(block.count);
+            for (int col = 1; col < COLUMN_NUM; col++) {
+                columns[col].resize(block.count);
+            }
+        }
+
+        // 差分编码须从块首开始解码，只解码至所需的最后一条
+        decodeDates(block.columns[0], block.column_bytes[0], to, dates.data());
+        for (int col = 1; col < COLUMN_NUM; col++) {
+            decodeValues(block.encoding[col], block.columns[col], block.column_bytes[col], to,
+                         columns[col].data());
+        }
+        for (size_t i = from; i < to; i++) {
+            result.emplace_back(Datetime(dates[i]), columns[OPEN][i], columns[HIGH][i],
+                                columns[LOW][i], columns[CLOSE][i], columns[AMOUNT][i],
+                                columns[VOLUME][i]);
+        }
+    });
+    return result;
+}
+
+DatetimeList NativeKDataFile::readDatetime(size_t start, size_t end) const {
+    DatetimeList result;
+    size_t total = size();
+    end = end > total ? total : end;
+    HKU_IF_RETURN(start >= end, result);
+
+    result.reserve(end - start);
+    vector<uint64_t> dates(m_block_capacity);
+    _forEachBlock(start, end, [&](const BlockInfo& block, size_t from, size_t to) {
+        if (dates.size() < block.count) {
+            dates.resize(block.count);
+        }
+        decodeDates(block.columns[0], block.column_bytes[0], to, dates.data());
+        for (size_t i = from; i < to; i++) {
+            result.emplace_back(dates[i]);
+        }
+    });
+    return result;
+}
+
+PriceList NativeKDataFile::readField(Field field, size_t start, size_t end) const {
+    PriceList result;
+    size_t total = size();
+    end = end > total ? total : end;
+    HKU_IF_RETURN(start >= end, result);
+    HKU_CHECK(field >= OPEN && field <= VOLUME, "Invalid field: {}", int(field));
+
+    result.reserve(end - start);
+    vector<double> values(m_block_capacity);
+    _forEachBlock(start, end, [&](const BlockInfo& block, size_t from, size_t to) {
+        if (values.size() < block.count) {
+            values.resize(block.count);
+        }
+        decodeValues(block.encoding[field], block.columns[field], block.column_bytes[field], to,
+                     values.data());
+        for (size_t i = from; i < to; i++) {
+            result.push_back(price_t(values[i]));
+        }
+    });
+    return result;
+}
+
+size_t NativeKDataFile::append(const string& filename, const KRecordList& records,
+                               uint32_t block_capacity) {
+    HKU_CHECK(block_capacity > 0, "Invalid block capacity!");
+    HKU_IF_RETURN(records.empty(), 0);
+
+    NativeKDataFile file;
+    if (existFile(filename)) {
+        HKU_ERROR_IF_RETURN(!file.open(filename), 0, "Failed open {}", filename);
+        if (file.m_valid_end < file.m_file.size()) {
+            // 上次写入未完成，先丢弃尾部不完整的数据
+            HKU_WARN("Discard the incomplete tail of {}", filename);
+            file.close();
+            HKU_ERROR_IF_RETURN(!compact(filename), 0, "Failed compact {}", filename);
+            HKU_ERROR_IF_RETURN(!file.open(filename), 0, "Failed open {}", filename);
+        }
+    }
+
+    bool new_file = file.m_file.size() == 0;
+    uint32_t capacity = new_file ? block_capacity : file.m_block_capacity;
+    uint64_t last = file.m_blocks.empty() ? 0 : file.m_blocks.back().last_date;
+    size_t old_total = file.size();
+    size_t old_blocks = file.blockCount();
+    file.close();
+
+    // 仅保留日期严格递增且晚于已有数据的记录
+    KRecordList buf;
+    const KRecord* begin = records.data();
+    size_t n = records.size();
+    bool sorted = records.front().datetime.number() > last;
+    for (size_t i = 1; sorted && i < n; i++) {
+        sorted = records[i - 1].datetime < records[i].datetime;
+    }
+    if (!sorted) {
+        buf.reserve(n);
+        for (const auto& r : records) {
+            uint64_t date = r.datetime.number();
+            if (!r.datetime.isNull() && date > last) {
+                buf.push_back(r);
+                last = date;
+            }
+        }
+        begin = buf.data();
+        n = buf.size();
+    }
+    HKU_IF_RETURN(n == 0, 0);
+
+    FILE* fp = fopen(filename.c_str(), "ab");
+    HKU_ERROR_IF_RETURN(!fp, 0, "Failed open {}", filename);
+    // 新建文件以当前时间初始化整理次数，避免删除后重建的同长度文件被误认为未变化
+    bool ok = !new_file || writeFileHeader(fp, capacity, uint32_t(Datetime::now().ticks()));
+    int64_t blocks = ok ? writeBlocks(fp, begin, n, capacity) : -1;
+    ok = fclose(fp) == 0 && blocks >= 0;
+    HKU_ERROR_IF_RETURN(!ok, 0, "Failed write {}", filename);
+
+    size_t total = old_total + n;
+    size_t min_blocks = (total + capacity - 1) / capacity;
+    if (old_blocks + size_t(blocks) > min_blocks + MAX_FRAGMENT_BLOCKS) {
+        compact(filename);
+    }
+    return n;
+}
+
+bool NativeKDataFile::compact(const string& filename) {
+    NativeKDataFile file;
+    HKU_IF_RETURN(!file.open(filename), false);
+    KRecordList records = file.read(0, file.size());
+    uint32_t capacity = file.m_block_capacity;
+    uint32_t generation = file.m_generation + 1;
+    file.close();
+
+    string tmp = fmt::format("{}.tmp", filename);
+    FILE* fp = fopen(tmp.c_str(), "wb");
+    HKU_ERROR_IF_RETURN(!fp, false, "Failed create {}", tmp);
+    bool ok = writeFileHeader(fp, capacity, generation) &&
+              writeBlocks(fp, records.data(), records.size(), capacity) >= 0;
+    ok = fclose(fp) == 0 && ok;
+    if (ok) {
+        // 已打开的只读映射仍指向原文件，不受替换影响（windows 下映射未关闭时替换失败）
+        ok = renameFile(tmp, filename, true);
+    }
+    if (!ok) {
+        HKU_ERROR("Failed compact {}", filename);
+        removeFile(tmp);
+    }
+    return ok;
+}
+
+}  // namespace hku
@@ -0,0 +1,154 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#pragma once
+#ifndef DATA_DRIVER_KDATA_NATIVE_NATIVEKDATAFILE_H_
+#define DATA_DRIVER_KDATA_NATIVE_NATIVEKDATAFILE_H_
+
+#include "../../../KRecord.h"
+#include "../../../utilities/MappedFile.h"
+
+namespace hku {
+
+/**
+ * hikyuu 原生K线文件（单只证券、单一K线类型）
+ * @details
+ * <pre>
+ * 文件由 16 字节文件头及依次追加的数据块组成，每个数据块包含 64 字节块头及按列存放的
+ * 日期、开、高、低、收、成交金额、成交量七列编码数据：
+ *   - 日期按 Datetime::number() 做二阶差分，再以 zigzag 变长整数编码；
+ *   - 价格、金额、数量列可无损表示为 10^k (k<=4) 的整数倍时，按整数做一阶差分编码，
+ *     否则与前值按位异或，仅保存非零的中间字节。
+ * 块头中记录记录数、首尾日期及各列长度，打开文件时只扫描块头即建立稀疏日期索引，
+ * 按日期或位置定位均为对块的二分查找，随后只解码命中的数据块；读取单列时跳过其他列。
+ * 写入只在文件尾部追加新块，不修改已有内容，读取方通过只读内存映射访问，
+ * 未写完整的尾部数据块将被忽略。碎片块过多时可通过 compact 重写文件，
+ * 重写时文件头中的整理次数加 1，读取方据此及文件长度判断已打开的映射是否仍有效，
+ * 不依赖各平台精度不一的修改时间及 inode。
+ * 各实例非线程安全。
+ * </pre>
+ */
+class NativeKDataFile {
+public:
+    /** 可单独读取的列 */
+    enum Field {
+        OPEN = 1,    ///< 开盘价
+        HIGH = 2,    ///< 最高价
+        LOW = 3,     ///< 最低价
+        CLOSE = 4,   ///< 收盘价
+        AMOUNT = 5,  ///< 成交金额
+        VOLUME = 6,  ///< 成交量
+    };
+
+    /** 每个数据块默认的最大记录数 */
+    static constexpr uint32_t DEFAULT_BLOCK_CAPACITY = 4096;
+
+    /** 超出满块所需块数多少个时，追加后自动整理文件 */
+    static constexpr size_t MAX_FRAGMENT_BLOCKS = 16;
+
+    NativeKDataFile() = default;
+    ~NativeKDataFile() = default;
+
+    NativeKDataFile(const NativeKDataFile&) = delete;
+    NativeKDataFile& operator=(const NativeKDataFile&) = delete;
+
+    /**
+     * 以只读内存映射方式打开文件并扫描块头
+     * @return 文件不存在或格式错误时返回 false
+     */
+    bool open(const string& filename);
+
+    /** 关闭文件 */
+    void close() noexcept;
+
+    /** 记录总数 */
+    size_t size() const noexcept {
+        return m_blocks.empty() ? 0 : m_blocks.back().start + m_blocks.back().count;
+    }
+
+    /** 数据块数 */
+    size_t blockCount() const noexcept {
+        return m_blocks.size();
+    }
+
+    /** 文件头中的整理次数，见 peek */
+    uint32_t generation() const noexcept {
+        return m_generation;
+    }
+
+    /** 最后一条记录的日期，无记录时返回 Null<Datetime>() */
+    Datetime lastDatetime() const;
+
+    /**
+     * 获取日期范围 [start, end) 对应的记录位置 [out_start, out_end)
+     * @return 范围内无记录时返回 false
+     */
+    bool getIndexRangeByDate(const Datetime& start, const Datetime& end, size_t& out_start,
+                             size_t& out_end) const;
+
+    /** 读取位置范围 [start, end) 内的K线记录 */
+    KRecordList read(size_t start, size_t end) const;
+
+    /** 读取位置范围 [start, end) 内的日期 */
+    DatetimeList readDatetime(size_t start, size_t end) const;
+
+    /** 读取位置范围 [start, end) 内的指定列 */
+    PriceList readField(Field field, size_t start, size_t end) const;
+
+    /**
+     * 在文件尾部追加K线记录，文件不存在时新建
+     * @details 日期不晚于文件中最后一条记录的记录将被忽略，记录须按日期升序排列
+     * @param filename 文件名，所在目录须已存在
+     * @param records 待追加的记录
+     * @param block_capacity 每个数据块的最大记录数，仅对新建文件有效
+     * @return 实际追加的记录数
+     */
+    static size_t append(const string& filename, const KRecordList& records,
+                         uint32_t block_capacity = DEFAULT_BLOCK_CAPACITY);
+
+    /**
+     * 不建立映射，仅读取文件当前的长度及文件头中的整理次数
+     * @details 追加只改变文件长度，compact 替换文件后整理次数改变，两者均未变化时
+     *          已打开的映射仍与文件内容一致
+     * @return 文件不存在时返回 false，空文件的整理次数为 0
+     */
+    static bool peek(const string& filename, size_t& size, uint32_t& generation);
+
+    /**
+     * 将文件重写为尽可能满的数据块，通过临时文件替换原文件
+     * @return 失败时返回 false，原文件保持不变
+     */
+    static bool compact(const string& filename);
+
+private:
+    struct BlockInfo {
+        const char* columns[7];  // 各列编码数据的起始位置
+        uint32_t column_bytes[7];
+        uint8_t encoding[7];
+        size_t start;  // 块内第一条记录的位置
+        uint32_t count;
+        uint64_t first_date;
+        uint64_t last_date;
+    };
+
+    size_t _findBlockByPos(size_t pos) const;
+    size_t _findPosByDate(uint64_t date) const;
+
+    template <typename Func>
+    void _forEachBlock(size_t start, size_t end, Func&& func) const;
+
+private:
+    MappedFile m_file;
+    uint32_t m_block_capacity{DEFAULT_BLOCK_CAPACITY};
+    uint32_t m_generation{0};
+    size_t m_valid_end{0};  // 最后一个完整数据块的结束位置
+    vector<BlockInfo> m_blocks;
+};
+
+}  // namespace hku
+
+#endif /* DATA_DRIVER_KDATA_NATIVE_NATIVEKDATAFILE_H_ */
@@ -5,10 +5,10 @@
  *       Author: yangrq1018
  */
 
+#include <cstdio>
 #include <fmt/format.h>
 #include <boost/algorithm/string.hpp>
 #include "SQLiteKDataDriver.h"
-#include "../mysql/KRecordTable.h"
 
 namespace hku {
 
@@ -16,26 +16,46 @@ inline bool isBaseKType(const KQuery::KType& ktype) {
     return (ktype == KQuery::DAY || ktype == KQuery::MIN || ktype == KQuery::MIN5);
 }
 
-inline KQuery::KType getBaseKType(const KQuery::KType& ktype) {
-    KQuery::KType base_ktype;
-    if (ktype == KQuery::WEEK || ktype == KQuery::MONTH || ktype == KQuery::QUARTER ||
-        ktype == KQuery::HALFYEAR || ktype == KQuery::YEAR) {
-        base_ktype = KQuery::DAY;
-    } else if (ktype == KQuery::MIN15 || ktype == KQuery::MIN30 || ktype == KQuery::MIN60 ||
-               ktype == KQuery::HOUR2 || ktype == KQuery::HOUR4 || ktype == KQuery::HOUR6 ||
-               ktype == KQuery::HOUR12) {
-        base_ktype = KQuery::MIN5;
-    } else if (ktype == KQuery::MIN3) {
-        base_ktype = KQuery::MIN;
-    } else {
-        HKU_ERROR("Unable to convert ktype {} to a base ktype", ktype);
+// 合成K线中日期位于 [start_date, end_date) 的位置区间
+static void getIndexRange(const KRecordList& klist, const Datetime& start_date,
+                          const Datetime& end_date, size_t& out_start, size_t& out_end) {
+    auto less = [](const KRecord& k, const Datetime& d) { return k.datetime < d; };
+    out_start = std::lower_bound(klist.begin(), klist.end(), start_date, less) - klist.begin();
+    out_end = std::lower_bound(klist.begin(), klist.end(), end_date, less) - klist.begin();
+}
+
+/*
+ * 解析交易时段，格式如 "09:30-11:30,13:00-15:00"，最多两个时段
+ * 格式错误时返回无效的市场信息，此时按自然时间切分
+ */
+static MarketInfo parseSession(const string& session) {
+    vector<TimeDelta> times;
+    vector<string> ranges;
+    boost::split(ranges, session, boost::is_any_of(","), boost::token_compress_on);
+    for (auto& range : ranges) {
+        vector<string> items;
+        boost::split(items, range, boost::is_any_of("-"));
+        HKU_ERROR_IF_RETURN(items.size() != 2 || times.size() >= 4, MarketInfo(),
+                            "Invalid session: {}", session);
+        for (auto& item : items) {
+            boost::trim(item);
+            int hour = 0, minute = 0;
+            HKU_ERROR_IF_RETURN(sscanf(item.c_str(), "%d:%d", &hour, &minute) != 2, MarketInfo(),
+                                "Invalid session: {}", session);
+            times.emplace_back(Hours(hour) + Minutes(minute));
+        }
     }
-    return base_ktype;
+    HKU_ERROR_IF_RETURN(times.empty(), MarketInfo(), "Invalid session: {}", session);
+    times.resize(4);
+    return MarketInfo("", "", "", "", Null<Datetime>(), times[0], times[1], times[2], times[3]);
 }
 
 SQLiteKDataDriver::SQLiteKDataDriver() : KDataDriver("sqlite3") {}
 
-SQLiteKDataDriver::~SQLiteKDataDriver() {}
+SQLiteKDataDriver::~SQLiteKDataDriver() {
+    // 预编译语句须在连接关闭前释放
+    m_reader.clear();
+}
 
 bool SQLiteKDataDriver::_init() {
     HKU_CHECK(m_sqlite_connection_map.empty(), "Maybe repeat initialization!");
@@ -44,6 +64,7 @@ bool SQLiteKDataDriver::_init() {
     string db_filename;
     m_ifConvert = tryGetParam<bool>("convert", false);
     HKU_DEBUG("SQLiteKDataDriver: m_ifConvert set to {}", m_ifConvert);
+    m_session = parseSession(tryGetParam<string>("session", "09:30-11:30,13:00-15:00"));
 
     for (auto iter = keys.begin(); iter != keys.end(); ++iter) {
         size_t pos = iter->find("_");
@@ -72,6 +93,9 @@ bool SQLiteKDataDriver::_init() {
                 }
             } else if (ktype == KQuery::getKTypeName(KQuery::MIN)) {
                 m_sqlite_connection_map[exchange + "_MIN"] = conn;
+                if (m_ifConvert) {
+                    m_sqlite_connection_map[exchange + "_MIN3"] = conn;
+                }
             } else if (ktype == KQuery::getKTypeName(KQuery::MIN5)) {
                 m_sqlite_connection_map[exchange + "_MIN5"] = conn;
                 if (m_ifConvert) {
@@ -79,6 +103,9 @@ bool SQLiteKDataDriver::_init() {
                     m_sqlite_connection_map[exchange + "_MIN30"] = conn;
                     m_sqlite_connection_map[exchange + "_MIN60"] = conn;
                     m_sqlite_connection_map[exchange + "_HOUR2"] = conn;
+                    m_sqlite_connection_map[exchange + "_HOUR4"] = conn;
+                    m_sqlite_connection_map[exchange + "_HOUR6"] = conn;
+                    m_sqlite_connection_map[exchange + "_HOUR12"] = conn;
                 }
             }
         } catch (...) {
@@ -99,29 +126,58 @@ KRecordList SQLiteKDataDriver::getKRecordList(const string& market, const string
                                               const KQuery& query) {
     KRecordList result;
     KQuery::KType ktype = query.kType();
-    if (query.queryType() == KQuery::INDEX) {
-        if (!isBaseKType(ktype)) {
-            KQuery::KType base_ktype = getBaseKType(ktype);
-            int64_t start, end, num;
-            start = query.start();
-            end = query.end();
-            num = end - start;
-            int32_t multiplier = KQuery::getKTypeInMin(ktype) / KQuery::getKTypeInMin(base_ktype);
-            end = getCount(market, code, base_ktype);
-            start = end - num * multiplier;
-            HKU_ERROR_IF(start < 0, "Invalid start index: {}", start);
-            result = _getKRecordList(market, code, ktype, start, end);
-        } else {
-            result = _getKRecordList(market, code, ktype, query.start(), query.end());
+    if (isBaseKType(ktype)) {
+        if (query.queryType() == KQuery::INDEX) {
+            return _getKRecordList(market, code, ktype, query.start(), query.end());
         }
+        return _getKRecordList(market, code, ktype, query.startDatetime(), query.endDatetime());
+    }
+
+    HKU_ERROR_IF_RETURN(!m_ifConvert, result, "KData: unsupported ktype {}", ktype);
+    const KRecordList& klist = _getConvertedKRecordList(market, code, ktype);
+    size_t start = 0, end = 0;
+    if (query.queryType() == KQuery::INDEX) {
+        start = query.start();
+        end = std::min<size_t>(query.end(), klist.size());
     } else {
-        result = _getKRecordList(market, code, ktype, query.startDatetime(), query.endDatetime());
+        getIndexRange(klist, query.startDatetime(), query.endDatetime(), start, end);
     }
-    if (isBaseKType(ktype))
-        return result;
-    HKU_ERROR_IF_RETURN(!m_ifConvert, KRecordList(), "KData: unsupported ktype {}", ktype);
-    KQuery::KType base_ktype = getBaseKType(ktype);
-    return convertToNewInterval(result, base_ktype, ktype);
+    HKU_IF_RETURN(start >= end, result);
+    result.assign(klist.begin() + start, klist.begin() + end);
+    return result;
+}
+
+const KRecordList& SQLiteKDataDriver::_getConvertedKRecordList(const string& market,
+                                                               const string& code,
+                                                               const KQuery::KType& ktype) {
+    string key(format("{}{}_{}", market, code, ktype));
+    auto iter = m_convert_states.find(key);
+    if (iter == m_convert_states.end()) {
+        iter = m_convert_states.emplace(key, ConvertState(ktype, m_session)).first;
+    }
+    ConvertState& state = iter->second;
+
+    // 重新读取最后一根已合成的基础K线，以便合入其更新（如盘中写入的最新K线）
+    KQuery::KType base_ktype = KRecordResampler::getBaseKType(ktype);
+    size_t base_total = _getCount(market, code, base_ktype);
+    size_t start = 0;
+    if (state.base_count > 0 && base_total >= state.base_count) {
+        start = state.base_count - 1;
+    }
+    KRecordList records = _getKRecordList(market, code, base_ktype, start, base_total);
+    if (start > 0 && (records.empty() || records.front().datetime != state.last_datetime)) {
+        // 已合成的基础K线被改写，重新合成
+        start = 0;
+        records = _getKRecordList(market, code, base_ktype, start, base_total);
+    }
+    if (start == 0) {
+        state.resampler.clear();
+    }
+
+    state.resampler.append(records.data(), records.size());
+    state.base_count = start + records.size();
+    state.last_datetime = records.empty() ? Null<Datetime>() : records.back().datetime;
+    return state.resampler.getKRecordList();
 }
 
 KRecordList SQLiteKDataDriver::_getKRecordList(const string& market, const string& code,
@@ -134,34 +190,15 @@ KRecordList SQLiteKDataDriver::_getKRecordList(const string& market, const strin
     HKU_IF_RETURN(!connection, result);
 
     try {
-        KRecordTable r(market, code, kType);
-        SQLStatementPtr st = connection->getStatement(fmt::format(
-          "{} order by date limit {}, {}", r.getSelectSQLNoDB(), start_ix, end_ix - start_ix));
-
-        st->exec();
-        while (st->moveNext()) {
-            KRecordTable record;
-            try {
-                record.load(st);
-                KRecord k;
-                k.datetime = record.date();
-                k.openPrice = record.open();
-                k.highPrice = record.high();
-                k.lowPrice = record.low();
-                k.closePrice = record.close();
-                k.transAmount = record.amount();
-                k.transCount = record.count();
-                result.push_back(k);
-            } catch (...) {
-                HKU_ERROR("Failed get record: {}", record.str());
-            }
-        }
+        result = m_reader.getKRecordList(connection.get(), key,
+                                         _getTableName(market, code, kType), start_ix, end_ix);
     } catch (...) {
         // 表可能不存在
         HKU_ERROR("Failed to get record by index: {}", key);
     }
     return result;
 }
+
 KRecordList SQLiteKDataDriver::_getKRecordList(const string& market, const string& code,
                                                const KQuery::KType& kType, Datetime start_date,
                                                Datetime end_date) {
@@ -173,28 +210,8 @@ KRecordList SQLiteKDataDriver::_getKRecordList(const string& market, const strin
     HKU_IF_RETURN(!connection, result);
 
     try {
-        KRecordTable r(market, code, kType);
-        SQLStatementPtr st = connection->getStatement(
-          fmt::format("{} where date >= {} and date < {} order by date", r.getSelectSQLNoDB(),
-                      start_date.number(), end_date.number()));
-        st->exec();
-        while (st->moveNext()) {
-            KRecordTable record;
-            try {
-                record.load(st);
-                KRecord k;
-                k.datetime = record.date();
-                k.openPrice = record.open();
-                k.highPrice = record.high();
-                k.lowPrice = record.low();
-                k.closePrice = record.close();
-                k.transAmount = record.amount();
-                k.transCount = record.count();
-                result.push_back(k);
-            } catch (...) {
-                HKU_ERROR("Failed get record: {}", record.str());
-            }
-        }
+        result = m_reader.getKRecordList(connection.get(), key,
+                                         _getTableName(market, code, kType), start_date, end_date);
     } catch (...) {
         // 表可能不存在
         HKU_ERROR("Failed to get record by date: {}", key);
@@ -204,20 +221,26 @@ KRecordList SQLiteKDataDriver::_getKRecordList(const string& market, const strin
 
 size_t SQLiteKDataDriver::getCount(const string& market, const string& code,
                                    const KQuery::KType& kType) {
+    if (isBaseKType(kType))
+        return _getCount(market, code, kType);
+    HKU_ERROR_IF_RETURN(!m_ifConvert, 0, "KData: unsupported ktype {}", kType);
+    return _getConvertedKRecordList(market, code, kType).size();
+}
+
+size_t SQLiteKDataDriver::_getCount(const string& market, const string& code,
+                                    const KQuery::KType& kType) {
     string key(format("{}_{}", market, kType));
     SQLiteConnectPtr connection = m_sqlite_connection_map[key];
     HKU_IF_RETURN(!connection, 0);
 
     size_t result = 0;
-    result = connection->queryInt(
-      fmt::format("select count(1) from {}", _getTableName(market, code, kType)), 0);
-
-    if (isBaseKType(kType))
-        return result;
-    HKU_ERROR_IF_RETURN(!m_ifConvert, 0, "KData: unsupported ktype {}", kType);
-    auto old_intervals_per_new_candle =
-      KQuery::getKTypeInMin(kType) / KQuery::getKTypeInMin(getBaseKType(kType));
-    return result / old_intervals_per_new_candle;
+    try {
+        result = m_reader.getCount(connection.get(), key, _getTableName(market, code, kType));
+    } catch (...) {
+        // 表可能不存在, 不打印异常信息
+        result = 0;
+    }
+    return result;
 }
 
 bool SQLiteKDataDriver::getIndexRangeByDate(const string& market, const string& code,
@@ -229,18 +252,23 @@ bool SQLiteKDataDriver::getIndexRangeByDate(const string& market, const string&
     HKU_IF_RETURN(
       query.startDatetime() >= query.endDatetime() || query.startDatetime() > (Datetime::max)(),
       false);
+    if (!isBaseKType(query.kType())) {
+        HKU_ERROR_IF_RETURN(!m_ifConvert, false, "KData: unsupported ktype {}", query.kType());
+        const KRecordList& klist = _getConvertedKRecordList(market, code, query.kType());
+        getIndexRange(klist, query.startDatetime(), query.endDatetime(), out_start, out_end);
+        return true;
+    }
+
     string key(format("{}_{}", market, query.kType()));
     SQLiteConnectPtr connection = m_sqlite_connection_map[key];
     HKU_IF_RETURN(!connection, false);
 
     string tablename = _getTableName(market, code, query.kType());
     try {
-        out_start = connection->queryInt(fmt::format("select count(1) from {} where date<{}",
-                                                     tablename, query.startDatetime().number()),
-                                         0);
-        out_end = connection->queryInt(fmt::format("select count(1) from {} where date<{}",
-                                                   tablename, query.endDatetime().number()),
-                                       0);
+        out_start = m_reader.getCountBefore(connection.get(), key, tablename,
+                                            query.startDatetime());
+        out_end =
+          m_reader.getCountBefore(connection.get(), key, tablename, query.endDatetime());
     } catch (...) {
         // 表可能不存在, 不打印异常信息
         out_start = 0;
@@ -251,41 +279,4 @@ bool SQLiteKDataDriver::getIndexRangeByDate(const string& market, const string&
     return true;
 }
 
-KRecordList SQLiteKDataDriver::convertToNewInterval(const KRecordList& candles,
-                                                    const KQuery::KType& from_ktype,
-                                                    const KQuery::KType& to_ktype) {
-    int32_t old_intervals_per_new_candle =
-      KQuery::getKTypeInMin(to_ktype) / KQuery::getKTypeInMin(from_ktype);
-    KRecordList result(candles.size() / old_intervals_per_new_candle);
-    if (result.size() == 0)
-        return result;
-
-    int32_t target = 0;
-    for (size_t x = 0, total = candles.size(); x < total; ++x) {
-        if (candles[x].openPrice != 0 && candles[x].highPrice != 0 && candles[x].lowPrice != 0 &&
-            candles[x].closePrice != 0) {
-            if (result[target].datetime.isNull())
-                result[target].datetime = candles[x].datetime;
-            if (result[target].openPrice == 0)
-                result[target].openPrice = candles[x].openPrice;
-            if (candles[x].highPrice > result[target].highPrice)
-                result[target].highPrice = candles[x].highPrice;
-            if ((result[target].lowPrice == 0) || (candles[x].lowPrice < result[target].lowPrice))
-                result[target].lowPrice = candles[x].lowPrice;
-
-            result[target].transCount += candles[x].transCount;
-            result[target].transAmount += candles[x].transAmount;
-            result[target].closePrice = candles[x].closePrice;
-        }
-
-        if ((x + 1) % old_intervals_per_new_candle == 0) {
-            if ((total - x) < old_intervals_per_new_candle + 1)
-                break;
-            target++;
-        }
-    }
-
-    return result;
-}
-
-}  // namespace hku
\ No newline at end of file
+}  // namespace hku
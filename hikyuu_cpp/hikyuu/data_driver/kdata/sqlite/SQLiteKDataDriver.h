@@ -8,13 +8,16 @@
 #ifndef SQLITE_KDATA_DRIVER_H
 #define SQLITE_KDATA_DRIVER_H
 
+#include "../../../MarketInfo.h"
+#include "../../../KRecordResampler.h"
 #include "../../../utilities/db_connect/DBConnect.h"
 #include "../../../utilities/db_connect/sqlite/SQLiteConnect.h"
 #include "../../KDataDriver.h"
+#include "../KRecordTableReader.h"
 
 namespace hku {
 
-class SQLiteKDataDriver : public KDataDriver {
+class HKU_API SQLiteKDataDriver : public KDataDriver {
 public:
     SQLiteKDataDriver();
     virtual ~SQLiteKDataDriver();
@@ -44,17 +47,34 @@ public:
 
 private:
     string _getTableName(const string& market, const string& code, KQuery::KType ktype);
+
+    size_t _getCount(const string& market, const string& code, const KQuery::KType& kType);
+
+    // 将基础K线的新增部分追加至合成状态，返回全部合成K线
+    const KRecordList& _getConvertedKRecordList(const string& market, const string& code,
+                                                const KQuery::KType& ktype);
+
     KRecordList _getKRecordList(const string& market, const string& code,
                                 const KQuery::KType& kType, size_t start_ix, size_t end_ix);
     KRecordList _getKRecordList(const string& market, const string& code,
                                 const KQuery::KType& ktype, Datetime start_date, Datetime end_date);
-    static KRecordList convertToNewInterval(const KRecordList& candles,
-                                            const KQuery::KType& from_type,
-                                            const KQuery::KType& to_ktype);
 
 private:
     unordered_map<string, SQLiteConnectPtr> m_sqlite_connection_map;  // key: exchange+code
+    KRecordTableReader m_reader;  // 预编译语句及位置索引缓存
     bool m_ifConvert = false;
+    MarketInfo m_session;  // 合成日内K线时使用的交易时段，由参数 session 指定
+
+    // 单个证券单个合成K线类型的增量合成状态
+    struct ConvertState {
+        ConvertState(const KQuery::KType& ktype, const MarketInfo& session)
+        : resampler(ktype, session) {}
+
+        KRecordResampler resampler;
+        size_t base_count{0};    // 已合成的基础K线数
+        Datetime last_datetime;  // 最后一根已合成的基础K线日期
+    };
+    unordered_map<string, ConvertState> m_convert_states;  // key: market+code+ktype
 };
 
 } /* namespace hku */
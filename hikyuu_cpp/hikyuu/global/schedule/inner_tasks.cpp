@@ -6,7 +6,6 @@
  */
 
 #include "hikyuu/StockManager.h"
-#include "hikyuu/global/GlobalSpotAgent.h"
 #include "inner_tasks.h"
 #include "scheduler.h"
 
@@ -18,23 +17,8 @@ void initInnerTask() {
 }
 
 void reloadHikyuuTask() {
-    // 先停止行情接收
-    auto* agent = getGlobalSpotAgent();
-    bool agent_running = agent->isRunning();
-    if (agent_running) {
-        agent->stop();
-    }
-
-    // 重新加载数据
+    // 热加载，行情接收无需停止，加载期间追加的实时K线会补入新的证券实例
     StockManager::instance().reload();
-
-    // 重新启动行情接收
-    if (agent_running) {
-        bool print = agent->getPrintFlag();
-        size_t work_num = agent->getWorkerNum();
-        const string& addr = agent->getServerAddr();
-        startSpotAgent(print, work_num, addr);
-    }
 }
 
 }  // namespace hku
\ No newline at end of file
@@ -53,6 +53,12 @@ void HKU_API getConfigFromIni(const string& config_file_name, Parameter& basePar
     hkuParam.set<bool>("load_history_finance",
                        config.getBool("hikyuu", "load_history_finance", "True"));
 
+    // 跨进程共享K线缓存，为空时不启用
+    if (config.hasOption("hikyuu", "shm_kdata")) {
+        hkuParam.set<string>("shm_kdata", config.get("hikyuu", "shm_kdata"));
+    }
+    hkuParam.set<bool>("shm_kdata_keep", config.getBool("hikyuu", "shm_kdata_keep", "False"));
+
     IniParser::StringListPtr option = config.getOptionList("baseinfo");
     for (auto iter = option->begin(); iter != option->end(); ++iter) {
         string value = config.get("baseinfo", *iter);
@@ -0,0 +1,178 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#include <cstring>
+#include "hikyuu/utilities/thread/algorithm.h"
+#include "crt/ALIGN.h"
+#include "BlockPanel.h"
+
+namespace hku {
+
+BlockPanel::BlockPanel(const StockList& stks, const DatetimeList& dates)
+: m_stks(stks), m_index(makeDatetimeIndex(dates)) {
+    m_data.resize(m_stks.size() * m_index->size(), Null<value_t>());
+}
+
+void BlockPanel::load(const Indicator& ind, const KQuery& query, bool fill_null) {
+    size_t len = m_index->size();
+    HKU_IF_RETURN(len == 0 || m_stks.empty(), void());
+
+    // 各证券直接写入各自的行，不保留中间的指标列表
+    parallel_for_index_void(
+      0, m_stks.size(), [this, nind = ind.clone(), &query, fill_null, len](size_t index) {
+          auto k = m_stks[index].getKData(query);
+          Indicator value = ALIGN(nind, m_index, fill_null)(k);
+          if (value.empty()) {
+              return;
+          }
+          if (value.size() != len) {
+              HKU_WARN("Ignore stock: {}, value len: {}, dst len: {}",
+                       m_stks[index].market_code(), value.size(), len);
+              return;
+          }
+          memcpy(row(index), value.data(), len * sizeof(value_t));
+      });
+}
+
+void BlockPanel::_sumCount(value_t* acc, value_t* count) const {
+    size_t len = m_index->size();
+    for (size_t i = 0; i < len; i++) {
+        acc[i] = 0.0;
+        count[i] = 0.0;
+    }
+
+    for (size_t s = 0, total = m_stks.size(); s < total; s++) {
+        const value_t* src = row(s);
+        for (size_t i = 0; i < len; i++) {
+            value_t v = src[i];
+            bool valid = v == v;
+            acc[i] += valid ? v : 0.0;
+            count[i] += valid ? 1.0 : 0.0;
+        }
+    }
+}
+
+template <class Compare>
+void BlockPanel::_compareCount(const value_t* x, value_t* hit, value_t* count,
+                               Compare cmp) const {
+    size_t len = m_index->size();
+    for (size_t i = 0; i < len; i++) {
+        hit[i] = 0.0;
+        count[i] = 0.0;
+    }
+
+    // Null 参与任何比较均为 false，无需额外判断
+    for (size_t s = 0, total = m_stks.size(); s < total; s++) {
+        const value_t* src = row(s);
+        for (size_t i = 0; i < len; i++) {
+            value_t v = src[i];
+            hit[i] += cmp(v, x[i]) ? 1.0 : 0.0;
+            count[i] += v == v ? 1.0 : 0.0;
+        }
+    }
+}
+
+void BlockPanel::sum(value_t* dst) const {
+    size_t len = m_index->size();
+    vector<value_t> count(len);
+    _sumCount(dst, count.data());
+    for (size_t i = 0; i < len; i++) {
+        dst[i] = count[i] > 0.0 ? dst[i] : Null<value_t>();
+    }
+}
+
+void BlockPanel::mean(value_t* dst) const {
+    size_t len = m_index->size();
+    vector<value_t> count(len);
+    _sumCount(dst, count.data());
+    for (size_t i = 0; i < len; i++) {
+        dst[i] = count[i] > 0.0 ? dst[i] / count[i] : Null<value_t>();
+    }
+}
+
+void BlockPanel::max(value_t* dst) const {
+    size_t len = m_index->size();
+    for (size_t i = 0; i < len; i++) {
+        dst[i] = Null<value_t>();
+    }
+    for (size_t s = 0, total = m_stks.size(); s < total; s++) {
+        const value_t* src = row(s);
+        for (size_t i = 0; i < len; i++) {
+            value_t v = src[i], cur = dst[i];
+            dst[i] = (v > cur || cur != cur) ? v : cur;
+        }
+    }
+}
+
+void BlockPanel::min(value_t* dst) const {
+    size_t len = m_index->size();
+    for (size_t i = 0; i < len; i++) {
+        dst[i] = Null<value_t>();
+    }
+    for (size_t s = 0, total = m_stks.size(); s < total; s++) {
+        const value_t* src = row(s);
+        for (size_t i = 0; i < len; i++) {
+            value_t v = src[i], cur = dst[i];
+            dst[i] = (v < cur || cur != cur) ? v : cur;
+        }
+    }
+}
+
+void BlockPanel::rank(const value_t* x, value_t* dst) const {
+    size_t len = m_index->size();
+    vector<value_t> count(len);
+    _compareCount(x, dst, count.data(), [](value_t v, value_t cur) { return v > cur; });
+    for (size_t i = 0; i < len; i++) {
+        dst[i] = (count[i] > 0.0 && x[i] == x[i]) ? dst[i] + 1.0 : Null<value_t>();
+    }
+}
+
+void BlockPanel::percentile(const value_t* x, value_t* dst) const {
+    size_t len = m_index->size();
+    vector<value_t> count(len);
+    _compareCount(x, dst, count.data(), [](value_t v, value_t cur) { return v <= cur; });
+    for (size_t i = 0; i < len; i++) {
+        dst[i] = (count[i] > 0.0 && x[i] == x[i]) ? dst[i] / count[i] : Null<value_t>();
+    }
+}
+
+void BlockPanel::demean(const value_t* x, value_t* dst) const {
+    size_t len = m_index->size();
+    mean(dst);
+    for (size_t i = 0; i < len; i++) {
+        dst[i] = x[i] - dst[i];
+    }
+}
+
+BlockMembership::BlockMembership(const StockList& stks, const DatetimeList& dates)
+: m_date_count(dates.size()) {
+    m_ranges.reserve(stks.size());
+    for (const auto& stk : stks) {
+        const Datetime& start_date = stk.startDatetime();
+        Datetime last_date = stk.lastDatetime().isNull() ? Datetime::max() : stk.lastDatetime();
+        size_t first = std::lower_bound(dates.begin(), dates.end(), start_date) - dates.begin();
+        size_t last = std::upper_bound(dates.begin(), dates.end(), last_date) - dates.begin();
+        m_ranges.emplace_back(first, std::max(first, last));
+    }
+}
+
+void BlockMembership::count(value_t* dst) const {
+    // 差分数组：区间起点 +1，终点 -1，前缀和即为每日成员数量
+    vector<int64_t> diff(m_date_count + 1, 0);
+    for (const auto& range : m_ranges) {
+        diff[range.first]++;
+        diff[range.second]--;
+    }
+
+    int64_t cur = 0;
+    for (size_t i = 0; i < m_date_count; i++) {
+        cur += diff[i];
+        dst[i] = value_t(cur);
+    }
+}
+
+}  // namespace hku
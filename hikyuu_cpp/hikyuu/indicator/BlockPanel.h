@@ -0,0 +1,176 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#pragma once
+#ifndef INDICATOR_BLOCK_PANEL_H_
+#define INDICATOR_BLOCK_PANEL_H_
+
+#include "Indicator.h"
+#include "DatetimeIndex.h"
+
+namespace hku {
+
+/**
+ * 板块横截面面板，保存各成分证券指标值对齐至同一组参考日期后的稠密矩阵
+ * @details
+ * <pre>
+ * 按 [证券][日期] 行优先连续存储，缺失值为 Null。横截面统计逐行顺序扫描，
+ * 内层循环对日期连续、无分支（以 x == x 作为有效值掩码），便于编译器自动向量化。
+ * 各项统计均忽略 Null 值，某日无任何有效值时结果为 Null。
+ * </pre>
+ * @ingroup Indicator
+ */
+class HKU_API BlockPanel {
+public:
+    typedef Indicator::value_t value_t;
+
+    /**
+     * 构造函数，所有值初始化为 Null
+     * @param stks 成分证券列表，其顺序即为面板行序
+     * @param dates 参考日期列表
+     */
+    BlockPanel(const StockList& stks, const DatetimeList& dates);
+
+    BlockPanel(const BlockPanel&) = delete;
+    BlockPanel& operator=(const BlockPanel&) = delete;
+
+    /** 证券数量（行数） */
+    size_t stockCount() const noexcept {
+        return m_stks.size();
+    }
+
+    /** 日期数量（列数） */
+    size_t dateCount() const noexcept {
+        return m_index->size();
+    }
+
+    /** 成分证券列表 */
+    const StockList& stocks() const noexcept {
+        return m_stks;
+    }
+
+    /** 指定证券的一行数据，长度为 dateCount() */
+    value_t* row(size_t stock_pos) noexcept {
+        return m_data.data() + stock_pos * m_index->size();
+    }
+
+    /** 指定证券的一行数据，长度为 dateCount() */
+    const value_t* row(size_t stock_pos) const noexcept {
+        return m_data.data() + stock_pos * m_index->size();
+    }
+
+    /**
+     * 并行计算各成分证券在指定查询范围内的指标值，按日期对齐后填入面板
+     * @param ind 指标公式
+     * @param query 查询范围
+     * @param fill_null 日期对齐时缺失数据是否填充 Null，否则取之前最近的数据
+     */
+    void load(const Indicator& ind, const KQuery& query, bool fill_null);
+
+    /** 每日有效值之和 */
+    void sum(value_t* dst) const;
+
+    /** 每日有效值的平均值 */
+    void mean(value_t* dst) const;
+
+    /** 每日有效值的最大值 */
+    void max(value_t* dst) const;
+
+    /** 每日有效值的最小值 */
+    void min(value_t* dst) const;
+
+    /**
+     * 每日 x 在成分有效值中从大到小的名次，大于 x 的有效值个数 + 1，x 为 Null 时结果为 Null
+     * @param x 待排名的值，长度为 dateCount()
+     * @param dst [out] 结果，长度为 dateCount()
+     */
+    void rank(const value_t* x, value_t* dst) const;
+
+    /**
+     * 每日成分有效值中小于等于 x 的比例，取值 [0, 1]，x 为 Null 时结果为 Null
+     * @param x 待计算的值，长度为 dateCount()
+     * @param dst [out] 结果，长度为 dateCount()
+     */
+    void percentile(const value_t* x, value_t* dst) const;
+
+    /**
+     * 每日 x 减去成分有效值的平均值
+     * @param x 待计算的值，长度为 dateCount()
+     * @param dst [out] 结果，长度为 dateCount()
+     */
+    void demean(const value_t* x, value_t* dst) const;
+
+private:
+    // 逐日累加有效值及有效值个数
+    void _sumCount(value_t* acc, value_t* count) const;
+
+    // 逐日统计有效值个数及满足 cmp(value, x) 的有效值个数
+    template <class Compare>
+    void _compareCount(const value_t* x, value_t* hit, value_t* count, Compare cmp) const;
+
+private:
+    StockList m_stks;
+    DatetimeIndexPtr m_index;
+    vector<value_t> m_data;
+};
+
+/**
+ * 板块成分按日期的成员关系，由各成分证券的上市、退市日期预先计算
+ * @details
+ * <pre>
+ * 证券在 [上市日期, 最后交易日期] 内的日期视为板块成员，未退市时截止于最后一个参考日期。
+ * 每只证券的成员日期在参考日期中为连续区间，因此按证券保存参考日期位置区间，
+ * 即为按日期成员位图的精确压缩表示，每日成员数量由差分数组一次计算。
+ * </pre>
+ * @ingroup Indicator
+ */
+class HKU_API BlockMembership {
+public:
+    typedef Indicator::value_t value_t;
+
+    /**
+     * 构造函数
+     * @param stks 成分证券列表
+     * @param dates 参考日期列表，须已升序排列
+     */
+    BlockMembership(const StockList& stks, const DatetimeList& dates);
+
+    /** 证券数量 */
+    size_t stockCount() const noexcept {
+        return m_ranges.size();
+    }
+
+    /** 日期数量 */
+    size_t dateCount() const noexcept {
+        return m_date_count;
+    }
+
+    /** 指定证券在指定日期是否为板块成员 */
+    bool isMember(size_t stock_pos, size_t date_pos) const noexcept {
+        const auto& range = m_ranges[stock_pos];
+        return date_pos >= range.first && date_pos < range.second;
+    }
+
+    /** 指定证券为板块成员的参考日期位置区间 [first, second) */
+    const std::pair<size_t, size_t>& range(size_t stock_pos) const noexcept {
+        return m_ranges[stock_pos];
+    }
+
+    /**
+     * 每日板块成员数量
+     * @param dst [out] 结果，长度为 dateCount()
+     */
+    void count(value_t* dst) const;
+
+private:
+    vector<std::pair<size_t, size_t>> m_ranges;
+    size_t m_date_count{0};
+};
+
+}  // namespace hku
+
+#endif /* INDICATOR_BLOCK_PANEL_H_ */
@@ -0,0 +1,54 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#include "ChipDistribution.h"
+
+namespace hku {
+
+double ChipDistribution::winner(price_t price, price_t base, price_t range) {
+    HKU_IF_RETURN(std::isnan(price) || std::isnan(base) || std::isnan(range), Null<double>());
+    HKU_IF_RETURN(price >= base + range, 1.0);
+    HKU_IF_RETURN(price <= base, 0.0);
+    return (price - base) / range;
+}
+
+void ChipDistribution::calculate(const KData& k, price_t* base, price_t* range) {
+    size_t total = k.size();
+    HKU_IF_RETURN(total == 0, void());
+    std::fill(base, base + total, Null<price_t>());
+    std::fill(range, range + total, Null<price_t>());
+
+    auto* kdata = k.data();
+    Datetime lastdate = kdata[total - 1].datetime.startOfDay();
+    StockWeightList sw_list = k.getStock().getWeight(Datetime::min(), lastdate + Days(1));
+    HKU_IF_RETURN(sw_list.empty(), void());
+
+    ChipDistribution chip;
+    price_t free_count = 0.0;
+    auto sw_iter = sw_list.begin();
+    for (size_t pos = 0; pos < total; pos++) {
+        const KRecord& krecord = kdata[pos];
+
+        // K线适用的流通盘为日期不大于K线日期的最后一个流通盘不为0的权息，忽略流通盘为0的权息
+        for (; sw_iter != sw_list.end() && sw_iter->datetime() <= krecord.datetime; ++sw_iter) {
+            if (sw_iter->freeCount() > 0.0) {
+                free_count = sw_iter->freeCount();
+            }
+        }
+
+        if (free_count <= 0.0) {
+            continue;
+        }
+
+        // transCount 为手数，流通股为万股
+        chip.update(krecord, krecord.transCount / free_count * 0.01);
+        base[pos] = chip.base();
+        range[pos] = chip.range();
+    }
+}
+
+}  // namespace hku
@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#pragma once
+#ifndef INDICATOR_CHIP_DISTRIBUTION_H_
+#define INDICATOR_CHIP_DISTRIBUTION_H_
+
+#include "../KData.h"
+
+namespace hku {
+
+/**
+ * 筹码分布
+ * @details
+ * <pre>
+ * 每根K线按换手率 A 衰减已有筹码，并以 A 的比例在 [收盘价, 收盘价 + (最高价 - 最低价)]
+ * 之间加入新筹码，即 COST(X) = DMA(CLOSE + (HIGH - LOW) * X%, A)。
+ * 由于各百分位使用相同的衰减系数，X% 获利盘的价格为 base + range * X%，
+ * 其中 base = DMA(CLOSE, A)，range = DMA(HIGH - LOW, A)，
+ * 只需维护这两个值即可回答任意百分位的 COST 及任意价格的 WINNER（获利盘比例）查询，
+ * 新K线到达时以 update 增量更新。
+ * </pre>
+ * @ingroup Indicator
+ */
+class HKU_API ChipDistribution {
+public:
+    ChipDistribution() = default;
+
+    /** 清空筹码 */
+    void reset() {
+        m_base = Null<price_t>();
+        m_range = Null<price_t>();
+    }
+
+    /** 是否尚无筹码 */
+    bool empty() const {
+        return std::isnan(m_base);
+    }
+
+    /**
+     * 加入一根K线，尚无筹码时以该K线初始化
+     * @param k K线记录
+     * @param turnover 换手率（0~1）
+     */
+    void update(const KRecord& k, double turnover) {
+        if (empty()) {
+            m_base = k.closePrice;
+            m_range = k.highPrice - k.lowPrice;
+        } else {
+            m_base = turnover * k.closePrice + (1.0 - turnover) * m_base;
+            m_range = turnover * (k.highPrice - k.lowPrice) + (1.0 - turnover) * m_range;
+        }
+    }
+
+    /** 0% 获利盘的价格 */
+    price_t base() const {
+        return m_base;
+    }
+
+    /** 100% 获利盘与 0% 获利盘的价格之差 */
+    price_t range() const {
+        return m_range;
+    }
+
+    /**
+     * X% 获利盘的价格，即 COST(X)
+     * @param percent 获利盘百分比（0~100）
+     */
+    price_t cost(double percent) const {
+        return m_base + m_range * percent * 0.01;
+    }
+
+    /**
+     * 以指定价格卖出的获利盘比例（0~1），即 WINNER(price)
+     * @note 尚无筹码或价格为 Null 时返回 Null
+     */
+    double winner(price_t price) const {
+        return winner(price, m_base, m_range);
+    }
+
+    /**
+     * 以指定价格卖出的获利盘比例（0~1）
+     * @param price 指定价格
+     * @param base 0% 获利盘的价格
+     * @param range 100% 获利盘与 0% 获利盘的价格之差
+     */
+    static double winner(price_t price, price_t base, price_t range);
+
+    /**
+     * 逐根计算K线的筹码分布，换手率由成交量与K线日期适用的权息流通盘计算
+     * @note 首个有流通盘数据的权息之前的K线没有筹码，输出为 Null
+     * @param k K线数据
+     * @param base 输出每根K线的 base()，长度不小于 k.size()
+     * @param range 输出每根K线的 range()，长度不小于 k.size()
+     */
+    static void calculate(const KData& k, price_t* base, price_t* range);
+
+private:
+    price_t m_base{Null<price_t>()};
+    price_t m_range{Null<price_t>()};
+};
+
+}  // namespace hku
+
+#endif /* INDICATOR_CHIP_DISTRIBUTION_H_ */
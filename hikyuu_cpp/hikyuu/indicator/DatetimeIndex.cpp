@@ -0,0 +1,54 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#include <cstring>
+#include "DatetimeIndex.h"
+
+namespace hku {
+
+DatetimeIndex::DatetimeIndex(const DatetimeList& dates) : m_dates(dates) {
+    _initTicks();
+}
+
+DatetimeIndex::DatetimeIndex(DatetimeList&& dates) : m_dates(std::move(dates)) {
+    _initTicks();
+}
+
+void DatetimeIndex::_initTicks() {
+    m_ticks.resize(m_dates.size());
+    for (size_t i = 0, total = m_dates.size(); i < total; i++) {
+        m_ticks[i] = m_dates[i].ticks();
+    }
+}
+
+bool DatetimeIndex::same(const uint64_t* src, size_t src_total) const noexcept {
+    return src_total == m_ticks.size() &&
+           (src_total == 0 || memcmp(src, m_ticks.data(), sizeof(uint64_t) * src_total) == 0);
+}
+
+void DatetimeIndex::mergeJoin(const uint64_t* src, size_t src_total, size_t start,
+                              bool fill_null, size_t* out) const {
+    const size_t null_pos = Null<size_t>();
+    const uint64_t* ref = m_ticks.data();
+    size_t total = m_ticks.size();
+
+    // j 指向下一个尚未越过的源位置，j - 1 即为不大于当前参考日期的最后一个源位置
+    size_t j = start;
+    for (size_t i = 0; i < total; i++) {
+        uint64_t cur = ref[i];
+        while (j < src_total && src[j] <= cur) {
+            j++;
+        }
+        if (j == start) {
+            out[i] = null_pos;
+        } else {
+            out[i] = (!fill_null || src[j - 1] == cur) ? j - 1 : null_pos;
+        }
+    }
+}
+
+}  // namespace hku
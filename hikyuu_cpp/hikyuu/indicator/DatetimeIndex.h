@@ -0,0 +1,86 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#pragma once
+#ifndef INDICATOR_DATETIME_INDEX_H_
+#define INDICATOR_DATETIME_INDEX_H_
+
+#include "../DataType.h"
+
+namespace hku {
+
+/**
+ * 日期索引，保存升序排列的参考日期及其预先计算的序数（Datetime::ticks）
+ * @details
+ * <pre>
+ * 创建后不可修改，多个 ALIGN 对齐至同一组参考日期时可共享同一索引，
+ * 避免每次对齐时复制日期列表并逐一比较 ptime。
+ * </pre>
+ * @ingroup Indicator
+ */
+class HKU_API DatetimeIndex {
+public:
+    explicit DatetimeIndex(const DatetimeList& dates);
+    explicit DatetimeIndex(DatetimeList&& dates);
+
+    DatetimeIndex(const DatetimeIndex&) = delete;
+    DatetimeIndex& operator=(const DatetimeIndex&) = delete;
+
+    /** 日期数量 */
+    size_t size() const noexcept {
+        return m_dates.size();
+    }
+
+    /** 是否为空 */
+    bool empty() const noexcept {
+        return m_dates.empty();
+    }
+
+    /** 参考日期列表 */
+    const DatetimeList& dates() const noexcept {
+        return m_dates;
+    }
+
+    /** 参考日期对应的序数，长度同 size() */
+    const uint64_t* ticks() const noexcept {
+        return m_ticks.data();
+    }
+
+    /**
+     * 按合并连接计算参考日期在源日期序列中对应的位置
+     * @details 对每个参考日期，取源序列 [start, src_total) 中日期不大于该参考日期的最后一个位置，
+     *          日期不相等且 fill_null 为 true，或不存在这样的位置时，对应位置为 Null<size_t>()
+     * @param src 源日期序列的序数，须已升序排列
+     * @param src_total 源日期序列长度
+     * @param start 源日期序列的起始位置
+     * @param fill_null 缺失日期是否置为 Null，否则取之前最近的数据
+     * @param out 输出位置，长度不小于 size()
+     */
+    void mergeJoin(const uint64_t* src, size_t src_total, size_t start, bool fill_null,
+                   size_t* out) const;
+
+    /** 源日期序列是否与参考日期完全相同 */
+    bool same(const uint64_t* src, size_t src_total) const noexcept;
+
+private:
+    void _initTicks();
+
+private:
+    DatetimeList m_dates;
+    vector<uint64_t> m_ticks;
+};
+
+typedef shared_ptr<const DatetimeIndex> DatetimeIndexPtr;
+
+/** 创建日期索引 */
+inline DatetimeIndexPtr makeDatetimeIndex(const DatetimeList& dates) {
+    return make_shared<const DatetimeIndex>(dates);
+}
+
+}  // namespace hku
+
+#endif /* INDICATOR_DATETIME_INDEX_H_ */
@@ -13,6 +13,7 @@
 #include "../KData.h"
 #include "../utilities/Parameter.h"
 #include "../utilities/thread/StealThreadPool.h"
+#include "../serialization/compact_archive.h"
 
 namespace hku {
 
@@ -80,11 +81,11 @@ public:
 
     value_t getByDate(Datetime, size_t num = 0);
 
-    Datetime getDatetime(size_t pos) const;
+    virtual Datetime getDatetime(size_t pos) const;
 
-    DatetimeList getDatetimeList() const;
+    virtual DatetimeList getDatetimeList() const;
 
-    size_t getPos(Datetime) const;
+    virtual size_t getPos(Datetime) const;
 
     /** 以PriceList方式获取指定的输出集 */
     PriceList getResultAsPriceList(size_t result_num);
@@ -250,6 +251,18 @@ private:
             }
         }
         ar& BOOST_SERIALIZATION_NVP(act_result_num);
+        if constexpr (is_binary_archive<Archive>::value) {
+            // 二进制存档按内存块整体写入，NaN/Inf 按位保存
+            for (size_t i = 0; i < act_result_num; ++i) {
+                size_t count = size();
+                ar& count;
+                if (count > 0) {
+                    ar.save_binary(m_pBuffer[i]->data(), count * sizeof(value_t));
+                }
+            }
+            return;
+        }
+
         string nan("nan");
         string inf;
         for (size_t i = 0; i < act_result_num; ++i) {
@@ -285,6 +298,21 @@ private:
 
         size_t act_result_num = 0;
         ar& BOOST_SERIALIZATION_NVP(act_result_num);
+        if constexpr (is_binary_archive<Archive>::value) {
+            if (version >= 1) {
+                for (size_t i = 0; i < act_result_num; ++i) {
+                    m_pBuffer[i] = new vector<value_t>();
+                    size_t count = 0;
+                    ar& count;
+                    m_pBuffer[i]->resize(count);
+                    if (count > 0) {
+                        ar.load_binary(m_pBuffer[i]->data(), count * sizeof(value_t));
+                    }
+                }
+                return;
+            }
+        }
+
         for (size_t i = 0; i < act_result_num; ++i) {
             m_pBuffer[i] = new vector<value_t>();
             size_t count = 0;
@@ -409,6 +437,11 @@ inline size_t IndicatorImp::_get_step_start(size_t pos, size_t step, size_t disc
 
 } /* namespace hku */
 
+#if HKU_SUPPORT_SERIALIZATION
+// 版本 1: 二进制存档下指标结果按内存块保存
+BOOST_CLASS_VERSION(hku::IndicatorImp, 1)
+#endif
+
 #if FMT_VERSION >= 90000
 template <>
 struct fmt::formatter<hku::IndicatorImp> : ostream_formatter {};
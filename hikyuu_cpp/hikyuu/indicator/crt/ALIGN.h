@@ -12,6 +12,7 @@
 #define INDICATOR_CRT_ALIGN_H_
 
 #include "../Indicator.h"
+#include "../DatetimeIndex.h"
 
 namespace hku {
 
@@ -25,6 +26,13 @@ Indicator ALIGN(const Indicator& ind, const DatetimeList& ref, bool fill_null =
 Indicator ALIGN(const Indicator& ind, const Indicator& ref, bool fill_null = true);
 Indicator ALIGN(const Indicator& ind, const KData& ref, bool fill_null = true);
 
+/**
+ * 按共享的日期索引对齐，大量指标对齐至相同日期时，应预先创建索引并共享使用
+ * @ingroup Indicator
+ */
+Indicator HKU_API ALIGN(const DatetimeIndexPtr& ref, bool fill_null = true);
+Indicator ALIGN(const Indicator& ind, const DatetimeIndexPtr& ref, bool fill_null = true);
+
 inline Indicator ALIGN(const Indicator& ind, const DatetimeList& ref, bool fill_null) {
     return ALIGN(ref, fill_null)(ind);
 }
@@ -37,6 +45,10 @@ inline Indicator ALIGN(const Indicator& ind, const KData& ref, bool fill_null) {
     return ALIGN(ref.getDatetimeList(), fill_null)(ind);
 }
 
+inline Indicator ALIGN(const Indicator& ind, const DatetimeIndexPtr& ref, bool fill_null) {
+    return ALIGN(ref, fill_null)(ind);
+}
+
 }  // namespace hku
 
 #endif /* INDICATOR_CRT_ALIGN_H_ */
@@ -12,23 +12,31 @@
 namespace hku {
 
 /**
- * 返回板块各成分该指标相应输出按计算类型得到的计算值.计算类型:0-累加,1-平均数,2-最大值,3-最小值.
+ * 返回板块各成分该指标相应输出按计算类型得到的计算值.
+ * 计算类型:0-累加,1-平均数,2-最大值,3-最小值,4-排名,5-百分位,6-去均值.
  * @param block 指定板块
  * @param query 指定范围
  * @param ind 指定指标
- * @param mode 计算类型:0-累加,1-平均数,2-最大值,3-最小值.
+ * @param mode 计算类型:0-累加,1-平均数,2-最大值,3-最小值,4-排名,5-百分位,6-去均值.
  * @param fill_null 日期对齐时缺失数据填充 nan 值。
+ * @note 4-排名、5-百分位、6-去均值为上下文证券自身指标值相对板块成分的横截面值：
+ *       排名为从大到小的名次，百分位为成分中小于等于自身值的比例，去均值为自身值减去成分平均值，
+ *       须在上下文中计算。
  * @return Indicator
  */
 Indicator HKU_API INSUM(const Block& block, const KQuery& query, const Indicator& ind, int mode,
                         bool fill_null = true);
 
 /**
- * 返回板块各成分该指标相应输出按计算类型得到的计算值.计算类型:0-累加,1-平均数,2-最大值,3-最小值.
+ * 返回板块各成分该指标相应输出按计算类型得到的计算值.
+ * 计算类型:0-累加,1-平均数,2-最大值,3-最小值,4-排名,5-百分位,6-去均值.
  * @param block 指定板块
  * @param ind 指定指标
- * @param mode 计算类型:0-累加,1-平均数,2-最大值,3-最小值.
+ * @param mode 计算类型:0-累加,1-平均数,2-最大值,3-最小值,4-排名,5-百分位,6-去均值.
  * @param fill_null 日期对齐时缺失数据填充 nan 值。
+ * @note 4-排名、5-百分位、6-去均值为上下文证券自身指标值相对板块成分的横截面值：
+ *       排名为从大到小的名次，百分位为成分中小于等于自身值的比例，去均值为自身值减去成分平均值，
+ *       须在上下文中计算。
  * @return Indicator
  */
 Indicator HKU_API INSUM(const Block& block, const Indicator& ind, int mode, bool fill_null = true);
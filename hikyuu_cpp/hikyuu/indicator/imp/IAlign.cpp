@@ -20,19 +20,114 @@ IAlign::IAlign() : IndicatorImp("ALIGN") {
     setParam<bool>("fill_null", true);  // 缺失的数据是否使用 nan 填充
 }
 
+IAlign::IAlign(const DatetimeIndexPtr& ref) : IndicatorImp("ALIGN") {
+    // 日期以索引为准，不再复制到参数中
+    setParam<DatetimeList>("align_date_list", DatetimeList());
+    setParam<bool>("fill_null", true);
+    m_ref_index = ref;
+    m_from_param = !ref;
+}
+
 IAlign::~IAlign() {}
 
+void IAlign::_checkParam(const string& name) const {
+    if ("align_date_list" == name) {
+        // 参数被重新设置，此前的索引失效
+        m_ref_index.reset();
+        m_from_param = true;
+    }
+}
+
+IndicatorImpPtr IAlign::_clone() {
+    auto p = make_shared<IAlign>();
+    p->m_ref_index = m_ref_index;
+    p->m_from_param = m_from_param;
+    return p;
+}
+
+DatetimeIndexPtr IAlign::getRefIndex() const {
+    return m_from_param ? DatetimeIndexPtr() : m_ref_index;
+}
+
+Datetime IAlign::getDatetime(size_t pos) const {
+    DatetimeIndexPtr ref_index = getRefIndex();
+    HKU_IF_RETURN(!ref_index, IndicatorImp::getDatetime(pos));
+    return pos < ref_index->size() ? ref_index->dates()[pos] : Null<Datetime>();
+}
+
+DatetimeList IAlign::getDatetimeList() const {
+    DatetimeIndexPtr ref_index = getRefIndex();
+    return ref_index ? ref_index->dates() : IndicatorImp::getDatetimeList();
+}
+
+size_t IAlign::getPos(Datetime date) const {
+    DatetimeIndexPtr ref_index = getRefIndex();
+    HKU_IF_RETURN(!ref_index, IndicatorImp::getPos(date));
+    const DatetimeList& dates = ref_index->dates();
+    auto iter = std::lower_bound(dates.begin(), dates.end(), date);
+    return iter != dates.end() && *iter == date ? iter - dates.begin() : Null<size_t>();
+}
+
+/* 直接引用参数中的日期列表，避免复制，不存在时返回 nullptr */
+static const DatetimeList* getAlignDateList(const Parameter& param) {
+    for (auto iter = param.begin(); iter != param.end(); ++iter) {
+        if (iter->first == "align_date_list") {
+            return boost::any_cast<DatetimeList>(&iter->second);
+        }
+    }
+    return nullptr;
+}
+
+/* 获取指标日期序列的序数，取值来源同 IndicatorImp::getDatetimeList */
+static void getDatetimeTicks(const Indicator& ind, vector<uint64_t>& ticks) {
+    ticks.clear();
+    auto imp = ind.getImp();
+    HKU_IF_RETURN(!imp, void());
+
+    const IAlign* align = dynamic_cast<const IAlign*>(imp.get());
+    DatetimeIndexPtr ref_index = align ? align->getRefIndex() : DatetimeIndexPtr();
+    if (ref_index) {
+        ticks.assign(ref_index->ticks(), ref_index->ticks() + ref_index->size());
+        return;
+    }
+
+    const DatetimeList* dates = getAlignDateList(imp->getParameter());
+    if (dates) {
+        ticks.resize(dates->size());
+        for (size_t i = 0, total = dates->size(); i < total; i++) {
+            ticks[i] = (*dates)[i].ticks();
+        }
+        return;
+    }
+
+    KData k = ind.getContext();
+    size_t total = k.size();
+    HKU_IF_RETURN(total == 0, void());
+    const KRecord* ks = k.data();
+    ticks.resize(total);
+    for (size_t i = 0; i < total; i++) {
+        ticks[i] = ks[i].datetime.ticks();
+    }
+}
+
 void IAlign::_calculate(const Indicator& ind) {
     // ref_date_list 参数会影响 IndicatorImp 全局，勿随意修改
-    DatetimeList dates = getParam<DatetimeList>("align_date_list");
-    size_t total = dates.size();
-
-    // 如果 align_date_list 无效，则尝试取自身上下文中的日期作为参考日期
-    if (0 == total) {
-        dates = getContext().getDatetimeList();
-        total = dates.size();
+    DatetimeIndexPtr ref_index = getRefIndex();
+    if (!ref_index) {
+        const DatetimeList* param_dates = getAlignDateList(m_params);
+        if (param_dates && !param_dates->empty()) {
+            // 参数被设置时索引已清空（见 _checkParam），仅在首次计算时建立
+            if (!m_ref_index) {
+                m_ref_index = makeDatetimeIndex(*param_dates);
+            }
+            ref_index = m_ref_index;
+        } else {
+            // 如果 align_date_list 无效，则尝试取自身上下文中的日期作为参考日期
+            ref_index = make_shared<const DatetimeIndex>(getContext().getDatetimeList());
+        }
     }
 
+    size_t total = ref_index->size();
     m_result_num = ind.getResultNumber();
     _readyBuffer(total, m_result_num);
 
@@ -48,8 +143,9 @@ void IAlign::_calculate(const Indicator& ind) {
     // 1.如果 fill_null, 则直接返回，m_discard 标记全部
     // 2.数据长度小于等于日期序列长度，则按右对齐，即最后的数据对应最后的日期，前面缺失的数据做抛弃处理
     // 3.数据长度大于日期序列长度，按右对其，前面超出日期序列的数据丢弃
-    DatetimeList ind_dates = ind.getDatetimeList();
-    if (ind_dates.size() == 0) {
+    vector<uint64_t> ind_ticks;
+    getDatetimeTicks(ind, ind_ticks);
+    if (ind_ticks.size() == 0) {
         if (fill_null) {
             m_discard = total;
             return;
@@ -77,9 +173,8 @@ void IAlign::_calculate(const Indicator& ind) {
             for (size_t r = 0; r < m_result_num; r++) {
                 auto const* src = ind.data(r);
                 auto* dst = this->data(r);
-                for (size_t i = m_discard; i < total; i++) {
-                    dst[i] = src[i + offset];
-                }
+                memcpy(dst + m_discard, src + m_discard + offset,
+                       sizeof(IndicatorImp::value_t) * (total - m_discard));
             }
             return;
         }
@@ -88,64 +183,45 @@ void IAlign::_calculate(const Indicator& ind) {
     // 其它有上下文日期对应的指标数据
     // 1. 如果没有刚好相等的日期，则取小于对应日期且最靠近对应日期的数据
     // 2. 如果有对应的日期，取对应日期的数据
-    size_t ind_idx = ind.discard();
-    for (size_t i = 0; i < total; i++) {
-        if (ind_idx >= ind_total) {
-            if (!fill_null) {
-                size_t pos = ind_total - 1;
-                for (size_t r = 0; r < m_result_num; r++) {
-                    for (size_t j = i; j < total; j++) {
-                        _set(ind.get(pos, r), j, r);
-                    }
-                }
-            }
-            break;
+    size_t ind_discard = ind.discard();
+    size_t src_total = std::min(ind_ticks.size(), ind_total);
+    size_t start = 0;
+    if (ref_index->same(ind_ticks.data(), src_total)) {
+        // 日期完全相同，无需对齐
+        start = ind_discard < total ? ind_discard : total;
+        for (size_t r = 0; r < m_result_num; r++) {
+            memcpy(this->data(r) + start, ind.data(r) + start,
+                   sizeof(IndicatorImp::value_t) * (total - start));
         }
 
-        const Datetime& ind_date = ind_dates[ind_idx];
-        if (ind_date == dates[i]) {
-            for (size_t r = 0; r < m_result_num; r++) {
-                _set(ind.get(ind_idx, r), i, r);
-            }
-            ind_idx++;
-
-        } else if (ind_date < dates[i]) {
-            size_t j = ind_idx + 1;
-            while (j < ind_total && ind_dates[j] < dates[i]) {
-                j++;
-            }
-
-            if (j >= ind_total) {
-                if (!fill_null) {
-                    for (size_t r = 0; r < m_result_num; r++) {
-                        price_t val = ind.get(j - 1, r);
-                        for (; i < total; i++) {
-                            _set(val, i, r);
-                        }
-                    }
+    } else {
+        vector<size_t> pos(total);
+        ref_index->mergeJoin(ind_ticks.data(), src_total, ind_discard, fill_null, pos.data());
+        const size_t null_pos = Null<size_t>();
+        for (size_t r = 0; r < m_result_num; r++) {
+            auto const* src = ind.data(r);
+            auto* dst = this->data(r);
+            size_t i = 0;
+            while (i < total) {
+                size_t p = pos[i];
+                if (p == null_pos) {
+                    i++;
+                    continue;
                 }
-                break;
-            }
 
-            if (ind_dates[j] == dates[i]) {
-                for (size_t r = 0; r < m_result_num; r++) {
-                    _set(ind.get(j, r), i, r);
-                }
-            } else if (!fill_null) {
-                for (size_t r = 0; r < m_result_num; r++) {
-                    _set(ind.get(j - 1, r), i, r);
+                // 源数据位置连续的一段整体复制
+                size_t len = 1;
+                while (i + len < total && pos[i + len] == p + len) {
+                    len++;
                 }
+                memcpy(dst + i, src + p, sizeof(IndicatorImp::value_t) * len);
+                i += len;
             }
-
-            ind_idx = j + 1;
         }
     }
 
-    if (fill_null) {
-        m_discard = total;
-    }
-    size_t i = 0;
-    while (i < total) {
+    m_discard = total;
+    for (size_t i = start; i < total; i++) {
         size_t not_null_count = 0;
         for (size_t r = 0; r < m_result_num; r++) {
             if (!std::isnan(get(i, r))) {
@@ -156,10 +232,6 @@ void IAlign::_calculate(const Indicator& ind) {
             m_discard = i;
             break;
         }
-        i++;
-    }
-    if (i == total) {
-        m_discard = total;
     }
 }
 
@@ -170,8 +242,14 @@ Indicator HKU_API ALIGN(bool fill_null) {
 }
 
 Indicator HKU_API ALIGN(const DatetimeList& ref, bool fill_null) {
-    IndicatorImpPtr p = make_shared<IAlign>();
-    p->setParam<DatetimeList>("align_date_list", ref);
+    IndicatorImpPtr p = make_shared<IAlign>(makeDatetimeIndex(ref));
+    p->setParam<bool>("fill_null", fill_null);
+    return Indicator(p);
+}
+
+Indicator HKU_API ALIGN(const DatetimeIndexPtr& ref, bool fill_null) {
+    HKU_CHECK(ref, "The ref datetime index is null!");
+    IndicatorImpPtr p = make_shared<IAlign>(ref);
     p->setParam<bool>("fill_null", fill_null);
     return Indicator(p);
 }
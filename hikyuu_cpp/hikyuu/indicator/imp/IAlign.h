@@ -12,17 +12,70 @@
 #define INDICATOR_IMP_IALIGH_H_
 
 #include "../Indicator.h"
+#include "../DatetimeIndex.h"
 
 namespace hku {
 
 class IAlign : public IndicatorImp {
-    INDICATOR_IMP(IAlign)
-    INDICATOR_IMP_NO_PRIVATE_MEMBER_SERIALIZATION
-
 public:
     IAlign();
+    explicit IAlign(const DatetimeIndexPtr& ref);
     virtual ~IAlign();
+
+    virtual void _checkParam(const string& name) const override;
+    virtual void _calculate(const Indicator& data) override;
+    virtual IndicatorImpPtr _clone() override;
+
+    virtual Datetime getDatetime(size_t pos) const override;
+    virtual DatetimeList getDatetimeList() const override;
+    virtual size_t getPos(Datetime) const override;
+
+    /** 由日期索引构造且未修改 align_date_list 参数时返回该索引，否则返回空 */
+    DatetimeIndexPtr getRefIndex() const;
+
+private:
+    // 参照日期索引（不可修改，克隆时共享）
+    // 由日期索引构造时 align_date_list 参数为空，以此索引为准；否则为参数日期列表的索引，
+    // 计算时按需建立，align_date_list 参数被设置时清空
+    mutable DatetimeIndexPtr m_ref_index;
+    mutable bool m_from_param{true};  // m_ref_index 是否来自 align_date_list 参数
+
+//============================================
+// 序列化支持
+//============================================
+#if HKU_SUPPORT_SERIALIZATION
+private:
+    friend class boost::serialization::access;
+    template <class Archive>
+    void save(Archive& ar, const unsigned int version) const {
+        ar& BOOST_SERIALIZATION_BASE_OBJECT_NVP(IndicatorImp);
+        // 由日期索引构造时参数中无日期，单独保存索引的日期
+        DatetimeIndexPtr ref_index = getRefIndex();
+        DatetimeList ref_dates = ref_index ? ref_index->dates() : DatetimeList();
+        ar& BOOST_SERIALIZATION_NVP(ref_dates);
+    }
+
+    template <class Archive>
+    void load(Archive& ar, const unsigned int version) {
+        ar& BOOST_SERIALIZATION_BASE_OBJECT_NVP(IndicatorImp);
+        DatetimeList ref_dates;
+        if (version >= 1) {
+            ar& BOOST_SERIALIZATION_NVP(ref_dates);
+        }
+        m_from_param = ref_dates.empty();
+        m_ref_index = m_from_param ? DatetimeIndexPtr()
+                                   : make_shared<const DatetimeIndex>(std::move(ref_dates));
+    }
+
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
+#endif
 };
 
 } /* namespace hku */
+
+#if HKU_SUPPORT_SERIALIZATION
+// 版本 1: 由日期索引构造时保存索引的日期
+BOOST_CLASS_VERSION(hku::IAlign, 1)
+#endif
+
 #endif /* INDICATOR_IMP_IALIGH_H_ */
@@ -9,6 +9,7 @@
 
 #include "IBlockSetNum.h"
 #include "../Indicator.h"
+#include "../BlockPanel.h"
 #include "../../StockManager.h"
 
 #if HKU_SUPPORT_SERIALIZATION
@@ -53,21 +54,8 @@ void IBlockSetNum::_calculate(const Indicator& ind) {
     _readyBuffer(total, 1);
     HKU_IF_RETURN(total == 0, void());
 
-    value_t zero = 0.0;
-    auto* dst = this->data();
-    for (size_t i = 0; i < total; i++) {
-        dst[i] = zero;
-    }
-
-    for (auto iter = block.begin(); iter != block.end(); ++iter) {
-        const Datetime& start_date = iter->startDatetime();
-        Datetime last_date = iter->lastDatetime().isNull() ? Datetime::max() : iter->lastDatetime();
-        for (size_t i = 0; i < total; i++) {
-            if (dates[i] >= start_date && dates[i] <= last_date) {
-                dst[i]++;
-            }
-        }
-    }
+    BlockMembership membership(block.getStockList(), dates);
+    membership.count(this->data());
 }
 
 Indicator HKU_API BLOCKSETNUM(const Block& block, const KQuery& query) {
@@ -82,11 +82,12 @@ void IIc::_calculate(const Indicator& inputInd) {
     vector<Indicator> all_returns(stk_count);  // 保存每支证券对齐后的 n 日收益率
     Indicator ind = inputInd;
     size_t discard = n;
+    DatetimeIndexPtr ref_index = makeDatetimeIndex(ref_dates);
     for (size_t i = 0; i < stk_count; i++) {
         auto k = m_stks[i].getKData(m_query);
-        all_inds[i] = ALIGN(ind(k), ref_dates, fill_null);
+        all_inds[i] = ALIGN(ind(k), ref_index, fill_null);
         // 计算 n 日收益率，同时需要右移 n 位，即第 i 日的因子值和第 i + n 的收益率对应
-        all_returns[i] = ALIGN(REF(ROCP(k.close(), n), n), ref_dates, fill_null);
+        all_returns[i] = ALIGN(REF(ROCP(k.close(), n), n), ref_index, fill_null);
     }
 
     m_discard = discard;
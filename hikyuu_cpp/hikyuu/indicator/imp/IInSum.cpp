@@ -7,10 +7,9 @@
  *      Author: fasiondog
  */
 
-#include "hikyuu/utilities/thread/thread.h"
 #include "IInSum.h"
 #include "../Indicator.h"
-#include "../crt/ALIGN.h"
+#include "../BlockPanel.h"
 #include "../../StockManager.h"
 
 #if HKU_SUPPORT_SERIALIZATION
@@ -37,127 +36,7 @@ void IInSum::_checkParam(const string& name) const {
         HKU_CHECK(market_info != Null<MarketInfo>(), "Invalid market: {}", market);
     } else if ("mode" == name) {
         int mode = getParam<int>("mode");
-        HKU_ASSERT(mode == 0 || mode == 1 || mode == 2 || mode == 3);
-    }
-}
-
-static IndicatorList getAllIndicators(const Block& block, const KQuery& query,
-                                      const DatetimeList& dates, const Indicator& ind,
-                                      bool fill_null) {
-#if 0                                        
-    IndicatorList ret;
-    for (auto iter = block.begin(); iter != block.end(); ++iter) {
-        auto k = iter->getKData(query);
-        ret.emplace_back(ALIGN(ind, dates, fill_null)(k));
-    }
-    return ret;
-#else
-    auto stks = block.getStockList();
-    return parallel_for_index(0, stks.size(),
-                              [nind = ind.clone(), fill_null, &stks, &query, &dates](size_t index) {
-                                  auto k = stks[index].getKData(query);
-                                  return ALIGN(nind, dates, fill_null)(k);
-                              });
-#endif
-}
-
-static void insum_cum(const IndicatorList& inds, Indicator::value_t* dst, size_t len) {
-    for (const auto& value : inds) {
-        if (value.empty()) {
-            continue;
-        }
-        if (value.size() != len) {
-            HKU_WARN("Ignore stock: {}, value len: {}, dst len: {}",
-                     value.getContext().getStock().market_code(), value.size(), len);
-            continue;
-        }
-        const auto* data = value.data();
-        for (size_t i = 0; i < len; i++) {
-            if (!std::isnan(data[i])) {
-                if (std::isnan(dst[i])) {
-                    dst[i] = data[i];
-                } else {
-                    dst[i] += data[i];
-                }
-            }
-        }
-    }
-}
-
-static void insum_mean(const IndicatorList& inds, Indicator::value_t* dst, size_t len) {
-    vector<size_t> count(len, 0);
-    for (const auto& value : inds) {
-        if (value.empty()) {
-            continue;
-        }
-        if (value.size() != len) {
-            HKU_WARN("Ignore stock: {}, value len: {}, dst len: {}",
-                     value.getContext().getStock().market_code(), value.size(), len);
-            continue;
-        }
-        const auto* data = value.data();
-        for (size_t i = 0; i < len; i++) {
-            if (!std::isnan(data[i])) {
-                if (std::isnan(dst[i])) {
-                    dst[i] = data[i];
-                } else {
-                    dst[i] += data[i];
-                }
-                count[i]++;
-            }
-        }
-    }
-
-    for (size_t i = 0; i < len; i++) {
-        if (!std::isnan(dst[i])) {
-            dst[i] = dst[i] / count[i];
-        }
-    }
-}
-
-static void insum_max(const IndicatorList& inds, Indicator::value_t* dst, size_t len) {
-    for (const auto& value : inds) {
-        if (value.empty()) {
-            continue;
-        }
-        if (value.size() != len) {
-            HKU_WARN("Ignore stock: {}, value len: {}, dst len: {}",
-                     value.getContext().getStock().market_code(), value.size(), len);
-            continue;
-        }
-        const auto* data = value.data();
-        for (size_t i = 0; i < len; i++) {
-            if (!std::isnan(data[i])) {
-                if (std::isnan(dst[i])) {
-                    dst[i] = data[i];
-                } else if (data[i] > dst[i]) {
-                    dst[i] = data[i];
-                }
-            }
-        }
-    }
-}
-
-static void insum_min(const IndicatorList& inds, Indicator::value_t* dst, size_t len) {
-    for (const auto& value : inds) {
-        if (value.empty()) {
-            continue;
-        }
-        if (value.size() != len) {
-            HKU_WARN("Ignore stock: {}, value len: {}, dst len: {}",
-                     value.getContext().getStock().market_code(), value.size(), len);
-            continue;
-        }
-        const auto* data = value.data();
-        for (size_t i = 0; i < len; i++) {
-            if (!std::isnan(data[i])) {
-                if (std::isnan(dst[i])) {
-                    dst[i] = data[i];
-                } else if (data[i] < dst[i]) {
-                    dst[i] = data[i];
-                }
-            }
-        }
+        HKU_ASSERT(mode >= 0 && mode <= 6);
     }
 }
 
@@ -183,17 +62,29 @@ void IInSum::_calculate(const Indicator& ind) {
     HKU_IF_RETURN(total == 0, void());
 
     int mode = getParam<int>("mode");
-    auto inds = getAllIndicators(block, q, dates, ind, getParam<bool>("fill_null"));
+    BlockPanel panel(block.getStockList(), dates);
+    panel.load(ind, q, getParam<bool>("fill_null"));
     auto* dst = this->data();
 
     if (0 == mode) {
-        insum_cum(inds, dst, total);
+        panel.sum(dst);
     } else if (1 == mode) {
-        insum_mean(inds, dst, total);
+        panel.mean(dst);
     } else if (2 == mode) {
-        insum_max(inds, dst, total);
+        panel.max(dst);
     } else if (3 == mode) {
-        insum_min(inds, dst, total);
+        panel.min(dst);
+    } else if (mode >= 4 && mode <= 6) {
+        // 排名、百分位、去均值均针对上下文证券自身的指标值
+        if (ignore_context || k.empty() || ind.size() != total) {
+            HKU_WARN("Mode {} requires a context matching the dates!", mode);
+        } else if (4 == mode) {
+            panel.rank(ind.data(), dst);
+        } else if (5 == mode) {
+            panel.percentile(ind.data(), dst);
+        } else {
+            panel.demean(ind.data(), dst);
+        }
     } else {
         HKU_ERROR("Not support mode: {}", mode);
     }
@@ -42,22 +42,36 @@ void ITimeLine::_calculate(const Indicator& data) {
     KQuery q = k.getQuery();
     Stock stk = k.getStock();
 
-    TimeLineList time_line = stk.getTimeLineList(q);
-    size_t total = time_line.size();
+    // 分批读取分时线，避免长周期查询时一次性载入全部记录
+    TimeLineListCursor cursor = stk.getTimeLineListCursor(q);
+    size_t total = cursor.total();
     HKU_IF_RETURN(total == 0, void());
 
     _readyBuffer(total, 1);
     auto* dst = this->data();
 
     m_discard = 0;
-    if (getParam<string>("part") == "price") {
-        for (size_t i = m_discard; i < total; i++) {
-            dst[i] = time_line[i].price;
-        }
-    } else {
-        for (size_t i = m_discard; i < total; i++) {
-            dst[i] = time_line[i].vol;
+    bool is_price = getParam<string>("part") == "price";
+    size_t pos = 0;
+    TimeLineList batch;
+    while (pos < total && cursor.next(batch)) {
+        size_t count = std::min(batch.size(), total - pos);
+        if (is_price) {
+            for (size_t i = 0; i < count; i++) {
+                dst[pos + i] = batch[i].price;
+            }
+        } else {
+            for (size_t i = 0; i < count; i++) {
+                dst[pos + i] = batch[i].vol;
+            }
         }
+        pos += count;
+    }
+
+    if (pos < total) {
+        HKU_WARN("Expected {} timeline records of {}, but only {} were read!", total,
+                 stk.market_code(), pos);
+        m_pBuffer[0]->resize(pos);
     }
 }
 
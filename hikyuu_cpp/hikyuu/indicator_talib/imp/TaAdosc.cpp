@@ -6,6 +6,7 @@
  */
 
 #include <ta-lib/ta_func.h>
+#include "ta_scratch.h"
 #include "TaAdosc.h"
 
 #if HKU_SUPPORT_SERIALIZATION
@@ -50,15 +51,15 @@ void TaAdosc::_calculate(const Indicator& data) {
 
     int fast_n = getParam<int>("fast_n");
     int slow_n = getParam<int>("slow_n");
-    int back = TA_ADOSC_Lookback(fast_n, slow_n);
+    int back = ta_lookback<TA_ADOSC_Lookback>(fast_n, slow_n);
     if (back < 0 || back >= total) {
         m_discard = total;
         return;
     }
 
     const KRecord* kptr = k.data();
-    std::unique_ptr<double[]> buf = std::make_unique<double[]>(4 * total);
-    double* high = buf.get();
+    TaScratch<double> buf(4 * total);
+    double* high = buf.data();
     double* low = high + total;
     double* close = low + total;
     double* vol = close + total;
@@ -6,6 +6,7 @@
  */
 
 #include <ta-lib/ta_func.h>
+#include "ta_scratch.h"
 #include "TaApo.h"
 
 #if HKU_SUPPORT_SERIALIZATION
@@ -35,7 +36,7 @@ void TaApo::_calculate(const Indicator& data) {
     int slow_n = getParam<int>("slow_n");
     TA_MAType matype = (TA_MAType)getParam<int>("matype");
     size_t total = data.size();
-    int lookback = TA_APO_Lookback(fast_n, slow_n, matype);
+    int lookback = ta_lookback<TA_APO_Lookback>(fast_n, slow_n, matype);
     if (lookback >= total || lookback < 0) {
         m_discard = total;
         return;
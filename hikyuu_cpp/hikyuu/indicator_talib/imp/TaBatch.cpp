@@ -0,0 +1,30 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#include "hikyuu/utilities/thread/algorithm.h"
+#include "../ta_crt.h"
+
+namespace hku {
+
+// Indicator::operator() 会克隆指标公式后计算，各线程之间互不影响；
+// ta-lib 临时缓存及 lookback 为线程内缓存（见 ta_scratch.h），同一工作线程计算多只证券时复用
+
+IndicatorList HKU_API TA_BATCH(const Indicator& ind, const vector<KData>& ks) {
+    return parallel_for_index(0, ks.size(), [&ind, &ks](size_t i) {
+        Indicator formula = ind;
+        return formula(ks[i]);
+    });
+}
+
+IndicatorList HKU_API TA_BATCH(const Indicator& ind, const IndicatorList& inputs) {
+    return parallel_for_index(0, inputs.size(), [&ind, &inputs](size_t i) {
+        Indicator formula = ind;
+        return formula(inputs[i]);
+    });
+}
+
+}  // namespace hku
@@ -6,6 +6,7 @@
  */
 
 #include <ta-lib/ta_func.h>
+#include "ta_scratch.h"
 #include "TaBbands.h"
 
 #if HKU_SUPPORT_SERIALIZATION
@@ -41,7 +42,7 @@ void TaBbands::_calculate(const Indicator& data) {
     double nbdevdn = getParam<double>("nbdevdn");
     TA_MAType matype = (TA_MAType)getParam<int>("matype");
     size_t total = data.size();
-    int lookback = TA_BBANDS_Lookback(n, nbdevup, nbdevdn, matype);
+    int lookback = ta_lookback<TA_BBANDS_Lookback>(n, nbdevup, nbdevdn, matype);
     if (lookback < 0) {
         m_discard = total;
         return;
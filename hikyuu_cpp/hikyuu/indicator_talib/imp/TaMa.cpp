@@ -6,6 +6,7 @@
  */
 
 #include <ta-lib/ta_func.h>
+#include "ta_scratch.h"
 #include "TaMa.h"
 
 #if HKU_SUPPORT_SERIALIZATION
@@ -33,7 +34,7 @@ void TaMa::_calculate(const Indicator& data) {
     int n = getParam<int>("n");
     TA_MAType matype = (TA_MAType)getParam<int>("matype");
     size_t total = data.size();
-    int lookback = TA_MA_Lookback(n, matype);
+    int lookback = ta_lookback<TA_MA_Lookback>(n, matype);
     if (lookback < 0) {
         m_discard = total;
         return;
@@ -6,6 +6,7 @@
  */
 
 #include <ta-lib/ta_func.h>
+#include "ta_scratch.h"
 #include "TaMacd.h"
 
 #if HKU_SUPPORT_SERIALIZATION
@@ -35,7 +36,7 @@ void TaMacd::_calculate(const Indicator& data) {
     int slow_n = getParam<int>("slow_n");
     int signal_n = getParam<int>("signal_n");
     size_t total = data.size();
-    int lookback = TA_MACD_Lookback(fast_n, slow_n, signal_n);
+    int lookback = ta_lookback<TA_MACD_Lookback>(fast_n, slow_n, signal_n);
     if (lookback < 0) {
         m_discard = total;
         return;
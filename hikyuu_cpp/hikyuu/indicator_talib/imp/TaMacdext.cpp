@@ -6,6 +6,7 @@
  */
 
 #include <ta-lib/ta_func.h>
+#include "ta_scratch.h"
 #include "TaMacdext.h"
 
 #if HKU_SUPPORT_SERIALIZATION
@@ -44,8 +45,8 @@ void TaMacdext::_calculate(const Indicator& data) {
     int signal_n = getParam<int>("signal_n");
     TA_MAType signal_matype = (TA_MAType)getParam<int>("signal_matype");
     size_t total = data.size();
-    int lookback =
-      TA_MACDEXT_Lookback(fast_n, fast_matype, slow_n, slow_matype, signal_n, signal_matype);
+    int lookback = ta_lookback<TA_MACDEXT_Lookback>(fast_n, fast_matype, slow_n, slow_matype,
+                                                    signal_n, signal_matype);
     if (lookback < 0) {
         m_discard = total;
         return;
@@ -6,6 +6,7 @@
  */
 
 #include <ta-lib/ta_func.h>
+#include "ta_scratch.h"
 #include "TaMama.h"
 
 #if HKU_SUPPORT_SERIALIZATION
@@ -30,7 +31,7 @@ void TaMama::_calculate(const Indicator& data) {
     double fast_limit = getParam<double>("fast_limit");
     double slow_limit = getParam<double>("slow_limit");
     size_t total = data.size();
-    int lookback = TA_MAMA_Lookback(fast_limit, slow_limit);
+    int lookback = ta_lookback<TA_MAMA_Lookback>(fast_limit, slow_limit);
     if (lookback < 0) {
         m_discard = total;
         return;
@@ -6,6 +6,7 @@
  */
 
 #include <ta-lib/ta_func.h>
+#include "ta_scratch.h"
 #include "TaMavp.h"
 
 #if HKU_SUPPORT_SERIALIZATION
@@ -48,7 +49,7 @@ void TaMavp::_calculate(const Indicator& ind) {
     int min_n = getParam<int>("min_n");
     int max_n = getParam<int>("max_n");
     TA_MAType matype = (TA_MAType)getParam<int>("matype");
-    int lookback = TA_MAVP_Lookback(min_n, max_n, matype);
+    int lookback = ta_lookback<TA_MAVP_Lookback>(min_n, max_n, matype);
     if (lookback < 0) {
         m_discard = total;
         return;
@@ -6,6 +6,7 @@
  */
 
 #include <ta-lib/ta_func.h>
+#include "ta_scratch.h"
 #include "TaSar.h"
 
 #if HKU_SUPPORT_SERIALIZATION
@@ -45,15 +46,15 @@ void TaSar::_calculate(const Indicator& data) {
 
     double acceleration = getParam<double>("acceleration");
     double maximum = getParam<double>("maximum");
-    int back = TA_SAR_Lookback(acceleration, maximum);
+    int back = ta_lookback<TA_SAR_Lookback>(acceleration, maximum);
     if (back < 0 || back >= total) {
         m_discard = total;
         return;
     }
 
     const KRecord* kptr = k.data();
-    std::unique_ptr<double[]> buf = std::make_unique<double[]>(2 * total);
-    double* high = buf.get();
+    TaScratch<double> buf(2 * total);
+    double* high = buf.data();
     double* low = high + total;
     for (size_t i = 0; i < total; ++i) {
         high[i] = kptr[i].highPrice;
@@ -6,6 +6,7 @@
  */
 
 #include <ta-lib/ta_func.h>
+#include "ta_scratch.h"
 #include "TaSarext.h"
 
 #if HKU_SUPPORT_SERIALIZATION
@@ -86,17 +87,17 @@ void TaSarext::_calculate(const Indicator& data) {
     double accelerationinitshort = getParam<double>("accelerationinitshort");
     double accelerationshort = getParam<double>("accelerationshort");
     double accelerationmaxshort = getParam<double>("accelerationmaxshort");
-    int back = TA_SAREXT_Lookback(startvalue, offsetonreverse, accelerationinitlong,
-                                  accelerationlong, accelerationmaxlong, accelerationinitshort,
-                                  accelerationshort, accelerationmaxshort);
+    int back = ta_lookback<TA_SAREXT_Lookback>(
+      startvalue, offsetonreverse, accelerationinitlong, accelerationlong, accelerationmaxlong,
+      accelerationinitshort, accelerationshort, accelerationmaxshort);
     if (back < 0 || back >= total) {
         m_discard = total;
         return;
     }
 
     const KRecord* kptr = k.data();
-    std::unique_ptr<double[]> buf = std::make_unique<double[]>(2 * total);
-    double* high = buf.get();
+    TaScratch<double> buf(2 * total);
+    double* high = buf.data();
     double* low = high + total;
     for (size_t i = 0; i < total; ++i) {
         high[i] = kptr[i].highPrice;
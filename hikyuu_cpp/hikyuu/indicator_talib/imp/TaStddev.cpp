@@ -6,6 +6,7 @@
  */
 
 #include <ta-lib/ta_func.h>
+#include "ta_scratch.h"
 #include "TaStddev.h"
 
 #if HKU_SUPPORT_SERIALIZATION
@@ -33,7 +34,7 @@ void TaStddev::_calculate(const Indicator& data) {
     int n = getParam<int>("n");
     double nbdev = getParam<double>("nbdev");
     size_t total = data.size();
-    int lookback = TA_STDDEV_Lookback(n, nbdev);
+    int lookback = ta_lookback<TA_STDDEV_Lookback>(n, nbdev);
     if (lookback < 0) {
         m_discard = total;
         return;
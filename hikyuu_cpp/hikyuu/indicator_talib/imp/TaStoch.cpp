@@ -6,6 +6,7 @@
  */
 
 #include <ta-lib/ta_func.h>
+#include "ta_scratch.h"
 #include "TaStoch.h"
 
 #if HKU_SUPPORT_SERIALIZATION
@@ -59,15 +60,16 @@ void TaStoch::_calculate(const Indicator& data) {
     TA_MAType slowk_matype = (TA_MAType)getParam<int>("slowk_matype");
     int slowd_n = getParam<int>("slowd_n");
     TA_MAType slowd_matype = (TA_MAType)getParam<int>("slowd_matype");
-    int back = TA_STOCH_Lookback(fastk_n, slowk_n, slowk_matype, slowd_n, slowd_matype);
+    int back =
+      ta_lookback<TA_STOCH_Lookback>(fastk_n, slowk_n, slowk_matype, slowd_n, slowd_matype);
     if (back < 0 || back >= total) {
         m_discard = total;
         return;
     }
 
     const KRecord* kptr = k.data();
-    std::unique_ptr<double[]> buf = std::make_unique<double[]>(3 * total);
-    double* high = buf.get();
+    TaScratch<double> buf(3 * total);
+    double* high = buf.data();
     double* low = high + total;
     double* close = low + total;
     for (size_t i = 0; i < total; ++i) {
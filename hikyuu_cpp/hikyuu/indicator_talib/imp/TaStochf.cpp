@@ -6,6 +6,7 @@
  */
 
 #include <ta-lib/ta_func.h>
+#include "ta_scratch.h"
 #include "TaStochf.h"
 
 #if HKU_SUPPORT_SERIALIZATION
@@ -52,15 +53,15 @@ void TaStochf::_calculate(const Indicator& data) {
     int fastk_n = getParam<int>("fastk_n");
     int fastd_n = getParam<int>("fastd_n");
     TA_MAType fastd_matype = (TA_MAType)getParam<int>("fastd_matype");
-    int back = TA_STOCHF_Lookback(fastk_n, fastd_n, fastd_matype);
+    int back = ta_lookback<TA_STOCHF_Lookback>(fastk_n, fastd_n, fastd_matype);
     if (back < 0 || back >= total) {
         m_discard = total;
         return;
     }
 
     const KRecord* kptr = k.data();
-    std::unique_ptr<double[]> buf = std::make_unique<double[]>(3 * total);
-    double* high = buf.get();
+    TaScratch<double> buf(3 * total);
+    double* high = buf.data();
     double* low = high + total;
     double* close = low + total;
     for (size_t i = 0; i < total; ++i) {
@@ -6,6 +6,7 @@
  */
 
 #include <ta-lib/ta_func.h>
+#include "ta_scratch.h"
 #include "TaStochrsi.h"
 
 #if HKU_SUPPORT_SERIALIZATION
@@ -40,7 +41,7 @@ void TaStochrsi::_calculate(const Indicator& data) {
     int fastd_n = getParam<int>("fastd_n");
     TA_MAType matype = (TA_MAType)getParam<int>("matype");
     size_t total = data.size();
-    int lookback = TA_STOCHRSI_Lookback(n, fastk_n, fastd_n, matype);
+    int lookback = ta_lookback<TA_STOCHRSI_Lookback>(n, fastk_n, fastd_n, matype);
     if (lookback < 0) {
         m_discard = total;
         return;
@@ -6,6 +6,7 @@
  */
 
 #include <ta-lib/ta_func.h>
+#include "ta_scratch.h"
 #include "TaT3.h"
 
 #if HKU_SUPPORT_SERIALIZATION
@@ -33,7 +34,7 @@ void TaT3::_calculate(const Indicator& data) {
     int n = getParam<int>("n");
     double vfactor = getParam<double>("vfactor");
     size_t total = data.size();
-    int lookback = TA_T3_Lookback(n, vfactor);
+    int lookback = ta_lookback<TA_T3_Lookback>(n, vfactor);
     if (lookback < 0) {
         m_discard = total;
         return;
@@ -6,6 +6,7 @@
  */
 
 #include <ta-lib/ta_func.h>
+#include "ta_scratch.h"
 #include "TaUltosc.h"
 
 #if HKU_SUPPORT_SERIALIZATION
@@ -48,15 +49,15 @@ void TaUltosc::_calculate(const Indicator& data) {
     int n1 = getParam<int>("n1");
     int n2 = getParam<int>("n2");
     int n3 = getParam<int>("n3");
-    int back = TA_ULTOSC_Lookback(n1, n2, n3);
+    int back = ta_lookback<TA_ULTOSC_Lookback>(n1, n2, n3);
     if (back < 0 || back >= total) {
         m_discard = total;
         return;
     }
 
     const KRecord* kptr = k.data();
-    std::unique_ptr<double[]> buf = std::make_unique<double[]>(3 * total);
-    double* high = buf.get();
+    TaScratch<double> buf(3 * total);
+    double* high = buf.data();
     double* low = high + total;
     double* close = low + total;
     for (size_t i = 0; i < total; ++i) {
@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include "ta_scratch.h"
+
 #define EXPOERT_TA_FUNC(func) BOOST_CLASS_EXPORT(hku::Cls_##func)
 
 #define TA_IN1_OUT1_IMP(func, func_lookback)                                         \
@@ -14,7 +16,7 @@
     Cls_##func::~Cls_##func() {}                                                     \
                                                                                      \
     void Cls_##func::_calculate(const Indicator &data) {                             \
-        int lookback = func_lookback();                                              \
+        int lookback = ta_lookback<func_lookback>();                                 \
         size_t total = data.size();                                                  \
         if (lookback < 0) {                                                          \
             m_discard = total;                                                       \
@@ -43,7 +45,7 @@
     Cls_##func::~Cls_##func() {}                                                     \
                                                                                      \
     void Cls_##func::_calculate(const Indicator &data) {                             \
-        int lookback = func_lookback();                                              \
+        int lookback = ta_lookback<func_lookback>();                                 \
         size_t total = data.size();                                                  \
         if (lookback < 0) {                                                          \
             m_discard = total;                                                       \
@@ -57,10 +59,10 @@
         }                                                                            \
                                                                                      \
         auto const *src = data.data();                                               \
-        std::unique_ptr<int[]> buf = std::make_unique<int[]>(total);                 \
+        TaScratch<int> buf(total);                                                   \
         int outBegIdx;                                                               \
         int outNbElement;                                                            \
-        func(m_discard, total - 1, src, &outBegIdx, &outNbElement, buf.get());       \
+        func(m_discard, total - 1, src, &outBegIdx, &outNbElement, buf);             \
         HKU_ASSERT((outBegIdx == m_discard) && (outBegIdx + outNbElement) <= total); \
         m_discard = outBegIdx;                                                       \
         auto *dst = this->data();                                                    \
@@ -89,7 +91,7 @@
                                                                                            \
     void Cls_##func::_calculate(const Indicator &data) {                                   \
         int n = getParam<int>("n");                                                        \
-        int lookback = func_lookback(n);                                                   \
+        int lookback = ta_lookback<func_lookback>(n);                                      \
         size_t total = data.size();                                                        \
         if (lookback < 0) {                                                                \
             m_discard = total;                                                             \
@@ -112,16 +114,16 @@
     }                                                                                      \
                                                                                            \
     void Cls_##func::_dyn_run_one_step(const Indicator &ind, size_t curPos, size_t step) { \
-        int back = func_lookback(step);                                                    \
+        int back = ta_lookback<func_lookback>(step);                                       \
         HKU_IF_RETURN(back<0 || back + ind.discard()> curPos, void());                     \
                                                                                            \
-        std::unique_ptr<double[]> buf = std::make_unique<double[]>(curPos);                \
+        TaScratch<double> buf(curPos);                                                     \
         auto const *src = ind.data();                                                      \
         int outBegIdx;                                                                     \
         int outNbElement;                                                                  \
-        func(ind.discard(), curPos, src, step, &outBegIdx, &outNbElement, buf.get());      \
+        func(ind.discard(), curPos, src, step, &outBegIdx, &outNbElement, buf);            \
         if (outNbElement >= 1) {                                                           \
-            _set(buf.get()[outNbElement - 1], curPos);                                     \
+            _set(buf[outNbElement - 1], curPos);                                           \
         }                                                                                  \
     }                                                                                      \
                                                                                            \
@@ -152,7 +154,7 @@
                                                                                            \
     void Cls_##func::_calculate(const Indicator &data) {                                   \
         int n = getParam<int>("n");                                                        \
-        int lookback = func_lookback(n);                                                   \
+        int lookback = ta_lookback<func_lookback>(n);                                      \
         size_t total = data.size();                                                        \
         if (lookback < 0) {                                                                \
             m_discard = total;                                                             \
@@ -166,10 +168,10 @@
         }                                                                                  \
                                                                                            \
         auto const *src = data.data();                                                     \
-        std::unique_ptr<int[]> buf = std::make_unique<int[]>(total);                       \
+        TaScratch<int> buf(total);                                                         \
         int outBegIdx;                                                                     \
         int outNbElement;                                                                  \
-        func(m_discard, total - 1, src, n, &outBegIdx, &outNbElement, buf.get());          \
+        func(m_discard, total - 1, src, n, &outBegIdx, &outNbElement, buf);                \
         HKU_ASSERT((outBegIdx == m_discard) && (outBegIdx + outNbElement) <= total);       \
         m_discard = outBegIdx;                                                             \
         auto *dst = this->data();                                                          \
@@ -180,16 +182,16 @@
     }                                                                                      \
                                                                                            \
     void Cls_##func::_dyn_run_one_step(const Indicator &ind, size_t curPos, size_t step) { \
-        int back = func_lookback(step);                                                    \
+        int back = ta_lookback<func_lookback>(step);                                       \
         HKU_IF_RETURN(back<0 || back + ind.discard()> curPos, void());                     \
                                                                                            \
-        std::unique_ptr<int[]> buf = std::make_unique<int[]>(curPos);                      \
+        TaScratch<int> buf(curPos);                                                        \
         auto const *src = ind.data();                                                      \
         int outBegIdx;                                                                     \
         int outNbElement;                                                                  \
-        func(ind.discard(), curPos, src, step, &outBegIdx, &outNbElement, buf.get());      \
+        func(ind.discard(), curPos, src, step, &outBegIdx, &outNbElement, buf);            \
         if (outNbElement >= 1) {                                                           \
-            _set(buf.get()[outNbElement - 1], curPos);                                     \
+            _set(buf[outNbElement - 1], curPos);                                           \
         }                                                                                  \
     }                                                                                      \
                                                                                            \
@@ -210,7 +212,7 @@
     Cls_##func::~Cls_##func() {}                                                     \
     void Cls_##func::_calculate(const Indicator &data) {                             \
         size_t total = data.size();                                                  \
-        int lookback = func_lookback();                                              \
+        int lookback = ta_lookback<func_lookback>();                                 \
         if (lookback < 0) {                                                          \
             m_discard = total;                                                       \
             return;                                                                  \
@@ -251,7 +253,7 @@
                                                                                            \
     void Cls_##func::_calculate(const Indicator &data) {                                   \
         int n = getParam<int>("n");                                                        \
-        int lookback = func_lookback(n);                                                   \
+        int lookback = ta_lookback<func_lookback>(n);                                      \
         size_t total = data.size();                                                        \
         if (lookback < 0) {                                                                \
             m_discard = total;                                                             \
@@ -265,8 +267,8 @@
         }                                                                                  \
                                                                                            \
         auto const *src = data.data();                                                     \
-        std::unique_ptr<int[]> buf = std::make_unique<int[]>(2 * (total));                 \
-        int *buf0 = buf.get();                                                             \
+        TaScratch<int> buf(2 * (total));                                                   \
+        int *buf0 = buf;                                                                   \
         int *buf1 = buf0 + total;                                                          \
         int outBegIdx;                                                                     \
         int outNbElement;                                                                  \
@@ -282,11 +284,11 @@
     }                                                                                      \
                                                                                            \
     void Cls_##func::_dyn_run_one_step(const Indicator &ind, size_t curPos, size_t step) { \
-        int back = func_lookback(step);                                                    \
+        int back = ta_lookback<func_lookback>(step);                                       \
         HKU_IF_RETURN(back<0 || back + ind.discard()> curPos, void());                     \
                                                                                            \
-        std::unique_ptr<int[]> buf = std::make_unique<int[]>(2 * curPos);                  \
-        int *buf0 = buf.get();                                                             \
+        TaScratch<int> buf(2 * curPos);                                                    \
+        int *buf0 = buf;                                                                   \
         int *buf1 = buf0 + curPos;                                                         \
         auto const *src = ind.data();                                                      \
         int outBegIdx;                                                                     \
@@ -326,7 +328,7 @@
     void Cls_##func::_calculate(const Indicator &data) {                                   \
         int n = getParam<int>("n");                                                        \
         size_t total = data.size();                                                        \
-        int lookback = func_lookback(n);                                                   \
+        int lookback = ta_lookback<func_lookback>(n);                                      \
         if (lookback < 0) {                                                                \
             m_discard = total;                                                             \
             return;                                                                        \
@@ -349,11 +351,11 @@
     }                                                                                      \
                                                                                            \
     void Cls_##func::_dyn_run_one_step(const Indicator &ind, size_t curPos, size_t step) { \
-        int back = func_lookback(step);                                                    \
+        int back = ta_lookback<func_lookback>(step);                                       \
         HKU_IF_RETURN(back<0 || back + ind.discard()> curPos, void());                     \
                                                                                            \
-        std::unique_ptr<double[]> buf = std::make_unique<double[]>(2 * curPos);            \
-        double *dst0 = buf.get();                                                          \
+        TaScratch<double> buf(2 * curPos);                                                 \
+        double *dst0 = buf;                                                                \
         double *ds1 = dst0 + curPos;                                                       \
         auto const *src = ind.data();                                                      \
         int outBegIdx;                                                                     \
@@ -393,7 +395,7 @@
     void Cls_##func::_calculate(const Indicator &data) {                                   \
         int n = getParam<int>("n");                                                        \
         size_t total = data.size();                                                        \
-        int lookback = func_lookback(n);                                                   \
+        int lookback = ta_lookback<func_lookback>(n);                                      \
         if (lookback < 0) {                                                                \
             m_discard = total;                                                             \
             return;                                                                        \
@@ -417,11 +419,11 @@
     }                                                                                      \
                                                                                            \
     void Cls_##func::_dyn_run_one_step(const Indicator &ind, size_t curPos, size_t step) { \
-        int back = func_lookback(step);                                                    \
+        int back = ta_lookback<func_lookback>(step);                                       \
         HKU_IF_RETURN(back<0 || back + ind.discard()> curPos, void());                     \
                                                                                            \
-        std::unique_ptr<double[]> buf = std::make_unique<double[]>(3 * curPos);            \
-        double *dst0 = buf.get();                                                          \
+        TaScratch<double> buf(3 * curPos);                                                 \
+        double *dst0 = buf;                                                                \
         double *ds1 = dst0 + curPos;                                                       \
         double *ds2 = ds1 + curPos;                                                        \
         auto const *src = ind.data();                                                      \
@@ -458,7 +460,7 @@
         HKU_IF_RETURN(total == 0, void());                                                        \
                                                                                                   \
         Indicator ref = prepare(ind);                                                             \
-        int lookback = func_lookback();                                                           \
+        int lookback = ta_lookback<func_lookback>();                                              \
         if (lookback < 0) {                                                                       \
             m_discard = total;                                                                    \
             return;                                                                               \
@@ -523,7 +525,7 @@
         Indicator ref = prepare(ind);                                                          \
                                                                                                \
         int n = getParam<int>("n");                                                            \
-        int lookback = func_lookback(n);                                                       \
+        int lookback = ta_lookback<func_lookback>(n);                                          \
         if (lookback < 0) {                                                                    \
             m_discard = total;                                                                 \
             return;                                                                            \
@@ -574,15 +576,15 @@
         HKU_IF_RETURN(total == 0, void());                                              \
                                                                                         \
         _readyBuffer(total, 1);                                                         \
-        int lookback = func_lookback();                                                 \
+        int lookback = ta_lookback<func_lookback>();                                    \
         if (lookback < 0 || lookback >= total) {                                        \
             m_discard = total;                                                          \
             return;                                                                     \
         }                                                                               \
                                                                                         \
         const KRecord *kptr = k.data();                                                 \
-        std::unique_ptr<double[]> buf = std::make_unique<double[]>(4 * total);          \
-        double *open = buf.get();                                                       \
+        TaScratch<double> buf(4 * total);                                               \
+        double *open = buf;                                                             \
         double *high = open + total;                                                    \
         double *low = high + total;                                                     \
         double *close = low + total;                                                    \
@@ -628,15 +630,15 @@
                                                                                         \
         _readyBuffer(total, 1);                                                         \
                                                                                         \
-        int lookback = func_lookback();                                                 \
+        int lookback = ta_lookback<func_lookback>();                                    \
         if (lookback < 0 || lookback >= total) {                                        \
             m_discard = total;                                                          \
             return;                                                                     \
         }                                                                               \
                                                                                         \
         const KRecord *kptr = k.data();                                                 \
-        std::unique_ptr<double[]> buf = std::make_unique<double[]>(4 * total);          \
-        double *open = buf.get();                                                       \
+        TaScratch<double> buf(4 * total);                                               \
+        double *open = buf;                                                             \
         double *high = open + total;                                                    \
         double *low = high + total;                                                     \
         double *close = low + total;                                                    \
@@ -647,12 +649,12 @@
             close[i] = kptr[i].closePrice;                                              \
         }                                                                               \
                                                                                         \
-        std::unique_ptr<int[]> outbuf = std::make_unique<int[]>(total);                 \
+        TaScratch<int> outbuf(total);                                                   \
         int outBegIdx;                                                                  \
         int outNbElement;                                                               \
         m_discard = lookback;                                                           \
         func(m_discard, total - 1, open, high, low, close, &outBegIdx, &outNbElement,   \
-             outbuf.get());                                                             \
+             outbuf);                                                                   \
         HKU_ASSERT((outBegIdx == m_discard) && (outBegIdx + outNbElement) <= total);    \
         auto *dst = this->data() + outBegIdx;                                           \
         for (size_t i = 0; i < outNbElement; ++i) {                                     \
@@ -697,15 +699,15 @@
                                                                                                   \
         _readyBuffer(total, 1);                                                                   \
                                                                                                   \
-        int lookback = func_lookback(param1_value);                                               \
+        int lookback = ta_lookback<func_lookback>(param1_value);                                  \
         if (lookback < 0 || lookback >= total) {                                                  \
             m_discard = total;                                                                    \
             return;                                                                               \
         }                                                                                         \
                                                                                                   \
         const KRecord *kptr = k.data();                                                           \
-        std::unique_ptr<double[]> buf = std::make_unique<double[]>(4 * total);                    \
-        double *open = buf.get();                                                                 \
+        TaScratch<double> buf(4 * total);                                                         \
+        double *open = buf;                                                                       \
         double *high = open + total;                                                              \
         double *low = high + total;                                                               \
         double *close = low + total;                                                              \
@@ -716,12 +718,12 @@
             close[i] = kptr[i].closePrice;                                                        \
         }                                                                                         \
                                                                                                   \
-        std::unique_ptr<int[]> outbuf = std::make_unique<int[]>(total);                           \
+        TaScratch<int> outbuf(total);                                                             \
         int outBegIdx;                                                                            \
         int outNbElement;                                                                         \
         m_discard = lookback;                                                                     \
         func(m_discard, total - 1, open, high, low, close, getParam<double>(#param1), &outBegIdx, \
-             &outNbElement, outbuf.get());                                                        \
+             &outNbElement, outbuf);                                                              \
         HKU_ASSERT((outBegIdx == m_discard) && (outBegIdx + outNbElement) <= total);              \
         auto *dst = this->data() + outBegIdx;                                                     \
         for (size_t i = 0; i < outNbElement; ++i) {                                               \
@@ -757,15 +759,15 @@
         HKU_IF_RETURN(total == 0, void());                                              \
                                                                                         \
         _readyBuffer(total, 1);                                                         \
-        int lookback = func_lookback();                                                 \
+        int lookback = ta_lookback<func_lookback>();                                    \
         if (lookback < 0 || lookback >= total) {                                        \
             m_discard = total;                                                          \
             return;                                                                     \
         }                                                                               \
                                                                                         \
         const KRecord *kptr = k.data();                                                 \
-        std::unique_ptr<double[]> buf = std::make_unique<double[]>(4 * total);          \
-        double *high = buf.get();                                                       \
+        TaScratch<double> buf(4 * total);                                               \
+        double *high = buf;                                                             \
         double *low = high + total;                                                     \
         double *close = low + total;                                                    \
         double *vol = close + total;                                                    \
@@ -810,15 +812,15 @@
         HKU_IF_RETURN(total == 0, void());                                                 \
                                                                                            \
         _readyBuffer(total, 1);                                                            \
-        int lookback = func_lookback();                                                    \
+        int lookback = ta_lookback<func_lookback>();                                       \
         if (lookback < 0 || lookback >= total) {                                           \
             m_discard = total;                                                             \
             return;                                                                        \
         }                                                                                  \
                                                                                            \
         const KRecord *kptr = k.data();                                                    \
-        std::unique_ptr<double[]> buf = std::make_unique<double[]>(2 * total);             \
-        double *high = buf.get();                                                          \
+        TaScratch<double> buf(2 * total);                                                  \
+        double *high = buf;                                                                \
         double *low = high + total;                                                        \
         for (size_t i = 0; i < total; ++i) {                                               \
             high[i] = kptr[i].highPrice;                                                   \
@@ -858,15 +860,15 @@
         HKU_IF_RETURN(total == 0, void());                                                  \
                                                                                             \
         _readyBuffer(total, 1);                                                             \
-        int lookback = func_lookback();                                                     \
+        int lookback = ta_lookback<func_lookback>();                                        \
         if (lookback < 0 || lookback >= total) {                                            \
             m_discard = 0;                                                                  \
             return;                                                                         \
         }                                                                                   \
                                                                                             \
         const KRecord *kptr = k.data();                                                     \
-        std::unique_ptr<double[]> buf = std::make_unique<double[]>(2 * total);              \
-        double *close = buf.get();                                                          \
+        TaScratch<double> buf(2 * total);                                                   \
+        double *close = buf;                                                                \
         double *vol = close + total;                                                        \
         for (size_t i = 0; i < total; ++i) {                                                \
             close[i] = kptr[i].closePrice;                                                  \
@@ -906,15 +908,15 @@
         HKU_IF_RETURN(total == 0, void());                                                        \
                                                                                                   \
         _readyBuffer(total, 1);                                                                   \
-        int lookback = func_lookback();                                                           \
+        int lookback = ta_lookback<func_lookback>();                                              \
         if (lookback < 0 || lookback >= total) {                                                  \
             m_discard = total;                                                                    \
             return;                                                                               \
         }                                                                                         \
                                                                                                   \
         const KRecord *kptr = k.data();                                                           \
-        std::unique_ptr<double[]> buf = std::make_unique<double[]>(3 * total);                    \
-        double *high = buf.get();                                                                 \
+        TaScratch<double> buf(3 * total);                                                         \
+        double *high = buf;                                                                       \
         double *low = high + total;                                                               \
         double *close = low + total;                                                              \
         for (size_t i = 0; i < total; ++i) {                                                      \
@@ -967,15 +969,15 @@
                                                                                         \
         _readyBuffer(total, 1);                                                         \
         int n = getParam<int>("n");                                                     \
-        int back = func_lookback(n);                                                    \
+        int back = ta_lookback<func_lookback>(n);                                       \
         if (back < 0 || back >= total) {                                                \
             m_discard = total;                                                          \
             return;                                                                     \
         }                                                                               \
                                                                                         \
         const KRecord *kptr = k.data();                                                 \
-        std::unique_ptr<double[]> buf = std::make_unique<double[]>(3 * total);          \
-        double *high = buf.get();                                                       \
+        TaScratch<double> buf(3 * total);                                               \
+        double *high = buf;                                                             \
         double *low = high + total;                                                     \
         double *close = low + total;                                                    \
         for (size_t i = 0; i < total; ++i) {                                            \
@@ -1033,15 +1035,15 @@
         _readyBuffer(total, 1);                                                         \
                                                                                         \
         int n = getParam<int>("n");                                                     \
-        int back = func_lookback(n);                                                    \
+        int back = ta_lookback<func_lookback>(n);                                       \
         if (back < 0 || back >= total) {                                                \
             m_discard = total;                                                          \
             return;                                                                     \
         }                                                                               \
                                                                                         \
         const KRecord *kptr = k.data();                                                 \
-        std::unique_ptr<double[]> buf = std::make_unique<double[]>(4 * total);          \
-        double *high = buf.get();                                                       \
+        TaScratch<double> buf(4 * total);                                               \
+        double *high = buf;                                                             \
         double *low = high + total;                                                     \
         double *close = low + total;                                                    \
         double *vol = close + total;                                                    \
@@ -1100,15 +1102,15 @@
                                                                                               \
         _readyBuffer(total, 1);                                                               \
         int n = getParam<int>("n");                                                           \
-        int back = func_lookback(n);                                                          \
+        int back = ta_lookback<func_lookback>(n);                                             \
         if (back < 0 || back >= total) {                                                      \
             m_discard = total;                                                                \
             return;                                                                           \
         }                                                                                     \
                                                                                               \
         const KRecord *kptr = k.data();                                                       \
-        std::unique_ptr<double[]> buf = std::make_unique<double[]>(2 * total);                \
-        double *high = buf.get();                                                             \
+        TaScratch<double> buf(2 * total);                                                     \
+        double *high = buf;                                                                   \
         double *low = high + total;                                                           \
         for (size_t i = 0; i < total; ++i) {                                                  \
             high[i] = kptr[i].highPrice;                                                      \
@@ -1162,15 +1164,15 @@
                                                                                               \
         _readyBuffer(total, 2);                                                               \
         int n = getParam<int>("n");                                                           \
-        int back = func_lookback(n);                                                          \
+        int back = ta_lookback<func_lookback>(n);                                             \
         if (back < 0 || back >= total) {                                                      \
             m_discard = total;                                                                \
             return;                                                                           \
         }                                                                                     \
                                                                                               \
         const KRecord *kptr = k.data();                                                       \
-        std::unique_ptr<double[]> buf = std::make_unique<double[]>(2 * total);                \
-        double *high = buf.get();                                                             \
+        TaScratch<double> buf(2 * total);                                                     \
+        double *high = buf;                                                                   \
         double *low = high + total;                                                           \
         for (size_t i = 0; i < total; ++i) {                                                  \
             high[i] = kptr[i].highPrice;                                                      \
@@ -1226,15 +1228,15 @@
                                                                                         \
         _readyBuffer(total, 3);                                                         \
         int n = getParam<int>("n");                                                     \
-        int back = func_lookback(n);                                                    \
+        int back = ta_lookback<func_lookback>(n);                                       \
         if (back < 0 || back >= total) {                                                \
             m_discard = total;                                                          \
             return;                                                                     \
         }                                                                               \
                                                                                         \
         const KRecord *kptr = k.data();                                                 \
-        std::unique_ptr<double[]> buf = std::make_unique<double[]>(3 * total);          \
-        double *high = buf.get();                                                       \
+        TaScratch<double> buf(3 * total);                                               \
+        double *high = buf;                                                             \
         double *low = high + total;                                                     \
         double *close = low + total;                                                    \
         for (size_t i = 0; i < total; ++i) {                                            \
@@ -1293,15 +1295,15 @@
                                                                                                 \
         _readyBuffer(total, 1);                                                                 \
         int n = getParam<int>("n");                                                             \
-        int back = func_lookback(n);                                                            \
+        int back = ta_lookback<func_lookback>(n);                                               \
         if (back < 0 || back >= total) {                                                        \
             m_discard = total;                                                                  \
             return;                                                                             \
         }                                                                                       \
                                                                                                 \
         const KRecord *kptr = k.data();                                                         \
-        std::unique_ptr<double[]> buf = std::make_unique<double[]>(2 * total);                  \
-        double *open = buf.get();                                                               \
+        TaScratch<double> buf(2 * total);                                                       \
+        double *open = buf;                                                                     \
         double *close = open + total;                                                           \
         for (size_t i = 0; i < total; ++i) {                                                    \
             open[i] = kptr[i].openPrice;                                                        \
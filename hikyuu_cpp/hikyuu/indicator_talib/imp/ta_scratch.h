@@ -0,0 +1,85 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <tuple>
+#include <vector>
+
+namespace hku {
+
+/**
+ * 当前线程的 ta-lib 输入/输出临时缓存
+ * @details 用于 ta-lib 需要的连续输入（如由 KData 取出的开高低收）及整型输出，同一工作线程上的
+ *          多次计算（如批量计算多只证券）复用该缓存，避免每次计算重新分配。每种元素类型每个线程
+ *          一份，超过 MAX_KEEP 个元素的缓存在本次使用结束后释放，避免偶发的超长序列长期占用内存。
+ * @note 同一线程内同一元素类型同时只能存在一个实例
+ */
+template <typename T>
+class TaScratch {
+public:
+    /** 单个线程保留的最大元素数 */
+    static constexpr size_t MAX_KEEP = 256 * 1024;
+
+    /**
+     * @param n 需要的元素数量
+     */
+    explicit TaScratch(size_t n) : m_buf(buffer()) {
+        if (m_buf.size() < n) {
+            m_buf.resize(n);
+        }
+    }
+
+    ~TaScratch() {
+        if (m_buf.size() > MAX_KEEP) {
+            std::vector<T>().swap(m_buf);
+        }
+    }
+
+    TaScratch(const TaScratch&) = delete;
+    TaScratch& operator=(const TaScratch&) = delete;
+
+    T* data() {
+        return m_buf.data();
+    }
+
+    operator T*() {
+        return m_buf.data();
+    }
+
+private:
+    static std::vector<T>& buffer() {
+        thread_local std::vector<T> buf;
+        return buf;
+    }
+
+private:
+    std::vector<T>& m_buf;
+};
+
+/**
+ * 获取 ta-lib 函数的 lookback，按参数缓存于当前线程
+ * @details 以相同参数对多只证券计算时（如 TA_BATCH），每个工作线程仅在参数变化时重新计算
+ * @note 缓存不感知 TA_SetUnstablePeriod 等 ta-lib 全局设置的变化，本库不修改这些设置
+ * @tparam Func ta-lib 的 lookback 函数，如 TA_RSI_Lookback
+ */
+template <auto Func, typename... Args>
+int ta_lookback(Args... args) {
+    thread_local std::tuple<Args...> s_args;
+    thread_local int s_lookback = 0;
+    thread_local bool s_valid = false;
+    std::tuple<Args...> key(args...);
+    if (!s_valid || key != s_args) {
+        s_lookback = Func(args...);
+        s_args = key;
+        s_valid = true;
+    }
+    return s_lookback;
+}
+
+}  // namespace hku
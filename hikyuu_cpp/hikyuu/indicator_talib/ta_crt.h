@@ -317,6 +317,25 @@ TA_K_OUT_CRT(TA_WCLPRICE)
 TA_K_OUT_N_CRT(TA_WILLR, 14)
 TA_IN1_OUT_N_CRT(TA_WMA, 30)
 
+/**
+ * 批量计算：以同一指标公式对多只证券的K线数据并行计算，适用于全市场筛选等场景
+ * @details 各证券在任务线程池中分片计算，同一工作线程上的 ta-lib 计算复用临时缓存及 lookback；
+ *          浮点输出的 ta-lib 函数直接写入各自指标的结果缓存，整型输出（如 CDL 形态类）及需由
+ *          K线取出的输入经线程内临时缓存中转
+ * @param ind 指标公式，如 TA_RSI(CLOSE(), 14) 或 TA_OBV()
+ * @param ks K线数据列表
+ * @return 与 ks 一一对应的计算结果
+ */
+IndicatorList HKU_API TA_BATCH(const Indicator& ind, const vector<KData>& ks);
+
+/**
+ * 批量计算：以同一指标公式对多个输入指标并行计算
+ * @param ind 指标公式，如 TA_RSI(14)
+ * @param inputs 输入指标列表
+ * @return 与 inputs 一一对应的计算结果
+ */
+IndicatorList HKU_API TA_BATCH(const Indicator& ind, const IndicatorList& inputs);
+
 }  // namespace hku
 
 #endif
\ No newline at end of file
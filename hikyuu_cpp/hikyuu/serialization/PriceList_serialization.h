@@ -11,6 +11,7 @@
 
 #include "../config.h"
 #include "../DataType.h"
+#include "compact_archive.h"
 
 #if HKU_SUPPORT_SERIALIZATION
 #if HKU_SUPPORT_XML_ARCHIVE
@@ -18,16 +19,30 @@
 namespace boost {
 namespace serialization {
 template <class Archive>
-void save(Archive& ar, hku::PriceList& values, unsigned int version) {
+void save(Archive& ar, const hku::PriceList& values, unsigned int version) {
     size_t count = values.size();
+    if constexpr (hku::is_binary_archive<Archive>::value) {
+        // 二进制存档按内存块保存，与 boost 自身的 vector 存档格式一致
+        unsigned int item_version = 0;
+        ar& BOOST_SERIALIZATION_NVP(count);
+        ar& BOOST_SERIALIZATION_NVP(item_version);
+        if (count > 0) {
+            ar.save_binary(values.data(), count * sizeof(hku::price_t));
+        }
+        return;
+    }
+
     unsigned int item_version = 0;
     ar& BOOST_SERIALIZATION_NVP(count);
     ar& BOOST_SERIALIZATION_NVP(item_version);
+    std::string nan("nan");
+    std::string inf;
     for (size_t i = 0; i < count; i++) {
         if (std::isnan(values[i])) {
-            ar& boost::serialization::make_nvp("item", "nan");
+            ar& boost::serialization::make_nvp("item", nan);
         } else if (std::isinf(values[i])) {
-            ar& boost::serialization::make_nvp("item", values[i] > 0 ? "+inf" : "-inf");
+            inf = values[i] > 0 ? "+inf" : "-inf";
+            ar& boost::serialization::make_nvp("item", inf);
         } else {
             ar& boost::serialization::make_nvp("item", values[i]);
         }
@@ -41,6 +56,13 @@ void load(Archive& ar, hku::PriceList& values, unsigned int version) {
     ar& BOOST_SERIALIZATION_NVP(count);
     ar& BOOST_SERIALIZATION_NVP(item_version);
     values.resize(count);
+    if constexpr (hku::is_binary_archive<Archive>::value) {
+        if (count > 0) {
+            ar.load_binary(values.data(), count * sizeof(hku::price_t));
+        }
+        return;
+    }
+
     for (size_t i = 0; i < count; i++) {
         std::string vstr;
         ar >> boost::serialization::make_nvp("item", vstr);
@@ -0,0 +1,152 @@
+/*
+ * compact_archive.h
+ *
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#pragma once
+#ifndef HIKYUU_SERIALIZATION_COMPACT_ARCHIVE_H_
+#define HIKYUU_SERIALIZATION_COMPACT_ARCHIVE_H_
+
+#include <cstring>
+#include <streambuf>
+#include <type_traits>
+#include "../config.h"
+#include "../DataType.h"
+
+#if HKU_SUPPORT_SERIALIZATION
+
+namespace hku {
+
+/** 是否为二进制存档，二进制存档下数值序列按内存块整体读写 */
+template <class Archive>
+struct is_binary_archive : std::false_type {};
+
+#if HKU_SUPPORT_BINARY_ARCHIVE
+template <>
+struct is_binary_archive<boost::archive::binary_oarchive> : std::true_type {};
+
+template <>
+struct is_binary_archive<boost::archive::binary_iarchive> : std::true_type {};
+
+/**
+ * 紧凑二进制存档
+ * @details
+ * <pre>
+ * 用于进程间传递对象（如 python pickle），格式为：
+ *   [0, 4)  魔数 "HKUB"
+ *   [4]     格式版本号
+ *   [5]     低 7 位为 sizeof(size_t)，最高位为 1 表示小端字节序
+ *   [6, 8)  boost 存档库版本号（小端）
+ *   [8, )   不带文件头的 boost binary 存档内容
+ * 去除了 boost 存档的文本文件头及字符集转换，写入时直接追加至 std::string，
+ * 读取时直接在输入内存上解析，不产生额外的复制。各类自身的序列化版本号仍由 boost 记录，
+ * 指标结果等数值序列在二进制存档下按内存块整体写入。
+ * 仅适用于相同平台、相同 boost 版本之间的传递，不匹配时读取抛出异常。
+ * </pre>
+ */
+class CompactArchive {
+public:
+    /** 格式版本号 */
+    static constexpr uint8_t FORMAT_VERSION = 1;
+
+    /** 头部长度 */
+    static constexpr size_t HEADER_SIZE = 8;
+
+    /** 是否为紧凑二进制存档（仅检查魔数） */
+    static bool isCompact(const char* data, size_t len) noexcept {
+        return data && len >= HEADER_SIZE && std::memcmp(data, "HKUB", 4) == 0;
+    }
+
+    /**
+     * 将对象写入紧凑二进制存档
+     * @param out 输出缓存，原有内容将被清除，可重复使用以避免内存重新分配
+     * @param obj 待保存的对象
+     */
+    template <typename T>
+    static void save(std::string& out, const T& obj) {
+        out.clear();
+        out.append("HKUB", 4);
+        out.push_back(char(FORMAT_VERSION));
+        out.push_back(char(_platformFlag()));
+        uint16_t lib_version = uint16_t(boost::archive::BOOST_ARCHIVE_VERSION());
+        out.push_back(char(lib_version & 0xff));
+        out.push_back(char(lib_version >> 8));
+
+        StringOutBuf buf(out);
+        boost::archive::binary_oarchive oa(buf, boost::archive::no_header |
+                                                  boost::archive::no_codecvt);
+        oa << obj;
+    }
+
+    /**
+     * 从紧凑二进制存档中读取对象
+     * @param data 存档数据，读取期间须保持有效
+     * @param len 存档数据长度
+     * @param obj 读取的对象
+     */
+    template <typename T>
+    static void load(const char* data, size_t len, T& obj) {
+        HKU_CHECK(isCompact(data, len), "Invalid compact archive!");
+        HKU_CHECK(uint8_t(data[4]) == FORMAT_VERSION, "Unsupported compact archive version: {}",
+                  uint8_t(data[4]));
+        HKU_CHECK(uint8_t(data[5]) == _platformFlag(),
+                  "The compact archive was created on an incompatible platform!");
+        uint16_t lib_version = uint16_t(uint8_t(data[6])) | (uint16_t(uint8_t(data[7])) << 8);
+        HKU_CHECK(lib_version == uint16_t(boost::archive::BOOST_ARCHIVE_VERSION()),
+                  "The compact archive was created by boost archive version {}, current is {}!",
+                  lib_version, uint16_t(boost::archive::BOOST_ARCHIVE_VERSION()));
+
+        MemoryInBuf buf(data + HEADER_SIZE, len - HEADER_SIZE);
+        boost::archive::binary_iarchive ia(buf, boost::archive::no_header |
+                                                  boost::archive::no_codecvt);
+        ia >> obj;
+    }
+
+private:
+    static uint8_t _platformFlag() noexcept {
+        const uint16_t probe = 1;
+        uint8_t little = *reinterpret_cast<const uint8_t*>(&probe) == 1 ? 0x80 : 0;
+        return uint8_t(sizeof(size_t)) | little;
+    }
+
+    /** 直接追加写入 std::string 的流缓冲 */
+    class StringOutBuf : public std::streambuf {
+    public:
+        explicit StringOutBuf(std::string& out) : m_out(out) {}
+
+    protected:
+        virtual std::streamsize xsputn(const char* s, std::streamsize n) override {
+            m_out.append(s, size_t(n));
+            return n;
+        }
+
+        virtual int_type overflow(int_type ch) override {
+            if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+                m_out.push_back(traits_type::to_char_type(ch));
+            }
+            return traits_type::not_eof(ch);
+        }
+
+    private:
+        std::string& m_out;
+    };
+
+    /** 只读内存流缓冲，不复制输入数据 */
+    class MemoryInBuf : public std::streambuf {
+    public:
+        MemoryInBuf(const char* data, size_t len) {
+            char* p = const_cast<char*>(data);
+            setg(p, p, p + len);
+        }
+    };
+};
+#endif /* HKU_SUPPORT_BINARY_ARCHIVE */
+
+}  // namespace hku
+
+#endif /* HKU_SUPPORT_SERIALIZATION */
+#endif /* HIKYUU_SERIALIZATION_COMPACT_ARCHIVE_H_ */
@@ -5,8 +5,10 @@
  *      Author: fasiondog
  */
 
+#include <chrono>
 #include <nlohmann/json.hpp>
 #include "OrderBrokerBase.h"
+#include "OrderDispatcher.h"
 
 namespace hku {
 
@@ -42,6 +44,25 @@ HKU_API std::ostream& operator<<(std::ostream& os, const BrokerPositionRecord& p
     return os;
 }
 
+int64_t BrokerOrder::now() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+string BrokerOrder::str() const {
+    return fmt::format(
+      "BrokerOrder({}, {}, {}{}, {:<.4f}, {:<.4f}, {}, submit: {}ns, ack: {}ns{})",
+      business == BUY ? "BUY" : "SELL", datetime, market, code, price, num,
+      getSystemPartName(from), submit_ns - signal_ns, ack_ns - submit_ns,
+      success ? string() : fmt::format(", error: {}", error));
+}
+
+HKU_API std::ostream& operator<<(std::ostream& os, const BrokerOrder& order) {
+    os << order.str();
+    return os;
+}
+
 HKU_API std::ostream& operator<<(std::ostream& os, const OrderBrokerBase& broker) {
     os << "OrderBroker(" << broker.name() << ")";
     return os;
@@ -52,34 +73,172 @@ HKU_API std::ostream& operator<<(std::ostream& os, const OrderBrokerPtr& broker)
     return os;
 }
 
-OrderBrokerBase::OrderBrokerBase() : m_name("NO_NAME") {}
+OrderBrokerBase::OrderBrokerBase() : m_name("NO_NAME") {
+    setParam<bool>("async", false);
+}
 
-OrderBrokerBase::OrderBrokerBase(const string& name) : m_name(name) {}
+OrderBrokerBase::OrderBrokerBase(const string& name) : m_name(name) {
+    setParam<bool>("async", false);
+}
 
 OrderBrokerBase::~OrderBrokerBase() {}
 
 void OrderBrokerBase::buy(Datetime datetime, const string& market, const string& code,
                           price_t price, double num, price_t stoploss, price_t goalPrice,
                           SystemPart from) noexcept {
+    BrokerOrder order;
+    order.signal_ns = BrokerOrder::now();
+    order.business = BrokerOrder::BUY;
+    order.datetime = datetime;
+    order.market = market;
+    order.code = code;
+    order.price = price;
+    order.num = num;
+    order.stoploss = stoploss;
+    order.goalPrice = goalPrice;
+    order.from = from;
+    _submit(std::move(order));
+}
+
+void OrderBrokerBase::sell(Datetime datetime, const string& market, const string& code,
+                           price_t price, double num, price_t stoploss, price_t goalPrice,
+                           SystemPart from) noexcept {
+    BrokerOrder order;
+    order.signal_ns = BrokerOrder::now();
+    order.business = BrokerOrder::SELL;
+    order.datetime = datetime;
+    order.market = market;
+    order.code = code;
+    order.price = price;
+    order.num = num;
+    order.stoploss = stoploss;
+    order.goalPrice = goalPrice;
+    order.from = from;
+    _submit(std::move(order));
+}
+
+void OrderBrokerBase::_submit(BrokerOrder&& order) noexcept {
     try {
-        _buy(datetime, market, code, price, num, stoploss, goalPrice, from);
+        if (getParam<bool>("async")) {
+            // 异步执行期间由委托持有代理实例，未由 shared_ptr 管理的实例只能同步执行
+            order.broker = weak_from_this().lock();
+            if (order.broker) {
+                m_pending_orders.fetch_add(1);
+                if (getGlobalOrderDispatcher()->submit(std::move(order))) {
+                    return;
+                }
+                _finishPendingOrder();
+                order.broker.reset();
+            }
+        }
     } catch (const std::exception& e) {
         HKU_ERROR(e.what());
     } catch (...) {
         HKU_ERROR_UNKNOWN;
     }
+
+    _executeOrder(order);
+    _completeOrder(order);
 }
 
-void OrderBrokerBase::sell(Datetime datetime, const string& market, const string& code,
-                           price_t price, double num, price_t stoploss, price_t goalPrice,
-                           SystemPart from) noexcept {
+void OrderBrokerBase::_executeOrder(BrokerOrder& order) noexcept {
+    order.submit_ns = BrokerOrder::now();
     try {
-        _sell(datetime, market, code, price, num, stoploss, goalPrice, from);
+        if (order.business == BrokerOrder::BUY) {
+            _buy(order.datetime, order.market, order.code, order.price, order.num, order.stoploss,
+                 order.goalPrice, order.from);
+        } else {
+            _sell(order.datetime, order.market, order.code, order.price, order.num,
+                  order.stoploss, order.goalPrice, order.from);
+        }
+        order.success = true;
     } catch (const std::exception& e) {
+        order.error = e.what();
         HKU_ERROR(e.what());
     } catch (...) {
+        order.error = "Unknown error!";
         HKU_ERROR_UNKNOWN;
     }
+    order.ack_ns = BrokerOrder::now();
+}
+
+void OrderBrokerBase::_sendOrders(BrokerOrderList& orders) {
+    for (auto& order : orders) {
+        _executeOrder(order);
+    }
+}
+
+void OrderBrokerBase::_dispatchOrders(BrokerOrderList& orders) noexcept {
+    int64_t start = BrokerOrder::now();
+    try {
+        _sendOrders(orders);
+    } catch (const std::exception& e) {
+        HKU_ERROR(e.what());
+        for (auto& order : orders) {
+            if (order.ack_ns == 0) {
+                order.error = e.what();
+            }
+        }
+    } catch (...) {
+        HKU_ERROR_UNKNOWN;
+        for (auto& order : orders) {
+            if (order.ack_ns == 0) {
+                order.error = "Unknown error!";
+            }
+        }
+    }
+
+    int64_t end = BrokerOrder::now();
+    for (auto& order : orders) {
+        if (order.submit_ns == 0) {
+            order.submit_ns = start;
+        }
+        if (order.ack_ns == 0) {
+            order.ack_ns = end;
+        }
+        _completeOrder(order);
+        _finishPendingOrder();
+    }
+}
+
+void OrderBrokerBase::_completeOrder(BrokerOrder& order) noexcept {
+    m_queue_latency.record(order.submit_ns - order.signal_ns);
+    m_ack_latency.record(order.ack_ns - order.submit_ns);
+    m_total_latency.record(order.ack_ns - order.signal_ns);
+    if (m_order_callback) {
+        try {
+            m_order_callback(order);
+        } catch (const std::exception& e) {
+            HKU_ERROR(e.what());
+        } catch (...) {
+            HKU_ERROR_UNKNOWN;
+        }
+    }
+}
+
+void OrderBrokerBase::_finishPendingOrder() noexcept {
+    if (m_pending_orders.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        // 持锁通知，避免等待方检查计数后、进入等待前错过唤醒
+        std::lock_guard<std::mutex> lock(m_pending_mutex);
+        m_pending_cond.notify_all();
+    }
+}
+
+void OrderBrokerBase::waitOrders() const {
+    std::unique_lock<std::mutex> lock(m_pending_mutex);
+    m_pending_cond.wait(
+      lock, [this]() { return m_pending_orders.load(std::memory_order_acquire) == 0; });
+}
+
+void OrderBrokerBase::resetLatency() {
+    m_queue_latency.reset();
+    m_ack_latency.reset();
+    m_total_latency.reset();
+}
+
+string OrderBrokerBase::getLatencyInfo() const {
+    return fmt::format("queue: {}\nack: {}\ntotal: {}", m_queue_latency.str(),
+                       m_ack_latency.str(), m_total_latency.str());
 }
 
 string OrderBrokerBase::getAssetInfo() noexcept {
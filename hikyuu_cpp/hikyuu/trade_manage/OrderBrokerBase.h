@@ -9,8 +9,12 @@
 #ifndef TRADE_MANAGE_ORDERBROKERBASE_H_
 #define TRADE_MANAGE_ORDERBROKERBASE_H_
 
+#include <condition_variable>
+#include <functional>
+#include <mutex>
 #include "../DataType.h"
 #include "../utilities/Parameter.h"
+#include "../utilities/LatencyHistogram.h"
 #include "../trade_sys/system/SystemPart.h"
 
 namespace hku {
@@ -33,6 +37,48 @@ struct HKU_API BrokerPositionRecord {
 
 HKU_API std::ostream& operator<<(std::ostream& os, const BrokerPositionRecord&);
 
+class OrderBrokerBase;
+
+/**
+ * 订单代理委托记录，记录委托内容、执行结果及各阶段时间戳
+ * @details 时间戳为 steady_clock 纳秒计数，仅用于计算耗时：
+ * <pre>
+ * signal_ns: 调用 buy/sell 发出指令的时刻
+ * submit_ns: 开始调用代理接口（_buy/_sell）的时刻
+ * ack_ns:    代理接口返回（委托被确认）的时刻
+ * </pre>
+ * @ingroup OrderBroker
+ */
+struct HKU_API BrokerOrder {
+    enum Business : uint8_t { BUY = 0, SELL = 1 };
+
+    shared_ptr<OrderBrokerBase> broker;  // 异步执行时持有代理实例
+    Business business{BUY};
+    Datetime datetime;           // 策略指示时间
+    string market;               // 市场标识
+    string code;                 // 证券代码
+    price_t price{0.0};          // 委托价格
+    double num{0.0};             // 委托数量
+    price_t stoploss{0.0};       // 预期的止损价
+    price_t goalPrice{0.0};      // 预期的目标价位
+    SystemPart from{PART_INVALID};  // 系统部件来源
+
+    int64_t signal_ns{0};
+    int64_t submit_ns{0};
+    int64_t ack_ns{0};
+    bool success{false};  // 代理接口是否正常返回
+    string error;         // 代理接口抛出的异常信息
+
+    /** 当前时间戳（steady_clock 纳秒计数） */
+    static int64_t now() noexcept;
+
+    string str() const;
+};
+
+typedef vector<BrokerOrder> BrokerOrderList;
+
+HKU_API std::ostream& operator<<(std::ostream& os, const BrokerOrder&);
+
 /**
  * 订单代理基类，实现实际的订单操作及程序化的订单。
  * @details 可通过向 TradeManager.regBroker 向 TradeManager 注册多个订单代理实例。
@@ -45,12 +91,19 @@ HKU_API std::ostream& operator<<(std::ostream& os, const BrokerPositionRecord&);
  *          买入/卖出指令的时刻进行控制，会导致代理发送错误的指令 。因此，需要指定在某一个时刻之后，
  *          才允许执行订单代理的买入/卖出操作。TradeManager的属性 brokeLastDatetime 即用于
  *          指定该时刻。
+ *
+ *          参数 async（默认 false）为 true 时，buy/sell 仅将委托放入全局订单分发队列，由独立的
+ *          分发线程按订单代理分批调用 _sendOrders，避免响应缓慢的订单代理阻塞策略的事件循环。
+ *          可通过 setOrderCallback 获取执行结果，通过 getTotalLatency 等获取各阶段的耗时分布。
  * @ingroup OrderBroker
  */
-class HKU_API OrderBrokerBase {
+class HKU_API OrderBrokerBase : public std::enable_shared_from_this<OrderBrokerBase> {
     PARAMETER_SUPPORT
 
 public:
+    /** 订单执行完毕（代理接口返回）后的回调 */
+    typedef std::function<void(const BrokerOrder&)> OrderCallback;
+
     OrderBrokerBase();
     OrderBrokerBase(const string& name);
     virtual ~OrderBrokerBase();
@@ -63,6 +116,8 @@ public:
 
     /**
      * 执行买入操作
+     * @note 参数 async 为 true 且实例由 shared_ptr 管理时，仅将委托放入全局订单分发队列后立即返回，
+     *       由分发线程调用 _buy，不阻塞调用线程；否则在当前线程中直接调用 _buy
      * @param datetime 策略指示时间
      * @param market 市场标识
      * @param code 证券代码
@@ -113,6 +168,33 @@ public:
      */
     string getAssetInfo() noexcept;
 
+    /**
+     * 设置订单执行完毕后的回调，异步模式下在分发线程中调用
+     * @note 需在发出委托前设置
+     */
+    void setOrderCallback(const OrderCallback& callback);
+
+    /** 等待已异步提交的订单全部执行完毕 */
+    void waitOrders() const;
+
+    /** 尚未执行完毕的异步订单数 */
+    size_t pendingOrders() const;
+
+    /** 排队耗时统计：发出指令至开始调用代理接口 */
+    const LatencyHistogram& getQueueLatency() const;
+
+    /** 确认耗时统计：调用代理接口至接口返回 */
+    const LatencyHistogram& getAckLatency() const;
+
+    /** 总耗时统计：发出指令至代理接口返回 */
+    const LatencyHistogram& getTotalLatency() const;
+
+    /** 清除耗时统计 */
+    void resetLatency();
+
+    /** 获取耗时统计摘要 */
+    string getLatencyInfo() const;
+
     /**
      * 子类实现接口，执行实际买入操作
      * @param datetime 策略指示时间
@@ -145,9 +227,39 @@ public:
         return string();
     }
 
+    /**
+     * 子类可选接口，批量执行同一批次中属于本代理的委托（如合并为一次请求发送）
+     * @details 默认逐个调用 _buy/_sell。子类实现时需为每个委托设置 success/error，
+     *          未设置的 submit_ns/ack_ns 以本接口的调用/返回时刻代替
+     * @param orders 按发出顺序排列的委托
+     */
+    virtual void _sendOrders(BrokerOrderList& orders);
+
+protected:
+    /** 调用 _buy/_sell 执行单个委托，并记录时间戳及执行结果 */
+    void _executeOrder(BrokerOrder& order) noexcept;
+
+private:
+    friend class OrderDispatcher;
+    void _submit(BrokerOrder&& order) noexcept;
+    void _dispatchOrders(BrokerOrderList& orders) noexcept;
+    void _completeOrder(BrokerOrder& order) noexcept;
+
+    // 异步订单执行完毕，待执行订单数归零时唤醒 waitOrders
+    void _finishPendingOrder() noexcept;
+
 protected:
     string m_name;
 
+private:
+    OrderCallback m_order_callback;
+    std::atomic<size_t> m_pending_orders{0};
+    mutable std::mutex m_pending_mutex;
+    mutable std::condition_variable m_pending_cond;
+    LatencyHistogram m_queue_latency;
+    LatencyHistogram m_ack_latency;
+    LatencyHistogram m_total_latency;
+
 //============================================
 // 序列化支持
 //============================================
@@ -194,6 +306,26 @@ inline void OrderBrokerBase::name(const string& name) {
     m_name = name;
 }
 
+inline void OrderBrokerBase::setOrderCallback(const OrderCallback& callback) {
+    m_order_callback = callback;
+}
+
+inline size_t OrderBrokerBase::pendingOrders() const {
+    return m_pending_orders.load(std::memory_order_acquire);
+}
+
+inline const LatencyHistogram& OrderBrokerBase::getQueueLatency() const {
+    return m_queue_latency;
+}
+
+inline const LatencyHistogram& OrderBrokerBase::getAckLatency() const {
+    return m_ack_latency;
+}
+
+inline const LatencyHistogram& OrderBrokerBase::getTotalLatency() const {
+    return m_total_latency;
+}
+
 } /* namespace hku */
 
 #if FMT_VERSION >= 90000
@@ -202,6 +334,9 @@ struct fmt::formatter<hku::OrderBrokerBase> : ostream_formatter {};
 
 template <>
 struct fmt::formatter<hku::OrderBrokerPtr> : ostream_formatter {};
+
+template <>
+struct fmt::formatter<hku::BrokerOrder> : ostream_formatter {};
 #endif
 
 #endif /* TRADE_MANAGE_ORDERBROKERBASE_H_ */
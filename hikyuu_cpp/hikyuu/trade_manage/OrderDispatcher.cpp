@@ -0,0 +1,147 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#include "OrderDispatcher.h"
+
+namespace hku {
+
+static std::atomic<OrderDispatcher*> g_order_dispatcher{nullptr};
+static std::mutex g_order_dispatcher_mutex;
+
+OrderDispatcher* getGlobalOrderDispatcher() {
+    OrderDispatcher* dispatcher = g_order_dispatcher.load(std::memory_order_acquire);
+    if (!dispatcher) {
+        std::lock_guard<std::mutex> lock(g_order_dispatcher_mutex);
+        dispatcher = g_order_dispatcher.load(std::memory_order_relaxed);
+        if (!dispatcher) {
+            dispatcher = new OrderDispatcher();
+            g_order_dispatcher.store(dispatcher, std::memory_order_release);
+        }
+    }
+    return dispatcher;
+}
+
+void releaseGlobalOrderDispatcher() {
+    std::lock_guard<std::mutex> lock(g_order_dispatcher_mutex);
+    OrderDispatcher* dispatcher = g_order_dispatcher.exchange(nullptr);
+    if (dispatcher) {
+        HKU_TRACE("release order dispatcher");
+        delete dispatcher;
+    }
+}
+
+OrderDispatcher::OrderDispatcher() {
+    m_thread = std::thread([this]() { _run(); });
+}
+
+OrderDispatcher::~OrderDispatcher() {
+    stop();
+}
+
+bool OrderDispatcher::submit(BrokerOrder&& order) {
+    HKU_ASSERT(order.broker);
+    m_submitting.fetch_add(1);
+    if (m_stop.load()) {
+        m_submitting.fetch_sub(1);
+        return false;
+    }
+
+    m_queue.push(std::move(order));
+
+    // 与 _wait 中的检测配对，避免分发线程在检测队列为空后错过唤醒
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_waiting.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cv.notify_one();
+    }
+    m_submitting.fetch_sub(1);
+    return true;
+}
+
+void OrderDispatcher::stop() {
+    std::lock_guard<std::mutex> stop_lock(m_stop_mutex);
+    HKU_IF_RETURN(!m_thread.joinable(), void());
+
+    m_stop.store(true);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cv.notify_one();
+    }
+    m_thread.join();
+
+    // 等待停止前已开始的提交完成，在当前线程中执行剩余的委托
+    while (m_submitting.load() != 0) {
+        std::this_thread::yield();
+    }
+    BrokerOrderList batch;
+    BrokerOrder order;
+    while (m_queue.try_pop(order)) {
+        batch.emplace_back(std::move(order));
+    }
+    _dispatch(batch);
+}
+
+void OrderDispatcher::_wait() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_waiting.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_queue.empty() && !m_stop.load()) {
+        // 超时仅作为保险，正常情况下由 submit 唤醒
+        m_cv.wait_for(lock, std::chrono::milliseconds(100));
+    }
+    m_waiting.store(false, std::memory_order_relaxed);
+}
+
+void OrderDispatcher::_run() {
+    BrokerOrderList batch;
+    batch.reserve(MAX_BATCH);
+    BrokerOrder order;
+    while (true) {
+        while (batch.size() < MAX_BATCH && m_queue.try_pop(order)) {
+            batch.emplace_back(std::move(order));
+        }
+
+        if (batch.empty()) {
+            if (m_stop.load()) {
+                break;
+            }
+            _wait();
+            continue;
+        }
+
+        _dispatch(batch);
+        batch.clear();
+    }
+}
+
+void OrderDispatcher::_dispatch(BrokerOrderList& batch) {
+    // 代理数量通常很少，线性查找即可
+    for (auto& order : batch) {
+        OrderBrokerBase* broker = order.broker.get();
+        auto iter = std::find_if(m_groups.begin(), m_groups.end(),
+                                 [broker](const auto& group) { return group.first == broker; });
+        if (iter == m_groups.end()) {
+            m_groups.emplace_back(broker, BrokerOrderList());
+            iter = m_groups.end() - 1;
+        }
+        iter->second.emplace_back(std::move(order));
+    }
+
+    for (auto& group : m_groups) {
+        if (!group.second.empty()) {
+            group.first->_dispatchOrders(group.second);
+            group.second.clear();
+        }
+    }
+
+    // 代理指针仅在本批次内有效，避免缓存无限增长
+    if (m_groups.size() > 64) {
+        m_groups.clear();
+    }
+}
+
+}  // namespace hku
@@ -0,0 +1,83 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#pragma once
+#ifndef TRADE_MANAGE_ORDERDISPATCHER_H_
+#define TRADE_MANAGE_ORDERDISPATCHER_H_
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "../utilities/thread/MPSCQueue.h"
+#include "OrderBrokerBase.h"
+
+namespace hku {
+
+/**
+ * 异步订单分发器
+ * @details
+ * <pre>
+ * 各线程通过无锁队列提交委托，由一个独立的分发线程按提交顺序批量取出，
+ * 按订单代理分组后调用各代理的 _sendOrders，记录耗时并执行完成回调。
+ * 同一订单代理的委托按提交顺序执行。
+ * </pre>
+ * @ingroup OrderBroker
+ */
+class HKU_API OrderDispatcher {
+public:
+    /** 每批次最多取出的委托数 */
+    static constexpr size_t MAX_BATCH = 256;
+
+    OrderDispatcher();
+    virtual ~OrderDispatcher();
+
+    OrderDispatcher(const OrderDispatcher&) = delete;
+    OrderDispatcher& operator=(const OrderDispatcher&) = delete;
+
+    /**
+     * 提交委托，可由任意线程调用
+     * @param order 委托，其 broker 不能为空
+     * @return 分发器已停止时返回 false，此时委托不被接收
+     */
+    bool submit(BrokerOrder&& order);
+
+    /** 执行完已接收的委托后停止分发线程 */
+    void stop();
+
+    /** 是否正在运行 */
+    bool isRunning() const {
+        return !m_stop.load(std::memory_order_acquire);
+    }
+
+private:
+    void _run();
+    void _wait();
+    void _dispatch(BrokerOrderList& batch);
+
+private:
+    MPSCQueue<BrokerOrder> m_queue;
+    std::atomic<bool> m_stop{false};
+    std::atomic<bool> m_waiting{false};   // 分发线程是否等待唤醒
+    std::atomic<size_t> m_submitting{0};  // 正在提交的委托数，用于停止时收集剩余委托
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::mutex m_stop_mutex;
+    std::thread m_thread;
+
+    // 分组缓存：订单代理 -> 本批次中属于该代理的委托，仅在分发线程中使用
+    vector<std::pair<OrderBrokerBase*, BrokerOrderList>> m_groups;
+};
+
+/** 获取全局订单分发器，首次调用时创建并启动分发线程 */
+HKU_API OrderDispatcher* getGlobalOrderDispatcher();
+
+/** 停止并释放全局订单分发器，仅在退出时调用 */
+HKU_API void releaseGlobalOrderDispatcher();
+
+}  // namespace hku
+
+#endif /* TRADE_MANAGE_ORDERDISPATCHER_H_ */
@@ -106,6 +106,11 @@ public:
     /** 继承子类必须实现私有变量的克隆接口 */
     virtual TradeCostPtr _clone() = 0;
 
+    /** 是否为 python 中实现的子类，python 实现的部件不能在多线程中并发执行 */
+    virtual bool isPythonObject() const {
+        return false;
+    }
+
 private:
     string m_name;
 
@@ -0,0 +1,189 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#include "TradeLedger.h"
+
+namespace hku {
+
+void TradeLedger::CumColumn::append(size_t i, double delta) {
+    value.push_back(value.empty() ? delta : value.back() + delta);
+    pos.push_back(i);
+}
+
+double TradeLedger::CumColumn::valueIn(size_t count) const {
+    // 前 count 条交易记录在 pos 中对应的记录数
+    size_t n = std::lower_bound(pos.begin(), pos.end(), count) - pos.begin();
+    return n > 0 ? value[n - 1] : 0.0;
+}
+
+void TradeLedger::clear() {
+    m_dates.clear();
+    m_stock_ids.clear();
+    m_business.clear();
+    m_from.clear();
+    m_plan_price.clear();
+    m_real_price.clear();
+    m_goal_price.clear();
+    m_number.clear();
+    m_cost.clear();
+    m_stoploss.clear();
+    m_cash.clear();
+    m_sorted = true;
+
+    m_stocks.clear();
+    m_columns.clear();
+    m_stock_map.clear();
+    m_debt_cash = CumColumn();
+
+    m_history_count = 0;
+    m_last_history.clear();
+}
+
+uint32_t TradeLedger::_getStockId(const Stock& stock) {
+    auto iter = m_stock_map.find(stock.market_code());
+    HKU_IF_RETURN(iter != m_stock_map.end(), iter->second);
+
+    uint32_t id = static_cast<uint32_t>(m_stocks.size());
+    m_stocks.push_back(stock);
+    m_columns.emplace_back();
+    m_stock_map[stock.market_code()] = id;
+    return id;
+}
+
+void TradeLedger::push_back(const TradeRecord& record) {
+    size_t i = m_dates.size();
+    if (i > 0 && record.datetime < m_dates.back()) {
+        m_sorted = false;
+    }
+
+    uint32_t id = _getStockId(record.stock);
+    m_dates.push_back(record.datetime);
+    m_stock_ids.push_back(id);
+    m_business.push_back(static_cast<uint8_t>(record.business));
+    m_from.push_back(static_cast<uint8_t>(record.from));
+    m_plan_price.push_back(record.planPrice);
+    m_real_price.push_back(record.realPrice);
+    m_goal_price.push_back(record.goalPrice);
+    m_number.push_back(record.number);
+    m_cost.push_back(record.cost);
+    m_stoploss.push_back(record.stoploss);
+    m_cash.push_back(record.cash);
+
+    StockColumn& column = m_columns[id];
+    switch (record.business) {
+        case BUSINESS_BUY:
+        case BUSINESS_GIFT:
+        case BUSINESS_CHECKIN_STOCK:
+            column.hold.append(i, record.number);
+            break;
+        case BUSINESS_SELL:
+        case BUSINESS_CHECKOUT_STOCK:
+            column.hold.append(i, -record.number);
+            break;
+        case BUSINESS_SELL_SHORT:
+            column.short_hold.append(i, record.number);
+            break;
+        case BUSINESS_BUY_SHORT:
+            column.short_hold.append(i, -record.number);
+            break;
+        case BUSINESS_BORROW_STOCK:
+            column.debt.append(i, record.number);
+            break;
+        case BUSINESS_RETURN_STOCK:
+            column.debt.append(i, -record.number);
+            break;
+        case BUSINESS_BORROW_CASH:
+            m_debt_cash.append(i, record.realPrice);
+            break;
+        case BUSINESS_RETURN_CASH:
+            m_debt_cash.append(i, -record.realPrice);
+            break;
+        default:
+            // 其他业务不影响持仓
+            break;
+    }
+}
+
+TradeRecord TradeLedger::operator[](size_t pos) const {
+    return TradeRecord(m_stocks[m_stock_ids[pos]], m_dates[pos],
+                       static_cast<BUSINESS>(m_business[pos]), m_plan_price[pos],
+                       m_real_price[pos], m_goal_price[pos], m_number[pos], m_cost[pos],
+                       m_stoploss[pos], m_cash[pos], static_cast<SystemPart>(m_from[pos]));
+}
+
+TradeRecordList TradeLedger::getTradeList(size_t start, size_t end) const {
+    TradeRecordList result;
+    end = std::min(end, m_dates.size());
+    HKU_IF_RETURN(start >= end, result);
+    result.reserve(end - start);
+    for (size_t i = start; i < end; i++) {
+        result.push_back((*this)[i]);
+    }
+    return result;
+}
+
+size_t TradeLedger::lowerBound(const Datetime& datetime) const {
+    return std::lower_bound(m_dates.begin(), m_dates.end(), datetime) - m_dates.begin();
+}
+
+size_t TradeLedger::countUntil(const Datetime& datetime) const {
+    if (m_sorted) {
+        return std::upper_bound(m_dates.begin(), m_dates.end(), datetime) - m_dates.begin();
+    }
+
+    // 交易日期无序时与按序遍历保持一致，遇到首个大于指定时刻的记录即停止
+    size_t total = m_dates.size();
+    for (size_t i = 0; i < total; i++) {
+        if (m_dates[i] > datetime) {
+            return i;
+        }
+    }
+    return total;
+}
+
+const TradeLedger::StockColumn* TradeLedger::_getColumn(const Stock& stock) const {
+    auto iter = m_stock_map.find(stock.market_code());
+    return iter != m_stock_map.end() ? &m_columns[iter->second] : nullptr;
+}
+
+double TradeLedger::getHoldNumber(const Stock& stock, size_t count) const {
+    const StockColumn* column = _getColumn(stock);
+    return column ? column->hold.valueIn(count) : 0.0;
+}
+
+double TradeLedger::getShortHoldNumber(const Stock& stock, size_t count) const {
+    const StockColumn* column = _getColumn(stock);
+    return column ? column->short_hold.valueIn(count) : 0.0;
+}
+
+double TradeLedger::getDebtNumber(const Stock& stock, size_t count) const {
+    const StockColumn* column = _getColumn(stock);
+    return column ? column->debt.valueIn(count) : 0.0;
+}
+
+price_t TradeLedger::getDebtCash(size_t count) const {
+    return m_debt_cash.valueIn(count);
+}
+
+void TradeLedger::updateHistory(const PositionRecordList& history) {
+    size_t total = history.size();
+    if (total < m_history_count) {
+        m_history_count = 0;
+        m_last_history.clear();
+    }
+    for (size_t i = m_history_count; i < total; i++) {
+        m_last_history[history[i].stock.market_code()] = i;
+    }
+    m_history_count = total;
+}
+
+size_t TradeLedger::getLastHistoryPos(const Stock& stock) const {
+    auto iter = m_last_history.find(stock.market_code());
+    return iter != m_last_history.end() ? iter->second : Null<size_t>();
+}
+
+}  // namespace hku
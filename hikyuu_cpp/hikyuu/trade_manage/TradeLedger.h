@@ -0,0 +1,169 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#pragma once
+#ifndef TRADE_MANAGE_TRADE_LEDGER_H_
+#define TRADE_MANAGE_TRADE_LEDGER_H_
+
+#include "TradeRecord.h"
+#include "PositionRecord.h"
+
+namespace hku {
+
+/**
+ * 按列存储的交易记录，TradeManager 以此代替 TradeRecordList 保存全部交易记录
+ * @details
+ * <pre>
+ * 交易记录的各字段分列保存，证券以编号代替 Stock 实例，业务类型及信号来源以单字节保存，
+ * 需要 TradeRecord 时按位置即时生成。
+ * 同时按证券分别保存影响多头持仓、空头持仓、借入股票的交易位置及其累计数量，
+ * 历史时刻的持仓查询由遍历全部交易记录变为二分查找。
+ * 查询结果与按顺序遍历交易记录、直至交易日期大于查询时刻为止的累计结果一致。
+ * 以市场简称+证券代码区分证券，与 Stock::operator== 一致，同一证券的不同实例生成记录时
+ * 统一使用首次加入时的实例。
+ * </pre>
+ * @ingroup TradeManagerClass
+ */
+class HKU_API TradeLedger {
+public:
+    TradeLedger() = default;
+    TradeLedger(const TradeLedger&) = default;
+    TradeLedger(TradeLedger&&) = default;
+    TradeLedger& operator=(const TradeLedger&) = default;
+    TradeLedger& operator=(TradeLedger&&) = default;
+    ~TradeLedger() = default;
+
+    /** 清空交易记录及持仓历史索引 */
+    void clear();
+
+    /** 交易记录数 */
+    size_t size() const noexcept {
+        return m_dates.size();
+    }
+
+    /** 是否无交易记录 */
+    bool empty() const noexcept {
+        return m_dates.empty();
+    }
+
+    /** 追加交易记录 */
+    void push_back(const TradeRecord& record);
+
+    /** 生成指定位置的交易记录，调用者需保证位置有效 */
+    TradeRecord operator[](size_t pos) const;
+
+    /** 生成最后一条交易记录，调用者需保证非空 */
+    TradeRecord back() const {
+        return (*this)[m_dates.size() - 1];
+    }
+
+    /** 指定位置交易记录的交易日期 */
+    const Datetime& datetime(size_t pos) const {
+        return m_dates[pos];
+    }
+
+    /** 指定位置交易记录的业务类型 */
+    BUSINESS business(size_t pos) const {
+        return static_cast<BUSINESS>(m_business[pos]);
+    }
+
+    /** 生成全部交易记录 */
+    TradeRecordList getTradeList() const {
+        return getTradeList(0, m_dates.size());
+    }
+
+    /** 生成位置范围 [start, end) 内的交易记录 */
+    TradeRecordList getTradeList(size_t start, size_t end) const;
+
+    /**
+     * 首条交易日期不小于指定时刻的交易记录位置，要求交易日期有序
+     * @param datetime 指定时刻
+     */
+    size_t lowerBound(const Datetime& datetime) const;
+
+    /**
+     * 截止到指定时刻（含）的交易记录数
+     * @param datetime 指定时刻
+     */
+    size_t countUntil(const Datetime& datetime) const;
+
+    /**
+     * 前 count 条交易记录累计的多头持仓数量
+     * @param stock 指定证券
+     * @param count 交易记录数，通常由 countUntil 获得
+     */
+    double getHoldNumber(const Stock& stock, size_t count) const;
+
+    /** 前 count 条交易记录累计的空头持仓数量 */
+    double getShortHoldNumber(const Stock& stock, size_t count) const;
+
+    /** 前 count 条交易记录累计的借入股票数量 */
+    double getDebtNumber(const Stock& stock, size_t count) const;
+
+    /** 前 count 条交易记录累计的借入资金 */
+    price_t getDebtCash(size_t count) const;
+
+    /**
+     * 将持仓历史记录中新增的记录编入索引，列表短于已索引的记录数时重建
+     * @param history 持仓历史记录
+     */
+    void updateHistory(const PositionRecordList& history);
+
+    /**
+     * 指定证券最后一条持仓历史记录的位置
+     * @return 不存在时返回 Null<size_t>()
+     */
+    size_t getLastHistoryPos(const Stock& stock) const;
+
+private:
+    // 影响某类持仓的交易记录位置及截至该记录（含）的累计数量
+    struct CumColumn {
+        vector<size_t> pos;
+        vector<double> value;
+
+        void append(size_t i, double delta);
+        double valueIn(size_t count) const;
+    };
+
+    // 单个证券的多头持仓、空头持仓、借入股票累计
+    struct StockColumn {
+        CumColumn hold;
+        CumColumn short_hold;
+        CumColumn debt;
+    };
+
+    // 证券编号，首次出现的证券追加至证券列表
+    uint32_t _getStockId(const Stock& stock);
+    const StockColumn* _getColumn(const Stock& stock) const;
+
+private:
+    vector<Datetime> m_dates;      // 交易日期
+    vector<uint32_t> m_stock_ids;  // 证券编号
+    vector<uint8_t> m_business;    // 业务类型
+    vector<uint8_t> m_from;        // 信号来源
+    vector<price_t> m_plan_price;  // 计划交易价格
+    vector<price_t> m_real_price;  // 实际交易价格
+    vector<price_t> m_goal_price;  // 目标价格
+    vector<double> m_number;       // 成交数量
+    vector<CostRecord> m_cost;     // 交易成本
+    vector<price_t> m_stoploss;    // 止损价
+    vector<price_t> m_cash;        // 现金余额
+    bool m_sorted{true};           // 交易日期是否有序
+
+    vector<Stock> m_stocks;                       // 证券编号 -> 证券
+    vector<StockColumn> m_columns;                // 证券编号 -> 持仓累计
+    unordered_map<string, uint32_t> m_stock_map;  // 证券标识 -> 证券编号
+
+    CumColumn m_debt_cash;  // 借入资金累计
+
+    size_t m_history_count{0};                     // 已编入索引的持仓历史记录数
+    unordered_map<string, size_t> m_last_history;  // 证券标识 -> 最后一条持仓历史记录位置
+};
+
+}  // namespace hku
+
+#endif /* TRADE_MANAGE_TRADE_LEDGER_H_ */
@@ -95,11 +95,10 @@ TradeManager::TradeManager(const Datetime& datetime, price_t initcash, const Tra
     m_init_cash = roundEx(initcash, 2);
     m_cash = m_init_cash;
     m_checkin_cash = m_init_cash;
-    m_trade_list.push_back(TradeRecord(Null<Stock>(), m_init_datetime, BUSINESS_INIT, m_init_cash,
-                                       m_init_cash, 0.0, 0, CostRecord(), 0.0, m_cash,
-                                       PART_INVALID));
+    m_ledger.push_back(TradeRecord(Null<Stock>(), m_init_datetime, BUSINESS_INIT, m_init_cash,
+                                   m_init_cash, 0.0, 0, CostRecord(), 0.0, m_cash, PART_INVALID));
     m_broker_last_datetime = Datetime::now();
-    _saveAction(m_trade_list.back());
+    _saveAction(m_ledger.back());
 }
 
 TradeManager::~TradeManager() {}
@@ -116,15 +115,14 @@ void TradeManager::_reset() {
     m_loan_list.clear();
     m_borrow_stock.clear();
 
-    m_trade_list.clear();
-    m_trade_list.push_back(TradeRecord(Null<Stock>(), m_init_datetime, BUSINESS_INIT, m_init_cash,
-                                       m_init_cash, 0.0, 0, CostRecord(), 0.0, m_cash,
-                                       PART_INVALID));
+    m_ledger.clear();
+    m_ledger.push_back(TradeRecord(Null<Stock>(), m_init_datetime, BUSINESS_INIT, m_init_cash,
+                                   m_init_cash, 0.0, 0, CostRecord(), 0.0, m_cash, PART_INVALID));
 
     m_position.clear();
     m_position_history.clear();
     m_actions.clear();
-    _saveAction(m_trade_list.back());
+    _saveAction(m_ledger.back());
 }
 
 TradeManagerPtr TradeManager::_clone() {
@@ -141,7 +139,7 @@ TradeManagerPtr TradeManager::_clone() {
     p->m_borrow_cash = m_borrow_cash;
     p->m_loan_list = m_loan_list;
     p->m_borrow_stock = m_borrow_stock;
-    p->m_trade_list = m_trade_list;
+    p->m_ledger = m_ledger;
     p->m_position = m_position;
     p->m_position_history = m_position_history;
     p->m_actions = m_actions;
@@ -155,10 +153,10 @@ double TradeManager::getMarginRate(const Datetime& datetime, const Stock& stock)
 
 Datetime TradeManager::firstDatetime() const {
     Datetime result;
-    TradeRecordList::const_iterator iter = m_trade_list.begin();
-    for (; iter != m_trade_list.end(); ++iter) {
-        if (iter->business == BUSINESS_BUY) {
-            result = iter->datetime;
+    size_t total = m_ledger.size();
+    for (size_t i = 0; i < total; i++) {
+        if (m_ledger.business(i) == BUSINESS_BUY) {
+            result = m_ledger.datetime(i);
             break;
         }
     }
@@ -182,29 +180,7 @@ double TradeManager::getHoldNumber(const Datetime& datetime, const Stock& stock)
     }
 
     // 在历史交易记录中，重新计算在指定的查询日期时，该交易对象的持仓数量
-    double number = 0;
-    TradeRecordList::const_iterator iter = m_trade_list.begin();
-    for (; iter != m_trade_list.end(); ++iter) {
-        // 交易记录中的交易日期已经大于查询日期，则跳出循环
-        if (iter->datetime > datetime) {
-            break;
-        }
-
-        if (iter->stock == stock) {
-            if (BUSINESS_BUY == iter->business || BUSINESS_GIFT == iter->business ||
-                BUSINESS_CHECKIN_STOCK == iter->business) {
-                number += iter->number;
-
-            } else if (BUSINESS_SELL == iter->business ||
-                       BUSINESS_CHECKOUT_STOCK == iter->business) {
-                number -= iter->number;
-
-            } else {
-                // 其他情况忽略
-            }
-        }
-    }
-    return number;
+    return m_ledger.getHoldNumber(stock, m_ledger.countUntil(datetime));
 }
 
 double TradeManager::getShortHoldNumber(const Datetime& datetime, const Stock& stock) {
@@ -224,27 +200,7 @@ double TradeManager::getShortHoldNumber(const Datetime& datetime, const Stock& s
     }
 
     // 在历史交易记录中，重新计算在指定的查询日期时，该交易对象的持仓数量
-    double number = 0;
-    TradeRecordList::const_iterator iter = m_trade_list.begin();
-    for (; iter != m_trade_list.end(); ++iter) {
-        // 交易记录中的交易日期已经大于查询日期，则跳出循环
-        if (iter->datetime > datetime) {
-            break;
-        }
-
-        if (iter->stock == stock) {
-            if (BUSINESS_SELL_SHORT == iter->business) {
-                number += iter->number;
-
-            } else if (BUSINESS_BUY_SHORT == iter->business) {
-                number -= iter->number;
-
-            } else {
-                // 其他情况忽略
-            }
-        }
-    }
-    return number;
+    return m_ledger.getShortHoldNumber(stock, m_ledger.countUntil(datetime));
 }
 
 double TradeManager::getDebtNumber(const Datetime& datetime, const Stock& stock) {
@@ -262,21 +218,7 @@ double TradeManager::getDebtNumber(const Datetime& datetime, const Stock& stock)
         return 0;
     }
 
-    double debt_n = 0;
-    TradeRecordList::const_iterator iter = m_trade_list.begin();
-    for (; iter != m_trade_list.end(); ++iter) {
-        if (iter->datetime > datetime) {
-            break;
-        }
-        if (iter->stock == stock) {
-            if (iter->business == BUSINESS_BORROW_STOCK) {
-                debt_n += iter->number;
-            } else if (iter->business == BUSINESS_RETURN_STOCK) {
-                debt_n -= iter->number;
-            }
-        }
-    }
-    return debt_n;
+    return m_ledger.getDebtNumber(stock, m_ledger.countUntil(datetime));
 }
 
 price_t TradeManager::getDebtCash(const Datetime& datetime) {
@@ -287,19 +229,7 @@ price_t TradeManager::getDebtCash(const Datetime& datetime) {
 
     HKU_IF_RETURN(datetime >= lastDatetime(), m_borrow_cash);
 
-    price_t debt_cash = 0.0;
-    TradeRecordList::const_iterator iter = m_trade_list.begin();
-    for (; iter != m_trade_list.end(); ++iter) {
-        if (iter->datetime > datetime) {
-            break;
-        }
-        if (iter->business == BUSINESS_BORROW_CASH) {
-            debt_cash += iter->realPrice;
-        } else if (iter->business == BUSINESS_RETURN_CASH) {
-            debt_cash -= iter->realPrice;
-        }
-    }
-    return debt_cash;
+    return m_ledger.getDebtCash(m_ledger.countUntil(datetime));
 }
 
 TradeRecordList TradeManager::getTradeList(const Datetime& start_date,
@@ -307,25 +237,8 @@ TradeRecordList TradeManager::getTradeList(const Datetime& start_date,
     TradeRecordList result;
     HKU_IF_RETURN(start_date >= end_date, result);
 
-    size_t total = m_trade_list.size();
-    HKU_IF_RETURN(total == 0, result);
-
-    TradeRecord temp_record;
-    temp_record.datetime = start_date;
-    auto low = lower_bound(
-      m_trade_list.begin(), m_trade_list.end(), temp_record,
-      std::bind(std::less<Datetime>(), std::bind(&TradeRecord::datetime, std::placeholders::_1),
-                std::bind(&TradeRecord::datetime, std::placeholders::_2)));
-
-    temp_record.datetime = end_date;
-    auto high = lower_bound(
-      m_trade_list.begin(), m_trade_list.end(), temp_record,
-      std::bind(std::less<Datetime>(), std::bind(&TradeRecord::datetime, std::placeholders::_1),
-                std::bind(&TradeRecord::datetime, std::placeholders::_2)));
-
-    result.insert(result.end(), low, high);
-
-    return result;
+    HKU_IF_RETURN(m_ledger.empty(), result);
+    return m_ledger.getTradeList(m_ledger.lowerBound(start_date), m_ledger.lowerBound(end_date));
 }
 
 PositionRecordList TradeManager::getPositionList() const {
@@ -364,36 +277,14 @@ PositionRecord TradeManager::getPosition(const Datetime& datetime, const Stock&
     }
 
     // 在历史交易记录中，重新计算在指定的查询日期时，该交易对象的持仓数量
-    double number = 0.0;
-    for (auto iter = m_trade_list.begin(); iter != m_trade_list.end(); ++iter) {
-        // 交易记录中的交易日期已经大于查询日期，则跳出循环
-        if (iter->datetime > datetime) {
-            break;
-        }
-
-        if (iter->stock == stock) {
-            if (BUSINESS_BUY == iter->business || BUSINESS_GIFT == iter->business ||
-                BUSINESS_CHECKIN_STOCK == iter->business) {
-                number += iter->number;
-
-            } else if (BUSINESS_SELL == iter->business ||
-                       BUSINESS_CHECKOUT_STOCK == iter->business) {
-                number -= iter->number;
-
-            } else {
-                // 其他情况忽略
-            }
-        }
-    }
-
+    double number = m_ledger.getHoldNumber(stock, m_ledger.countUntil(datetime));
     HKU_IF_RETURN(0.0 == number, result);
 
-    // 倒序遍历历史持仓，寻找最后一条持仓记录
-    for (auto iter = m_position_history.rbegin(); iter != m_position_history.rend(); ++iter) {
-        if (iter->stock == stock) {
-            result = *iter;
-            break;
-        }
+    // 该交易对象的最后一条历史持仓记录
+    m_ledger.updateHistory(m_position_history);
+    size_t history_pos = m_ledger.getLastHistoryPos(stock);
+    if (history_pos != Null<size_t>()) {
+        result = m_position_history[history_pos];
     }
 
     HKU_WARN_IF(result.stock != stock, "Not found in the history positions, maybe exists error! {}",
@@ -430,9 +321,9 @@ bool TradeManager::checkin(const Datetime& datetime, price_t cash) {
     price_t in_cash = roundEx(cash, precision);
     m_cash = roundEx(m_cash + in_cash, precision);
     m_checkin_cash = roundEx(m_checkin_cash + in_cash, precision);
-    m_trade_list.push_back(TradeRecord(Null<Stock>(), datetime, BUSINESS_CHECKIN, in_cash, in_cash,
-                                       0.0, 0, CostRecord(), 0.0, m_cash, PART_INVALID));
-    _saveAction(m_trade_list.back());
+    m_ledger.push_back(TradeRecord(Null<Stock>(), datetime, BUSINESS_CHECKIN, in_cash, in_cash, 0.0,
+                                   0, CostRecord(), 0.0, m_cash, PART_INVALID));
+    _saveAction(m_ledger.back());
     return true;
 }
 
@@ -453,9 +344,9 @@ bool TradeManager::checkout(const Datetime& datetime, price_t cash) {
 
     m_cash = tmp_cash;
     m_checkout_cash = roundEx(m_checkout_cash + out_cash, precision);
-    m_trade_list.push_back(TradeRecord(Null<Stock>(), datetime, BUSINESS_CHECKOUT, out_cash,
-                                       out_cash, 0.0, 0, CostRecord(), 0.0, m_cash, PART_INVALID));
-    _saveAction(m_trade_list.back());
+    m_ledger.push_back(TradeRecord(Null<Stock>(), datetime, BUSINESS_CHECKOUT, out_cash, out_cash,
+                                   0.0, 0, CostRecord(), 0.0, m_cash, PART_INVALID));
+    _saveAction(m_ledger.back());
     return true;
 }
 
@@ -491,8 +382,8 @@ bool TradeManager::checkinStock(const Datetime& datetime, const Stock& stock, pr
     }
 
     // 加入交易记录
-    m_trade_list.push_back(TradeRecord(stock, datetime, BUSINESS_CHECKIN_STOCK, price, price, 0.0,
-                                       number, CostRecord(), 0.0, m_cash, PART_INVALID));
+    m_ledger.push_back(TradeRecord(stock, datetime, BUSINESS_CHECKIN_STOCK, price, price, 0.0,
+                                   number, CostRecord(), 0.0, m_cash, PART_INVALID));
 
     // 更新累计存入资产价值记录
     m_checkin_stock = roundEx(m_checkin_stock + market_value, precision);
@@ -535,8 +426,8 @@ bool TradeManager::checkoutStock(const Datetime& datetime, const Stock& stock, p
     }
 
     // 更新交易记录
-    m_trade_list.push_back(TradeRecord(stock, datetime, BUSINESS_CHECKOUT_STOCK, price, price, 0.0,
-                                       number, CostRecord(), 0.0, m_cash, PART_INVALID));
+    m_ledger.push_back(TradeRecord(stock, datetime, BUSINESS_CHECKOUT_STOCK, price, price, 0.0,
+                                   number, CostRecord(), 0.0, m_cash, PART_INVALID));
 
     // 更新累计取出股票价值
     m_checkout_stock = roundEx(m_checkout_stock - price * number * stock.unit(), precision);
@@ -558,8 +449,8 @@ bool TradeManager::borrowCash(const Datetime& datetime, price_t cash) {
     m_cash = roundEx(m_cash + in_cash - cost.total, precision);
     m_borrow_cash = roundEx(m_borrow_cash + in_cash, precision);
     m_loan_list.push_back(LoanRecord(datetime, in_cash));
-    m_trade_list.push_back(TradeRecord(Null<Stock>(), datetime, BUSINESS_BORROW_CASH, in_cash,
-                                       in_cash, 0.0, 0, cost, 0.0, m_cash, PART_INVALID));
+    m_ledger.push_back(TradeRecord(Null<Stock>(), datetime, BUSINESS_BORROW_CASH, in_cash, in_cash,
+                                   0.0, 0, cost, 0.0, m_cash, PART_INVALID));
     return true;
 }
 
@@ -625,8 +516,8 @@ bool TradeManager::returnCash(const Datetime& datetime, price_t cash) {
 
     m_cash = roundEx(m_cash - out_cash, precision);
     m_borrow_cash = roundEx(m_borrow_cash - in_cash, precision);
-    m_trade_list.push_back(TradeRecord(Null<Stock>(), datetime, BUSINESS_RETURN_CASH, in_cash,
-                                       in_cash, 0.0, 0, cost, 0.0, m_cash, PART_INVALID));
+    m_ledger.push_back(TradeRecord(Null<Stock>(), datetime, BUSINESS_RETURN_CASH, in_cash, in_cash,
+                                   0.0, 0, cost, 0.0, m_cash, PART_INVALID));
     return true;
 }
 
@@ -653,8 +544,8 @@ bool TradeManager::borrowStock(const Datetime& datetime, const Stock& stock, pri
     m_cash = roundEx(m_cash - cost.total, precision);
 
     // 加入交易记录
-    m_trade_list.push_back(TradeRecord(stock, datetime, BUSINESS_BORROW_STOCK, price, price, 0.0,
-                                       number, cost, 0.0, m_cash, PART_INVALID));
+    m_ledger.push_back(TradeRecord(stock, datetime, BUSINESS_BORROW_STOCK, price, price, 0.0,
+                                   number, cost, 0.0, m_cash, PART_INVALID));
 
     // 更新当前借入股票信息
     borrow_stock_map_type::iterator iter = m_borrow_stock.find(stock.id());
@@ -756,8 +647,8 @@ bool TradeManager::returnStock(const Datetime& datetime, const Stock& stock, pri
     m_cash = roundEx(m_cash - cost.total, precision);
 
     // 更新交易记录
-    m_trade_list.push_back(TradeRecord(stock, datetime, BUSINESS_RETURN_STOCK, price, price, 0.0,
-                                       number, cost, 0.0, m_cash, PART_INVALID));
+    m_ledger.push_back(TradeRecord(stock, datetime, BUSINESS_RETURN_STOCK, price, price, 0.0,
+                                   number, cost, 0.0, m_cash, PART_INVALID));
 
     return true;
 }
@@ -837,7 +728,7 @@ TradeRecord TradeManager::buy(const Datetime& datetime, const Stock& stock, pric
     // 加入交易记录
     result = TradeRecord(stock, datetime, BUSINESS_BUY, planPrice, realPrice, goalPrice, number,
                          cost, stoploss, m_cash, from);
-    m_trade_list.push_back(result);
+    m_ledger.push_back(result);
 
     // 更新当前持仓记录
     position_map_type::iterator pos_iter = m_position.find(stock.id());
@@ -925,7 +816,7 @@ TradeRecord TradeManager::sell(const Datetime& datetime, const Stock& stock, pri
     // 更新交易记录
     result = TradeRecord(stock, datetime, BUSINESS_SELL, planPrice, realPrice, goalPrice,
                          real_number, cost, stoploss, m_cash, from);
-    m_trade_list.push_back(result);
+    m_ledger.push_back(result);
 
     // 更新当前持仓情况
     position.number -= real_number;
@@ -1041,7 +932,7 @@ TradeRecord TradeManager::sellShort(const Datetime& datetime, const Stock& stock
     // 加入交易记录
     result = TradeRecord(stock, datetime, BUSINESS_SELL_SHORT, planPrice, realPrice, goalPrice,
                          sell_num, cost, stoploss, m_cash, from);
-    m_trade_list.push_back(result);
+    m_ledger.push_back(result);
 
     // 更新当前空头持仓记录
     price_t risk = roundEx((stoploss - realPrice) * sell_num * stock.unit(), precision);
@@ -1121,7 +1012,7 @@ TradeRecord TradeManager::buyShort(const Datetime& datetime, const Stock& stock,
     // 更新交易记录
     result = TradeRecord(stock, datetime, BUSINESS_BUY_SHORT, planPrice, realPrice, goalPrice,
                          real_number, cost, stoploss, m_cash, from);
-    m_trade_list.push_back(result);
+    m_ledger.push_back(result);
 
     // 更新当前空头持仓情况
     position.number -= real_number;
@@ -1276,55 +1167,56 @@ FundsRecord TradeManager::getFunds(const Datetime& indatetime, KQuery::KType kty
     map<uint64_t, BorrowRecord> bor_stock_map;
     map<uint64_t, BorrowRecord>::iterator bor_stock_iter;
 
-    TradeRecordList::const_iterator iter = m_trade_list.begin();
-    for (; iter != m_trade_list.end(); ++iter) {
-        if (iter->datetime > datetime) {
+    size_t trade_total = m_ledger.size();
+    for (size_t i = 0; i < trade_total; i++) {
+        TradeRecord record = m_ledger[i];
+        if (record.datetime > datetime) {
             // 如果交易记录的日期大于指定的日期则跳出循环，处理完毕
             break;
         }
 
-        cash = iter->cash;
-        switch (iter->business) {
+        cash = record.cash;
+        switch (record.business) {
             case BUSINESS_INIT:
-                checkin_cash += iter->realPrice;
+                checkin_cash += record.realPrice;
                 break;
 
             case BUSINESS_BUY:
             case BUSINESS_GIFT:
-                stock_iter = stock_map.find(iter->stock.id());
+                stock_iter = stock_map.find(record.stock.id());
                 if (stock_iter != stock_map.end()) {
-                    stock_iter->second.number += iter->number;
+                    stock_iter->second.number += record.number;
                 } else {
-                    stock_map[iter->stock.id()] = Stock_Number(iter->stock, iter->number);
+                    stock_map[record.stock.id()] = Stock_Number(record.stock, record.number);
                 }
                 break;
 
             case BUSINESS_SELL:
-                stock_iter = stock_map.find(iter->stock.id());
+                stock_iter = stock_map.find(record.stock.id());
                 if (stock_iter != stock_map.end()) {
-                    stock_iter->second.number -= iter->number;
+                    stock_iter->second.number -= record.number;
                 } else {
                     HKU_WARN("{} {} Sell error in m_trade_list!", datetime,
-                             iter->stock.market_code());
+                             record.stock.market_code());
                 }
                 break;
 
             case BUSINESS_SELL_SHORT:
-                short_stock_iter = short_stock_map.find(iter->stock.id());
+                short_stock_iter = short_stock_map.find(record.stock.id());
                 if (short_stock_iter != short_stock_map.end()) {
-                    short_stock_iter->second.number += iter->number;
+                    short_stock_iter->second.number += record.number;
                 } else {
-                    short_stock_map[iter->stock.id()] = Stock_Number(iter->stock, iter->number);
+                    short_stock_map[record.stock.id()] = Stock_Number(record.stock, record.number);
                 }
                 break;
 
             case BUSINESS_BUY_SHORT:
-                short_stock_iter = short_stock_map.find(iter->stock.id());
+                short_stock_iter = short_stock_map.find(record.stock.id());
                 if (short_stock_iter != short_stock_map.end()) {
-                    short_stock_iter->second.number -= iter->number;
+                    short_stock_iter->second.number -= record.number;
                 } else {
                     HKU_WARN("{} {} BuyShort Error in m_trade_list!", datetime,
-                             iter->stock.market_code());
+                             record.stock.market_code());
                 }
                 break;
 
@@ -1332,86 +1224,88 @@ FundsRecord TradeManager::getFunds(const Datetime& indatetime, KQuery::KType kty
                 break;
 
             case BUSINESS_CHECKIN:
-                checkin_cash += iter->realPrice;
+                checkin_cash += record.realPrice;
                 break;
 
             case BUSINESS_CHECKOUT:
-                checkout_cash += iter->realPrice;
+                checkout_cash += record.realPrice;
                 break;
 
             case BUSINESS_CHECKIN_STOCK:
-                stock_iter = stock_map.find(iter->stock.id());
+                stock_iter = stock_map.find(record.stock.id());
                 if (stock_iter != stock_map.end()) {
-                    stock_map[iter->stock.id()].number += iter->number;
+                    stock_map[record.stock.id()].number += record.number;
                 } else {
-                    stock_map[iter->stock.id()] = Stock_Number(iter->stock, iter->number);
+                    stock_map[record.stock.id()] = Stock_Number(record.stock, record.number);
                 }
-                checkin_stock = roundEx(
-                  checkin_stock + iter->realPrice * iter->number * iter->stock.unit(), precision);
+                checkin_stock =
+                  roundEx(checkin_stock + record.realPrice * record.number * record.stock.unit(),
+                          precision);
                 break;
 
             case BUSINESS_CHECKOUT_STOCK:
-                stock_iter = stock_map.find(iter->stock.id());
+                stock_iter = stock_map.find(record.stock.id());
                 if (stock_iter != stock_map.end()) {
-                    stock_map[iter->stock.id()].number -= iter->number;
+                    stock_map[record.stock.id()].number -= record.number;
                 } else {
                     HKU_WARN("{} {} CheckoutStock Error in m_trade_list!", datetime,
-                             iter->stock.market_code());
+                             record.stock.market_code());
                 }
-                checkout_stock = roundEx(
-                  checkout_stock + iter->realPrice * iter->number * iter->stock.unit(), precision);
+                checkout_stock =
+                  roundEx(checkout_stock + record.realPrice * record.number * record.stock.unit(),
+                          precision);
                 break;
 
             case BUSINESS_BORROW_CASH:
-                funds.borrow_cash += iter->realPrice;
+                funds.borrow_cash += record.realPrice;
                 break;
 
             case BUSINESS_RETURN_CASH:
-                funds.borrow_cash -= iter->realPrice;
+                funds.borrow_cash -= record.realPrice;
                 break;
 
             case BUSINESS_BORROW_STOCK:
-                funds.borrow_asset =
-                  roundEx(funds.borrow_asset + iter->realPrice * iter->number * iter->stock.unit(),
-                          precision);
-                bor_stock_iter = bor_stock_map.find(iter->stock.id());
+                funds.borrow_asset = roundEx(
+                  funds.borrow_asset + record.realPrice * record.number * record.stock.unit(),
+                  precision);
+                bor_stock_iter = bor_stock_map.find(record.stock.id());
                 if (bor_stock_iter == bor_stock_map.end()) {
                     BorrowRecord bor;
-                    BorrowRecord::Data data(iter->datetime, iter->realPrice, iter->number);
+                    BorrowRecord::Data data(record.datetime, record.realPrice, record.number);
                     bor.record_list.push_back(data);
-                    bor_stock_map[iter->stock.id()] = bor;
+                    bor_stock_map[record.stock.id()] = bor;
                 } else {
-                    BorrowRecord::Data data(iter->datetime, iter->realPrice, iter->number);
+                    BorrowRecord::Data data(record.datetime, record.realPrice, record.number);
                     bor_stock_iter->second.record_list.push_back(data);
                 }
                 break;
 
             case BUSINESS_RETURN_STOCK:
-                bor_stock_iter = bor_stock_map.find(iter->stock.id());
+                bor_stock_iter = bor_stock_map.find(record.stock.id());
                 if (bor_stock_iter == bor_stock_map.end()) {
-                    HKU_WARN("{} {} Error return stock in m_trade_list!", iter->datetime,
-                             iter->stock.market_code());
+                    HKU_WARN("{} {} Error return stock in m_trade_list!", record.datetime,
+                             record.stock.market_code());
 
                 } else {
                     BorrowRecord& bor = bor_stock_iter->second;
-                    size_t remain_num = iter->number;
+                    size_t remain_num = record.number;
                     do {
                         list<BorrowRecord::Data>::iterator bor_iter = bor.record_list.begin();
                         if (remain_num == bor_iter->number) {
-                            funds.borrow_asset -=
-                              roundEx(bor_iter->price * remain_num * iter->stock.unit(), precision);
+                            funds.borrow_asset -= roundEx(
+                              bor_iter->price * remain_num * record.stock.unit(), precision);
                             bor.record_list.pop_front();
                             break;
 
                         } else if (remain_num < bor_iter->number) {
-                            funds.borrow_asset -=
-                              roundEx(bor_iter->price * remain_num * iter->stock.unit(), precision);
+                            funds.borrow_asset -= roundEx(
+                              bor_iter->price * remain_num * record.stock.unit(), precision);
                             bor_iter->number -= remain_num;
                             break;
 
                         } else {  // remain_num > bor_iter->number
                             funds.borrow_asset -= roundEx(
-                              bor_iter->price * bor_iter->number * iter->stock.unit(), precision);
+                              bor_iter->price * bor_iter->number * record.stock.unit(), precision);
                             remain_num -= bor_iter->number;
                             bor.record_list.pop_front();
                         }
@@ -1426,7 +1320,7 @@ FundsRecord TradeManager::getFunds(const Datetime& indatetime, KQuery::KType kty
 
             default:
                 HKU_WARN("{} {} Unknown business in m_trade_list!", datetime,
-                         iter->stock.market_code());
+                         record.stock.market_code());
                 break;
         }
     }
@@ -1533,7 +1427,7 @@ void TradeManager::updateWithWeight(const Datetime& datetime) {
     }
 
     for (size_t i = 0; i < total; ++i) {
-        m_trade_list.push_back(new_trade_buffer[i]);
+        m_ledger.push_back(new_trade_buffer[i]);
     }
 
     m_last_update_datetime = datetime;
@@ -1622,9 +1516,9 @@ void TradeManager::tocsv(const string& path) {
             "止损价,现金余额,信号来源,日期,开盘价,最高价,最低价,收盘价,"
             "成交金额,成交量"
          << std::endl;
-    TradeRecordList::const_iterator trade_iter = m_trade_list.begin();
-    for (; trade_iter != m_trade_list.end(); ++trade_iter) {
-        const TradeRecord& record = *trade_iter;
+    size_t trade_total = m_ledger.size();
+    for (size_t i = 0; i < trade_total; i++) {
+        TradeRecord record = m_ledger[i];
         if (record.stock.isNull()) {
             file << record.datetime << sep << sep << sep << getBusinessName(record.business) << sep
                  << record.planPrice << sep << record.realPrice << sep << record.goalPrice << sep
@@ -1717,7 +1611,7 @@ bool TradeManager::addPosition(const PositionRecord& pr) {
     HKU_ERROR_IF_RETURN(pr.takeDatetime < initDatetime(), false,
                         "Poistion takeDatetime({}) > initDatetime({})", pr.takeDatetime,
                         initDatetime());
-    HKU_ERROR_IF_RETURN(!m_trade_list.empty(), false, "Exist trade list!");
+    HKU_ERROR_IF_RETURN(!m_ledger.empty(), false, "Exist trade list!");
 
     auto iter = m_position.find(pr.stock.id());
     HKU_ERROR_IF_RETURN(iter != m_position.end(), false, "The stock({}) has position!",
@@ -1819,7 +1713,7 @@ bool TradeManager::_add_buy_tr(const TradeRecord& tr) {
 
     m_cash = roundEx(m_cash - money - tr.cost.total, precision);
     new_tr.cash = m_cash;
-    m_trade_list.push_back(new_tr);
+    m_ledger.push_back(new_tr);
 
     // 更新当前持仓记录
     position_map_type::iterator pos_iter = m_position.find(tr.stock.id());
@@ -1868,7 +1762,7 @@ bool TradeManager::_add_sell_tr(const TradeRecord& tr) {
     // 更新交易记录
     TradeRecord new_tr(tr);
     new_tr.cash = m_cash;
-    m_trade_list.push_back(new_tr);
+    m_ledger.push_back(new_tr);
 
     // 更新当前持仓情况
     position.number -= tr.number;
@@ -1896,9 +1790,9 @@ bool TradeManager::_add_checkin_tr(const TradeRecord& tr) {
     price_t in_cash = roundEx(tr.realPrice, precision);
     m_cash = roundEx(m_cash + in_cash, precision);
     m_checkin_cash = roundEx(m_checkin_cash + in_cash, precision);
-    m_trade_list.push_back(TradeRecord(Null<Stock>(), tr.datetime, BUSINESS_CHECKIN, in_cash,
-                                       in_cash, 0.0, 0, CostRecord(), 0.0, m_cash, PART_INVALID));
-    _saveAction(m_trade_list.back());
+    m_ledger.push_back(TradeRecord(Null<Stock>(), tr.datetime, BUSINESS_CHECKIN, in_cash, in_cash,
+                                   0.0, 0, CostRecord(), 0.0, m_cash, PART_INVALID));
+    _saveAction(m_ledger.back());
     return true;
 }
 
@@ -1911,9 +1805,9 @@ bool TradeManager::_add_checkout_tr(const TradeRecord& tr) {
 
     m_cash = roundEx(m_cash - out_cash, precision);
     m_checkout_cash = roundEx(m_checkout_cash + out_cash, precision);
-    m_trade_list.push_back(TradeRecord(Null<Stock>(), tr.datetime, BUSINESS_CHECKOUT, out_cash,
-                                       out_cash, 0.0, 0, CostRecord(), 0.0, m_cash, PART_INVALID));
-    _saveAction(m_trade_list.back());
+    m_ledger.push_back(TradeRecord(Null<Stock>(), tr.datetime, BUSINESS_CHECKOUT, out_cash,
+                                   out_cash, 0.0, 0, CostRecord(), 0.0, m_cash, PART_INVALID));
+    _saveAction(m_ledger.back());
     return true;
 }
 
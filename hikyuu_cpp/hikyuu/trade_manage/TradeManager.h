@@ -12,6 +12,7 @@
 #include "TradeManagerBase.h"
 #include "../utilities/Parameter.h"
 #include "TradeRecord.h"
+#include "TradeLedger.h"
 #include "PositionRecord.h"
 #include "BorrowRecord.h"
 #include "FundsRecord.h"
@@ -68,7 +69,7 @@ public:
 
     /** 最后一笔交易日期，注意和交易类型无关，如未发生交易返回账户建立日期 */
     virtual Datetime lastDatetime() const override {
-        return m_trade_list.empty() ? m_init_datetime : m_trade_list.back().datetime;
+        return m_ledger.empty() ? m_init_datetime : m_ledger.datetime(m_ledger.size() - 1);
     }
 
     /**
@@ -136,7 +137,7 @@ public:
 
     /** 获取全部交易记录 */
     virtual TradeRecordList getTradeList() const override {
-        return m_trade_list;
+        return m_ledger.getTradeList();
     }
 
     /**
@@ -397,7 +398,7 @@ private:
     typedef map<uint64_t, BorrowRecord> borrow_stock_map_type;
     borrow_stock_map_type m_borrow_stock;  // 当前借入的股票及其数量
 
-    TradeRecordList m_trade_list;  // 交易记录
+    TradeLedger m_ledger;  // 交易记录，按列存储
 
     typedef map<uint64_t, PositionRecord> position_map_type;
     position_map_type m_position;  // 当前持仓交易对象的持仓记录 ["sh000001"-> ]
@@ -437,7 +438,8 @@ private:
         position = getShortPositionList();
         ar& bs::make_nvp<PositionRecordList>("m_short_position", position);
         ar& BOOST_SERIALIZATION_NVP(m_short_position_history);
-        ar& BOOST_SERIALIZATION_NVP(m_trade_list);
+        TradeRecordList trade_list = m_ledger.getTradeList();
+        ar& bs::make_nvp<TradeRecordList>("m_trade_list", trade_list);
         ar& BOOST_SERIALIZATION_NVP(m_actions);
     }
 
@@ -475,7 +477,12 @@ private:
             m_short_position[iter->stock.id()] = *iter;
         }
         ar& BOOST_SERIALIZATION_NVP(m_short_position_history);
-        ar& BOOST_SERIALIZATION_NVP(m_trade_list);
+        TradeRecordList trade_list;
+        ar& bs::make_nvp<TradeRecordList>("m_trade_list", trade_list);
+        m_ledger.clear();
+        for (const auto& record : trade_list) {
+            m_ledger.push_back(record);
+        }
         ar& BOOST_SERIALIZATION_NVP(m_actions);
     }
 
@@ -177,6 +177,11 @@ public:
         return shared_ptr<TradeManagerBase>();
     }
 
+    /** 是否为 python 中实现的子类，python 实现的部件不能在多线程中并发执行 */
+    virtual bool isPythonObject() const {
+        return false;
+    }
+
     /**
      * 注册订单代理
      * @param broker 订单代理实例
@@ -0,0 +1,28 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#pragma once
+#ifndef TRADE_MANAGE_CRT_OB_LOOPBACK_H_
+#define TRADE_MANAGE_CRT_OB_LOOPBACK_H_
+
+#include "../OrderBrokerBase.h"
+
+namespace hku {
+
+/**
+ * 创建进程内回环订单代理，委托按指示价格立即全部成交，用于测试及性能评估
+ * @param cash 初始可用资金
+ * @param latency_us 每个委托模拟的确认耗时（微秒）
+ * @param async 是否通过全局订单分发线程异步执行
+ * @see LoopbackOrderBroker
+ * @ingroup OrderBroker
+ */
+OrderBrokerPtr HKU_API OB_Loopback(price_t cash = 0.0, int latency_us = 0, bool async = false);
+
+}  // namespace hku
+
+#endif /* TRADE_MANAGE_CRT_OB_LOOPBACK_H_ */
@@ -0,0 +1,120 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#include <chrono>
+#include <thread>
+#include <nlohmann/json.hpp>
+#include "LoopbackOrderBroker.h"
+
+#if HKU_SUPPORT_SERIALIZATION
+BOOST_CLASS_EXPORT(hku::LoopbackOrderBroker)
+#endif
+
+namespace hku {
+
+using json = nlohmann::json;
+
+LoopbackOrderBroker::LoopbackOrderBroker() : OrderBrokerBase("OB_Loopback") {
+    setParam<double>("cash", 0.0);
+    setParam<int>("latency_us", 0);
+}
+
+LoopbackOrderBroker::~LoopbackOrderBroker() {}
+
+void LoopbackOrderBroker::_simulateLatency() const {
+    int latency = getParam<int>("latency_us");
+    if (latency > 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(latency));
+    }
+}
+
+void LoopbackOrderBroker::_buy(Datetime datetime, const string& market, const string& code,
+                               price_t price, double num, price_t stoploss, price_t goalPrice,
+                               SystemPart from) {
+    _simulateLatency();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Position& pos = m_positions[fmt::format("{}{}", market, code)];
+    if (pos.number == 0.0) {
+        pos.market = market;
+        pos.code = code;
+    }
+    pos.number += num;
+    pos.money += price * num;
+    pos.stoploss = stoploss;
+    pos.goal_price = goalPrice;
+    m_cash_delta -= price * num;
+    m_order_count++;
+}
+
+void LoopbackOrderBroker::_sell(Datetime datetime, const string& market, const string& code,
+                                price_t price, double num, price_t stoploss, price_t goalPrice,
+                                SystemPart from) {
+    _simulateLatency();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    string key = fmt::format("{}{}", market, code);
+    auto iter = m_positions.find(key);
+    HKU_CHECK(iter != m_positions.end() && iter->second.number >= num,
+              "Insufficient position to sell! {} {}", key, num);
+    Position& pos = iter->second;
+    // 按比例扣减买入成本
+    pos.money -= pos.money * num / pos.number;
+    pos.number -= num;
+    pos.stoploss = stoploss;
+    pos.goal_price = goalPrice;
+    if (pos.number == 0.0) {
+        m_positions.erase(iter);
+    }
+    m_cash_delta += price * num;
+    m_order_count++;
+}
+
+string LoopbackOrderBroker::_getAssetInfo() {
+    json result;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    result["datetime"] = Datetime::now().str();
+    result["cash"] = getParam<double>("cash") + m_cash_delta;
+    json positions = json::array();
+    for (const auto& item : m_positions) {
+        const Position& pos = item.second;
+        json record;
+        record["market"] = pos.market;
+        record["code"] = pos.code;
+        record["number"] = pos.number;
+        record["stoploss"] = pos.stoploss;
+        record["goal_price"] = pos.goal_price;
+        record["cost_price"] = pos.number != 0.0 ? pos.money / pos.number : 0.0;
+        positions.push_back(std::move(record));
+    }
+    result["positions"] = std::move(positions);
+    return result.dump();
+}
+
+size_t LoopbackOrderBroker::getOrderCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_order_count;
+}
+
+price_t LoopbackOrderBroker::getCash() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return getParam<double>("cash") + m_cash_delta;
+}
+
+double LoopbackOrderBroker::getPositionNumber(const string& market, const string& code) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto iter = m_positions.find(fmt::format("{}{}", market, code));
+    return iter != m_positions.end() ? iter->second.number : 0.0;
+}
+
+OrderBrokerPtr HKU_API OB_Loopback(price_t cash, int latency_us, bool async) {
+    auto p = make_shared<LoopbackOrderBroker>();
+    p->setParam<double>("cash", cash);
+    p->setParam<int>("latency_us", latency_us);
+    p->setParam<bool>("async", async);
+    return p;
+}
+
+} /* namespace hku */
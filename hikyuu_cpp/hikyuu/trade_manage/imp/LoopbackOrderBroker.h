@@ -0,0 +1,83 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#pragma once
+#ifndef TRADE_MANAGE_IMP_LOOPBACKORDERBROKER_H_
+#define TRADE_MANAGE_IMP_LOOPBACKORDERBROKER_H_
+
+#include <mutex>
+#include "../OrderBrokerBase.h"
+
+namespace hku {
+
+/**
+ * 进程内回环订单代理，委托按指示价格立即全部成交，用于测试及性能评估
+ * @details
+ * <pre>
+ * 参数：
+ * cash: 初始可用资金，默认 0.0（可为负，不做资金检查）
+ * latency_us: 每个委托模拟的确认耗时（微秒），默认 0
+ * </pre>
+ * @ingroup OrderBroker
+ */
+class HKU_API LoopbackOrderBroker : public OrderBrokerBase {
+public:
+    LoopbackOrderBroker();
+    virtual ~LoopbackOrderBroker();
+
+    virtual void _buy(Datetime datetime, const string& market, const string& code, price_t price,
+                      double num, price_t stoploss, price_t goalPrice, SystemPart from) override;
+
+    virtual void _sell(Datetime datetime, const string& market, const string& code,
+                       price_t price, double num, price_t stoploss, price_t goalPrice,
+                       SystemPart from) override;
+
+    virtual string _getAssetInfo() override;
+
+    /** 已成交的委托数 */
+    size_t getOrderCount() const;
+
+    /** 当前可用资金 */
+    price_t getCash() const;
+
+    /** 获取指定证券的持仓数量 */
+    double getPositionNumber(const string& market, const string& code) const;
+
+private:
+    struct Position {
+        string market;
+        string code;
+        double number{0.0};
+        price_t money{0.0};
+        price_t stoploss{0.0};
+        price_t goal_price{0.0};
+    };
+
+    void _simulateLatency() const;
+
+private:
+    mutable std::mutex m_mutex;
+    price_t m_cash_delta{0.0};  // 相对于初始资金的变动
+    size_t m_order_count{0};
+    unordered_map<string, Position> m_positions;  // market + code -> 持仓
+
+//============================================
+// 序列化支持
+//============================================
+#if HKU_SUPPORT_SERIALIZATION
+private:
+    friend class boost::serialization::access;
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int version) {
+        ar& BOOST_SERIALIZATION_BASE_OBJECT_NVP(OrderBrokerBase);
+    }
+#endif
+};
+
+} /* namespace hku */
+
+#endif /* TRADE_MANAGE_IMP_LOOPBACKORDERBROKER_H_ */
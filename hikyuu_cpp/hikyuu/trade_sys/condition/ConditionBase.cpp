@@ -96,6 +96,20 @@ bool ConditionBase::isValid(const Datetime& datetime) {
     return m_values[iter->second] > 0.;
 }
 
+void ConditionBase::fillValidFlags(const DatetimeList& dates, uint8_t* flags,
+                                   uint8_t mask) const {
+    auto iter = m_date_index.begin();
+    auto end = m_date_index.end();
+    for (size_t i = 0, total = dates.size(); i < total && iter != end; i++) {
+        while (iter != end && iter->first < dates[i]) {
+            ++iter;
+        }
+        if (iter != end && iter->first == dates[i] && m_values[iter->second] > 0.) {
+            flags[i] |= mask;
+        }
+    }
+}
+
 DatetimeList ConditionBase::getDatetimeList() const {
     DatetimeList result;
     for (const auto& d : m_date_index) {
@@ -90,6 +90,14 @@ public:
      */
     bool isValid(const Datetime& datetime);
 
+    /**
+     * 批量判断升序日期列表中各日期系统是否有效，较逐个调用 isValid 更快
+     * @param dates 升序排列的日期列表
+     * @param flags 与 dates 等长的标志数组，有效时对应位置按位或上 mask
+     * @param mask 有效标志
+     */
+    void fillValidFlags(const DatetimeList& dates, uint8_t* flags, uint8_t mask) const;
+
     /** 子类计算接口 */
     virtual void _calculate() = 0;
 
@@ -99,6 +107,11 @@ public:
     /** 子类克隆接口 */
     virtual ConditionPtr _clone() = 0;
 
+    /** 是否为 python 中实现的子类，python 实现的部件不能在多线程中并发执行 */
+    virtual bool isPythonObject() const {
+        return false;
+    }
+
 public:
     typedef vector<price_t>::const_iterator const_iterator;
     const_iterator cbegin() const {
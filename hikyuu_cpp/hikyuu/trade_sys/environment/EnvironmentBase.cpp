@@ -99,6 +99,21 @@ bool EnvironmentBase::isValid(const Datetime& datetime) const {
     return m_values[iter->second] > 0.;
 }
 
+void EnvironmentBase::fillValidFlags(const DatetimeList& dates, uint8_t* flags,
+                                     uint8_t mask) const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    auto iter = m_date_index.begin();
+    auto end = m_date_index.end();
+    for (size_t i = 0, total = dates.size(); i < total && iter != end; i++) {
+        while (iter != end && iter->first < dates[i]) {
+            ++iter;
+        }
+        if (iter != end && iter->first == dates[i] && m_values[iter->second] > 0.) {
+            flags[i] |= mask;
+        }
+    }
+}
+
 price_t EnvironmentBase::getValue(const Datetime& datetime) const {
     std::shared_lock<std::shared_mutex> lock(m_mutex);
     auto iter = m_date_index.find(datetime);
@@ -76,6 +76,14 @@ public:
      */
     bool isValid(const Datetime& datetime) const;
 
+    /**
+     * 批量判断升序日期列表中各日期的外部环境是否有效，较逐个调用 isValid 更快
+     * @param dates 升序排列的日期列表
+     * @param flags 与 dates 等长的标志数组，有效时对应位置按位或上 mask
+     * @param mask 有效标志
+     */
+    void fillValidFlags(const DatetimeList& dates, uint8_t* flags, uint8_t mask) const;
+
     price_t getValue(const Datetime& datetime) const;
 
     /**
@@ -93,6 +101,11 @@ public:
     /** 子类克隆接口 */
     virtual EnvironmentPtr _clone() = 0;
 
+    /** 是否为 python 中实现的子类，python 实现的部件不能在多线程中并发执行 */
+    virtual bool isPythonObject() const {
+        return false;
+    }
+
 protected:
     string m_name;
     KQuery m_query;
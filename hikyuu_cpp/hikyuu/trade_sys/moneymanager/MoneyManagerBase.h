@@ -152,6 +152,11 @@ public:
     /** 子类克隆私有变量接口 */
     virtual MoneyManagerPtr _clone() = 0;
 
+    /** 是否为 python 中实现的子类，python 实现的部件不能在多线程中并发执行 */
+    virtual bool isPythonObject() const {
+        return false;
+    }
+
 protected:
     string m_name;
     KQuery m_query;
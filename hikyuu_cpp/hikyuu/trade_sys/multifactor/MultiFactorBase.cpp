@@ -15,7 +15,6 @@
 #include "hikyuu/indicator/crt/ICIR.h"
 #include "hikyuu/indicator/crt/SPEARMAN.h"
 #include "hikyuu/indicator/crt/CORR.h"
-#include "hikyuu/indicator/crt/ZSCORE.h"
 #include "MultiFactorBase.h"
 
 namespace hku {
@@ -228,90 +227,138 @@ const IndicatorList& MultiFactorBase::getAllFactors() {
 }
 
 ScoreRecordList MultiFactorBase::getScores(const Datetime& d) {
-    calculate();
-    ScoreRecordList ret;
-    const auto iter = m_date_index.find(d);
-    HKU_IF_RETURN(iter == m_date_index.cend(), ret);
-    ret = m_stk_factor_by_date[iter->second];
-    return ret;
+    return getScores(d, 0, Null<size_t>());
 }
 
 ScoreRecordList MultiFactorBase::getScores(const Datetime& date, size_t start, size_t end) {
     ScoreRecordList ret;
     HKU_IF_RETURN(start >= end, ret);
 
-    const auto& cross = getScores(date);
-    if (end == Null<size_t>() || end > cross.size()) {
-        end = cross.size();
-    }
+    auto cross = getScoreSpan(date, end);
+    HKU_IF_RETURN(start >= cross.size(), ret);
 
-    for (size_t i = start; i < end; i++) {
-        ret.emplace_back(cross[i]);
+    ret.reserve(cross.size() - start);
+    for (size_t i = start, total = cross.size(); i < total; i++) {
+        ret.emplace_back(m_stks[cross[i].index], cross[i].value);
     }
-
     return ret;
 }
 
 ScoreRecordList MultiFactorBase::getScores(const Datetime& date, size_t start, size_t end,
                                            std::function<bool(const ScoreRecord&)>&& filter) {
+    HKU_IF_RETURN(!filter, getScores(date, start, end));
+
     ScoreRecordList ret;
     HKU_IF_RETURN(start >= end, ret);
 
-    const auto& cross = getScores(date);
-    HKU_IF_RETURN(cross.empty(), ret);
-
-    if (end == Null<size_t>() || end > cross.size()) {
-        end = cross.size();
-    }
-
-    if (filter) {
-        for (size_t i = start; i < end; i++) {
-            if (filter(cross[i])) {
-                ret.emplace_back(cross[i]);
-            }
-        }
-    } else {
-        for (size_t i = start; i < end; i++) {
-            ret.emplace_back(cross[i]);
+    auto cross = getScoreSpan(date, end);
+    for (size_t i = start, total = cross.size(); i < total; i++) {
+        ScoreRecord sc(m_stks[cross[i].index], cross[i].value);
+        if (filter(sc)) {
+            ret.emplace_back(std::move(sc));
         }
     }
-
     return ret;
 }
 
 ScoreRecordList MultiFactorBase::getScores(
   const Datetime& date, size_t start, size_t end,
   std::function<bool(const Datetime&, const ScoreRecord&)>&& filter) {
+    HKU_IF_RETURN(!filter, getScores(date, start, end));
+
     ScoreRecordList ret;
     HKU_IF_RETURN(start >= end, ret);
 
-    const auto& cross = getScores(date);
-    HKU_IF_RETURN(cross.empty(), ret);
-
-    if (end == Null<size_t>() || end > cross.size()) {
-        end = cross.size();
-    }
-
-    if (filter) {
-        for (size_t i = start; i < end; i++) {
-            if (filter(date, cross[i])) {
-                ret.emplace_back(cross[i]);
-            }
-        }
-    } else {
-        for (size_t i = start; i < end; i++) {
-            ret.emplace_back(cross[i]);
+    auto cross = getScoreSpan(date, end);
+    for (size_t i = start, total = cross.size(); i < total; i++) {
+        ScoreRecord sc(m_stks[cross[i].index], cross[i].value);
+        if (filter(date, sc)) {
+            ret.emplace_back(std::move(sc));
         }
     }
-
     return ret;
 }
 
 const vector<ScoreRecordList>& MultiFactorBase::getAllScores() {
     calculate();
+    std::lock_guard<std::mutex> lock(m_rank_mutex);
+    size_t days_total = m_cross_sections.size();
+    HKU_IF_RETURN(m_stk_factor_by_date.size() == days_total, m_stk_factor_by_date);
+
+    m_stk_factor_by_date.resize(days_total);
+    auto build_one_day = [this](size_t di) {
+        auto cross = _rankCrossSection(di, Null<size_t>());
+        auto& one_day = m_stk_factor_by_date[di];
+        one_day.reserve(cross.size());
+        for (const auto& sc : cross) {
+            one_day.emplace_back(m_stks[sc.index], sc.value);
+        }
+    };
+
+#if !MF_USE_MULTI_THREAD
+    for (size_t di = 0; di < days_total; di++) {
+        build_one_day(di);
+    }
+#else
+    parallel_for_index_void(0, days_total, build_one_day);
+#endif
     return m_stk_factor_by_date;
 }
 
+ScoreIndexSpan MultiFactorBase::getScoreSpan(const Datetime& date, size_t topn) {
+    calculate();
+    const auto iter = m_date_index.find(date);
+    HKU_IF_RETURN(iter == m_date_index.cend(), ScoreIndexSpan());
+    std::lock_guard<std::mutex> lock(m_rank_mutex);
+    HKU_IF_RETURN(iter->second >= m_cross_sections.size(), ScoreIndexSpan());
+    return _rankCrossSection(iter->second, topn);
+}
+
+// 截面评分降序比较，Null 值排在最后，值相同时按证券位置升序
+static bool scoreGreater(const ScoreIndexRecord& a, const ScoreIndexRecord& b) {
+    if (std::isnan(a.value)) {
+        return std::isnan(b.value) && a.index < b.index;
+    }
+    if (std::isnan(b.value)) {
+        return true;
+    }
+    return a.value > b.value || (a.value == b.value && a.index < b.index);
+}
+
+ScoreIndexSpan MultiFactorBase::_rankCrossSection(size_t pos, size_t topn) {
+    auto& cross = m_cross_sections[pos];
+    auto& scores = cross.scores;
+    size_t stk_count = m_stks.size();
+    if (scores.size() != stk_count) {
+        scores.resize(stk_count);
+        for (size_t si = 0; si < stk_count; si++) {
+            scores[si].index = static_cast<uint32_t>(si);
+            const auto& factor = m_all_factors[si];
+            scores[si].value = pos < factor.size() ? factor.data()[pos] : Null<value_t>();
+        }
+        cross.ranked = 0;
+    }
+
+    size_t total = scores.size();
+    if (topn > total) {
+        topn = total;
+    }
+
+    // 已排序部分之后的评分均不大于已排序部分，只需对剩余部分继续排序
+    if (topn > cross.ranked) {
+        auto first = scores.begin() + cross.ranked;
+        if ((topn - cross.ranked) * 4 >= total - cross.ranked) {
+            std::sort(first, scores.end(), scoreGreater);
+            cross.ranked = total;
+        } else {
+            std::partial_sort(first, scores.begin() + topn, scores.end(), scoreGreater);
+            cross.ranked = topn;
+        }
+    }
+
+    return ScoreIndexSpan(scores.data(), topn);
+}
+
 Indicator MultiFactorBase::getIC(int ndays) {
     calculate();
     std::lock_guard<std::mutex> lock(m_mutex);
@@ -398,96 +445,173 @@ Indicator MultiFactorBase::getICIR(int ir_n, int ic_n) {
 
 IndicatorList MultiFactorBase::_getAllReturns(int ndays) const {
     bool fill_null = getParam<bool>("fill_null");
+    DatetimeIndexPtr ref_index = makeDatetimeIndex(m_ref_dates);
 #if !MF_USE_MULTI_THREAD
     vector<Indicator> all_returns;
     all_returns.reserve(m_stks.size());
     for (const auto& stk : m_stks) {
         auto k = stk.getKData(m_query);
-        all_returns.emplace_back(ALIGN(REF(ROCP(k.close(), ndays), ndays), m_ref_dates, fill_null));
+        all_returns.emplace_back(ALIGN(REF(ROCP(k.close(), ndays), ndays), ref_index, fill_null));
     }
     return all_returns;
 #else
-    return parallel_for_index(0, m_stks.size(), [this, ndays, fill_null](size_t i) {
+    return parallel_for_index(0, m_stks.size(), [this, ndays, fill_null, &ref_index](size_t i) {
         auto k = m_stks[i].getKData(m_query);
-        return ALIGN(REF(ROCP(k.close(), ndays), ndays), m_ref_dates, fill_null);
+        return ALIGN(REF(ROCP(k.close(), ndays), ndays), ref_index, fill_null);
     });
 #endif
 }
 
+// 截面最小最大值归一化，无有效值或最大值等于最小值时全部置为 Null
+static void minMaxNormalize(MultiFactorBase::value_t* cross, size_t total) {
+    using value_t = MultiFactorBase::value_t;
+    value_t min_value = std::numeric_limits<value_t>::max();
+    value_t max_value = std::numeric_limits<value_t>::lowest();
+    for (size_t i = 0; i < total; i++) {
+        if (!std::isnan(cross[i])) {
+            min_value = std::min(min_value, cross[i]);
+            max_value = std::max(max_value, cross[i]);
+        }
+    }
+
+    if (max_value <= min_value) {
+        std::fill(cross, cross + total, Null<value_t>());
+        return;
+    }
+
+    value_t diff = max_value - min_value;
+    for (size_t i = 0; i < total; i++) {
+        cross[i] = (cross[i] - min_value) / diff;
+    }
+}
+
+// 截面标准化，计算方式同 ZSCORE 指标，有效值不足2个时全部置为 Null
+static void zscoreNormalize(MultiFactorBase::value_t* cross, size_t total, bool out_extreme,
+                            double nsigma, bool recursive) {
+    using value_t = MultiFactorBase::value_t;
+    value_t sum = 0.0;
+    size_t count = 0;
+    for (size_t i = 0; i < total; i++) {
+        if (!std::isnan(cross[i])) {
+            sum += cross[i];
+            count++;
+        }
+    }
+
+    if (count <= 1) {
+        std::fill(cross, cross + total, Null<value_t>());
+        return;
+    }
+
+    value_t mean = sum / count;
+    sum = 0.0;
+    for (size_t i = 0; i < total; i++) {
+        if (!std::isnan(cross[i])) {
+            value_t x = cross[i] - mean;
+            sum += x * x;
+        }
+    }
+
+    value_t sigma = std::sqrt(sum / (count - 1));
+    for (size_t i = 0; i < total; i++) {
+        cross[i] = (cross[i] - mean) / sigma;
+    }
+
+    HKU_IF_RETURN(!out_extreme, void());
+    bool found = false;
+    for (size_t i = 0; i < total; i++) {
+        if (cross[i] > nsigma) {
+            cross[i] = nsigma;
+            found = true;
+        } else if (cross[i] < -nsigma) {
+            cross[i] = -nsigma;
+            found = true;
+        }
+    }
+
+    if (found && recursive) {
+        zscoreNormalize(cross, total, out_extreme, nsigma, recursive);
+    }
+}
+
 vector<IndicatorList> MultiFactorBase::getAllSrcFactors() {
     vector<IndicatorList> all_stk_inds;
     size_t stk_count = m_stks.size();
     HKU_IF_RETURN(stk_count == 0, all_stk_inds);
-    all_stk_inds.resize(stk_count);
 
     bool fill_null = getParam<bool>("fill_null");
     size_t ind_count = m_inds.size();
-    for (size_t i = 0; i < stk_count; i++) {
-        const auto& stk = m_stks[i];
-        auto kdata = stk.getKData(m_query);
-        auto& cur_stk_inds = all_stk_inds[i];
-        cur_stk_inds.resize(ind_count);
-        for (size_t j = 0; j < ind_count; j++) {
-            cur_stk_inds[j] = ALIGN(m_inds[j](kdata), m_ref_dates, fill_null);
-            cur_stk_inds[j].name(m_inds[j].name());
+    DatetimeIndexPtr ref_index = makeDatetimeIndex(m_ref_dates);
+    auto calculate_stk_inds = [this, ind_count, fill_null, &ref_index](size_t si) {
+        auto kdata = m_stks[si].getKData(m_query);
+        IndicatorList stk_inds(ind_count);
+        for (size_t ii = 0; ii < ind_count; ii++) {
+            stk_inds[ii] = ALIGN(m_inds[ii](kdata), ref_index, fill_null);
+            stk_inds[ii].name(m_inds[ii].name());
         }
+        return stk_inds;
+    };
+
+#if !MF_USE_MULTI_THREAD
+    all_stk_inds.reserve(stk_count);
+    for (size_t si = 0; si < stk_count; si++) {
+        all_stk_inds.emplace_back(calculate_stk_inds(si));
     }
+#else
+    all_stk_inds = parallel_for_index(0, stk_count, calculate_stk_inds);
+#endif
 
-    // 每日截面归一化
-    if (getParam<bool>("enable_min_max_normalize")) {
-        for (size_t di = 0, days_total = m_ref_dates.size(); di < days_total; di++) {
-            for (size_t ii = 0; ii < ind_count; ii++) {
-                Indicator::value_t min_value = std::numeric_limits<Indicator::value_t>::max();
-                Indicator::value_t max_value = std::numeric_limits<Indicator::value_t>::min();
-                for (size_t si = 0; si < stk_count; si++) {
-                    auto value = all_stk_inds[si][ii][di];
-                    if (!std::isnan(value)) {
-                        if (value > max_value) {
-                            max_value = value;
-                        } else if (value < min_value) {
-                            min_value = value;
-                        }
-                    }
-                }
-
-                if (max_value == min_value ||
-                    max_value == std::numeric_limits<Indicator::value_t>::max()) {
-                    for (size_t si = 0; si < stk_count; si++) {
-                        auto* dst = all_stk_inds[si][ii].data();
-                        dst[di] = Null<Indicator::value_t>();
-                    }
-                } else {
-                    Indicator::value_t diff = max_value - min_value;
-                    for (size_t si = 0; si < stk_count; si++) {
-                        auto* dst = all_stk_inds[si][ii].data();
-                        dst[di] = (dst[di] - min_value) / diff;
-                    }
-                }
-            }
+    bool min_max_normalize = getParam<bool>("enable_min_max_normalize");
+    bool zscore = getParam<bool>("enable_zscore");
+    HKU_IF_RETURN(!min_max_normalize && !zscore, all_stk_inds);
+
+    bool zscore_out_extreme = getParam<bool>("zscore_out_extreme");
+    double zscore_nsigma = getParam<double>("zscore_nsigma");
+    bool zscore_recursive = getParam<bool>("zscore_recursive");
+
+    // 按 [因子][日期][证券] 连续存放，每日截面在内存中连续，逐截面进行归一化、标准化后写回
+    size_t days_total = m_ref_dates.size();
+    size_t cross_count = ind_count * days_total;
+    vector<value_t> matrix(cross_count * stk_count);
+    vector<value_t*> src(ind_count * stk_count);
+    for (size_t ii = 0; ii < ind_count; ii++) {
+        for (size_t si = 0; si < stk_count; si++) {
+            src[ii * stk_count + si] = all_stk_inds[si][ii].data();
         }
     }
 
-    // 每日截面标准化
-    if (getParam<bool>("enable_zscore")) {
-        Indicator one_day = PRICELIST(PriceList(stk_count, Null<price_t>()));
-        for (size_t di = 0, days_total = m_ref_dates.size(); di < days_total; di++) {
-            for (size_t ii = 0; ii < ind_count; ii++) {
-                auto* one_day_data = one_day.data();
-                for (size_t si = 0; si < stk_count; si++) {
-                    one_day_data[si] = all_stk_inds[si][ii][di];
-                }
-
-                auto new_value =
-                  ZSCORE(one_day, getParam<bool>("zscore_out_extreme"),
-                         getParam<double>("zscore_nsigma"), getParam<bool>("zscore_recursive"));
-
-                for (size_t si = 0; si < stk_count; si++) {
-                    auto* dst = all_stk_inds[si][ii].data();
-                    dst[di] = new_value[si];
-                }
-            }
+    auto process_cross = [&](size_t ci) {
+        size_t ii = ci / days_total;
+        size_t di = ci % days_total;
+        value_t* cross = matrix.data() + ci * stk_count;
+        value_t* const* cross_src = src.data() + ii * stk_count;
+        for (size_t si = 0; si < stk_count; si++) {
+            cross[si] = cross_src[si][di];
+        }
+
+        // 每日截面归一化
+        if (min_max_normalize) {
+            minMaxNormalize(cross, stk_count);
         }
+
+        // 每日截面标准化
+        if (zscore) {
+            zscoreNormalize(cross, stk_count, zscore_out_extreme, zscore_nsigma,
+                            zscore_recursive);
+        }
+
+        for (size_t si = 0; si < stk_count; si++) {
+            cross_src[si][di] = cross[si];
+        }
+    };
+
+#if !MF_USE_MULTI_THREAD
+    for (size_t ci = 0; ci < cross_count; ci++) {
+        process_cross(ci);
     }
+#else
+    parallel_for_index_void(0, cross_count, process_cross);
+#endif
 
     return all_stk_inds;
 }
@@ -495,32 +619,24 @@ vector<IndicatorList> MultiFactorBase::getAllSrcFactors() {
 void MultiFactorBase::_buildIndex() {
     size_t stk_count = m_stks.size();
     HKU_ASSERT(stk_count == m_all_factors.size());
+    HKU_CHECK(stk_count <= std::numeric_limits<uint32_t>::max(), "Too many stocks: {}",
+              stk_count);
+    m_stk_map.clear();
     for (size_t i = 0; i < stk_count; i++) {
         m_stk_map[m_stks[i]] = i;
     }
 
-    // 建立每日截面的索引，并每日降序排序
     size_t days_total = m_ref_dates.size();
-    m_stk_factor_by_date.resize(days_total);
-    ScoreRecordList one_day;
+    m_date_index.clear();
     for (size_t i = 0; i < days_total; i++) {
-        one_day.resize(stk_count);
-        for (size_t j = 0; j < stk_count; j++) {
-            one_day[j] = ScoreRecord(m_stks[j], m_all_factors[j][i]);
-        }
-        std::sort(one_day.begin(), one_day.end(), [](const ScoreRecord& a, const ScoreRecord& b) {
-            if (std::isnan(a.value) && std::isnan(b.value)) {
-                return false;
-            } else if (!std::isnan(a.value) && std::isnan(b.value)) {
-                return true;
-            } else if (std::isnan(a.value) && !std::isnan(b.value)) {
-                return false;
-            }
-            return a.value > b.value;
-        });
-        m_stk_factor_by_date[i] = std::move(one_day);
         m_date_index[m_ref_dates[i]] = i;
     }
+
+    // 每日截面在查询时按需排序，此处仅重置
+    std::lock_guard<std::mutex> lock(m_rank_mutex);
+    m_cross_sections.clear();
+    m_cross_sections.resize(days_total);
+    m_stk_factor_by_date.clear();
 }
 
 void MultiFactorBase::calculate() {
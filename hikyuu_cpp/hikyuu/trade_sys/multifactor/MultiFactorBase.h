@@ -114,6 +114,16 @@ public:
     /** 获取所有截面数据，已按降序排列 */
     const vector<ScoreRecordList>& getAllScores();
 
+    /**
+     * 获取指定日期截面降序排列的前 topn 个评分，截面在首次查询时按需部分排序并缓存
+     * @note 返回的视图不持有数据，在重新计算（如修改参数、证券列表）前有效，
+     *       记录中的 index 为证券在 getStockList() 中的位置
+     * @param date 指定日期
+     * @param topn 需要的数量，Null<size_t>() 表示全部
+     * @return 指定日期不存在时返回空视图
+     */
+    ScoreIndexSpan getScoreSpan(const Datetime& date, size_t topn = Null<size_t>());
+
     /**
      * 获取合成因子的IC, 长度与参考日期同
      * @note ndays 对于使用 IC/ICIR 加权的新因子，最好保持好 ic_n 一致，
@@ -152,6 +162,15 @@ private:
 
     void initParam();
 
+    // 截面评分，仅前 ranked 个已降序排列，其后的评分均不大于已排序部分
+    struct RankedCrossSection {
+        ScoreIndexRecordList scores;
+        size_t ranked{0};
+    };
+
+    // 将指定位置的截面至少排序前 topn 个，需持有 m_rank_mutex
+    ScoreIndexSpan _rankCrossSection(size_t pos, size_t topn);
+
 protected:
     void _buildIndex();  // 计算完成后创建截面索引
     IndicatorList _getAllReturns(int ndays) const;
@@ -169,13 +188,16 @@ protected:
     unordered_map<Stock, size_t> m_stk_map;  // 证券->合成后因子位置索引
     IndicatorList m_all_factors;             // 保存所有证券合成后的新因子
     unordered_map<Datetime, size_t> m_date_index;
-    vector<ScoreRecordList> m_stk_factor_by_date;
+    vector<ScoreRecordList> m_stk_factor_by_date;  // 仅在调用 getAllScores 时生成
     Indicator m_ic;
 
 private:
     std::mutex m_mutex;
     bool m_calculated{false};
 
+    vector<RankedCrossSection> m_cross_sections;  // 按日期顺序的截面评分，按需排序
+    std::mutex m_rank_mutex;
+
 //============================================
 // 序列化支持
 //============================================
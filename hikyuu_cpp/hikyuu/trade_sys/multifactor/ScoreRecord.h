@@ -31,6 +31,55 @@ struct HKU_API ScoreRecord {
 typedef vector<ScoreRecord> ScoreRecordList;
 typedef vector<ScoreRecord> ScoreList;
 
+/**
+ * 紧凑的截面评分记录，以证券在多因子证券列表中的位置代替证券
+ */
+struct ScoreIndexRecord {
+    typedef Indicator::value_t value_t;
+
+    uint32_t index{0};  // 证券在证券列表中的位置
+    value_t value{0.0};
+};
+
+typedef vector<ScoreIndexRecord> ScoreIndexRecordList;
+
+/**
+ * 连续存放的截面评分记录视图，不持有数据
+ */
+class ScoreIndexSpan {
+public:
+    ScoreIndexSpan() = default;
+    ScoreIndexSpan(const ScoreIndexRecord* data, size_t size) : m_data(data), m_size(size) {}
+
+    const ScoreIndexRecord* data() const noexcept {
+        return m_data;
+    }
+
+    size_t size() const noexcept {
+        return m_size;
+    }
+
+    bool empty() const noexcept {
+        return m_size == 0;
+    }
+
+    const ScoreIndexRecord* begin() const noexcept {
+        return m_data;
+    }
+
+    const ScoreIndexRecord* end() const noexcept {
+        return m_data + m_size;
+    }
+
+    const ScoreIndexRecord& operator[](size_t pos) const {
+        return m_data[pos];
+    }
+
+private:
+    const ScoreIndexRecord* m_data{nullptr};
+    size_t m_size{0};
+};
+
 HKU_API std::ostream& operator<<(std::ostream& out, const ScoreRecord& td);
 
 HKU_API std::ostream& operator<<(std::ostream& out, const ScoreRecordList& td);
@@ -5,7 +5,9 @@
  *      Author: fasiondog
  */
 
+#include <unordered_set>
 #include "hikyuu/global/sysinfo.h"
+#include "hikyuu/utilities/thread/algorithm.h"
 #include "hikyuu/trade_manage/crt/crtTM.h"
 #include "hikyuu/trade_sys/selector/imp/optimal/OptimalSelectorBase.h"
 
@@ -17,18 +19,96 @@ BOOST_CLASS_EXPORT(hku::SimplePortfolio)
 
 namespace hku {
 
-SimplePortfolio::SimplePortfolio() : Portfolio("PF_Simple") {}
+SimplePortfolio::SimplePortfolio() : Portfolio("PF_Simple") {
+    initParam();
+}
 
 SimplePortfolio::SimplePortfolio(const TradeManagerPtr& tm, const SelectorPtr& se, const AFPtr& af)
-: Portfolio("PF_Simple", tm, se, af) {}
+: Portfolio("PF_Simple", tm, se, af) {
+    initParam();
+}
 
 SimplePortfolio::~SimplePortfolio() {}
 
+void SimplePortfolio::initParam() {
+    // 并行执行各运行中子系统的当日操作
+    // （仅子账户及子系统自身部件会被修改，汇总至总账户时仍按序执行）
+    // 注意：子系统间存在共享部件（如默认共享的 EV）或部件由 python 实现时，自动退化为串行执行
+    setParam<bool>("parallel", false);
+}
+
 void SimplePortfolio::_reset() {
     m_dlist_sys_list.clear();
     m_delay_adjust_sys_list.clear();
     m_tmp_selected_list.clear();
     m_tmp_will_remove_sys.clear();
+    m_tmp_running_sys_list.clear();
+    m_tg.reset();
+}
+
+TradeRecordList SimplePortfolio::_runOnRunningSys(
+  const std::function<TradeRecord(const SYSPtr&)>& f) {
+    // 固定本次遍历顺序，保证并行与串行时汇总至总账户的交易记录顺序一致
+    m_tmp_running_sys_list.clear();
+    m_tmp_running_sys_list.reserve(m_running_sys_set.size());
+    for (const auto& sys : m_running_sys_set) {
+        m_tmp_running_sys_list.emplace_back(sys);
+    }
+
+    size_t total = m_tmp_running_sys_list.size();
+    if (!getParam<bool>("parallel") || total < 2 || !_canRunInParallel()) {
+        TradeRecordList ret;
+        ret.reserve(total);
+        for (const auto& sys : m_tmp_running_sys_list) {
+            ret.emplace_back(f(sys));
+        }
+        return ret;
+    }
+
+    // 线程池在整个回测期间复用，避免每个交易日的每个阶段都创建、销毁线程
+    if (!m_tg) {
+        m_tg = std::make_unique<ThreadPool>();
+    }
+
+    TradeRecordList ret(total);
+    std::vector<std::future<void>> tasks;
+    for (const auto& range : parallelIndexRange(0, total)) {
+        tasks.emplace_back(m_tg->submit([this, &f, &ret, range]() {
+            for (size_t i = range.first; i < range.second; i++) {
+                ret[i] = f(m_tmp_running_sys_list[i]);
+            }
+        }));
+    }
+    for (auto& task : tasks) {
+        task.get();
+    }
+    return ret;
+}
+
+bool SimplePortfolio::_canRunInParallel() const {
+    // 各子系统的部件实例必须互不相同且均不是 python 实现，才可并发执行
+    std::unordered_set<const void*> parts;
+    auto check_part = [&parts](const auto& part) {
+        if (!part) {
+            return true;
+        }
+        return !part->isPythonObject() && parts.insert(part.get()).second;
+    };
+
+    for (const auto& sys : m_tmp_running_sys_list) {
+        TMPtr tm = sys->getTM();
+        // 子账户 clone 时共享同一成本算法实例，其接口为 const，仅需排除 python 实现
+        if (tm && (!check_part(tm) || (tm->costFunc() && tm->costFunc()->isPythonObject()))) {
+            return false;
+        }
+        if (!check_part(sys->getEV()) || !check_part(sys->getCN()) ||
+            !check_part(sys->getSG()) || !check_part(sys->getMM()) ||
+            !check_part(sys->getST()) || !check_part(sys->getTP()) ||
+            !check_part(sys->getPG()) || !check_part(sys->getSP())) {
+            return false;
+        }
+    }
+    return true;
 }
 
 void SimplePortfolio::_readyForRun() {
@@ -105,12 +185,15 @@ void SimplePortfolio::_runMoment(const Datetime& date, const Datetime& nextCycle
     //---------------------------------------------------
     int precision = m_tm->getParam<int>("precision");
 
-    // 更新所有运行中系统的权息
+    // 更新所有运行中系统的权息（各子账户相互独立，可并行处理）
+    _runOnRunningSys([&date](const SYSPtr& sys) {
+        sys->getTM()->updateWithWeight(date);
+        return TradeRecord();
+    });
+
     price_t sum_cash = 0.0;
-    for (auto& running_sys : m_running_sys_set) {
-        TMPtr sub_tm = running_sys->getTM();
-        sub_tm->updateWithWeight(date);
-        sum_cash += sub_tm->currentCash();
+    for (auto& running_sys : m_tmp_running_sys_list) {
+        sum_cash += running_sys->getTM()->currentCash();
     }
 
     // 开盘前，进行轧差处理（平衡 sub_sys, cash_tm, tm 之间的误差）
@@ -174,8 +257,9 @@ void SimplePortfolio::_runMoment(const Datetime& date, const Datetime& nextCycle
     //---------------------------------------------------
     // 检测当前运行中的系统是否存在延迟卖出信号，并在开盘时有效处理
     //---------------------------------------------------
-    for (auto& sys : m_running_sys_set) {
-        auto tr = sys->pfProcessDelaySellRequest(date);
+    TradeRecordList tr_list =
+      _runOnRunningSys([&date](const SYSPtr& sys) { return sys->pfProcessDelaySellRequest(date); });
+    for (auto& tr : tr_list) {
         if (!tr.isNull()) {
             HKU_INFO_IF(trace, "[PF] sell delay {}", tr);
             m_tm->addTradeRecord(tr);
@@ -253,16 +337,19 @@ void SimplePortfolio::_runMoment(const Datetime& date, const Datetime& nextCycle
 
     //----------------------------------------------------------------------------
     // 执行所有运行中的系统，无论是延迟还是非延迟，当天运行中的系统都需要被执行一次
+    // 各子系统仅操作自身子账户，先（并行）执行，再按固定顺序将交易记录汇总至总账户
     //----------------------------------------------------------------------------
-    for (auto& sub_sys : m_running_sys_set) {
+    tr_list = _runOnRunningSys([&date, &nextCycle, adjust, trace](const SYSPtr& sub_sys) {
         HKU_INFO_IF(trace, "[PF] run: {}", sub_sys->name());
         if (adjust) {
             auto sg = sub_sys->getSG();
             sg->startCycle(date, nextCycle);
             HKU_INFO_IF(trace, "[PF] sg should buy: {}", sg->shouldBuy(date));
         }
+        return sub_sys->runMoment(date);
+    });
 
-        auto tr = sub_sys->runMoment(date);
+    for (auto& tr : tr_list) {
         if (!tr.isNull()) {
             HKU_INFO_IF(trace, "[PF] {}", tr);
             m_tm->addTradeRecord(tr);
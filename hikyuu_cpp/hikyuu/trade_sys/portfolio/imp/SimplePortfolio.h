@@ -10,6 +10,7 @@
 #ifndef TRADE_SYS_PORTFOLIO_SIMPLE_H_
 #define TRADE_SYS_PORTFOLIO_SIMPLE_H_
 
+#include "hikyuu/utilities/thread/ThreadPool.h"
 #include "hikyuu/trade_sys/allocatefunds/AllocateFundsBase.h"
 #include "hikyuu/trade_sys/selector/SelectorBase.h"
 #include "hikyuu/trade_sys/portfolio/Portfolio.h"
@@ -28,11 +29,22 @@ public:
     SimplePortfolio(const TradeManagerPtr& tm, const SelectorPtr& se, const AFPtr& af);
     virtual ~SimplePortfolio();
 
+private:
+    void initParam();
+
+    // 并行执行运行中子系统的当日操作，返回的交易记录与 m_tmp_running_sys_list 一一对应
+    TradeRecordList _runOnRunningSys(const std::function<TradeRecord(const SYSPtr&)>& f);
+
+    // 运行中子系统间无共享部件且无 python 实现的部件时，方可并行执行
+    bool _canRunInParallel() const;
+
 private:
     SystemList m_dlist_sys_list;               // 因证券退市，无法执行卖出的系统（资产全部损失）
     SystemWeightList m_delay_adjust_sys_list;  // 延迟调仓卖出的系统列表
     SystemWeightList m_tmp_selected_list;
     SystemWeightList m_tmp_will_remove_sys;
+    SystemList m_tmp_running_sys_list;  // 运行中系统的固定顺序快照，用于并行执行后的有序归并
+    std::unique_ptr<ThreadPool> m_tg;   // 并行执行时使用的线程池，首次并行时创建，reset 时释放
 
 //============================================
 // 序列化支持
@@ -79,6 +79,11 @@ public:
     /** 子类克隆接口 */
     virtual ProfitGoalPtr _clone() = 0;
 
+    /** 是否为 python 中实现的子类，python 实现的部件不能在多线程中并发执行 */
+    virtual bool isPythonObject() const {
+        return false;
+    }
+
     /** 子类计算接口，由setTO调用 */
     virtual void _calculate() = 0;
 
@@ -65,12 +65,14 @@ void MultiFactorSelector::_reset() {
         m_mf->reset();
     }
     m_stk_sys_dict.clear();
+    m_sys_list.clear();
 }
 
 SelectorPtr MultiFactorSelector::_clone() {
     auto p = make_shared<MultiFactorSelector>();
     p->m_mf = m_mf->clone();
     p->m_stk_sys_dict = m_stk_sys_dict;
+    p->m_sys_list = m_sys_list;
     for (const auto& ind : m_inds) {
         p->m_inds.emplace_back(ind.clone());
     }
@@ -129,22 +131,19 @@ ScoreRecordList MultiFactorSelector::filterTopNReverse(Datetime date,
     return scores;
 }
 
-ScoreRecordList MultiFactorSelector::filterTopN(Datetime date, const ScoreRecordList& raw_scores,
-                                                size_t topn, bool only_should_buy) {
-    ScoreRecordList scores;
-    if (only_should_buy) {
-        scores = filterOnlyShouldBuy(date, raw_scores, topn);
-    } else {
-        scores.assign(raw_scores.begin(), raw_scores.begin() + std::min(topn, raw_scores.size()));
-    }
-    return scores;
-}
-
 SystemWeightList MultiFactorSelector::getSelected(Datetime date) {
     bool ignore_null = getParam<bool>("ignore_null");
     bool ignore_le_zero = getParam<bool>("ignore_le_zero");
     bool only_should_buy = getParam<bool>("only_should_buy");
     bool reverse = getParam<bool>("reverse");
+    int param_topn = getParam<int>("topn");
+
+    if (!reverse) {
+        // 正序排列，直接在多因子按需排序的截面上选取，无需复制整个截面
+        return getSelectedTopN(date, param_topn > 0 ? static_cast<size_t>(param_topn)
+                                                     : Null<size_t>(),
+                               only_should_buy, ignore_null, ignore_le_zero);
+    }
 
     ScoreRecordList raw_scores = m_mf->getScores(date);
     raw_scores.erase(std::remove_if(raw_scores.begin(), raw_scores.end(),
@@ -154,21 +153,14 @@ SystemWeightList MultiFactorSelector::getSelected(Datetime date) {
                                     }),
                      raw_scores.end());
 
-    int param_topn = getParam<int>("topn");
     size_t topn = param_topn > 0 ? static_cast<size_t>(param_topn) : raw_scores.size();
     if (topn > raw_scores.size()) {
         topn = raw_scores.size();
     }
 
-    ScoreRecordList scores;
-    if (!reverse) {
-        // 正序排列
-        scores = filterTopN(date, raw_scores, topn, only_should_buy);
-
-    } else {
-        // 倒序排列
-        scores = filterTopNReverse(date, raw_scores, topn, only_should_buy, ignore_null);
-    }
+    // 倒序排列
+    ScoreRecordList scores =
+      filterTopNReverse(date, raw_scores, topn, only_should_buy, ignore_null);
 
     SystemWeightList ret;
     for (const auto& sc : scores) {
@@ -177,6 +169,37 @@ SystemWeightList MultiFactorSelector::getSelected(Datetime date) {
     return ret;
 }
 
+SystemWeightList MultiFactorSelector::getSelectedTopN(Datetime date, size_t topn,
+                                                      bool only_should_buy, bool ignore_null,
+                                                      bool ignore_le_zero) {
+    SystemWeightList ret;
+    HKU_IF_RETURN(topn == 0, ret);
+
+    // 按需扩大截面的排序范围，直至选足 topn 个或截面已全部遍历
+    size_t rank_n = topn, pos = 0;
+    while (true) {
+        auto cross = m_mf->getScoreSpan(date, rank_n);
+        for (size_t total = cross.size(); pos < total && ret.size() < topn; pos++) {
+            const auto& sc = cross[pos];
+            if ((ignore_null && std::isnan(sc.value)) || (ignore_le_zero && sc.value <= 0.0)) {
+                continue;
+            }
+            const auto& sys = m_sys_list[sc.index];
+            if (only_should_buy && !sys->getSG()->shouldBuy(date)) {
+                continue;
+            }
+            ret.emplace_back(sys, sc.value);
+        }
+
+        if (ret.size() >= topn || cross.size() < rank_n ||
+            rank_n >= m_mf->getStockListNumber()) {
+            break;
+        }
+        rank_n = rank_n > m_mf->getStockListNumber() / 2 ? Null<size_t>() : rank_n * 2;
+    }
+    return ret;
+}
+
 void MultiFactorSelector::_calculate() {
     Stock ref_stk = getParam<Stock>("ref_stk");
     if (ref_stk.isNull()) {
@@ -219,6 +242,13 @@ void MultiFactorSelector::_calculate() {
     for (const auto& sys : m_real_sys_list) {
         m_stk_sys_dict.insert({sys->getStock(), sys});
     }
+
+    // 与多因子证券列表顺序一致的系统列表
+    m_sys_list.clear();
+    m_sys_list.reserve(stks.size());
+    for (const auto& stk : stks) {
+        m_sys_list.emplace_back(m_stk_sys_dict[stk]);
+    }
 }
 
 SelectorPtr HKU_API SE_MultiFactor(const MFPtr& mf, int topn) {
@@ -32,8 +32,8 @@ public:
 
 private:
     ScoreRecordList filterOnlyShouldBuy(Datetime date, const ScoreRecordList& scores, size_t topn);
-    ScoreRecordList filterTopN(Datetime date, const ScoreRecordList& raw_scores, size_t topn,
-                               bool only_should_buy);
+    SystemWeightList getSelectedTopN(Datetime date, size_t topn, bool only_should_buy,
+                                     bool ignore_null, bool ignore_le_zero);
     ScoreRecordList filterTopNReverse(Datetime date, const ScoreRecordList& raw_scores, size_t topn,
                                       bool only_should_buy, bool ignore_null);
 
@@ -41,6 +41,7 @@ private:
     IndicatorList m_inds;
     MFPtr m_mf;
     unordered_map<Stock, SYSPtr> m_stk_sys_dict;
+    SystemList m_sys_list;  // 与多因子证券列表顺序一致的系统
 
     //============================================
     // 序列化支持
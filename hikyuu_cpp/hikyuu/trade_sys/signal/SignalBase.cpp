@@ -131,6 +131,27 @@ DatetimeList SignalBase::getSellSignal() const {
     return result;
 }
 
+// 按日期顺序合并查询，sigs 中存在的日期在 flags 对应位置按位或上 mask
+static void fillFlagsByDate(const std::map<Datetime, double>& sigs, const DatetimeList& dates,
+                            uint8_t* flags, uint8_t mask) {
+    auto iter = sigs.begin();
+    auto end = sigs.end();
+    for (size_t i = 0, total = dates.size(); i < total && iter != end; i++) {
+        while (iter != end && iter->first < dates[i]) {
+            ++iter;
+        }
+        if (iter != end && iter->first == dates[i]) {
+            flags[i] |= mask;
+        }
+    }
+}
+
+void SignalBase::fillSignalFlags(const DatetimeList& dates, uint8_t* flags, uint8_t buy_mask,
+                                 uint8_t sell_mask) const {
+    fillFlagsByDate(m_buySig, dates, flags, buy_mask);
+    fillFlagsByDate(m_sellSig, dates, flags, sell_mask);
+}
+
 double SignalBase::getBuyValue(const Datetime& datetime) const {
     auto iter = m_buySig.find(datetime);
     return iter != m_buySig.end() ? iter->second : 0.0;
@@ -76,6 +76,16 @@ public:
     /** 获取所有卖出指示日期列表 */
     DatetimeList getSellSignal() const;
 
+    /**
+     * 批量标记升序日期列表中各日期的买入、卖出信号，较逐个调用 shouldBuy/shouldSell 更快
+     * @param dates 升序排列的日期列表
+     * @param flags 与 dates 等长的标志数组
+     * @param buy_mask 存在买入信号时按位或上的标志
+     * @param sell_mask 存在卖出信号时按位或上的标志
+     */
+    void fillSignalFlags(const DatetimeList& dates, uint8_t* flags, uint8_t buy_mask,
+                         uint8_t sell_mask) const;
+
     void _addSignal(const Datetime& datetime, double value);
 
     /**
@@ -127,6 +137,11 @@ public:
     /** 子类克隆接口 */
     virtual SignalPtr _clone() = 0;
 
+    /** 是否为 python 中实现的子类，python 实现的部件不能在多线程中并发执行 */
+    virtual bool isPythonObject() const {
+        return false;
+    }
+
     /** 子类计算接口，在setTO中调用 */
     virtual void _calculate(const KData&) = 0;
 
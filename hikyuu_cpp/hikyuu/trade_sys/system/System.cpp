@@ -161,6 +161,21 @@ void System::baseCheckParam(const string& name) const {
 
 void System::paramChanged() {
     m_calculated = false;
+    m_run_param_changed = true;
+}
+
+void System::_readRunParam() {
+    m_run_param.trace = getParam<bool>("trace");
+    m_run_param.buy_delay = getParam<bool>("buy_delay");
+    m_run_param.sell_delay = getParam<bool>("sell_delay");
+    m_run_param.delay_use_current_price = getParam<bool>("delay_use_current_price");
+    m_run_param.can_trade_when_high_eq_low = getParam<bool>("can_trade_when_high_eq_low");
+    m_run_param.ev_open_position = getParam<bool>("ev_open_position");
+    m_run_param.cn_open_position = getParam<bool>("cn_open_position");
+    m_run_param.support_borrow_stock = getParam<bool>("support_borrow_stock");
+    m_run_param.max_delay_count = getParam<int>("max_delay_count");
+    m_run_param.tp_delay_n = getParam<int>("tp_delay_n");
+    m_run_param_changed = false;
 }
 
 void System::reset() {
@@ -377,6 +392,26 @@ void System::readyForRun() {
 
     m_tm->setParam<bool>("support_borrow_cash", getParam<bool>("support_borrow_cash"));
     m_tm->setParam<bool>("support_borrow_stock", getParam<bool>("support_borrow_stock"));
+
+    _updateRunParam();
+}
+
+void System::_prepareBarFlags() {
+    size_t total = m_kdata.size();
+    m_bar_flags.resize(total);
+    HKU_IF_RETURN(total == 0, void());
+
+    // 各部件均以日期有序保存结果，按K线日期顺序批量合并查询
+    DatetimeList dates = m_kdata.getDatetimeList();
+    uint8_t init = (m_ev ? 0 : BAR_EV_VALID) | (m_cn ? 0 : BAR_CN_VALID);
+    std::fill(m_bar_flags.begin(), m_bar_flags.end(), init);
+    if (m_ev) {
+        m_ev->fillValidFlags(dates, m_bar_flags.data(), BAR_EV_VALID);
+    }
+    if (m_cn) {
+        m_cn->fillValidFlags(dates, m_bar_flags.data(), BAR_CN_VALID);
+    }
+    m_sg->fillSignalFlags(dates, m_bar_flags.data(), BAR_SG_BUY, BAR_SG_SELL);
 }
 
 void System::run(const KQuery& query, bool reset, bool resetAll) {
@@ -403,13 +438,23 @@ void System::run(const KData& kdata, bool reset, bool resetAll) {
 
     readyForRun();
 
-    bool trace = getParam<bool>("trace");
+    bool trace = m_run_param.trace;
     setTO(kdata);
     size_t total = m_kdata.size();
     auto const* ks = m_kdata.data();
     auto const* src_ks = m_src_kdata.data();
     HKU_ASSERT(m_kdata.size() == m_src_kdata.size());
 
+    _prepareBarFlags();
+    const uint8_t* flags = m_bar_flags.data();
+
+    // 按信号数量预留交易记录空间，避免运行中反复扩容
+    size_t signal_count = 0;
+    for (size_t i = 0; i < total; ++i) {
+        signal_count += (flags[i] & (BAR_SG_BUY | BAR_SG_SELL)) ? 1 : 0;
+    }
+    m_trade_list.reserve(m_trade_list.size() + 2 * signal_count);
+
     // 适应 strategy 模式下运行时同步资产信息可能造成的偏差
     Datetime tm_init_datetime = m_tm->initDatetime();
     Datetime tm_last_datetime = m_tm->lastDatetime();
@@ -420,7 +465,7 @@ void System::run(const KData& kdata, bool reset, bool resetAll) {
 
     for (size_t i = 0; i < total; ++i) {
         if (ks[i].datetime >= tm_init_datetime && ks[i].datetime >= tm_last_datetime) {
-            auto tr = _runMoment(ks[i], src_ks[i]);
+            auto tr = _runMoment(ks[i], src_ks[i], flags + i);
             if (trace) {
                 HKU_INFO_IF(!tr.isNull(), "{}", tr);
                 PositionRecord position = m_tm->getPosition(ks[i].datetime, m_stock);
@@ -439,6 +484,7 @@ void System::run(const KData& kdata, bool reset, bool resetAll) {
             }
         }
     }
+    m_bar_flags.clear();
     m_calculated = true;
 }
 
@@ -459,8 +505,10 @@ TradeRecord System::runMoment(const Datetime& datetime) {
     return _runMoment(today, src_today);
 }
 
-TradeRecord System::_runMoment(const KRecord& today, const KRecord& src_today) {
-    bool trace = getParam<bool>("trace");
+TradeRecord System::_runMoment(const KRecord& today, const KRecord& src_today,
+                               const uint8_t* flags) {
+    _updateRunParam();
+    bool trace = m_run_param.trace;
     if (trace) {
         HKU_INFO("{} ------------------------------------------------------", today.datetime);
         HKU_INFO("[{}] cal today {} ", name(), today);
@@ -474,7 +522,7 @@ TradeRecord System::_runMoment(const KRecord& today, const KRecord& src_today) {
     TradeRecord result;
     if ((today.highPrice == today.lowPrice || today.closePrice > today.highPrice ||
          today.closePrice < today.lowPrice) &&
-        !getParam<bool>("can_trade_when_high_eq_low")) {
+        !m_run_param.can_trade_when_high_eq_low) {
         HKU_INFO_IF(trace, "[{}] ignore current highPrice == lowPrice", name());
         return result;
     }
@@ -491,7 +539,8 @@ TradeRecord System::_runMoment(const KRecord& today, const KRecord& src_today) {
     // 处理市场环境策略
     //----------------------------------------------------------
 
-    bool current_ev_valid = _environmentIsValid(today.datetime);
+    bool current_ev_valid =
+      flags ? (*flags & BAR_EV_VALID) != 0 : _environmentIsValid(today.datetime);
 
     // 如果当前环境无效
     if (!current_ev_valid) {
@@ -512,7 +561,7 @@ TradeRecord System::_runMoment(const KRecord& today, const KRecord& src_today) {
         HKU_INFO_IF(trace, "[{}] EV status from invalid to valid", name());
 
         // 如果使用环境判定策略进行初始建仓
-        if (getParam<bool>("ev_open_position")) {
+        if (m_run_param.ev_open_position) {
             HKU_INFO_IF(trace, "[{}] EV to buy", name());
             TradeRecord tr = _buy(today, src_today, PART_ENVIRONMENT);
             m_pre_ev_valid = current_ev_valid;
@@ -526,7 +575,8 @@ TradeRecord System::_runMoment(const KRecord& today, const KRecord& src_today) {
     // 处理系统有效条件判断策略
     //----------------------------------------------------------
 
-    bool current_cn_valid = _conditionIsValid(today.datetime);
+    bool current_cn_valid =
+      flags ? (*flags & BAR_CN_VALID) != 0 : _conditionIsValid(today.datetime);
 
     // 如果系统当前无效
     if (!current_cn_valid) {
@@ -547,7 +597,7 @@ TradeRecord System::_runMoment(const KRecord& today, const KRecord& src_today) {
         HKU_INFO_IF(trace, "[{}] CN status from invalid to valid", name());
 
         // 如果使用环境判定策略进行初始建仓
-        if (getParam<bool>("cn_open_position")) {
+        if (m_run_param.cn_open_position) {
             HKU_INFO_IF(trace, "[{}] CN to buy", name());
             TradeRecord tr = _buy(today, src_today, PART_CONDITION);
             m_pre_cn_valid = current_cn_valid;
@@ -562,7 +612,7 @@ TradeRecord System::_runMoment(const KRecord& today, const KRecord& src_today) {
     //----------------------------------------------------------
 
     // 如果有买入信号
-    if (m_sg->shouldBuy(today.datetime)) {
+    if (flags ? (*flags & BAR_SG_BUY) != 0 : m_sg->shouldBuy(today.datetime)) {
         TradeRecord tr;
         if (m_tm->haveShort(m_stock)) {
             HKU_INFO_IF(trace, "[{}] SG to buy short", name());
@@ -576,7 +626,7 @@ TradeRecord System::_runMoment(const KRecord& today, const KRecord& src_today) {
     }
 
     // 发出卖出信号
-    if (m_sg->shouldSell(today.datetime)) {
+    if (flags ? (*flags & BAR_SG_SELL) != 0 : m_sg->shouldSell(today.datetime)) {
         TradeRecord tr;
         if (m_tm->have(m_stock)) {
             HKU_INFO_IF(trace, "[{}] SG to sell", name());
@@ -622,7 +672,7 @@ TradeRecord System::_runMoment(const KRecord& today, const KRecord& src_today) {
                     m_lastTakeProfit = current_take_profile;
                 }
 
-                int tp_delay_n = getParam<int>("tp_delay_n");
+                int tp_delay_n = m_run_param.tp_delay_n;
                 size_t pos = m_kdata.getPos(today.datetime);
                 size_t position_pos = m_kdata.getPos(position.takeDatetime);
                 // 如果当前价格小于等于止盈价，且满足止盈延迟条件则卖出
@@ -646,7 +696,7 @@ TradeRecord System::_runMoment(const KRecord& today, const KRecord& src_today) {
 
 TradeRecord System::_buy(const KRecord& today, const KRecord& src_today, Part from) {
     TradeRecord result;
-    if (getParam<bool>("buy_delay")) {
+    if (m_run_param.buy_delay) {
         _submitBuyRequest(today, src_today, from);
         return result;
     } else {
@@ -664,7 +714,7 @@ TradeRecord System::_buyNow(const KRecord& today, const KRecord& src_today, Part
     price_t stoploss = _getStoplossPrice(today, src_today, today.closePrice);
 
     // 如果计划的价格已经小于等于止损价，放弃交易
-    bool trace = getParam<bool>("trace");
+    bool trace = m_run_param.trace;
     if (planPrice <= stoploss) {
         HKU_INFO_IF(trace, "[{}] buy failed, planPrice: {} <= stoploss: {}", name(), planPrice,
                     stoploss);
@@ -699,7 +749,7 @@ TradeRecord System::_buyNow(const KRecord& today, const KRecord& src_today, Part
 
 TradeRecord System::_buyDelay(const KRecord& today, const KRecord& src_today) {
     TradeRecord result;
-    if (today.highPrice == today.lowPrice && !getParam<bool>("can_trade_when_high_eq_low")) {
+    if (today.highPrice == today.lowPrice && !m_run_param.can_trade_when_high_eq_low) {
         // 无法实际执行，延迟至下一时刻
         _submitBuyRequest(KRecord(today.datetime), KRecord(today.datetime), m_buyRequest.from);
         return result;
@@ -712,7 +762,7 @@ TradeRecord System::_buyDelay(const KRecord& today, const KRecord& src_today) {
     price_t stoploss = 0.0;
     double number = 0.0;
     price_t goalPrice = 0.0;
-    if (getParam<bool>("delay_use_current_price")) {
+    if (m_run_param.delay_use_current_price) {
         // 使用当前计划价格计算止损价和可买入数量
         stoploss = _getStoplossPrice(today, src_today, today.openPrice);
         number = planPrice <= stoploss ? 0.0
@@ -753,7 +803,7 @@ TradeRecord System::_buyDelay(const KRecord& today, const KRecord& src_today) {
 
 void System::_submitBuyRequest(const KRecord& today, const KRecord& src_today, Part from) {
     if (m_buyRequest.valid) {
-        if (m_buyRequest.count > getParam<int>("max_delay_count")) {
+        if (m_buyRequest.count > m_run_param.max_delay_count) {
             // 超出最大延迟次数，清除买入请求
             m_buyRequest.clear();
             return;
@@ -776,7 +826,8 @@ void System::_submitBuyRequest(const KRecord& today, const KRecord& src_today, P
 }
 
 TradeRecord System::_sellForce(const Datetime& date, double num, Part from, bool on_open) {
-    bool trace = getParam<bool>("trace");
+    _updateRunParam();
+    bool trace = m_run_param.trace;
     HKU_INFO_IF(trace, "[{}] force sell {} by {}", name(), num, getSystemPartName(from));
 
     TradeRecord record;
@@ -819,9 +870,9 @@ TradeRecord System::_sellForce(const Datetime& date, double num, Part from, bool
 }
 
 TradeRecord System::_sell(const KRecord& today, const KRecord& src_today, Part from) {
-    bool trace = getParam<bool>("trace");
+    bool trace = m_run_param.trace;
     TradeRecord result;
-    if (getParam<bool>("sell_delay")) {
+    if (m_run_param.sell_delay) {
         _submitSellRequest(today, src_today, from);
         HKU_INFO_IF(trace, "[{}] will be delay to sell", name());
         return result;
@@ -873,11 +924,11 @@ TradeRecord System::_sellNow(const KRecord& today, const KRecord& src_today, Par
 }
 
 TradeRecord System::_sellDelay(const KRecord& today, const KRecord& src_today) {
-    bool trace = getParam<bool>("trace");
+    bool trace = m_run_param.trace;
     HKU_INFO_IF(trace, "[{}] process _sellDelay request", name());
 
     TradeRecord result;
-    if (today.highPrice == today.lowPrice && !getParam<bool>("can_trade_when_high_eq_low")) {
+    if (today.highPrice == today.lowPrice && !m_run_param.can_trade_when_high_eq_low) {
         // 无法执行，保留卖出请求，继续延迟至下一时刻
         _submitSellRequest(KRecord(today.datetime), KRecord(today.datetime), m_sellRequest.from);
         return result;
@@ -892,7 +943,7 @@ TradeRecord System::_sellDelay(const KRecord& today, const KRecord& src_today) {
 
     Part from = m_sellRequest.from;
 
-    if (getParam<bool>("delay_use_current_price")) {
+    if (m_run_param.delay_use_current_price) {
         stoploss = _getStoplossPrice(today, src_today, today.openPrice);
         if (planPrice < stoploss) {
             number = m_tm->getHoldNumber(today.datetime, m_stock);
@@ -934,7 +985,7 @@ TradeRecord System::_sellDelay(const KRecord& today, const KRecord& src_today) {
 
 void System::_submitSellRequest(const KRecord& today, const KRecord& src_today, Part from) {
     if (m_sellRequest.valid) {
-        if (m_sellRequest.count > getParam<int>("max_delay_count")) {
+        if (m_sellRequest.count > m_run_param.max_delay_count) {
             // 超出最大延迟次数，清除买入请求
             m_sellRequest.clear();
             return;
@@ -962,10 +1013,10 @@ void System::_submitSellRequest(const KRecord& today, const KRecord& src_today,
 
 TradeRecord System::_buyShort(const KRecord& today, const KRecord& src_today, Part from) {
     TradeRecord result;
-    if (getParam<bool>("support_borrow_stock") == false)
+    if (!m_run_param.support_borrow_stock)
         return result;
 
-    if (getParam<bool>("buy_delay")) {
+    if (m_run_param.buy_delay) {
         _submitBuyShortRequest(today, src_today, from);
         return result;
     } else {
@@ -1035,7 +1086,7 @@ TradeRecord System::_buyShortDelay(const KRecord& today, const KRecord& src_toda
     price_t stoploss = 0.0;
     double number = 0.0;
     price_t goalPrice = 0.0;
-    if (getParam<bool>("delay_use_current_price")) {
+    if (m_run_param.delay_use_current_price) {
         // 取当前时刻的收盘价对应的止损价
         stoploss = _getShortStoplossPrice(today, src_today, today.openPrice);
         number =
@@ -1082,7 +1133,7 @@ TradeRecord System::_buyShortDelay(const KRecord& today, const KRecord& src_toda
 
 void System::_submitBuyShortRequest(const KRecord& today, const KRecord& src_today, Part from) {
     if (m_buyShortRequest.valid) {
-        if (m_buyShortRequest.count > getParam<int>("max_delay_count")) {
+        if (m_buyShortRequest.count > m_run_param.max_delay_count) {
             // 超出最大延迟次数，清除买入请求
             m_buyRequest.clear();
             return;
@@ -1106,12 +1157,12 @@ void System::_submitBuyShortRequest(const KRecord& today, const KRecord& src_tod
 
 TradeRecord System::_sellShort(const KRecord& today, const KRecord& src_today, Part from) {
     TradeRecord result;
-    if (getParam<bool>("support_borrow_stock") == false) {
+    if (!m_run_param.support_borrow_stock) {
         // HKU_WARN("set system param support_borrow_stock to true to short sell");
         return result;
     }
 
-    if (getParam<bool>("sell_delay")) {
+    if (m_run_param.sell_delay) {
         _submitSellShortRequest(today, src_today, from);
         return result;
     } else {
@@ -1169,7 +1220,7 @@ TradeRecord System::_sellShortDelay(const KRecord& today, const KRecord& src_tod
     price_t stoploss = 0.0;
     double number = 0;
     price_t goalPrice = 0.0;
-    if (getParam<bool>("delay_use_current_price")) {
+    if (m_run_param.delay_use_current_price) {
         stoploss = _getShortStoplossPrice(today, src_today, today.openPrice);
         number = _getSellShortNumber(today.datetime, planPrice, stoploss - planPrice,
                                      m_sellShortRequest.from);
@@ -1204,7 +1255,7 @@ TradeRecord System::_sellShortDelay(const KRecord& today, const KRecord& src_tod
 
 void System::_submitSellShortRequest(const KRecord& today, const KRecord& src_today, Part from) {
     if (m_sellShortRequest.valid) {
-        if (m_sellShortRequest.count > getParam<int>("max_delay_count")) {
+        if (m_sellShortRequest.count > m_run_param.max_delay_count) {
             // 超出最大延迟次数，清除买入请求
             m_sellShortRequest.clear();
             return;
@@ -1236,6 +1287,7 @@ TradeRecord System::_processRequest(const KRecord& today, const KRecord& src_tod
 
 TradeRecord System::pfProcessDelaySellRequest(const Datetime& date) {
     HKU_IF_RETURN(!m_sellRequest.valid, TradeRecord());
+    _updateRunParam();
     size_t pos = m_kdata.getPos(date);
     HKU_IF_RETURN(pos == Null<size_t>(), TradeRecord());
     KRecord today = m_kdata.getKRecord(pos);
@@ -304,7 +304,23 @@ private:
 
     TradeRecord _processRequest(const KRecord& today, const KRecord& src_today);
 
-    TradeRecord _runMoment(const KRecord& record, const KRecord& src_record);
+    /**
+     * 执行单根K线
+     * @param flags 预先批量计算的当日部件状态（BarFlag 组合），为空时逐个查询各部件
+     */
+    TradeRecord _runMoment(const KRecord& record, const KRecord& src_record,
+                           const uint8_t* flags = nullptr);
+
+    // 按K线日期批量计算各部件状态，结果保存在 m_bar_flags 中
+    void _prepareBarFlags();
+
+    // 参数变更后刷新运行期参数缓存
+    void _updateRunParam() {
+        if (m_run_param_changed) {
+            _readRunParam();
+        }
+    }
+    void _readRunParam();
 
     // Portfolio | AllocateFunds 指示立即进行强制卖出，以便对 buy_delay 的系统进行资金调整
     TradeRecord _sellForce(const Datetime& date, double num, Part from, bool on_open);
@@ -343,6 +359,32 @@ protected:
 private:
     void initParam();  // 初始化参数及其默认值
 
+    // 每根K线的部件状态标志
+    enum BarFlag : uint8_t {
+        BAR_EV_VALID = 1,  // 市场环境有效
+        BAR_CN_VALID = 2,  // 系统条件有效
+        BAR_SG_BUY = 4,    // 存在买入信号
+        BAR_SG_SELL = 8,   // 存在卖出信号
+    };
+
+    // 逐K线执行时频繁读取的参数，避免每根K线均按名称查找参数
+    struct RunParam {
+        bool trace{false};
+        bool buy_delay{true};
+        bool sell_delay{true};
+        bool delay_use_current_price{true};
+        bool can_trade_when_high_eq_low{false};
+        bool ev_open_position{false};
+        bool cn_open_position{false};
+        bool support_borrow_stock{false};
+        int max_delay_count{3};
+        int tp_delay_n{1};
+    };
+
+    RunParam m_run_param;
+    bool m_run_param_changed{true};
+    vector<uint8_t> m_bar_flags;  // 与 m_kdata 对应的部件状态，仅在 run 期间有效
+
 //============================================
 // 序列化支持
 //============================================
@@ -0,0 +1,172 @@
+/*
+ * LatencyHistogram.h
+ *
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#pragma once
+#ifndef HIKYUU_UTILITIES_LATENCYHISTOGRAM_H
+#define HIKYUU_UTILITIES_LATENCYHISTOGRAM_H
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <fmt/format.h>
+
+namespace hku {
+
+/**
+ * 延迟直方图（对数-线性分桶），用于统计耗时的分位数
+ * @details
+ * <pre>
+ * 以纳秒为单位记录，小于 32 的值精确记录，其余按 2 的幂次分段，每段再线性分为 16 个桶，
+ * 分位数的相对误差不超过 1/16。桶数固定，记录时无内存分配，各计数均为原子变量，
+ * 可由多个线程同时记录；统计时与记录并发仅产生近似结果。
+ * </pre>
+ */
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BITS = 4;
+    static constexpr int64_t SUB_COUNT = 1 << SUB_BITS;
+    static constexpr size_t BUCKET_COUNT = (64 - SUB_BITS + 1) * SUB_COUNT;
+
+    LatencyHistogram() {
+        reset();
+    }
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    /** 记录一次耗时（纳秒），负值按 0 记录 */
+    void record(int64_t ns) noexcept {
+        uint64_t v = ns > 0 ? uint64_t(ns) : 0;
+        m_buckets[_index(v)].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        m_sum.fetch_add(v, std::memory_order_relaxed);
+
+        uint64_t cur = m_min.load(std::memory_order_relaxed);
+        while (v < cur && !m_min.compare_exchange_weak(cur, v, std::memory_order_relaxed)) {
+        }
+        cur = m_max.load(std::memory_order_relaxed);
+        while (v > cur && !m_max.compare_exchange_weak(cur, v, std::memory_order_relaxed)) {
+        }
+    }
+
+    /** 清除全部记录 */
+    void reset() noexcept {
+        for (auto& bucket : m_buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        m_count.store(0, std::memory_order_relaxed);
+        m_sum.store(0, std::memory_order_relaxed);
+        m_min.store((std::numeric_limits<uint64_t>::max)(), std::memory_order_relaxed);
+        m_max.store(0, std::memory_order_relaxed);
+    }
+
+    /** 记录次数 */
+    uint64_t count() const noexcept {
+        return m_count.load(std::memory_order_relaxed);
+    }
+
+    /** 最小值（纳秒），无记录时返回 0 */
+    int64_t min() const noexcept {
+        return count() == 0 ? 0 : int64_t(m_min.load(std::memory_order_relaxed));
+    }
+
+    /** 最大值（纳秒） */
+    int64_t max() const noexcept {
+        return int64_t(m_max.load(std::memory_order_relaxed));
+    }
+
+    /** 平均值（纳秒） */
+    double mean() const noexcept {
+        uint64_t total = count();
+        return total == 0 ? 0.0 : double(m_sum.load(std::memory_order_relaxed)) / double(total);
+    }
+
+    /**
+     * 获取分位数
+     * @param percent 百分比 [0, 100]，如 99.9
+     * @return 所在桶的上界（纳秒），不超过记录的最大值；无记录时返回 0
+     */
+    int64_t percentile(double percent) const noexcept {
+        uint64_t total = count();
+        if (total == 0) {
+            return 0;
+        }
+        percent = percent < 0.0 ? 0.0 : (percent > 100.0 ? 100.0 : percent);
+        uint64_t target = uint64_t(percent / 100.0 * double(total) + 0.5);
+        if (target == 0) {
+            target = 1;
+        }
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; i++) {
+            seen += m_buckets[i].load(std::memory_order_relaxed);
+            if (seen >= target) {
+                int64_t upper = _upper(i);
+                int64_t max_value = max();
+                return upper < max_value ? upper : max_value;
+            }
+        }
+        return max();
+    }
+
+    /** 以微秒为单位输出统计摘要 */
+    std::string str() const {
+        return fmt::format(
+          "count: {}, mean: {:.3f}us, p50: {:.3f}us, p90: {:.3f}us, p99: {:.3f}us, "
+          "p99.9: {:.3f}us, max: {:.3f}us",
+          count(), mean() / 1000.0, percentile(50.0) / 1000.0, percentile(90.0) / 1000.0,
+          percentile(99.0) / 1000.0, percentile(99.9) / 1000.0, max() / 1000.0);
+    }
+
+private:
+    static int _msb(uint64_t v) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - __builtin_clzll(v);
+#else
+        int r = 0;
+        while (v >>= 1) {
+            r++;
+        }
+        return r;
+#endif
+    }
+
+    static size_t _index(uint64_t v) noexcept {
+        if (v < uint64_t(2 * SUB_COUNT)) {
+            return size_t(v);
+        }
+        int msb = _msb(v);
+        int shift = msb - SUB_BITS;
+        return size_t((msb - SUB_BITS) * SUB_COUNT + int64_t(v >> shift));
+    }
+
+    static int64_t _upper(size_t ix) noexcept {
+        if (ix < size_t(2 * SUB_COUNT)) {
+            return int64_t(ix);
+        }
+        int shift = int(ix / SUB_COUNT) - 1;
+        uint64_t sub = ix % SUB_COUNT + SUB_COUNT;
+        uint64_t upper = ((sub + 1) << shift) - 1;
+        return upper > uint64_t((std::numeric_limits<int64_t>::max)())
+                 ? (std::numeric_limits<int64_t>::max)()
+                 : int64_t(upper);
+    }
+
+private:
+    std::atomic<uint64_t> m_buckets[BUCKET_COUNT];
+    std::atomic<uint64_t> m_count;
+    std::atomic<uint64_t> m_sum;
+    std::atomic<uint64_t> m_min;
+    std::atomic<uint64_t> m_max;
+};
+
+}  // namespace hku
+
+#endif /* HIKYUU_UTILITIES_LATENCYHISTOGRAM_H */
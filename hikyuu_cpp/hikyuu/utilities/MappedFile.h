@@ -0,0 +1,61 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#pragma once
+#ifndef HIKYUU_UTILITIES_MAPPEDFILE_H_
+#define HIKYUU_UTILITIES_MAPPEDFILE_H_
+
+#include <cstddef>
+#include <string>
+
+namespace hku {
+
+/**
+ * 只读内存映射文件
+ * @details 映射打开时的整个文件，之后文件在尾部追加的内容不可见；空文件视为打开成功但长度为 0。
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() {
+        close();
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * 映射指定文件，已打开时先关闭
+     * @return 文件不存在或映射失败时返回 false
+     */
+    bool open(const std::string& filename);
+
+    /** 解除映射 */
+    void close() noexcept;
+
+    /** 映射的数据 */
+    const char* data() const noexcept {
+        return m_data;
+    }
+
+    /** 映射的长度 */
+    size_t size() const noexcept {
+        return m_size;
+    }
+
+private:
+    const char* m_data{nullptr};
+    size_t m_size{0};
+#ifdef _WIN32
+    void* m_file{nullptr};
+    void* m_mapping{nullptr};
+#endif
+};
+
+}  // namespace hku
+
+#endif /* HIKYUU_UTILITIES_MAPPEDFILE_H_ */
@@ -17,6 +17,90 @@
 
 namespace hku {
 
+namespace {
+
+/*
+ * 预计算的日期边界表，覆盖 [1900-01-01, 2200-01-01)
+ * 以日序号（julian day number）为下标，避免 startOfMonth/nextMonth 等函数反复进行公历换算
+ * 超出范围的日期仍使用 boost gregorian 计算
+ */
+struct DateBoundaryTable {
+    static constexpr int START_YEAR = 1900;
+    static constexpr int END_YEAR = 2200;
+    static constexpr size_t MONTH_COUNT = (END_YEAR - START_YEAR) * 12;
+
+    uint32_t first_day;                // START_YEAR-01-01 的日序号
+    uint32_t last_day;                 // END_YEAR-01-01 的日序号（不含）
+    std::vector<uint32_t> month_start;  // 月序号 -> 当月1日的日序号，末尾多一项为 END_YEAR-01-01
+    std::vector<uint16_t> day_month;    // (日序号 - first_day) -> 月序号
+
+    DateBoundaryTable() {
+        month_start.resize(MONTH_COUNT + 1);
+        for (size_t i = 0; i <= MONTH_COUNT; i++) {
+            month_start[i] = bd::date(static_cast<unsigned short>(START_YEAR + i / 12),
+                                      static_cast<unsigned short>(i % 12 + 1), 1)
+                               .day_number();
+        }
+        first_day = month_start.front();
+        last_day = month_start.back();
+
+        day_month.resize(last_day - first_day);
+        for (size_t i = 0; i < MONTH_COUNT; i++) {
+            for (uint32_t d = month_start[i]; d < month_start[i + 1]; d++) {
+                day_month[d - first_day] = static_cast<uint16_t>(i);
+            }
+        }
+    }
+
+    bool contains(uint32_t day) const {
+        return day >= first_day && day < last_day;
+    }
+
+    /** 月序号，调用前需确认 contains(day) */
+    size_t monthIndex(uint32_t day) const {
+        return day_month[day - first_day];
+    }
+
+    /** 包含指定日期、长度为 n 个月的周期（月、季、半年、年）的起始日序号 */
+    uint32_t startOfPeriod(uint32_t day, size_t n) const {
+        size_t ix = monthIndex(day);
+        return month_start[ix - ix % n];
+    }
+
+    /** 包含指定日期、长度为 n 个月的周期的上一周期起始日序号，超出范围时返回 0 */
+    uint32_t prePeriod(uint32_t day, size_t n) const {
+        size_t ix = monthIndex(day);
+        ix -= ix % n;
+        return ix >= n ? month_start[ix - n] : 0;
+    }
+
+    /** 包含指定日期、长度为 n 个月的周期的下一周期起始日序号 */
+    uint32_t nextPeriod(uint32_t day, size_t n) const {
+        size_t ix = monthIndex(day);
+        return month_start[ix - ix % n + n];
+    }
+
+    static const DateBoundaryTable &instance() {
+        static DateBoundaryTable table;
+        return table;
+    }
+};
+
+inline uint32_t dayNumber(const bt::ptime &d) {
+    return d.date().day_number();
+}
+
+inline Datetime fromDayNumber(uint32_t day) {
+    return Datetime(bd::date(static_cast<bd::date::date_int_type>(day)));
+}
+
+// 周一为一周起始，julian day number 对 7 取余为 0 时为周一
+inline uint32_t startOfWeekDay(uint32_t day) {
+    return day - day % 7;
+}
+
+}  // namespace
+
 HKU_UTILS_API std::ostream &operator<<(std::ostream &out, const Datetime &d) {
     out << d.str();
     return out;
@@ -127,12 +211,6 @@ Datetime::Datetime(const std::string &ts) {
         : bt::ptime(bd::from_undelimited_string(date_str), bt::duration_from_string(time_str));
 }
 
-bool Datetime::isNull() const {
-    bd::date d(bd::pos_infin);
-    bt::ptime null_date = bt::ptime(d, bt::time_duration(0, 0, 0));
-    return (m_data == null_date) ? true : false;
-}
-
 Datetime &Datetime::operator=(const Datetime &d) {
     if (this == &d)
         return *this;
@@ -285,17 +363,9 @@ uint64_t Datetime::hex() const noexcept {
 }
 
 uint64_t Datetime::ticks() const noexcept {
-    try {
-        HKU_IF_RETURN(isNull(), Null<uint64_t>());
-        TimeDelta d = (*this) - Datetime::min();
-        return d.ticks();
-    } catch (const std::exception &e) {
-        HKU_ERROR(e.what());
-        return Null<uint64_t>();
-    } catch (...) {
-        HKU_ERROR("Unknown error!");
-        return Null<uint64_t>();
-    }
+    HKU_IF_RETURN(isNull(), Null<uint64_t>());
+    static const bt::ptime s_min_time(bd::date(bd::min_date_time), bt::time_duration(0, 0, 0));
+    return (m_data - s_min_time).ticks();
 }
 
 long Datetime::year() const {
@@ -371,7 +441,7 @@ DatetimeList HKU_UTILS_API getDateRange(const Datetime &start, const Datetime &e
 }
 
 Datetime Datetime::dateOfWeek(int day) const {
-    HKU_IF_RETURN(*this == Null<Datetime>(), *this);
+    HKU_IF_RETURN(isNull(), *this);
 
     int dd = day;
     if (dd < 0) {
@@ -390,24 +460,42 @@ Datetime Datetime::dateOfWeek(int day) const {
 }
 
 Datetime Datetime::startOfMonth() const {
-    return *this == Null<Datetime>() ? *this : Datetime(year(), month(), 1);
+    HKU_IF_RETURN(isNull(), *this);
+    uint32_t day = dayNumber(m_data);
+    const auto &table = DateBoundaryTable::instance();
+    HKU_IF_RETURN(table.contains(day), fromDayNumber(table.startOfPeriod(day, 1)));
+    return Datetime(year(), month(), 1);
 }
 
 Datetime Datetime::endOfMonth() const {
-    return *this == Null<Datetime>() ? *this : Datetime(date().end_of_month());
+    HKU_IF_RETURN(isNull(), *this);
+    uint32_t day = dayNumber(m_data);
+    const auto &table = DateBoundaryTable::instance();
+    HKU_IF_RETURN(table.contains(day), fromDayNumber(table.nextPeriod(day, 1) - 1));
+    return Datetime(date().end_of_month());
 }
 
 Datetime Datetime::startOfYear() const {
-    return *this == Null<Datetime>() ? *this : Datetime(year(), 1, 1);
+    HKU_IF_RETURN(isNull(), *this);
+    uint32_t day = dayNumber(m_data);
+    const auto &table = DateBoundaryTable::instance();
+    HKU_IF_RETURN(table.contains(day), fromDayNumber(table.startOfPeriod(day, 12)));
+    return Datetime(year(), 1, 1);
 }
 
 Datetime Datetime::endOfYear() const {
-    return *this == Null<Datetime>() ? Null<Datetime>() : Datetime(year(), 12, 31);
+    HKU_IF_RETURN(isNull(), Null<Datetime>());
+    uint32_t day = dayNumber(m_data);
+    const auto &table = DateBoundaryTable::instance();
+    HKU_IF_RETURN(table.contains(day), fromDayNumber(table.nextPeriod(day, 12) - 1));
+    return Datetime(year(), 12, 31);
 }
 
 Datetime Datetime::startOfWeek() const {
     Datetime result;
-    HKU_IF_RETURN(*this == Null<Datetime>(), result);
+    HKU_IF_RETURN(isNull(), result);
+    uint32_t day = dayNumber(m_data);
+    HKU_IF_RETURN(DateBoundaryTable::instance().contains(day), fromDayNumber(startOfWeekDay(day)));
     int today = dayOfWeek();
     if (today == 0) {
         result = Datetime(date() + bd::date_duration(-6));
@@ -424,7 +512,10 @@ Datetime Datetime::startOfWeek() const {
 
 Datetime Datetime::endOfWeek() const {
     Datetime result;
-    HKU_IF_RETURN(*this == Null<Datetime>(), result);
+    HKU_IF_RETURN(isNull(), result);
+    uint32_t day = dayNumber(m_data);
+    HKU_IF_RETURN(DateBoundaryTable::instance().contains(day),
+                  fromDayNumber(startOfWeekDay(day) + 6));
     int today = dayOfWeek();
     if (today == 0) {
         result = Datetime(date());
@@ -439,7 +530,10 @@ Datetime Datetime::endOfWeek() const {
 
 Datetime Datetime::startOfQuarter() const {
     Datetime result;
-    HKU_IF_RETURN(*this == Null<Datetime>(), result);
+    HKU_IF_RETURN(isNull(), result);
+    uint32_t day = dayNumber(m_data);
+    const auto &table = DateBoundaryTable::instance();
+    HKU_IF_RETURN(table.contains(day), fromDayNumber(table.startOfPeriod(day, 3)));
     int m = month();
     int y = year();
     if (m <= 3) {
@@ -457,7 +551,10 @@ Datetime Datetime::startOfQuarter() const {
 
 Datetime Datetime::endOfQuarter() const {
     Datetime result;
-    HKU_IF_RETURN(*this == Null<Datetime>(), result);
+    HKU_IF_RETURN(isNull(), result);
+    uint32_t day = dayNumber(m_data);
+    const auto &table = DateBoundaryTable::instance();
+    HKU_IF_RETURN(table.contains(day), fromDayNumber(table.nextPeriod(day, 3) - 1));
     int m = month();
     int y = year();
     if (m <= 3) {
@@ -474,23 +571,35 @@ Datetime Datetime::endOfQuarter() const {
 }
 
 Datetime Datetime::startOfHalfyear() const {
-    HKU_IF_RETURN(*this == Null<Datetime>(), *this);
+    HKU_IF_RETURN(isNull(), *this);
+    uint32_t day = dayNumber(m_data);
+    const auto &table = DateBoundaryTable::instance();
+    HKU_IF_RETURN(table.contains(day), fromDayNumber(table.startOfPeriod(day, 6)));
     return month() <= 6 ? Datetime(year(), 1, 1) : Datetime(year(), 7, 1);
 }
 
 Datetime Datetime::endOfHalfyear() const {
-    HKU_IF_RETURN(*this == Null<Datetime>(), *this);
+    HKU_IF_RETURN(isNull(), *this);
+    uint32_t day = dayNumber(m_data);
+    const auto &table = DateBoundaryTable::instance();
+    HKU_IF_RETURN(table.contains(day), fromDayNumber(table.nextPeriod(day, 6) - 1));
     return month() <= 6 ? Datetime(year(), 6, 30) : Datetime(year(), 12, 31);
 }
 
 Datetime Datetime::nextDay() const {
-    HKU_IF_RETURN(*this == Null<Datetime>() || *this == Datetime::max(), *this);
+    HKU_IF_RETURN(isNull(), *this);
+    uint32_t day = dayNumber(m_data);
+    HKU_IF_RETURN(DateBoundaryTable::instance().contains(day), fromDayNumber(day + 1));
+    HKU_IF_RETURN(*this == Datetime::max(), *this);
     return Datetime(date() + bd::date_duration(1));
 }
 
 Datetime Datetime::nextWeek() const {
     Datetime result;
-    HKU_IF_RETURN(*this == Null<Datetime>(), result);
+    HKU_IF_RETURN(isNull(), result);
+    uint32_t day = dayNumber(m_data);
+    HKU_IF_RETURN(DateBoundaryTable::instance().contains(day),
+                  fromDayNumber(startOfWeekDay(day) + 7));
     result = Datetime(endOfWeek().date() + bd::date_duration(1));
     if (result > Datetime::max())
         result = Datetime::max();
@@ -500,7 +609,10 @@ Datetime Datetime::nextWeek() const {
 
 Datetime Datetime::nextMonth() const {
     Datetime result;
-    HKU_IF_RETURN(*this == Null<Datetime>(), result);
+    HKU_IF_RETURN(isNull(), result);
+    uint32_t day = dayNumber(m_data);
+    const auto &table = DateBoundaryTable::instance();
+    HKU_IF_RETURN(table.contains(day), fromDayNumber(table.nextPeriod(day, 1)));
     result = Datetime(endOfMonth().date() + bd::date_duration(1));
     if (result > Datetime::max())
         result = Datetime::max();
@@ -510,7 +622,10 @@ Datetime Datetime::nextMonth() const {
 
 Datetime Datetime::nextQuarter() const {
     Datetime result;
-    HKU_IF_RETURN(*this == Null<Datetime>(), result);
+    HKU_IF_RETURN(isNull(), result);
+    uint32_t day = dayNumber(m_data);
+    const auto &table = DateBoundaryTable::instance();
+    HKU_IF_RETURN(table.contains(day), fromDayNumber(table.nextPeriod(day, 3)));
     result = Datetime(endOfQuarter().date() + bd::date_duration(1));
     if (result > Datetime::max())
         result = Datetime::max();
@@ -520,7 +635,10 @@ Datetime Datetime::nextQuarter() const {
 
 Datetime Datetime::nextHalfyear() const {
     Datetime result;
-    HKU_IF_RETURN(*this == Null<Datetime>(), result);
+    HKU_IF_RETURN(isNull(), result);
+    uint32_t day = dayNumber(m_data);
+    const auto &table = DateBoundaryTable::instance();
+    HKU_IF_RETURN(table.contains(day), fromDayNumber(table.nextPeriod(day, 6)));
     result = Datetime(endOfHalfyear().date() + bd::date_duration(1));
     if (result > Datetime::max())
         result = Datetime::max();
@@ -530,7 +648,10 @@ Datetime Datetime::nextHalfyear() const {
 
 Datetime Datetime::nextYear() const {
     Datetime result;
-    HKU_IF_RETURN(*this == Null<Datetime>(), result);
+    HKU_IF_RETURN(isNull(), result);
+    uint32_t day = dayNumber(m_data);
+    const auto &table = DateBoundaryTable::instance();
+    HKU_IF_RETURN(table.contains(day), fromDayNumber(table.nextPeriod(day, 12)));
     result = Datetime(endOfYear().date() + bd::date_duration(1));
     if (result > Datetime::max())
         result = Datetime::max();
@@ -538,13 +659,19 @@ Datetime Datetime::nextYear() const {
 }
 
 Datetime Datetime::preDay() const {
-    HKU_IF_RETURN(*this == Null<Datetime>() || *this == Datetime::min(), *this);
+    HKU_IF_RETURN(isNull(), *this);
+    uint32_t day = dayNumber(m_data);
+    HKU_IF_RETURN(DateBoundaryTable::instance().contains(day - 1), fromDayNumber(day - 1));
+    HKU_IF_RETURN(*this == Datetime::min(), *this);
     return Datetime(date() - bd::date_duration(1));
 }
 
 Datetime Datetime::preWeek() const {
     Datetime result;
-    HKU_IF_RETURN(*this == Null<Datetime>(), result);
+    HKU_IF_RETURN(isNull(), result);
+    uint32_t day = dayNumber(m_data);
+    uint32_t pre = startOfWeekDay(day) - 7;
+    HKU_IF_RETURN(DateBoundaryTable::instance().contains(pre), fromDayNumber(pre));
     try {
         result = Datetime(date() - bd::date_duration(7)).startOfWeek();
     } catch (...) {
@@ -555,7 +682,13 @@ Datetime Datetime::preWeek() const {
 
 Datetime Datetime::preMonth() const {
     Datetime result;
-    HKU_IF_RETURN(*this == Null<Datetime>(), result);
+    HKU_IF_RETURN(isNull(), result);
+    uint32_t day = dayNumber(m_data);
+    const auto &table = DateBoundaryTable::instance();
+    if (table.contains(day)) {
+        uint32_t pre = table.prePeriod(day, 1);
+        HKU_IF_RETURN(pre != 0, fromDayNumber(pre));
+    }
     try {
         int m = month();
         result = (m == 1) ? Datetime(year() - 1, 12, 1) : Datetime(year(), m - 1, 1);
@@ -567,7 +700,13 @@ Datetime Datetime::preMonth() const {
 
 Datetime Datetime::preQuarter() const {
     Datetime result;
-    HKU_IF_RETURN(*this == Null<Datetime>(), result);
+    HKU_IF_RETURN(isNull(), result);
+    uint32_t day = dayNumber(m_data);
+    const auto &table = DateBoundaryTable::instance();
+    if (table.contains(day)) {
+        uint32_t pre = table.prePeriod(day, 3);
+        HKU_IF_RETURN(pre != 0, fromDayNumber(pre));
+    }
     try {
         int m = startOfQuarter().month();
         result = (m == 1) ? Datetime(year() - 1, 10, 1) : Datetime(year(), m - 3, 1);
@@ -580,7 +719,13 @@ Datetime Datetime::preQuarter() const {
 
 Datetime Datetime::preHalfyear() const {
     Datetime result;
-    HKU_IF_RETURN(*this == Null<Datetime>(), result);
+    HKU_IF_RETURN(isNull(), result);
+    uint32_t day = dayNumber(m_data);
+    const auto &table = DateBoundaryTable::instance();
+    if (table.contains(day)) {
+        uint32_t pre = table.prePeriod(day, 6);
+        HKU_IF_RETURN(pre != 0, fromDayNumber(pre));
+    }
     try {
         int m = startOfHalfyear().month();
         result = (m <= 6) ? Datetime(year() - 1, 7, 1) : Datetime(year(), 1, 1);
@@ -593,7 +738,13 @@ Datetime Datetime::preHalfyear() const {
 
 Datetime Datetime::preYear() const {
     Datetime result;
-    HKU_IF_RETURN(*this == Null<Datetime>(), result);
+    HKU_IF_RETURN(isNull(), result);
+    uint32_t day = dayNumber(m_data);
+    const auto &table = DateBoundaryTable::instance();
+    if (table.contains(day)) {
+        uint32_t pre = table.prePeriod(day, 12);
+        HKU_IF_RETURN(pre != 0, fromDayNumber(pre));
+    }
     try {
         result = Datetime(year() - 1, 1, 1);
     } catch (...) {
@@ -605,7 +756,7 @@ Datetime Datetime::preYear() const {
 
 Datetime Datetime::endOfDay() const {
     Datetime result;
-    HKU_IF_RETURN(*this == Null<Datetime>(), result);
+    HKU_IF_RETURN(isNull(), result);
     result = date() != bd::date(bd::max_date_time) ? Datetime(year(), month(), day(), 23, 59, 59)
                                                    : Datetime::max();
     return result;
@@ -372,6 +372,11 @@ inline Datetime::Datetime(const bd::date &d) : m_data(bt::ptime(d, bt::time_dura
 
 inline Datetime::Datetime(const bt::ptime &d) : m_data(d) {}
 
+inline bool Datetime::isNull() const {
+    // Null<Datetime> 即 +infinity
+    return m_data.is_pos_infinity();
+}
+
 inline bt::ptime Datetime::ptime() const {
     return m_data;
 }
@@ -68,6 +68,28 @@ class HKU_UTILS_API DBConnectBase : public std::enable_shared_from_this<DBConnec
      */
     virtual void resetAutoIncrement(const std::string &tablename) = 0;
 
+    /** dataVersion 的返回值，表示无法获取数据版本 */
+    static constexpr int64_t NO_DATA_VERSION = (std::numeric_limits<int64_t>::min)();
+
+    /**
+     * 指定表的数据版本，表中数据被修改（包括其他连接或进程提交的修改）后改变，
+     * 用于判断依据表中数据建立的缓存是否仍然有效
+     * @note 仅保证数据修改后版本不同，版本改变时数据不一定被修改。默认返回
+     *       NO_DATA_VERSION，此时调用者不应缓存依据表中数据建立的内容
+     * @param tablename 表名
+     */
+    virtual int64_t dataVersion(const std::string &tablename) {
+        return NO_DATA_VERSION;
+    }
+
+    /**
+     * 连接代数，底层连接重新建立（如断线重连）后递增
+     * @note 重连后原有的预编译语句均已失效，缓存预编译语句时需据此判断是否重新创建
+     */
+    uint64_t generation() const noexcept {
+        return m_generation;
+    }
+
     //-------------------------------------------------------------------------
     // 模板方法
     //-------------------------------------------------------------------------
@@ -292,6 +314,9 @@ class HKU_UTILS_API DBConnectBase : public std::enable_shared_from_this<DBConnec
     template <typename TableT, size_t page_size = 50>
     SQLResultSet<TableT, page_size> query(const DBCondition &cond);
 
+protected:
+    uint64_t m_generation{0};
+
 private:
     DBConnectBase() = delete;
 };
@@ -71,6 +71,10 @@ void MySQLConnect::connect() {
         SQL_CHECK(mysql_set_character_set(m_mysql, "utf8") == 0, mysql_errno(m_mysql),
                   "mysql_set_character_set error! {}", mysql_error(m_mysql));
 
+        // 新建立的连接上原有的预编译语句均已失效
+        m_thread_id = mysql_thread_id(m_mysql);
+        m_generation++;
+
     } catch (std::bad_alloc& e) {
         close();
         HKU_ERROR(e.what());
@@ -107,6 +111,13 @@ bool MySQLConnect::ping() {
     auto ret = mysql_ping(m_mysql);
     HKU_ERROR_IF_RETURN(ret && !tryConnect(), false, "mysql_ping error code: {}, msg: {}", ret,
                         mysql_error(m_mysql));
+
+    // 启用了自动重连时，mysql_ping 可能已在原句柄上重新连接，此时连接线程 id 改变
+    unsigned long thread_id = mysql_thread_id(m_mysql);
+    if (thread_id != m_thread_id) {
+        m_thread_id = thread_id;
+        m_generation++;
+    }
     return true;
 }
 
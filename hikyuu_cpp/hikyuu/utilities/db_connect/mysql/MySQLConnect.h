@@ -53,6 +53,7 @@ private:
 
 private:
     MYSQL *m_mysql;
+    unsigned long m_thread_id{0};  // 当前连接的线程 id，自动重连后改变
 };
 
 }  // namespace hku
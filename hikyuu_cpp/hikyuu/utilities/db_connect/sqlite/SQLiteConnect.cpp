@@ -143,6 +143,21 @@ void SQLiteConnect::resetAutoIncrement(const std::string &tablename) {
     exec(fmt::format("UPDATE sqlite_sequence SET seq=0 WHERE name='{}'", tablename));
 }
 
+int64_t SQLiteConnect::dataVersion(const std::string &tablename) {
+    HKU_CHECK(m_db, "Invalid sqlite connect!");
+    // 以整个数据库的版本作为表的版本，无需访问数据库文件。
+    // data_version 只反映其他连接提交的修改，本连接的修改由 total_changes 反映
+    sqlite3_stmt *stmt = NULL;
+    int rc = sqlite3_prepare_v2(m_db, "PRAGMA data_version;", -1, &stmt, NULL);
+    SQL_CHECK(rc == SQLITE_OK, rc, "Failed query data_version! {}", sqlite3_errmsg(m_db));
+    int64_t version = 0;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        version = sqlite3_column_int64(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+    return (version << 32) + uint32_t(sqlite3_total_changes(m_db));
+}
+
 bool SQLiteConnect::check(bool quick) noexcept {
     bool good = false;
     sqlite3_stmt *integrity = NULL;
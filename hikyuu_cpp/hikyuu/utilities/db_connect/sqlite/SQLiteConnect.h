@@ -52,6 +52,7 @@ public:
     virtual SQLStatementPtr getStatement(const std::string &sql_statement) override;
     virtual bool tableExist(const std::string &tablename) override;
     virtual void resetAutoIncrement(const std::string &tablename) override;
+    virtual int64_t dataVersion(const std::string &tablename) override;
 
     /**
      * @brief 对数据库进行检查
@@ -11,8 +11,9 @@
 #ifndef HIKYUU_UTILITIES_THREAD_FUNCWRAPPER_H
 #define HIKYUU_UTILITIES_THREAD_FUNCWRAPPER_H
 
-#include <memory>
-#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 #ifdef _MSC_VER
 #pragma warning(push)
@@ -23,9 +24,15 @@ namespace hku {
 
 /**
  * 函数及函数对象等包装器实现移动语义，以便线程池支持不同类型的任务
+ * @details
+ * 尺寸不超过 INLINE_SIZE、对齐要求不超过指针且移动构造不抛出异常的函数对象直接存放于包装器内部（小对象优化），
+ * 无需额外的堆内存分配，否则存放于堆中。
  */
 class FuncWrapper {
 public:
+    /** 可内部存放的函数对象最大尺寸，使包装器本身恰好占用 64 字节 */
+    static constexpr size_t INLINE_SIZE = 64 - sizeof(void*);
+
     FuncWrapper() = default;
     FuncWrapper(const FuncWrapper&) = delete;
     FuncWrapper(FuncWrapper&) = delete;
@@ -34,46 +41,114 @@ public:
     /** 移动构造函数，实现对函数及函数对象等任务包装 */
     template <typename F>
     // cppcheck-suppress noExplicitConstructor ; 此处不能添加 explicit 修饰，需要使用转换复制
-    FuncWrapper(F&& f) : impl(new impl_type<F>(std::move(f))) {}
+    FuncWrapper(F&& f) {
+        typedef typename std::decay<F>::type func_type;
+        if constexpr (is_inline<func_type>()) {
+            new (&m_storage) func_type(std::forward<F>(f));
+            m_ops = &inline_ops<func_type>::ops;
+        } else {
+            *reinterpret_cast<func_type**>(&m_storage) = new func_type(std::forward<F>(f));
+            m_ops = &heap_ops<func_type>::ops;
+        }
+    }
+
+    ~FuncWrapper() {
+        reset();
+    }
 
     /** 执行被包装的任务 */
     void operator()() {
-        if (impl) {
-            impl->call();
+        if (m_ops) {
+            m_ops->call(&m_storage);
         }
     }
 
     /** 移动构造函数 */
-    FuncWrapper(FuncWrapper&& other) : impl(std::move(other.impl)) {}
+    FuncWrapper(FuncWrapper&& other) noexcept {
+        move_from(other);
+    }
 
     /** 移动复制函数 */
-    FuncWrapper& operator=(FuncWrapper&& other) {
-        impl = std::move(other.impl);
+    FuncWrapper& operator=(FuncWrapper&& other) noexcept {
+        if (this != &other) {
+            reset();
+            move_from(other);
+        }
         return *this;
     }
 
     /** 是否是空任务，用于线程池判断是否在所有任务完成后终止运行 */
     bool isNullTask() const {
-        return impl ? false : true;
+        return m_ops ? false : true;
+    }
+
+    /** 被包装的任务是否存放于包装器内部，未分配堆内存 */
+    bool isInline() const {
+        return m_ops && m_ops->is_inline;
     }
 
 private:
-    struct impl_base {
-        virtual void call() = 0;
-        virtual ~impl_base() {}
+    struct ops_type {
+        void (*call)(void* storage);
+        void (*move)(void* dst, void* src) noexcept;  // 移动至 dst 并销毁 src
+        void (*destroy)(void* storage) noexcept;
+        bool is_inline;
     };
 
-    std::unique_ptr<impl_base> impl;
+    template <typename F>
+    static constexpr bool is_inline() {
+        return sizeof(F) <= INLINE_SIZE && alignof(F) <= alignof(void*) &&
+               std::is_nothrow_move_constructible<F>::value;
+    }
 
     template <typename F>
-    struct impl_type : impl_base {
-        F f;
-        // cppcheck-suppress noExplicitConstructor ; 此处不能添加 explicit 修饰，需要使用转换复制
-        impl_type(F&& f_) : f(std::move(f_)) {}
-        void call() override {
-            f();
+    struct inline_ops {
+        static void call(void* storage) {
+            (*static_cast<F*>(storage))();
         }
+        static void move(void* dst, void* src) noexcept {
+            F* from = static_cast<F*>(src);
+            new (dst) F(std::move(*from));
+            from->~F();
+        }
+        static void destroy(void* storage) noexcept {
+            static_cast<F*>(storage)->~F();
+        }
+        static constexpr ops_type ops{&call, &move, &destroy, true};
     };
+
+    template <typename F>
+    struct heap_ops {
+        static void call(void* storage) {
+            (**static_cast<F**>(storage))();
+        }
+        static void move(void* dst, void* src) noexcept {
+            *static_cast<F**>(dst) = *static_cast<F**>(src);
+        }
+        static void destroy(void* storage) noexcept {
+            delete *static_cast<F**>(storage);
+        }
+        static constexpr ops_type ops{&call, &move, &destroy, false};
+    };
+
+    void move_from(FuncWrapper& other) noexcept {
+        if (other.m_ops) {
+            other.m_ops->move(&m_storage, &other.m_storage);
+            m_ops = other.m_ops;
+            other.m_ops = nullptr;
+        }
+    }
+
+    void reset() noexcept {
+        if (m_ops) {
+            m_ops->destroy(&m_storage);
+            m_ops = nullptr;
+        }
+    }
+
+private:
+    const ops_type* m_ops{nullptr};
+    typename std::aligned_storage<INLINE_SIZE, alignof(void*)>::type m_storage;
 };
 
 } /* namespace hku */
@@ -0,0 +1,85 @@
+/*
+ * MPSCQueue.h
+ *
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#pragma once
+#ifndef HIKYUU_UTILITIES_THREAD_MPSCQUEUE_H
+#define HIKYUU_UTILITIES_THREAD_MPSCQUEUE_H
+
+#include <atomic>
+
+namespace hku {
+
+/**
+ * 无锁多生产者单消费者队列（Vyukov 链表队列）
+ * @details
+ * <pre>
+ * 任意线程均可调用 push，仅由一个消费者线程调用 try_pop/empty，二者均不加锁。
+ * 入队仅需一次原子交换，先进先出。生产者交换链表头后尚未链接前，该元素对消费者暂不可见，
+ * 因此 empty 返回 true 并不保证没有正在入队的元素，消费者等待时需配合生产者的唤醒通知。
+ * 元素类型需可默认构造。
+ * </pre>
+ */
+template <typename T>
+class MPSCQueue {
+public:
+    MPSCQueue() : m_head(new Node()), m_tail(m_head.load(std::memory_order_relaxed)) {}
+
+    ~MPSCQueue() {
+        Node* node = m_tail;
+        while (node) {
+            Node* next = node->next.load(std::memory_order_relaxed);
+            delete node;
+            node = next;
+        }
+    }
+
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+    /** 入队，可由任意线程调用 */
+    void push(T&& value) {
+        Node* node = new Node(std::move(value));
+        Node* prev = m_head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    /** 出队，仅由消费者线程调用 */
+    bool try_pop(T& res) {
+        Node* tail = m_tail;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next) {
+            return false;
+        }
+        // next 成为新的哨兵节点
+        res = std::move(next->value);
+        m_tail = next;
+        delete tail;
+        return true;
+    }
+
+    /** 是否为空，仅由消费者线程调用 */
+    bool empty() const {
+        return m_tail->next.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    struct Node {
+        Node() = default;
+        explicit Node(T&& v) : value(std::move(v)) {}
+        std::atomic<Node*> next{nullptr};
+        T value;
+    };
+
+    alignas(64) std::atomic<Node*> m_head;  // 生产者端
+    alignas(64) Node* m_tail;               // 消费者端（哨兵节点）
+};
+
+}  // namespace hku
+
+#endif /* HIKYUU_UTILITIES_THREAD_MPSCQUEUE_H */
@@ -15,6 +15,7 @@
 #include <vector>
 #include "FuncWrapper.h"
 #include "MQStealQueue.h"
+#include "WorkStealQueue.h"
 #include "InterruptFlag.h"
 #include "../cppdef.h"
 
@@ -30,6 +31,7 @@ namespace hku {
 
 /**
  * @brief 无集中队列多队列偷取任务池
+ * @details 外部线程提交的任务进入各工作线程的接收队列，工作线程内提交的任务进入其无锁本地队列
  * @ingroup MQStealThreadPool
  */
 #ifdef _MSC_VER
@@ -55,6 +57,7 @@ public:
             for (size_t i = 0; i < m_worker_num; i++) {
                 // 创建工作线程及其任务队列
                 m_queues.emplace_back(new MQStealQueue<task_type>);
+                m_steal_queues.emplace_back(new WorkStealQueue);
             }
             // 初始完毕所有线程资源后再启动线程
             for (int i = 0; i < m_worker_num; i++) {
@@ -88,7 +91,7 @@ public:
 
         size_t total = 0;
         for (size_t i = 0; i < m_worker_num; i++) {
-            total += m_queues[i]->size();
+            total += m_queues[i]->size() + m_steal_queues[i]->size();
         }
         return total;
     }
@@ -112,32 +115,26 @@ public:
         typedef typename std::invoke_result<FunctionType>::type result_type;
         std::packaged_task<result_type()> task(f);
         task_handle<result_type> res(task.get_future());
+        push_task(std::move(task));
+        return res;
+    }
 
-        // 如果是本地线程且线程仍未终止，则加入自身队列
-        if (m_local_work_queue) {
-            // 本地线程任务从前部入队列（递归成栈）
-            m_local_work_queue->push_front(std::move(task));
-            return res;
+    /**
+     * 向线程池提交无需返回值的任务，不创建 future，适用于大量细粒度任务
+     * @note 任务内抛出的异常将被忽略，需由任务自身处理
+     */
+    template <typename FunctionType>
+    void submit_void(FunctionType f) {
+        if (m_thread_need_stop.isSet() || m_done) {
+            throw std::logic_error("You can't submit a task to the stopped MQStealThreadPool!");
         }
 
-        // 选择任务最少的任务队列，将任务加入其尾部
-        size_t min_count = std::numeric_limits<size_t>::max();
-        int index = 0;
-        for (int i = 0; i < m_worker_num; ++i) {
-            size_t cur_count = m_queues[i]->size();
-            if (cur_count == 0) {
-                index = i;
-                break;
-            }
-
-            if (cur_count < min_count) {
-                min_count = cur_count;
-                index = i;
+        push_task([func = std::move(f)]() mutable {
+            try {
+                func();
+            } catch (...) {
             }
-        }
-
-        m_queues[index]->push(std::move(task));
-        return res;
+        });
     }
 
 #ifdef _MSC_VER
@@ -175,6 +172,7 @@ public:
 
         for (size_t i = 0; i < m_worker_num; i++) {
             m_queues[i]->clear();
+            m_steal_queues[i]->clear();
         }
     }
 
@@ -192,7 +190,7 @@ public:
             while (true) {
                 bool can_quit = true;
                 for (size_t i = 0; i < m_worker_num; i++) {
-                    if (m_queues[i]->size() != 0) {
+                    if (m_queues[i]->size() != 0 || m_steal_queues[i]->size() != 0) {
                         can_quit = false;
                         break;
                     }
@@ -226,6 +224,7 @@ public:
 
         for (size_t i = 0; i < m_worker_num; i++) {
             m_queues[i]->clear();
+            m_steal_queues[i]->clear();
         }
 
         m_done = true;
@@ -237,37 +236,76 @@ private:
     size_t m_worker_num;          // 工作线程数量
     bool m_runnging_until_empty;  // 运行直到队列空时停止
 
-    std::vector<std::unique_ptr<MQStealQueue<task_type>>> m_queues;  // 线程任务队列
+    std::vector<std::unique_ptr<MQStealQueue<task_type>>> m_queues;  // 线程任务接收队列
+    std::vector<std::unique_ptr<WorkStealQueue>> m_steal_queues;     // 线程本地无锁队列
     std::vector<InterruptFlag*> m_interrupt_flags;                   // 线程终止标志
     std::vector<std::thread> m_threads;                              // 工作线程
 
     // 线程本地变量
 #if CPP_STANDARD >= CPP_STANDARD_17
     inline static thread_local MQStealQueue<task_type>* m_local_work_queue =
-      nullptr;                                                    // 本地任务队列
+      nullptr;                                                                 // 本地任务队列
+    inline static thread_local WorkStealQueue* m_local_steal_queue = nullptr;  // 本地无锁队列
     inline static thread_local int m_index = -1;                  // 在线程池中的序号
     inline static thread_local InterruptFlag m_thread_need_stop;  // 线程停止运行指示
 #else
     static thread_local MQStealQueue<task_type>* m_local_work_queue;  // 本地任务队列
+    static thread_local WorkStealQueue* m_local_steal_queue;          // 本地无锁队列
     static thread_local int m_index;                                  // 在线程池中的序号
     static thread_local InterruptFlag m_thread_need_stop;             // 线程停止运行指示
 #endif
 
+    void push_task(task_type&& task) {
+        // 工作线程内提交的任务从前部进入本地无锁队列（递归成栈），已满时进入本地接收队列前部
+        if (m_local_steal_queue) {
+            if (!m_local_steal_queue->push_front(std::move(task))) {
+                m_local_work_queue->push_front(std::move(task));
+            }
+            return;
+        }
+
+        // 选择任务最少的任务队列，将任务加入其尾部
+        size_t min_count = std::numeric_limits<size_t>::max();
+        int index = 0;
+        for (int i = 0; i < m_worker_num; ++i) {
+            size_t cur_count = m_queues[i]->size();
+            if (cur_count == 0) {
+                index = i;
+                break;
+            }
+
+            if (cur_count < min_count) {
+                min_count = cur_count;
+                index = i;
+            }
+        }
+
+        m_queues[index]->push(std::move(task));
+    }
+
     void worker_thread(int index) {
         m_index = index;
         m_interrupt_flags[index] = &m_thread_need_stop;
         m_local_work_queue = m_queues[m_index].get();
+        m_local_steal_queue = m_steal_queues[m_index].get();
         while (!m_thread_need_stop.isSet() && !m_done) {
             run_pending_task();
         }
         m_interrupt_flags[m_index] = nullptr;
         m_local_work_queue = nullptr;
+        m_local_steal_queue = nullptr;
         // printf("%zu thread (%lld) finished!\n", m_index, std::this_thread::get_id());
     }
 
     void run_pending_task() {
         task_type task;
-        // 尝试从本地队列获取任务并执行
+        // 优先执行本线程内提交的任务
+        if (m_local_steal_queue->try_pop(task)) {
+            task();
+            return;
+        }
+
+        // 尝试从本地接收队列获取任务并执行
         if (m_local_work_queue->try_pop(task)) {
             if (task.isNullTask()) {
                 m_thread_need_stop.set();
@@ -300,7 +338,8 @@ private:
     bool pop_task_from_other_thread_queue(task_type& task) {
         for (size_t i = 0; i < m_worker_num; ++i) {
             size_t index = (m_index + i + 1) % m_worker_num;
-            if (index != m_index && m_queues[index]->try_steal(task)) {
+            if (index != m_index &&
+                (m_steal_queues[index]->try_steal(task) || m_queues[index]->try_steal(task))) {
                 return true;
             }
         }
@@ -115,16 +115,28 @@ public:
         typedef typename std::invoke_result<FunctionType>::type result_type;
         std::packaged_task<result_type()> task(f);
         task_handle<result_type> res(task.get_future());
-        if (m_local_work_queue) {
-            // 本地线程任务从前部入队列（递归成栈）
-            m_local_work_queue->push_front(std::move(task));
-        } else {
-            m_master_work_queue.push(std::move(task));
-            m_cv.notify_one();
-        }
+        push_task(std::move(task));
         return res;
     }
 
+    /**
+     * 向线程池提交无需返回值的任务，不创建 future，适用于大量细粒度任务
+     * @note 任务内抛出的异常将被忽略，需由任务自身处理
+     */
+    template <typename FunctionType>
+    void submit_void(FunctionType f) {
+        if (m_thread_need_stop.isSet() || m_done) {
+            throw std::logic_error("You can't submit a task to the stopped StealThreadPool!!");
+        }
+
+        push_task([func = std::move(f)]() mutable {
+            try {
+                func();
+            } catch (...) {
+            }
+        });
+    }
+
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
@@ -145,14 +157,15 @@ public:
         m_done = true;
 
         // 同时加入结束任务指示，以便在dll退出时也能够终止
+        // 注：本地队列只允许所属线程写入，工作线程通过 m_done 及中断标志退出
         for (size_t i = 0; i < m_worker_num; i++) {
             if (m_interrupt_flags[i]) {
                 m_interrupt_flags[i]->set();
             }
-            m_queues[i]->push_front(FuncWrapper());
+            m_master_work_queue.push(FuncWrapper());
         }
 
-        m_cv.notify_all();  // 唤醒所有工作线程
+        notify_all();  // 唤醒所有工作线程
         for (size_t i = 0; i < m_worker_num; i++) {
             if (m_threads[i].joinable()) {
                 m_threads[i].join();
@@ -208,7 +221,7 @@ public:
         }
 
         // 唤醒所有工作线程
-        m_cv.notify_all();
+        notify_all();
 
         // 等待线程结束
         for (size_t i = 0; i < m_worker_num; i++) {
@@ -249,6 +262,21 @@ private:
     static thread_local InterruptFlag m_thread_need_stop;    // 线程停止运行指示
 #endif
 
+    void push_task(task_type&& task) {
+        // 本地线程任务从前部入队列（递归成栈），本地队列已满时转入主队列
+        if (m_local_work_queue && m_local_work_queue->push_front(std::move(task))) {
+            return;
+        }
+        m_master_work_queue.push(std::move(task));
+        m_cv.notify_one();
+    }
+
+    void notify_all() {
+        // 加锁以避免工作线程检查等待条件后、进入等待前错过通知
+        { std::lock_guard<std::mutex> lk(m_cv_mutex); }
+        m_cv.notify_all();
+    }
+
     void worker_thread(int index) {
         m_interrupt_flags[index] = &m_thread_need_stop;
         m_index = index;
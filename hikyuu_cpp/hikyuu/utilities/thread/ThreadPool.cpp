@@ -26,6 +26,7 @@ thread_local InterruptFlag StealThreadPool::m_thread_need_stop;
 
 thread_local MQStealQueue<MQStealThreadPool::task_type>* MQStealThreadPool::m_local_work_queue =
   nullptr;
+thread_local WorkStealQueue* MQStealThreadPool::m_local_steal_queue = nullptr;
 thread_local int MQStealThreadPool::m_index = -1;
 thread_local InterruptFlag MQStealThreadPool::m_thread_need_stop;
 #endif
@@ -11,93 +11,177 @@
 #ifndef HIKYUU_UTILITIES_THREAD_WORKSTEALQUEUE_H
 #define HIKYUU_UTILITIES_THREAD_WORKSTEALQUEUE_H
 
-#include <deque>
-#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include "FuncWrapper.h"
 
 namespace hku {
 
 /**
- * 任务偷取队列
+ * 任务偷取队列（无锁 Chase-Lev 双端队列）
+ * @details
+ * <pre>
+ * 只有所属的工作线程（owner）可以调用 push_front/try_pop，从同一端入队和出队（后进先出），
+ * 其他线程通过 try_steal 从另一端偷取最早入队的任务，三者均不加锁。
+ *
+ * 队列容量固定，push_front 在队列已满时返回 false，由调用者转存至其他队列。
+ * 每个槽位记录下一次允许写入的序号，偷取者在 CAS 获得任务所有权后才移出任务，
+ * 移出完毕前所属线程不会覆盖该槽位，因此可以直接存放非平凡类型的 FuncWrapper。
+ * </pre>
  */
 class WorkStealQueue {
 private:
     typedef FuncWrapper data_type;
-    std::deque<data_type> m_queue;
-    mutable std::mutex m_mutex;
+
+    struct Slot {
+        std::atomic<int64_t> stamp{0};  // 允许写入该槽位的任务序号
+        data_type data;
+    };
 
 public:
-    /** 构造函数 */
-    WorkStealQueue() {}
+    /** 默认容量 */
+    static constexpr size_t DEFAULT_CAPACITY = 1024;
+
+    /**
+     * 构造函数
+     * @param capacity 队列容量，向上取整为 2 的幂
+     */
+    explicit WorkStealQueue(size_t capacity = DEFAULT_CAPACITY) {
+        size_t n = 2;
+        while (n < capacity) {
+            n <<= 1;
+        }
+        m_capacity = static_cast<int64_t>(n);
+        m_mask = m_capacity - 1;
+        m_slots.reset(new Slot[n]);
+        for (int64_t i = 0; i < m_capacity; i++) {
+            m_slots[i].stamp.store(i, std::memory_order_relaxed);
+        }
+    }
 
     // 禁用赋值构造和赋值重载
     WorkStealQueue(const WorkStealQueue& other) = delete;
     WorkStealQueue& operator=(const WorkStealQueue& other) = delete;
 
-    /** 将数据插入队列头部 */
-    void push_front(data_type&& data) {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_queue.push_front(std::move(data));
+    /** 队列容量 */
+    size_t capacity() const {
+        return static_cast<size_t>(m_capacity);
     }
 
-    /** 将数据插入队列尾部 */
-    void push_back(data_type&& data) {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_queue.push_back(std::move(data));
+    /**
+     * 将数据插入队列头部，仅限所属线程调用
+     * @return 队列已满时返回 false，此时 data 保持不变
+     */
+    bool push_front(data_type&& data) {
+        int64_t b = m_bottom.load(std::memory_order_relaxed);
+        int64_t t = m_top.load(std::memory_order_acquire);
+        if (b - t >= m_capacity) {
+            return false;
+        }
+
+        // 偷取者可能仍在移出该槽位上一轮的任务
+        Slot& slot = m_slots[b & m_mask];
+        if (slot.stamp.load(std::memory_order_acquire) != b) {
+            return false;
+        }
+
+        slot.data = std::move(data);
+        m_bottom.store(b + 1, std::memory_order_release);
+        return true;
     }
 
-    /** 队列是否为空 */
+    /** 队列是否为空（近似值） */
     bool empty() const {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        return m_queue.empty();
+        return size() == 0;
     }
 
-    /** 队列大小，！未加锁，谨慎使用 */
+    /** 队列大小（近似值） */
     size_t size() const {
-        return m_queue.size();
+        int64_t b = m_bottom.load(std::memory_order_relaxed);
+        int64_t t = m_top.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_t>(b - t) : 0;
     }
 
+    /** 清空队列，仅可在所属线程及偷取者均已停止后调用 */
     void clear() {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        auto tmp = std::deque<data_type>();
-        m_queue.swap(tmp);
+        int64_t t = m_top.load(std::memory_order_relaxed);
+        int64_t b = m_bottom.load(std::memory_order_relaxed);
+        for (int64_t i = t; i < b; i++) {
+            data_type tmp(std::move(m_slots[i & m_mask].data));
+        }
+        for (int64_t i = 0; i < m_capacity; i++) {
+            m_slots[i].stamp.store(i, std::memory_order_relaxed);
+        }
+        m_top.store(0, std::memory_order_relaxed);
+        m_bottom.store(0, std::memory_order_relaxed);
     }
 
     /**
-     * 尝试从队列头部弹出一条数数据
+     * 尝试从队列头部弹出一条数数据，仅限所属线程调用
      * @param res 存储弹出的数据
      * @return 如果原本队列为空返回 false，否则为 true
      */
     bool try_pop(data_type& res) {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        if (m_queue.empty()) {
+        int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = m_top.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            m_bottom.store(b + 1, std::memory_order_relaxed);
             return false;
         }
 
-        res = std::move(m_queue.front());
-        m_queue.pop_front();
-        return true;
+        Slot& slot = m_slots[b & m_mask];
+        if (t < b) {
+            // 偷取者不会触及 b，槽位下一次仍由序号 b 写入
+            res = std::move(slot.data);
+            return true;
+        }
+
+        // 仅剩最后一个任务，与偷取者竞争
+        bool success = m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                     std::memory_order_relaxed);
+        if (success) {
+            res = std::move(slot.data);
+            slot.stamp.store(b + m_capacity, std::memory_order_release);
+        }
+        m_bottom.store(b + 1, std::memory_order_relaxed);
+        return success;
     }
 
     /**
-     * 尝试从队列尾部偷取一条数据
+     * 尝试从队列尾部偷取一条数据，可在任意线程调用
      * @param res 存储偷取的数据
-     * @return 如果原本队列为空返回 false，否则为 true
+     * @return 如果原本队列为空或竞争失败返回 false，否则为 true
      */
     bool try_steal(data_type& res) {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        if (m_queue.empty()) {
+        int64_t t = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = m_bottom.load(std::memory_order_acquire);
+        if (t >= b) {
             return false;
         }
 
-        if (m_queue.back().isNullTask()) {
+        if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                           std::memory_order_relaxed)) {
             return false;
         }
 
-        res = std::move(m_queue.back());
-        m_queue.pop_back();
+        // 已获得序号 t 的所有权，移出后通知所属线程该槽位可再次写入
+        Slot& slot = m_slots[t & m_mask];
+        res = std::move(slot.data);
+        slot.stamp.store(t + m_capacity, std::memory_order_release);
         return true;
     }
+
+private:
+    alignas(64) std::atomic<int64_t> m_top{0};     // 偷取端
+    alignas(64) std::atomic<int64_t> m_bottom{0};  // 所属线程端
+    int64_t m_capacity;
+    int64_t m_mask;
+    std::unique_ptr<Slot[]> m_slots;
 };
 
 } /* namespace hku */
@@ -70,6 +70,7 @@ target("hikyuu")
 
     if is_plat("linux", "cross") then
         add_cxflags("-fPIC")
+        add_syslinks("rt") -- boost interprocess 共享内存
     end
 
     if is_plat("macosx") then
@@ -92,6 +93,7 @@ target("hikyuu")
     end
     add_files("./data_driver/block_info/qianlong/**.cpp")
     add_files("./data_driver/kdata/cvs/**.cpp")
+    add_files("./data_driver/kdata/native/**.cpp")
     if get_config("sqlite") or get_config("hdf5") then
         add_files("./data_driver/kdata/sqlite/**.cpp")
     end
@@ -0,0 +1,344 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#include "../test_config.h"
+#include <cstdio>
+#include <hikyuu/StockManager.h>
+#include <hikyuu/utilities/os.h>
+#include <hikyuu/data_driver/DataDriverFactory.h>
+#include <hikyuu/data_driver/kdata/native/NativeKDataDriver.h>
+
+using namespace hku;
+
+/**
+ * @defgroup test_NativeKDataDriver test_NativeKDataDriver
+ * @ingroup test_hikyuu_data_driver_suite
+ * @{
+ */
+
+// 生成 n 条分钟线，价格为 0.01 的整数倍，部分成交金额无法以定点数表示
+static KRecordList makeMinRecords(size_t n, const Datetime& start = Datetime(201901020931LL)) {
+    KRecordList result;
+    result.reserve(n);
+    Datetime d = start;
+    price_t close = 10.0;
+    for (size_t i = 0; i < n; i++) {
+        price_t open = close;
+        close = std::round((open + (i % 7 == 0 ? -0.03 : 0.02)) * 100.0) / 100.0;
+        price_t amount = i % 5 == 0 ? close * 1000.0 / 3.0 : close * 1000.0;
+        result.emplace_back(d, open, std::max(open, close) + 0.01, std::min(open, close) - 0.01,
+                            close, amount, price_t(1000 + i % 100));
+        d = d + Minutes(1);
+        if (d.hour() == 15) {
+            d = Datetime(d.year(), d.month(), d.day()) + Days(1) + Hours(9) + Minutes(31);
+        }
+    }
+    return result;
+}
+
+static void checkSameRecords(const KRecordList& a, const KRecordList& b, size_t b_start = 0) {
+    for (size_t i = 0; i < a.size(); i++) {
+        const KRecord& x = a[i];
+        const KRecord& y = b[b_start + i];
+        CHECK_EQ(x.datetime, y.datetime);
+        CHECK_EQ(x.openPrice, y.openPrice);
+        CHECK_EQ(x.highPrice, y.highPrice);
+        CHECK_EQ(x.lowPrice, y.lowPrice);
+        CHECK_EQ(x.closePrice, y.closePrice);
+        CHECK_EQ(x.transAmount, y.transAmount);
+        CHECK_EQ(x.transCount, y.transCount);
+    }
+}
+
+/** @par 检测点 */
+TEST_CASE("test_NativeKDataFile") {
+    string filename = fmt::format("{}/test_native_kdata.hkd", StockManager::instance().tmpdir());
+    removeFile(filename);
+
+    KRecordList records = makeMinRecords(1000);
+
+    /** @arg 多次追加，块容量为 64 */
+    CHECK_EQ(NativeKDataFile::append(filename, KRecordList(records.begin(), records.begin() + 300),
+                                     64),
+             300);
+    CHECK_EQ(NativeKDataFile::append(filename, KRecordList(records.begin() + 300, records.end())),
+             700);
+
+    NativeKDataFile file;
+    REQUIRE(file.open(filename));
+    CHECK_EQ(file.size(), 1000);
+    CHECK_EQ(file.blockCount(), 5 + 11);
+    CHECK_EQ(file.lastDatetime(), records.back().datetime);
+
+    /** @arg 全部读取及跨块读取与原始记录一致 */
+    KRecordList result = file.read(0, Null<size_t>());
+    REQUIRE_EQ(result.size(), records.size());
+    checkSameRecords(result, records);
+
+    result = file.read(250, 420);
+    REQUIRE_EQ(result.size(), 170);
+    checkSameRecords(result, records, 250);
+    CHECK_UNARY(file.read(1000, 1100).empty());
+    CHECK_UNARY(file.read(10, 10).empty());
+
+    /** @arg 单独读取列 */
+    PriceList closes = file.readField(NativeKDataFile::CLOSE, 990, 1000);
+    REQUIRE_EQ(closes.size(), 10);
+    for (size_t i = 0; i < closes.size(); i++) {
+        CHECK_EQ(closes[i], records[990 + i].closePrice);
+    }
+    PriceList amounts = file.readField(NativeKDataFile::AMOUNT, 0, 20);
+    REQUIRE_EQ(amounts.size(), 20);
+    CHECK_EQ(amounts[5], records[5].transAmount);
+    DatetimeList dates = file.readDatetime(63, 66);
+    REQUIRE_EQ(dates.size(), 3);
+    CHECK_EQ(dates[0], records[63].datetime);
+    CHECK_EQ(dates[2], records[65].datetime);
+
+    /** @arg 按日期定位 */
+    size_t start = 0, end = 0;
+    CHECK_UNARY(file.getIndexRangeByDate(records[100].datetime, records[700].datetime, start, end));
+    CHECK_EQ(start, 100);
+    CHECK_EQ(end, 700);
+    CHECK_UNARY(
+      file.getIndexRangeByDate(records[100].datetime + Seconds(1), Null<Datetime>(), start, end));
+    CHECK_EQ(start, 101);
+    CHECK_EQ(end, 1000);
+    CHECK_UNARY(file.getIndexRangeByDate(Datetime::min(), records[1].datetime, start, end));
+    CHECK_EQ(start, 0);
+    CHECK_EQ(end, 1);
+    CHECK_UNARY_FALSE(file.getIndexRangeByDate(records.back().datetime + Minutes(1),
+                                               Null<Datetime>(), start, end));
+    file.close();
+
+    /** @arg 重复及乱序的记录被忽略 */
+    KRecordList more = makeMinRecords(1100);
+    KRecordList mixed(more.begin() + 990, more.begin() + 1099);
+    std::swap(mixed[20], mixed[21]);
+    CHECK_EQ(NativeKDataFile::append(filename, mixed), 98);
+    CHECK_EQ(NativeKDataFile::append(filename, KRecordList(more.begin() + 1099, more.end())), 1);
+    REQUIRE(file.open(filename));
+    CHECK_EQ(file.size(), 1099);
+    CHECK_EQ(file.blockCount(), 19);
+    uint32_t generation = file.generation();
+    file.close();
+
+    /** @arg 追加不改变整理次数，peek 返回当前文件长度 */
+    size_t file_size = 0;
+    uint32_t peek_generation = 0;
+    CHECK_UNARY(NativeKDataFile::peek(filename, file_size, peek_generation));
+    CHECK_EQ(peek_generation, generation);
+    CHECK_UNARY(file_size > 0);
+    CHECK_UNARY_FALSE(NativeKDataFile::peek(filename + ".none", file_size, peek_generation));
+
+    /** @arg 整理后块数减少，数据不变，整理次数加 1 */
+    CHECK_UNARY(NativeKDataFile::compact(filename));
+    CHECK_UNARY(NativeKDataFile::peek(filename, file_size, peek_generation));
+    CHECK_EQ(peek_generation, generation + 1);
+    REQUIRE(file.open(filename));
+    CHECK_EQ(file.generation(), generation + 1);
+    CHECK_EQ(file.blockCount(), 18);
+    CHECK_EQ(file.size(), 1099);
+    result = file.read(0, 1000);
+    checkSameRecords(result, records);
+    CHECK_EQ(file.lastDatetime(), more.back().datetime);
+    file.close();
+
+    /** @arg 尾部不完整的数据块被忽略，下次追加前丢弃 */
+    FILE* fp = fopen(filename.c_str(), "ab");
+    REQUIRE(fp);
+    fwrite("HKCB0123456789", 1, 14, fp);
+    fclose(fp);
+    REQUIRE(file.open(filename));
+    CHECK_EQ(file.size(), 1099);
+    file.close();
+
+    KRecordList last = makeMinRecords(1101);
+    CHECK_EQ(NativeKDataFile::append(filename, KRecordList(last.begin() + 1100, last.end())), 1);
+    REQUIRE(file.open(filename));
+    CHECK_EQ(file.size(), 1100);
+    CHECK_EQ(file.lastDatetime(), last.back().datetime);
+    file.close();
+
+    removeFile(filename);
+}
+
+/** @par 检测点 */
+TEST_CASE("test_NativeKDataDriver_remap") {
+    string dir = fmt::format("{}/native_remap", StockManager::instance().tmpdir());
+    removeDir(dir);
+
+    Parameter param;
+    param.set<string>("type", "native");
+    param.set<string>("dir", dir);
+    auto driver = make_shared<NativeKDataDriver>();
+    REQUIRE(driver->init(param));
+    auto other = driver->clone();
+
+    KRecordList records = makeMinRecords(300);
+    CHECK_EQ(driver->appendKRecordList("SH", "600000", KQuery::MIN,
+                                       KRecordList(records.begin(), records.begin() + 100)),
+             100);
+    CHECK_EQ(other->getCount("SH", "600000", KQuery::MIN), 100);
+
+    /** @arg 多次追加产生碎片块后，其他驱动实例可读取新数据 */
+    for (size_t i = 100; i < 300; i += 50) {
+        KRecordList part(records.begin() + i, records.begin() + i + 50);
+        CHECK_EQ(driver->appendKRecordList("SH", "600000", KQuery::MIN, part), 50);
+        CHECK_EQ(other->getCount("SH", "600000", KQuery::MIN), i + 50);
+    }
+
+    /** @arg 整理替换文件后，其他驱动实例读取的数据不变 */
+    CHECK_UNARY(NativeKDataFile::compact(driver->getFileName("SH", "600000", KQuery::MIN)));
+    KRecordList result =
+      other->getKRecordList("SH", "600000", KQuery(0, Null<int64_t>(), KQuery::MIN));
+    REQUIRE_EQ(result.size(), records.size());
+    checkSameRecords(result, records);
+
+    /** @arg 文件删除后返回空 */
+    removeFile(driver->getFileName("SH", "600000", KQuery::MIN));
+    CHECK_EQ(other->getCount("SH", "600000", KQuery::MIN), 0);
+    CHECK_UNARY(other->getKRecordList("SH", "600000", KQuery(0)).empty());
+
+    removeDir(dir);
+}
+
+/** @par 检测点 */
+TEST_CASE("test_NativeKDataDriver") {
+    StockManager& sm = StockManager::instance();
+    string dir = fmt::format("{}/native", sm.tmpdir());
+    removeDir(dir);
+
+    Parameter param;
+    param.set<string>("type", "native");
+    param.set<string>("dir", dir);
+    auto driver = make_shared<NativeKDataDriver>();
+    REQUIRE(driver->init(param));
+
+    /** @arg 已在 DataDriverFactory 中注册 */
+    CHECK_UNARY(DataDriverFactory::getKDataDriverPool(param) != nullptr);
+
+    /** @arg 从当前K线数据驱动导入 */
+    KDataDriverPtr src =
+      DataDriverFactory::getKDataDriverPool(sm.getKDataDriverParameter())->getPrototype()->clone();
+    size_t total = src->getCount("SH", "000001", KQuery::DAY);
+    REQUIRE(total > 100);
+
+    // 先导入前 100 条，再增量导入其余部分
+    KRecordList head = src->getKRecordList("SH", "000001", KQuery(0, 100, KQuery::DAY));
+    CHECK_EQ(driver->appendKRecordList("SH", "000001", KQuery::DAY, head), 100);
+    CHECK_EQ(driver->importKData(*src, "SH", "000001", KQuery::DAY, 1000), total - 100);
+    CHECK_EQ(driver->importKData(*src, "SH", "000001", KQuery::DAY), 0);
+    CHECK_EQ(driver->getCount("SH", "000001", KQuery::DAY), total);
+    CHECK_UNARY(existFile(driver->getFileName("SH", "000001", KQuery::DAY)));
+
+    KRecordList expect =
+      src->getKRecordList("SH", "000001", KQuery(0, Null<int64_t>(), KQuery::DAY));
+    KRecordList result =
+      driver->getKRecordList("SH", "000001", KQuery(0, Null<int64_t>(), KQuery::DAY));
+    REQUIRE_EQ(result.size(), expect.size());
+    checkSameRecords(result, expect);
+
+    /** @arg 按日期查询 */
+    KQuery query = KQueryByDate(Datetime(201101010000LL), Datetime(201201010000LL), KQuery::DAY);
+    size_t start = 0, end = 0, expect_start = 0, expect_end = 0;
+    CHECK_UNARY(driver->getIndexRangeByDate("SH", "000001", query, start, end));
+    CHECK_UNARY(src->getIndexRangeByDate("SH", "000001", query, expect_start, expect_end));
+    CHECK_EQ(start, expect_start);
+    CHECK_EQ(end, expect_end);
+    result = driver->getKRecordList("SH", "000001", query);
+    CHECK_EQ(result.size(), end - start);
+    checkSameRecords(result, expect, start);
+
+    /** @arg 单列读取 */
+    PriceList closes = driver->getField("SH", "000001", KQuery::DAY, NativeKDataFile::CLOSE);
+    REQUIRE_EQ(closes.size(), total);
+    CHECK_EQ(closes.back(), expect.back().closePrice);
+
+    /** @arg 不存在的数据 */
+    CHECK_EQ(driver->getCount("SH", "000001", KQuery::MIN60), 0);
+    CHECK_UNARY(driver->getKRecordList("SZ", "999999", KQuery(0)).empty());
+    CHECK_UNARY_FALSE(driver->getIndexRangeByDate("SZ", "999999", query, start, end));
+
+    /** @arg 追加后其他驱动实例可读取新数据 */
+    auto other = driver->clone();
+    CHECK_EQ(other->getCount("SH", "000001", KQuery::DAY), total);
+    KRecordList next_records;
+    next_records.emplace_back(expect.back().datetime + Days(1), 1.0, 2.0, 0.5, 1.5, 100.0, 10.0);
+    CHECK_EQ(driver->appendKRecordList("SH", "000001", KQuery::DAY, next_records), 1);
+    CHECK_EQ(other->getCount("SH", "000001", KQuery::DAY), total + 1);
+
+    removeDir(dir);
+}
+
+/** @} */
+
+#if ENABLE_BENCHMARK_TEST
+TEST_CASE("test_NativeKDataDriver_benchmark") {
+    StockManager& sm = StockManager::instance();
+    string dir = fmt::format("{}/native_benchmark", sm.tmpdir());
+    removeDir(dir);
+
+    Parameter param;
+    param.set<string>("type", "native");
+    param.set<string>("dir", dir);
+    auto driver = make_shared<NativeKDataDriver>();
+    REQUIRE(driver->init(param));
+
+    KRecordList records = makeMinRecords(1000000);
+    {
+        BENCHMARK_TIME_MSG(test_NativeKDataDriver_benchmark, 1, "write 1000000 min records");
+        driver->appendKRecordList("SH", "600000", KQuery::MIN, records);
+    }
+
+    int cycle = 1000;
+    {
+        BENCHMARK_TIME_MSG(test_NativeKDataDriver_benchmark, cycle, "native tail read 100 bars");
+        for (int i = 0; i < cycle; i++) {
+            KRecordList result =
+              driver->getKRecordList("SH", "600000", KQuery(999900, 1000000, KQuery::MIN));
+        }
+    }
+
+    {
+        BENCHMARK_TIME_MSG(test_NativeKDataDriver_benchmark, 10, "native full scan close");
+        for (int i = 0; i < 10; i++) {
+            PriceList closes =
+              driver->getField("SH", "600000", KQuery::MIN, NativeKDataFile::CLOSE);
+        }
+    }
+
+    {
+        BENCHMARK_TIME_MSG(test_NativeKDataDriver_benchmark, 10, "native full read");
+        for (int i = 0; i < 10; i++) {
+            KRecordList result =
+              driver->getKRecordList("SH", "600000", KQuery(0, Null<int64_t>(), KQuery::MIN));
+        }
+    }
+
+    KDataDriverPtr src =
+      DataDriverFactory::getKDataDriverPool(sm.getKDataDriverParameter())->getPrototype()->clone();
+    driver->importKData(*src, "SH", "000001", KQuery::DAY);
+    size_t total = src->getCount("SH", "000001", KQuery::DAY);
+    {
+        BENCHMARK_TIME_MSG(test_NativeKDataDriver_benchmark, cycle, "source tail read 100 bars");
+        for (int i = 0; i < cycle; i++) {
+            KRecordList result = src->getKRecordList(
+              "SH", "000001", KQuery(int64_t(total - 100), int64_t(total), KQuery::DAY));
+        }
+    }
+    {
+        BENCHMARK_TIME_MSG(test_NativeKDataDriver_benchmark, cycle, "native tail read 100 bars");
+        for (int i = 0; i < cycle; i++) {
+            KRecordList result = driver->getKRecordList(
+              "SH", "000001", KQuery(int64_t(total - 100), int64_t(total), KQuery::DAY));
+        }
+    }
+
+    removeDir(dir);
+}
+#endif
@@ -0,0 +1,201 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#include "../test_config.h"
+#include <hikyuu/StockManager.h>
+#include <hikyuu/KRecordResampler.h>
+#include <hikyuu/utilities/os.h>
+#include <hikyuu/utilities/db_connect/sqlite/SQLiteConnect.h>
+#include <hikyuu/data_driver/kdata/sqlite/SQLiteKDataDriver.h>
+
+using namespace hku;
+
+/**
+ * @defgroup test_SQLiteKDataDriver test_SQLiteKDataDriver
+ * @ingroup test_hikyuu_data_driver_suite
+ * @{
+ */
+
+// 按 A 股交易时段生成 days 个完整交易日及最后一日前 tail 根的5分钟线
+static KRecordList makeMin5Records(size_t days, size_t tail) {
+    KRecordList result;
+    Datetime day(20190102);
+    for (size_t d = 0; d <= days; d++) {
+        size_t n = d < days ? 48 : tail;
+        for (size_t i = 0; i < n; i++) {
+            Datetime t = i < 24 ? day + Hours(9) + Minutes(35 + 5 * i)
+                                : day + Hours(13) + Minutes(5 + 5 * (i - 24));
+            price_t v = 10.0 + 0.01 * result.size();
+            result.emplace_back(t, v, v + 0.05, v - 0.05, v + 0.01, 1000.0, 100.0);
+        }
+        day = day + Days(1);
+    }
+    return result;
+}
+
+static void createKDataTable(const string& filename, const KRecordList& klist) {
+    Parameter param;
+    param.set<string>("db", filename);
+    SQLiteConnect con(param);
+    con.exec(
+      "create table if not exists `000001` (date INTEGER PRIMARY KEY, open DOUBLE, "
+      "high DOUBLE, low DOUBLE, close DOUBLE, amount DOUBLE, count DOUBLE)");
+    con.transaction();
+    for (const auto& k : klist) {
+        con.exec(fmt::format("insert or replace into `000001` values ({}, {}, {}, {}, {}, {}, {})",
+                             k.datetime.number(), k.openPrice, k.highPrice, k.lowPrice,
+                             k.closePrice, k.transAmount, k.transCount));
+    }
+    con.commit();
+}
+
+/** @par 检测点 */
+TEST_CASE("test_SQLiteKDataDriver_convert") {
+    string filename = fmt::format("{}/test_sqlite_kdata.db", StockManager::instance().tmpdir());
+    removeFile(filename);
+
+    KRecordList min5 = makeMin5Records(5, 10);
+    createKDataTable(filename, min5);
+
+    Parameter param;
+    param.set<string>("type", "sqlite3");
+    param.set<string>("sh_min5", filename);
+    param.set<bool>("convert", true);
+    param.set<string>("session", "09:30-11:30,13:00-15:00");
+    auto driver = make_shared<SQLiteKDataDriver>();
+    REQUIRE(driver->init(param));
+    REQUIRE_EQ(driver->getCount("SH", "000001", KQuery::MIN5), min5.size());
+
+    /** @arg 合成K线的数量与按位置、按日期读取的结果一致 */
+    MarketInfo session("SH", "", "", "", Null<Datetime>(), Hours(9) + Minutes(30),
+                       Hours(11) + Minutes(30), Hours(13), Hours(15));
+    for (auto& ktype : {KQuery::MIN15, KQuery::MIN30, KQuery::MIN60, KQuery::HOUR2,
+                        KQuery::HOUR4, KQuery::HOUR6, KQuery::HOUR12}) {
+        KRecordList expect = KRecordResampler::resample(min5, ktype, session);
+        size_t total = driver->getCount("SH", "000001", ktype);
+        CHECK_EQ(total, expect.size());
+
+        KRecordList klist =
+          driver->getKRecordList("SH", "000001", KQuery(0, Null<int64_t>(), ktype));
+        CHECK_EQ(klist, expect);
+        klist = driver->getKRecordList("SH", "000001",
+                                       KQueryByDate(Datetime::min(), Null<Datetime>(), ktype));
+        CHECK_EQ(klist, expect);
+
+        /** @arg 按位置读取部分合成K线 */
+        klist = driver->getKRecordList("SH", "000001", KQuery(2, 5, ktype));
+        REQUIRE_EQ(klist.size(), 3);
+        CHECK_EQ(klist, KRecordList(expect.begin() + 2, expect.begin() + 5));
+        klist = driver->getKRecordList("SH", "000001", KQuery(total - 1, total, ktype));
+        REQUIRE_EQ(klist.size(), 1);
+        CHECK_EQ(klist[0], expect.back());
+    }
+
+    /** @arg 周期长于全天交易时长时每日一根 */
+    CHECK_EQ(driver->getCount("SH", "000001", KQuery::HOUR6), 6);
+    CHECK_EQ(driver->getCount("SH", "000001", KQuery::HOUR12), 6);
+
+    /** @arg 按日期获取合成K线的位置区间 */
+    KRecordList expect = KRecordResampler::resample(min5, KQuery::MIN30, session);
+    size_t start = 0, end = 0;
+    CHECK_UNARY(driver->getIndexRangeByDate(
+      "SH", "000001", KQueryByDate(expect[3].datetime, expect[10].datetime, KQuery::MIN30),
+      start, end));
+    CHECK_EQ(start, 3);
+    CHECK_EQ(end, 10);
+
+    /** @arg 基础K线新增及最后一根更新后，增量合成的结果与重新合成一致 */
+    min5.back().closePrice += 0.5;
+    min5.back().transAmount += 10.0;
+    KRecordList full = makeMin5Records(6, 0);
+    KRecordList appended(full.begin() + min5.size(), full.end());
+    appended.insert(appended.begin(), min5.back());
+    createKDataTable(filename, appended);
+    min5.pop_back();
+    min5.insert(min5.end(), appended.begin(), appended.end());
+    for (auto& ktype : {KQuery::MIN15, KQuery::MIN60, KQuery::HOUR6}) {
+        expect = KRecordResampler::resample(min5, ktype, session);
+        CHECK_EQ(driver->getCount("SH", "000001", ktype), expect.size());
+        CHECK_EQ(driver->getKRecordList("SH", "000001", KQuery(0, Null<int64_t>(), ktype)),
+                 expect);
+    }
+
+    /** @arg 已合成的基础K线被删除后重新合成 */
+    {
+        Parameter con_param;
+        con_param.set<string>("db", filename);
+        SQLiteConnect con(con_param);
+        con.exec(fmt::format("delete from `000001` where date >= {}",
+                             Datetime(20190104).number()));
+    }
+    KRecordList head;
+    for (const auto& k : min5) {
+        if (k.datetime < Datetime(20190104)) {
+            head.push_back(k);
+        }
+    }
+    expect = KRecordResampler::resample(head, KQuery::MIN15, session);
+    CHECK_EQ(driver->getCount("SH", "000001", KQuery::MIN15), expect.size());
+    CHECK_EQ(driver->getKRecordList("SH", "000001", KQuery(0, Null<int64_t>(), KQuery::MIN15)),
+             expect);
+
+    driver.reset();
+    removeFile(filename);
+}
+
+/** @par 检测点 */
+TEST_CASE("test_SQLiteKDataDriver_convert_day") {
+    string filename = fmt::format("{}/test_sqlite_kdata_day.db", StockManager::instance().tmpdir());
+    removeFile(filename);
+
+    // 2019-01-02 起的 300 个自然日中的工作日
+    KRecordList days;
+    Datetime day(20190102);
+    for (size_t i = 0; i < 300; i++, day = day + Days(1)) {
+        if (day.dayOfWeek() == 0 || day.dayOfWeek() == 6) {
+            continue;
+        }
+        price_t v = 10.0 + 0.01 * days.size();
+        days.emplace_back(day, v, v + 0.05, v - 0.05, v + 0.01, 1000.0, 100.0);
+    }
+    createKDataTable(filename, days);
+
+    Parameter param;
+    param.set<string>("type", "sqlite3");
+    param.set<string>("sh_day", filename);
+    param.set<bool>("convert", true);
+    auto driver = make_shared<SQLiteKDataDriver>();
+    REQUIRE(driver->init(param));
+    REQUIRE_EQ(driver->getCount("SH", "000001", KQuery::DAY), days.size());
+
+    /** @arg 日线以上周期的数量与合成结果一致，按位置读取与按日期读取一致 */
+    for (auto& ktype :
+         {KQuery::WEEK, KQuery::MONTH, KQuery::QUARTER, KQuery::HALFYEAR, KQuery::YEAR}) {
+        KRecordList expect = KRecordResampler::resample(days, ktype, MarketInfo());
+        size_t total = driver->getCount("SH", "000001", ktype);
+        CHECK_EQ(total, expect.size());
+        CHECK_EQ(driver->getKRecordList("SH", "000001", KQuery(0, Null<int64_t>(), ktype)),
+                 expect);
+        KRecordList klist = driver->getKRecordList("SH", "000001", KQuery(total - 1, total, ktype));
+        REQUIRE_EQ(klist.size(), 1);
+        CHECK_EQ(klist[0], expect.back());
+    }
+    CHECK_EQ(driver->getCount("SH", "000001", KQuery::MONTH), 10);
+
+    /** @arg 按位置读取的周线区间与按日期换算一致 */
+    KRecordList expect = KRecordResampler::resample(days, KQuery::WEEK, MarketInfo());
+    KRecordList klist = driver->getKRecordList("SH", "000001", KQuery(10, 20, KQuery::WEEK));
+    CHECK_EQ(klist, KRecordList(expect.begin() + 10, expect.begin() + 20));
+    klist = driver->getKRecordList(
+      "SH", "000001", KQueryByDate(expect[10].datetime, expect[20].datetime, KQuery::WEEK));
+    CHECK_EQ(klist, KRecordList(expect.begin() + 10, expect.begin() + 20));
+
+    driver.reset();
+    removeFile(filename);
+}
+
+/** @} */
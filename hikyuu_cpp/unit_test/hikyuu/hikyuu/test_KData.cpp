@@ -1323,6 +1323,83 @@ TEST_CASE("test_getKData_recover") {
              KRecord(Datetime(200208220000), 18.74, 18.86, 18.59, 18.79, 13101.3, 106872));
 }
 
+/** @par 检测点 */
+TEST_CASE("test_getKData_recover_factors") {
+    StockManager& sm = StockManager::instance();
+    Stock stock = sm.getStock("sh600000");
+
+    /** @arg 复权因子表缓存 */
+    RecoverFactorListPtr factors = stock.getRecoverFactors();
+    REQUIRE(factors);
+    CHECK_GT(factors->size(), 1);
+    CHECK_EQ(factors->front().datetime, Datetime::min());
+    CHECK_EQ(factors->front().denominator, 1.0);
+    CHECK_EQ(factors->front().addend, 0.0);
+    CHECK_UNARY(std::isnan(factors->front().equalForward));
+    CHECK_UNARY(std::isnan(factors->front().equalBackward));
+    CHECK_EQ(stock.getRecoverFactors().get(), factors.get());
+
+    /** @arg 权息变更后复权因子表失效重建 */
+    stock.setWeightList(stock.getWeight());
+    RecoverFactorListPtr new_factors = stock.getRecoverFactors();
+    REQUIRE(new_factors);
+    CHECK_NE(new_factors.get(), factors.get());
+    REQUIRE_EQ(new_factors->size(), factors->size());
+    for (size_t i = 0; i < factors->size(); i++) {
+        CHECK_EQ((*new_factors)[i].datetime, (*factors)[i].datetime);
+        CHECK_EQ((*new_factors)[i].denominator, (*factors)[i].denominator);
+        CHECK_EQ((*new_factors)[i].addend, (*factors)[i].addend);
+        CHECK_EQ(std::isnan((*new_factors)[i].equalForward),
+                 std::isnan((*factors)[i].equalForward));
+        if (!std::isnan((*factors)[i].equalForward)) {
+            CHECK_EQ((*new_factors)[i].equalForward, (*factors)[i].equalForward);
+        }
+        CHECK_EQ(std::isnan((*new_factors)[i].equalBackward),
+                 std::isnan((*factors)[i].equalBackward));
+        if (!std::isnan((*factors)[i].equalBackward)) {
+            CHECK_EQ((*new_factors)[i].equalBackward, (*factors)[i].equalBackward);
+        }
+    }
+
+    /** @arg 后复权以区间第一根K线为基准 */
+    KQuery query = KQueryByDate(Datetime(201001010000), Null<Datetime>(), KQuery::DAY);
+    KData raw = stock.getKData(query);
+    query.recoverType(KQuery::BACKWARD);
+    KData kdata = stock.getKData(query);
+    REQUIRE_EQ(kdata.size(), raw.size());
+    CHECK_EQ(kdata[0], raw[0]);
+    CHECK_NE(kdata[kdata.size() - 1], raw[raw.size() - 1]);
+
+    /** @arg 周线复权与日线复权一致，2011-06-03 除权所在周由日线重新合成 */
+    KQuery::RecoverType recover_types[] = {KQuery::FORWARD, KQuery::BACKWARD,
+                                           KQuery::EQUAL_FORWARD, KQuery::EQUAL_BACKWARD};
+    for (auto recover_type : recover_types) {
+        KData day = stock.getKData(KQuery(0, Null<int64_t>(), KQuery::DAY, recover_type));
+        KData week = stock.getKData(KQuery(0, Null<int64_t>(), KQuery::WEEK, recover_type));
+        for (auto& date : {Datetime(201106030000), Datetime(201105200000)}) {
+            size_t week_pos = week.getPos(date);
+            REQUIRE(week_pos != Null<size_t>());
+            KRecord week_record = week[week_pos];
+            KRecordList week_day;
+            for (size_t i = 0; i < day.size(); i++) {
+                if (day[i].datetime >= date.startOfWeek() && day[i].datetime <= date) {
+                    week_day.push_back(day[i]);
+                }
+            }
+            REQUIRE(!week_day.empty());
+            price_t high = week_day.front().highPrice, low = week_day.front().lowPrice;
+            for (const auto& record : week_day) {
+                high = std::max(high, record.highPrice);
+                low = std::min(low, record.lowPrice);
+            }
+            CHECK_EQ(week_record.openPrice, doctest::Approx(week_day.front().openPrice));
+            CHECK_EQ(week_record.highPrice, doctest::Approx(high));
+            CHECK_EQ(week_record.lowPrice, doctest::Approx(low));
+            CHECK_EQ(week_record.closePrice, doctest::Approx(week_day.back().closePrice));
+        }
+    }
+}
+
 /** @par 检测点 */
 TEST_CASE("test_getKRecord_By_Date") {
     StockManager& sm = StockManager::instance();
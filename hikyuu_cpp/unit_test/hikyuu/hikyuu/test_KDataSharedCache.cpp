@@ -0,0 +1,184 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#include "../test_config.h"
+#include <hikyuu/StockManager.h>
+#include <hikyuu/KDataSharedCache.h>
+
+#if !defined(_WIN32)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace hku;
+
+/**
+ * @defgroup test_hikyuu_KDataSharedCache test_hikyuu_KDataSharedCache
+ * @ingroup test_hikyuu_base_suite
+ * @{
+ */
+
+// 按工作日生成日线记录
+static KRecordList makeSharedTestKRecordList(const Datetime& start, size_t total, price_t base) {
+    KRecordList result;
+    Datetime d = start;
+    while (result.size() < total) {
+        if (d.dayOfWeek() != 0 && d.dayOfWeek() != 6) {
+            price_t v = base + result.size();
+            result.emplace_back(d, v, v + 1.0, v - 1.0, v + 0.5, v * 100.0, v * 10.0);
+        }
+        d = d + Days(1);
+    }
+    return result;
+}
+
+static StockMapIterator::stock_map_t makeSharedTestStocks(bool with_data) {
+    StockMapIterator::stock_map_t result;
+    for (int i = 0; i < 3; i++) {
+        string code = fmt::format("T0000{}", i);
+        Stock stk("SH", code, "test");
+        if (with_data) {
+            stk.setKRecordList(makeSharedTestKRecordList(Datetime(20240301), 20 + i, 10.0 * i));
+        }
+        result[fmt::format("SH{}", code)] = stk;
+    }
+    return result;
+}
+
+/** @par 检测点 */
+TEST_CASE("test_KDataSharedCache") {
+    string name("unittest");
+    KDataSharedCache::remove(name, KQuery::DAY);
+
+    /** @arg 共享内存段不存在时成为所有者 */
+    auto owner = std::make_unique<KDataSharedCache>(name);
+    CHECK_EQ(owner->open(KQuery::DAY, 0), KDataSharedCache::OWNER);
+    CHECK_EQ(owner->role(KQuery::DAY), KDataSharedCache::OWNER);
+    CHECK_EQ(owner->role(KQuery::MIN), KDataSharedCache::NONE);
+
+    /** @arg 所有者发布前，其他实例等待超时 */
+    {
+        KDataSharedCache other(name);
+        CHECK_EQ(other.open(KQuery::DAY, 200), KDataSharedCache::NONE);
+    }
+
+    /** @arg 发布已缓存的K线，发布后所有者数据不变 */
+    auto owner_stocks = makeSharedTestStocks(true);
+    Stock no_buffer("SH", "T00009", "test");
+    owner_stocks["SHT00009"] = no_buffer;
+    CHECK_EQ(owner->publish(KQuery::DAY, owner_stocks), 3);
+    for (int i = 0; i < 3; i++) {
+        const Stock& stk = owner_stocks[fmt::format("SHT0000{}", i)];
+        KRecordList expect = makeSharedTestKRecordList(Datetime(20240301), 20 + i, 10.0 * i);
+        CHECK_EQ(stk.getKRecordList(KQuery(0, Null<int64_t>(), KQuery::DAY)), expect);
+    }
+
+    /** @arg 其他实例附着共享数据 */
+    KDataSharedCache reader(name);
+    CHECK_EQ(reader.open(KQuery::DAY, 0), KDataSharedCache::ATTACHED);
+    auto reader_stocks = makeSharedTestStocks(false);
+    CHECK_EQ(reader.attach(KQuery::DAY, reader_stocks), 3);
+    const Stock& stk = reader_stocks["SHT00002"];
+    CHECK_UNARY(stk.isBuffer(KQuery::DAY));
+    KRecordList expect = makeSharedTestKRecordList(Datetime(20240301), 22, 20.0);
+    CHECK_EQ(stk.getCount(KQuery::DAY), 22);
+    CHECK_EQ(stk.getKRecordList(KQuery(0, Null<int64_t>(), KQuery::DAY)), expect);
+    KData kdata = stk.getKData(KQueryByDate(Datetime(20240305), Datetime(20240312), KQuery::DAY));
+    CHECK_EQ(kdata.size(), 5);
+    CHECK_EQ(kdata[0].datetime, Datetime(20240305));
+
+    /** @arg 实时行情更新复制为本地数据，不影响共享数据 */
+    Stock updated = stk;
+    KRecord k(Datetime(20240401), 1.0, 2.0, 0.5, 1.5, 100.0, 10.0);
+    updated.realtimeUpdate(k, KQuery::DAY);
+    CHECK_EQ(updated.getCount(KQuery::DAY), 23);
+    CHECK_EQ(owner_stocks["SHT00002"].getCount(KQuery::DAY), 22);
+
+    /** @arg 所有者退出后，已附着的实例仍可使用，新实例重新成为所有者 */
+    owner.reset();
+    const Stock& stk1 = reader_stocks["SHT00001"];
+    CHECK_EQ(stk1.getKRecordList(KQuery(0, Null<int64_t>(), KQuery::DAY)),
+             makeSharedTestKRecordList(Datetime(20240301), 21, 10.0));
+    {
+        KDataSharedCache next(name);
+        CHECK_EQ(next.open(KQuery::DAY, 0), KDataSharedCache::OWNER);
+    }
+    KDataSharedCache::remove(name, KQuery::DAY);
+}
+
+/** @par 检测点 */
+TEST_CASE("test_KDataSharedCache_stale") {
+    string name("unittest_stale");
+    KDataSharedCache::remove(name, KQuery::DAY);
+
+    auto old_owner = std::make_unique<KDataSharedCache>(name);
+    REQUIRE_EQ(old_owner->open(KQuery::DAY, 0, 202403290000ULL), KDataSharedCache::OWNER);
+    auto old_stocks = makeSharedTestStocks(true);
+    CHECK_EQ(old_owner->publish(KQuery::DAY, old_stocks), 3);
+
+    /** @arg 数据版本一致时附着 */
+    {
+        KDataSharedCache reader(name);
+        CHECK_EQ(reader.open(KQuery::DAY, 0, 202403290000ULL), KDataSharedCache::ATTACHED);
+    }
+
+    /** @arg 数据版本不一致时删除过期的段并成为所有者 */
+    auto new_owner = std::make_unique<KDataSharedCache>(name);
+    REQUIRE_EQ(new_owner->open(KQuery::DAY, 0, 202404010000ULL), KDataSharedCache::OWNER);
+
+    /** @arg 原所有者的证券仍可使用已映射的数据 */
+    CHECK_EQ(old_stocks["SHT00001"].getKRecordList(KQuery(0, Null<int64_t>(), KQuery::DAY)),
+             makeSharedTestKRecordList(Datetime(20240301), 21, 10.0));
+
+    auto new_stocks = makeSharedTestStocks(false);
+    new_stocks["SHT00000"].setKRecordList(makeSharedTestKRecordList(Datetime(20240301), 23, 0.0));
+    CHECK_EQ(new_owner->publish(KQuery::DAY, new_stocks), 1);
+
+    /** @arg 原所有者退出时不删除其他进程重建的段 */
+    old_owner.reset();
+    {
+        KDataSharedCache reader(name);
+        CHECK_EQ(reader.open(KQuery::DAY, 0, 202404010000ULL), KDataSharedCache::ATTACHED);
+        auto reader_stocks = makeSharedTestStocks(false);
+        CHECK_EQ(reader.attach(KQuery::DAY, reader_stocks), 1);
+        CHECK_EQ(reader_stocks["SHT00000"].getCount(KQuery::DAY), 23);
+    }
+
+    new_owner.reset();
+    KDataSharedCache::remove(name, KQuery::DAY);
+}
+
+#if !defined(_WIN32)
+/** @par 检测点 */
+TEST_CASE("test_KDataSharedCache_abandoned") {
+    string name("unittest_abandoned");
+    KDataSharedCache::remove(name, KQuery::DAY);
+
+    // 子进程成为所有者后，未发布即退出（不执行析构）
+    pid_t pid = fork();
+    REQUIRE(pid >= 0);
+    if (pid == 0) {
+        KDataSharedCache* owner = new KDataSharedCache(name);
+        _exit(owner->open(KQuery::DAY, 0) == KDataSharedCache::OWNER ? 0 : 1);
+    }
+    int status = 0;
+    REQUIRE_EQ(waitpid(pid, &status, 0), pid);
+    REQUIRE_EQ(WEXITSTATUS(status), 0);
+
+    /** @arg 所有者在发布前退出，等待的进程无需等待至超时即成为新的所有者 */
+    auto start = std::chrono::steady_clock::now();
+    {
+        KDataSharedCache next(name);
+        CHECK_EQ(next.open(KQuery::DAY, 60000), KDataSharedCache::OWNER);
+    }
+    CHECK_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(10));
+
+    KDataSharedCache::remove(name, KQuery::DAY);
+}
+#endif
+
+/** @} */
@@ -0,0 +1,361 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#include "../test_config.h"
+#include <atomic>
+#include <shared_mutex>
+#include <thread>
+#include <hikyuu/KRecordBuffer.h>
+
+using namespace hku;
+
+/**
+ * @defgroup test_hikyuu_KRecordBuffer test_hikyuu_KRecordBuffer
+ * @ingroup test_hikyuu_base_suite
+ * @{
+ */
+
+static KRecord makeKRecord(const Datetime& d, price_t v) {
+    return KRecord(d, v, v, v, v, v, v);
+}
+
+static bool isConsistent(const KRecord& k) {
+    return k.openPrice == k.highPrice && k.openPrice == k.lowPrice &&
+           k.openPrice == k.closePrice && k.openPrice == k.transAmount &&
+           k.openPrice == k.transCount;
+}
+
+// 按交易日（跳过周末）生成日线记录
+static KRecordList makeDayKRecordList(const Datetime& start, size_t total) {
+    KRecordList result;
+    Datetime d = start;
+    while (result.size() < total) {
+        if (d.dayOfWeek() != 0 && d.dayOfWeek() != 6) {
+            result.push_back(makeKRecord(d, double(result.size())));
+        }
+        d = d + Days(1);
+    }
+    return result;
+}
+
+static size_t lowerBound(const KRecordList& ks, const Datetime& d) {
+    return std::lower_bound(ks.begin(), ks.end(), d,
+                            [](const KRecord& k, const Datetime& d) { return k.datetime < d; }) -
+           ks.begin();
+}
+
+/** @par 检测点 */
+TEST_CASE("test_KRecordBuffer") {
+    KRecordBuffer buffer;
+
+    /** @arg 未缓存 */
+    CHECK_UNARY_FALSE(buffer.isBuffered());
+    CHECK_EQ(buffer.size(), 0);
+    CHECK_EQ(buffer.get(0), KRecord());
+    CHECK_EQ(buffer.back(), KRecord());
+    CHECK_UNARY(buffer.getKRecordList(0, 10).empty());
+
+    /** @arg 空缓存 */
+    buffer.assign(KRecordList());
+    CHECK_UNARY(buffer.isBuffered());
+    CHECK_UNARY(buffer.empty());
+
+    KRecordList ks = makeDayKRecordList(Datetime(20240101), 10);
+    buffer.assign(ks);
+    CHECK_EQ(buffer.size(), 10);
+    CHECK_EQ(buffer.get(3), ks[3]);
+    CHECK_EQ(buffer.get(10), KRecord());
+    CHECK_EQ(buffer.back(), ks.back());
+
+    /** @arg 获取记录列表，结束位置超出时截断 */
+    CHECK_EQ(buffer.getKRecordList(2, 5), KRecordList(ks.begin() + 2, ks.begin() + 5));
+    CHECK_EQ(buffer.getKRecordList(8, 100), KRecordList(ks.begin() + 8, ks.end()));
+    CHECK_UNARY(buffer.getKRecordList(5, 5).empty());
+    CHECK_UNARY(buffer.getKRecordList(10, 20).empty());
+
+    /** @arg 更新最后一条记录 */
+    KRecord last = makeKRecord(ks.back().datetime, 100.0);
+    buffer.updateBack(last);
+    CHECK_EQ(buffer.size(), 10);
+    CHECK_EQ(buffer.back(), last);
+    CHECK_EQ(buffer.get(8), ks[8]);
+
+    /** @arg 连续追加超出预留空间 */
+    ks.back() = last;
+    for (size_t i = 0; i < 200; i++) {
+        KRecord k = makeKRecord(ks.back().datetime + Days(1), double(i));
+        buffer.append(k);
+        ks.push_back(k);
+    }
+    CHECK_EQ(buffer.size(), ks.size());
+    CHECK_EQ(buffer.getKRecordList(0, ks.size()), ks);
+
+    /** @arg 释放缓存 */
+    buffer.clear();
+    CHECK_UNARY_FALSE(buffer.isBuffered());
+    CHECK_EQ(buffer.size(), 0);
+}
+
+/** @par 检测点 */
+TEST_CASE("test_KRecordBuffer_getIndexRangeByDate") {
+    KRecordBuffer buffer(true);
+    size_t start = 0, end = 0;
+
+    /** @arg 空缓存 */
+    buffer.assign(KRecordList());
+    CHECK_UNARY_FALSE(
+      buffer.getIndexRangeByDate(Datetime(20240101), Datetime(20250101), start, end));
+
+    /** @arg 首条记录通过追加写入 */
+    KRecordList ks;
+    ks.push_back(makeKRecord(Datetime(20240102), 1.0));
+    buffer.append(ks.back());
+    CHECK_UNARY(buffer.getIndexRangeByDate(Datetime(20240101), Datetime(20250101), start, end));
+    CHECK_EQ(start, 0);
+    CHECK_EQ(end, 1);
+
+    /** @arg 与二分查找结果一致，包括追加超出日期索引预留范围后 */
+    ks = makeDayKRecordList(Datetime(20200101), 500);
+    buffer.assign(ks);
+    for (size_t i = 0; i < 300; i++) {
+        Datetime d = ks.back().datetime + Days(ks.back().datetime.dayOfWeek() == 5 ? 3 : 1);
+        ks.push_back(makeKRecord(d, double(i)));
+        buffer.append(ks.back());
+    }
+    REQUIRE(buffer.size() == ks.size());
+
+    Datetime first = ks.front().datetime - Days(3);
+    Datetime stop = ks.back().datetime + Days(3);
+    for (Datetime d = first; d < stop; d = d + Days(1)) {
+        for (const Datetime& query_start : {d, d + Minutes(1)}) {
+            Datetime query_end = query_start + Days(7);
+            size_t expect_start = lowerBound(ks, query_start);
+            size_t expect_end = lowerBound(ks, query_end);
+            bool success = buffer.getIndexRangeByDate(query_start, query_end, start, end);
+            CHECK_EQ(success, expect_start < expect_end);
+            if (success) {
+                CHECK_EQ(start, expect_start);
+                CHECK_EQ(end, expect_end);
+            }
+        }
+    }
+
+    /** @arg 结束日期为 Null */
+    CHECK_UNARY(buffer.getIndexRangeByDate(ks[10].datetime, Null<Datetime>(), start, end));
+    CHECK_EQ(start, 10);
+    CHECK_EQ(end, ks.size());
+}
+
+/** @par 检测点 */
+TEST_CASE("test_KRecordBuffer_attach") {
+    KRecordBuffer buffer(true);
+    auto shared = std::make_shared<KRecordList>(makeDayKRecordList(Datetime(20240101), 100));
+    const KRecordList& ks = *shared;
+
+    /** @arg 引用外部数据，不复制记录 */
+    buffer.attach(ks.data(), ks.size(), shared);
+    CHECK_UNARY(buffer.isBuffered());
+    CHECK_UNARY(buffer.isShared());
+    CHECK_EQ(shared.use_count(), 2);
+    CHECK_EQ(buffer.size(), ks.size());
+    CHECK_EQ(buffer.getKRecordList(0, 100), ks);
+    size_t start = 0, end = 0;
+    CHECK_UNARY(buffer.getIndexRangeByDate(ks[10].datetime, ks[20].datetime, start, end));
+    CHECK_EQ(start, 10);
+    CHECK_EQ(end, 20);
+
+    /** @arg 更新最后一条记录时复制为私有数据，外部数据不变 */
+    KRecord old_last = ks.back();
+    KRecord last = makeKRecord(ks.back().datetime, 1000.0);
+    buffer.updateBack(last);
+    CHECK_UNARY_FALSE(buffer.isShared());
+    CHECK_EQ(buffer.back(), last);
+    CHECK_EQ(ks.back(), old_last);
+    CHECK_EQ(buffer.get(50), ks[50]);
+
+    /** @arg 追加记录时复制为私有数据 */
+    buffer.attach(ks.data(), ks.size(), shared);
+    KRecord k = makeKRecord(ks.back().datetime + Days(1), 1.0);
+    buffer.append(k);
+    CHECK_UNARY_FALSE(buffer.isShared());
+    CHECK_EQ(buffer.size(), ks.size() + 1);
+    CHECK_EQ(buffer.back(), k);
+    CHECK_EQ(ks.size(), 100);
+    CHECK_UNARY(buffer.getIndexRangeByDate(k.datetime, Null<Datetime>(), start, end));
+    CHECK_EQ(start, 100);
+
+    /** @arg 释放缓存后不再持有外部数据 */
+    buffer.clear();
+    CHECK_EQ(shared.use_count(), 1);
+}
+
+/** @par 检测点 */
+TEST_CASE("test_KRecordBuffer_concurrent") {
+    KRecordBuffer buffer(true);
+    buffer.assign(makeDayKRecordList(Datetime(20200101), 100));
+
+    /** @arg 单写多读，读者获取的最后一条记录始终完整 */
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> errors{0};
+    vector<std::thread> readers;
+    for (int i = 0; i < 4; i++) {
+        readers.emplace_back([&]() {
+            size_t pre_size = 0;
+            while (!stop) {
+                KRecordList ks = buffer.getKRecordList(0, Null<size_t>());
+                if (ks.size() < pre_size || !isConsistent(ks.back()) ||
+                    !isConsistent(buffer.back())) {
+                    errors++;
+                }
+                pre_size = ks.size();
+            }
+        });
+    }
+
+    KRecord last = buffer.back();
+    for (int i = 0; i < 20000; i++) {
+        if (i % 100 == 0) {
+            last = makeKRecord(last.datetime + Days(1), double(i));
+            buffer.append(last);
+        } else {
+            buffer.updateBack(makeKRecord(last.datetime, double(i)));
+        }
+    }
+    stop = true;
+    for (auto& t : readers) {
+        t.join();
+    }
+
+    CHECK_EQ(errors, 0);
+    CHECK_EQ(buffer.size(), 300);
+    CHECK_EQ(buffer.back(), makeKRecord(last.datetime, 19999.0));
+}
+
+/** @par 检测点 */
+TEST_CASE("test_KRecordBuffer_reclaim") {
+    KRecordBuffer buffer(true);
+    auto shared = std::make_shared<KRecordList>(makeDayKRecordList(Datetime(20240101), 100));
+    const KRecordList& ks = *shared;
+
+    /** @arg 没有读者时，被替换的数据块在替换时立即释放 */
+    buffer.attach(ks.data(), ks.size(), shared);
+    CHECK_EQ(shared.use_count(), 2);
+    buffer.assign(makeDayKRecordList(Datetime(20240101), 10));
+    CHECK_EQ(shared.use_count(), 1);
+
+    /** @arg 并发读取时替换，被替换的数据块由之后退出的读者释放，无需等待下一次写入 */
+    buffer.attach(ks.data(), ks.size(), shared);
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> errors{0};
+    vector<std::thread> readers;
+    for (int i = 0; i < 4; i++) {
+        readers.emplace_back([&]() {
+            while (!stop) {
+                size_t total = buffer.size();
+                if (total != 100 && total != 200) {
+                    errors++;
+                }
+                KRecord k = buffer.back();
+                if (!isConsistent(k)) {
+                    errors++;
+                }
+            }
+            // 写入者已结束，最后一次读取后不再有读者
+            buffer.get(0);
+        });
+    }
+
+    for (int i = 0; i < 1000; i++) {
+        buffer.assign(makeDayKRecordList(Datetime(20240101), 200));
+        buffer.attach(ks.data(), ks.size(), shared);
+    }
+    buffer.assign(makeDayKRecordList(Datetime(20240101), 200));
+    stop = true;
+    for (auto& t : readers) {
+        t.join();
+    }
+
+    CHECK_EQ(errors, 0);
+    CHECK_EQ(shared.use_count(), 1);
+    CHECK_EQ(buffer.size(), 200);
+}
+
+//-----------------------------------------------------------------------------
+// benchmark
+//-----------------------------------------------------------------------------
+#if ENABLE_BENCHMARK_TEST
+// 一个写入者持续更新最后一条记录，多个读者并发读取
+TEST_CASE("test_KRecordBuffer_contention_benchmark") {
+    const size_t total = 4096;
+    const int read_cycle = 100000;
+    const int reader_num = std::max(2, int(std::thread::hardware_concurrency()) - 1);
+    KRecordList ks = makeDayKRecordList(Datetime(20000101), total);
+
+    auto run = [&](const std::function<void(int)>& write,
+                   const std::function<void()>& read) {
+        std::atomic<bool> stop{false};
+        std::thread writer([&]() {
+            for (int i = 0; !stop; i++) {
+                write(i);
+            }
+        });
+        vector<std::thread> readers;
+        for (int i = 0; i < reader_num; i++) {
+            readers.emplace_back([&]() {
+                for (int n = 0; n < read_cycle; n++) {
+                    read();
+                }
+            });
+        }
+        for (auto& t : readers) {
+            t.join();
+        }
+        stop = true;
+        writer.join();
+    };
+
+    {
+        // 原有方式: 读写锁保护的 KRecordList
+        KRecordList buf(ks);
+        std::shared_mutex mutex;
+        BENCHMARK_TIME_MSG(test_KRecordBuffer_shared_mutex, read_cycle,
+                           fmt::format("shared_mutex, readers: {}", reader_num));
+        run(
+          [&](int i) {
+              std::unique_lock<std::shared_mutex> lock(mutex);
+              buf.back().closePrice = i;
+          },
+          [&]() {
+              {
+                  std::shared_lock<std::shared_mutex> lock(mutex);
+                  KRecord k = buf.back();
+              }
+              std::shared_lock<std::shared_mutex> lock(mutex);
+              KRecordList result(buf.end() - 100, buf.end());
+          });
+    }
+
+    {
+        KRecordBuffer buf(true);
+        buf.assign(ks);
+        KRecord last = ks.back();
+        BENCHMARK_TIME_MSG(test_KRecordBuffer_lock_free, read_cycle,
+                           fmt::format("KRecordBuffer, readers: {}", reader_num));
+        run(
+          [&](int i) {
+              last.closePrice = i;
+              buf.updateBack(last);
+          },
+          [&]() {
+              KRecord k = buf.back();
+              KRecordList result = buf.getKRecordList(total - 100, total);
+          });
+    }
+}
+#endif
+
+/** @} */
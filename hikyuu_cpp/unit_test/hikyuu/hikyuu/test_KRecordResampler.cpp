@@ -0,0 +1,195 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#include "../test_config.h"
+#include <hikyuu/StockManager.h>
+#include <hikyuu/KRecordResampler.h>
+
+using namespace hku;
+
+/**
+ * @defgroup test_hikyuu_KRecordResampler test_hikyuu_KRecordResampler
+ * @ingroup test_hikyuu_base_suite
+ * @{
+ */
+
+// 按沪市交易时段生成一日的5分钟线，价格及成交量为序号 + 1
+static KRecordList makeMin5KRecordList(const Datetime& day) {
+    KRecordList result;
+    Datetime start[2] = {day + Hours(9) + Minutes(30), day + Hours(13)};
+    for (int s = 0; s < 2; s++) {
+        for (int i = 1; i <= 24; i++) {
+            price_t v = double(result.size() + 1);
+            result.emplace_back(start[s] + Minutes(5 * i), v, v + 0.5, v - 0.5, v, v, v);
+        }
+    }
+    return result;
+}
+
+/** @par 检测点 */
+TEST_CASE("test_KRecordResampler_period_end") {
+    MarketInfo market = StockManager::instance().getMarketInfo("SH");
+    Datetime day(201112060000);
+
+    /** @arg 60分钟，按交易时段切分，跨午休的时刻归入相邻时段 */
+    KRecordResampler min60(KQuery::MIN60, market);
+    CHECK_EQ(min60.getPeriodEnd(Datetime(201112060925)), Datetime(201112061030));
+    CHECK_EQ(min60.getPeriodEnd(Datetime(201112060935)), Datetime(201112061030));
+    CHECK_EQ(min60.getPeriodEnd(Datetime(201112061030)), Datetime(201112061030));
+    CHECK_EQ(min60.getPeriodEnd(Datetime(201112061031)), Datetime(201112061130));
+    CHECK_EQ(min60.getPeriodEnd(Datetime(201112061200)), Datetime(201112061130));
+    CHECK_EQ(min60.getPeriodEnd(Datetime(201112061305)), Datetime(201112061400));
+    CHECK_EQ(min60.getPeriodEnd(Datetime(201112061500)), Datetime(201112061500));
+    CHECK_EQ(min60.getPeriodEnd(Datetime(201112061510)), Datetime(201112061500));
+
+    /** @arg 15分钟 */
+    KRecordResampler min15(KQuery::MIN15, market);
+    CHECK_EQ(min15.getPeriodEnd(Datetime(201112060931)), Datetime(201112060945));
+    CHECK_EQ(min15.getPeriodEnd(Datetime(201112061316)), Datetime(201112061330));
+
+    /** @arg 小时线，最后一段截止于闭市时间 */
+    KRecordResampler hour2(KQuery::HOUR2, market);
+    CHECK_EQ(hour2.getPeriodEnd(Datetime(201112061100)), Datetime(201112061130));
+    CHECK_EQ(hour2.getPeriodEnd(Datetime(201112061305)), Datetime(201112061500));
+    KRecordResampler hour4(KQuery::HOUR4, market);
+    CHECK_EQ(hour4.getPeriodEnd(Datetime(201112060935)), Datetime(201112061500));
+    KRecordResampler hour12(KQuery::HOUR12, market);
+    CHECK_EQ(hour12.getPeriodEnd(Datetime(201112061305)), Datetime(201112061500));
+
+    /** @arg 任意 N 分钟，跨越午休 */
+    KRecordResampler min90(90, market);
+    CHECK_EQ(min90.getPeriodEnd(Datetime(201112061000)), Datetime(201112061100));
+    CHECK_EQ(min90.getPeriodEnd(Datetime(201112061105)), Datetime(201112061400));
+    CHECK_EQ(min90.getPeriodEnd(Datetime(201112061405)), Datetime(201112061500));
+    CHECK_THROWS(KRecordResampler(0, market));
+
+    /** @arg 市场信息无效时按自然时间切分 */
+    KRecordResampler no_market(KQuery::MIN60, MarketInfo());
+    CHECK_EQ(no_market.getPeriodEnd(Datetime(201112060935)), Datetime(201112061000));
+    CHECK_EQ(no_market.getPeriodEnd(Datetime(201112061000)), Datetime(201112061000));
+
+    /** @arg 日线以上 */
+    CHECK_EQ(KRecordResampler(KQuery::DAY, market).getPeriodEnd(Datetime(201112061500)), day);
+    CHECK_EQ(KRecordResampler(KQuery::WEEK, market).getPeriodEnd(day), Datetime(20111209));
+    CHECK_EQ(KRecordResampler(KQuery::MONTH, market).getPeriodEnd(day), Datetime(20111231));
+    CHECK_EQ(KRecordResampler(KQuery::QUARTER, market).getPeriodEnd(Datetime(20110805)),
+             Datetime(20110930));
+    CHECK_EQ(KRecordResampler(KQuery::HALFYEAR, market).getPeriodEnd(Datetime(20110405)),
+             Datetime(20110630));
+    CHECK_EQ(KRecordResampler(KQuery::YEAR, market).getPeriodEnd(day), Datetime(20111231));
+
+    /** @arg 基础K线类型 */
+    CHECK_EQ(KRecordResampler::getBaseKType(KQuery::DAY), KQuery::DAY);
+    CHECK_EQ(KRecordResampler::getBaseKType(KQuery::WEEK), KQuery::DAY);
+    CHECK_EQ(KRecordResampler::getBaseKType(KQuery::HOUR6), KQuery::MIN5);
+    CHECK_EQ(KRecordResampler::getBaseKType(KQuery::MIN3), KQuery::MIN);
+    CHECK_EQ(KRecordResampler::getBaseKType(KQuery::MIN5), KQuery::MIN5);
+}
+
+/** @par 检测点 */
+TEST_CASE("test_KRecordResampler_intraday") {
+    MarketInfo market = StockManager::instance().getMarketInfo("SH");
+    KRecordList min5 = makeMin5KRecordList(Datetime(201112060000));
+
+    /** @arg 5分钟线合成60分钟线 */
+    KRecordList result = KRecordResampler::resample(min5, KQuery::MIN60, market);
+    REQUIRE(result.size() == 4);
+    CHECK_EQ(result[0].datetime, Datetime(201112061030));
+    CHECK_EQ(result[1].datetime, Datetime(201112061130));
+    CHECK_EQ(result[2].datetime, Datetime(201112061400));
+    CHECK_EQ(result[3].datetime, Datetime(201112061500));
+    for (size_t i = 0; i < result.size(); i++) {
+        double first = double(i * 12 + 1), last = double(i * 12 + 12);
+        CHECK_EQ(result[i].openPrice, first);
+        CHECK_EQ(result[i].highPrice, last + 0.5);
+        CHECK_EQ(result[i].lowPrice, first - 0.5);
+        CHECK_EQ(result[i].closePrice, last);
+        CHECK_EQ(result[i].transAmount, (first + last) * 6);
+        CHECK_EQ(result[i].transCount, (first + last) * 6);
+    }
+
+    /** @arg 5分钟线合成2小时线 */
+    result = KRecordResampler::resample(min5, KQuery::HOUR2, market);
+    REQUIRE(result.size() == 2);
+    CHECK_EQ(result[0].datetime, Datetime(201112061130));
+    CHECK_EQ(result[0].closePrice, 24.0);
+    CHECK_EQ(result[1].datetime, Datetime(201112061500));
+    CHECK_EQ(result[1].openPrice, 25.0);
+
+    /** @arg 无效K线被忽略 */
+    KRecordList with_invalid = min5;
+    with_invalid[0].openPrice = 0.0;
+    result = KRecordResampler::resample(with_invalid, KQuery::MIN60, market);
+    REQUIRE(result.size() == 4);
+    CHECK_EQ(result[0].openPrice, 2.0);
+
+    /** @arg 增量追加，与一次性合成结果相同 */
+    KRecordResampler resampler(KQuery::MIN30, market);
+    KRecordList expect = KRecordResampler::resample(min5, KQuery::MIN30, market);
+    for (const auto& k : min5) {
+        resampler.append(k);
+        CHECK_EQ(resampler.getKRecordList().back().datetime,
+                 resampler.getPeriodEnd(k.datetime));
+    }
+    const KRecordList& incremental = resampler.getKRecordList();
+    REQUIRE(incremental.size() == expect.size());
+    for (size_t i = 0; i < expect.size(); i++) {
+        CHECK_EQ(incremental[i].datetime, expect[i].datetime);
+        CHECK_EQ(incremental[i].closePrice, expect[i].closePrice);
+        CHECK_EQ(incremental[i].transCount, expect[i].transCount);
+    }
+
+    /** @arg 最后一根基础K线的更新替换其之前的贡献，过期的K线被忽略 */
+    KRecord last = min5.back();
+    KRecord update(last.datetime, last.openPrice, 100.0, 1.0, 99.0, 1.0, 1.0);
+    KRecord before_update = incremental.back();
+    resampler.append(update);
+    CHECK_EQ(incremental.size(), expect.size());
+    CHECK_EQ(incremental.back().openPrice, before_update.openPrice);
+    CHECK_EQ(incremental.back().highPrice, 100.0);
+    CHECK_EQ(incremental.back().lowPrice, 1.0);
+    CHECK_EQ(incremental.back().closePrice, 99.0);
+    CHECK_EQ(incremental.back().transCount, before_update.transCount - last.transCount + 1.0);
+    resampler.append(min5.front());
+    CHECK_EQ(incremental.size(), expect.size());
+    CHECK_EQ(incremental.back().closePrice, 99.0);
+
+    /** @arg 取出结果后清空 */
+    KRecordList taken = resampler.take();
+    CHECK_EQ(taken.size(), expect.size());
+    CHECK_UNARY(resampler.getKRecordList().empty());
+}
+
+/** @par 检测点 */
+TEST_CASE("test_KRecordResampler_day") {
+    Stock stk = getStock("sh000001");
+
+    /** @arg 日线合成周线、月线，与导入时生成的扩展K线一致 */
+    KQuery::KType ktypes[2] = {KQuery::WEEK, KQuery::MONTH};
+    for (const auto& ktype : ktypes) {
+        KRecordList expect = stk.getKRecordList(KQuery(-20, Null<int64_t>(), ktype));
+        REQUIRE(expect.size() == 20);
+        KRecordResampler resampler(ktype, MarketInfo());
+        Datetime start = ktype == KQuery::WEEK ? expect[0].datetime.startOfWeek()
+                                               : expect[0].datetime.startOfMonth();
+        KRecordList days = stk.getKRecordList(KQueryByDate(start, Null<Datetime>(), KQuery::DAY));
+        resampler.append(days.data(), days.size());
+        const KRecordList& result = resampler.getKRecordList();
+        REQUIRE(result.size() == expect.size());
+        for (size_t i = 0; i < expect.size(); i++) {
+            CHECK_EQ(result[i].datetime, expect[i].datetime);
+            CHECK_EQ(result[i].openPrice, doctest::Approx(expect[i].openPrice));
+            CHECK_EQ(result[i].highPrice, doctest::Approx(expect[i].highPrice));
+            CHECK_EQ(result[i].lowPrice, doctest::Approx(expect[i].lowPrice));
+            CHECK_EQ(result[i].closePrice, doctest::Approx(expect[i].closePrice));
+            CHECK_EQ(result[i].transAmount, doctest::Approx(expect[i].transAmount));
+            CHECK_EQ(result[i].transCount, doctest::Approx(expect[i].transCount));
+        }
+    }
+}
+
+/** @} */
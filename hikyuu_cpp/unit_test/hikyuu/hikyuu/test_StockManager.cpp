@@ -6,9 +6,11 @@
  */
 
 #include "doctest/doctest.h"
+#include <fstream>
 #include <hikyuu/StockManager.h>
 #include <hikyuu/utilities/runtimeinfo.h>
 #include <hikyuu/utilities/Log.h>
+#include <hikyuu/utilities/os.h>
 
 using namespace hku;
 
@@ -159,6 +161,19 @@ TEST_CASE("test_StockManager_getBlock") {
     }
 }
 
+/** @par 检测点 初始化后板块成分完整，且与 StockManager 中的证券实例一致 */
+TEST_CASE("test_StockManager_getBlock_after_init") {
+    if (supportChineseSimple()) {
+        StockManager& sm = StockManager::instance();
+        Block blk = sm.getBlock("地域板块", "陕西");
+        // 测试板块文件中共 48 只证券，其中 38 只存在于证券列表中
+        CHECK_EQ(blk.size(), 38);
+        for (const auto& stk : blk.getStockList()) {
+            CHECK_EQ(sm.getStock(stk.market_code()), stk);
+        }
+    }
+}
+
 /** @par 检测点 */
 TEST_CASE("test_StockManager_TempCsvStock") {
     StockManager& sm = StockManager::instance();
@@ -253,4 +268,134 @@ TEST_CASE("test_StockManager_getZhBond10") {
     CHECK_EQ(result[5535].value, doctest::Approx(2.3375));
 }
 
+/** @par 检测点 */
+TEST_CASE("test_StockManager_snapshot") {
+    auto& sm = StockManager::instance();
+    string filename = fmt::format("{}/sm_snapshot.bin", sm.tmpdir());
+
+    /** @arg 无效的快照文件，加载失败且数据不变 */
+    size_t total = sm.size();
+    CHECK_UNARY_FALSE(sm.loadSnapshot(fmt::format("{}/not_exist_snapshot.bin", sm.tmpdir())));
+    {
+        std::ofstream ofs(filename, std::ios::binary);
+        ofs << "invalid snapshot";
+    }
+    CHECK_UNARY_FALSE(sm.loadSnapshot(filename));
+    CHECK_EQ(sm.size(), total);
+
+    Stock stk = sm["sh000001"];
+    KRecordList expect_klist = stk.getKRecordList(KQuery(0));
+    StockWeightList expect_weights = sm["sz000001"].getWeight();
+    size_t block_total = sm.getBlockList().size();
+    REQUIRE(stk.isBuffer(KQuery::DAY));
+
+    /** @arg 保存后恢复，数据与原数据一致 */
+    CHECK_UNARY(sm.saveSnapshot(filename));
+    CHECK_UNARY(sm.loadSnapshot(filename));
+    CHECK_UNARY(sm.dataReady());
+    CHECK_EQ(sm.size(), total);
+    CHECK_EQ(sm.getBlockList().size(), block_total);
+    CHECK_EQ(sm.isHoliday(Datetime(202101010000LL)), true);
+    CHECK_EQ(sm.getMarketInfo("SH").code(), "000001");
+
+    Stock new_stk = sm["sh000001"];
+    CHECK_NE(new_stk, stk);
+    CHECK_EQ(new_stk.name(), stk.name());
+    CHECK_EQ(new_stk.startDatetime(), stk.startDatetime());
+    CHECK_UNARY(new_stk.isBuffer(KQuery::DAY));
+    CHECK_UNARY_FALSE(new_stk.isBuffer(KQuery::WEEK));
+    CHECK_EQ(new_stk.getKRecordList(KQuery(0)), expect_klist);
+
+    StockWeightList weights = sm["sz000001"].getWeight();
+    REQUIRE(weights.size() == expect_weights.size());
+    for (size_t i = 0; i < weights.size(); i++) {
+        CHECK_EQ(weights[i], expect_weights[i]);
+        CHECK_EQ(weights[i].bonus(), expect_weights[i].bonus());
+    }
+
+    /** @arg 恢复的K线引用快照文件的映射，覆盖保存同名快照后原数据不变 */
+    CHECK_UNARY(sm.saveSnapshot(filename));
+    CHECK_EQ(new_stk.getKRecordList(KQuery(0)), expect_klist);
+    CHECK_UNARY(sm.loadSnapshot(filename));
+    CHECK_EQ(sm["sh000001"].getKRecordList(KQuery(0)), expect_klist);
+
+    /** @arg 更新恢复的K线时复制为私有数据，快照文件不变 */
+    KRecord last = expect_klist.back();
+    last.closePrice = last.highPrice;
+    last.transCount += 1.0;
+    sm["sh000001"].realtimeUpdate(last, KQuery::DAY);
+    CHECK_EQ(sm["sh000001"].getKRecordList(KQuery(-1)).back(), last);
+    CHECK_UNARY(sm.loadSnapshot(filename));
+    CHECK_EQ(sm["sh000001"].getKRecordList(KQuery(0)), expect_klist);
+
+    /** @arg 从数据源重新加载，恢复测试前的状态，并删除快照文件 */
+    sm.reload();
+    CHECK_EQ(sm.size(), total);
+    CHECK_EQ(sm["sh000001"].getKRecordList(KQuery(0)), expect_klist);
+    CHECK_UNARY(removeFile(filename));
+    CHECK_UNARY_FALSE(existFile(filename));
+}
+
+/** @par 检测点 */
+TEST_CASE("test_StockManager_reload") {
+    auto& sm = StockManager::instance();
+    size_t total = sm.size();
+    size_t block_total = sm.getBlockList().size();
+    Stock stk = sm["sh000001"];
+    REQUIRE(stk.isBuffer(KQuery::DAY));
+    KRecordList expect_klist = stk.getKRecordList(KQuery(0));
+    REQUIRE(!expect_klist.empty());
+
+    /** @arg 重新加载前通过实时行情更新的最后一根K线及追加的K线均补入新实例 */
+    KRecord origin_last = expect_klist.back();
+    KRecord last = origin_last;
+    last.highPrice = origin_last.highPrice + 1.0;
+    last.closePrice = origin_last.highPrice + 1.0;
+    last.transAmount = origin_last.transAmount + 100.0;
+    last.transCount = origin_last.transCount + 10.0;
+    stk.realtimeUpdate(last, KQuery::DAY);
+    expect_klist.back() = last;
+
+    Datetime d = expect_klist.back().datetime + Days(1);
+    while (d.dayOfWeek() == 0 || d.dayOfWeek() == 6) {
+        d = d + Days(1);
+    }
+    KRecord k(d, 10.0, 11.0, 9.0, 10.5, 1000.0, 100.0);
+    stk.realtimeUpdate(k, KQuery::DAY);
+    expect_klist.push_back(k);
+    REQUIRE(stk.getKRecordList(KQuery(0)) == expect_klist);
+
+    sm.reload();
+    CHECK_EQ(sm.size(), total);
+    CHECK_EQ(sm.getBlockList().size(), block_total);
+
+    Stock new_stk = sm["sh000001"];
+    CHECK_NE(new_stk, stk);
+    CHECK_EQ(new_stk.name(), stk.name());
+    CHECK_UNARY(new_stk.isBuffer(KQuery::DAY));
+    CHECK_EQ(new_stk.getKRecordList(KQuery(0)), expect_klist);
+
+    /** @arg 板块中的证券为重新加载后的证券实例 */
+    for (const auto& blk : sm.getBlockList()) {
+        for (const auto& blk_stk : blk.getStockList()) {
+            CHECK_EQ(blk_stk, sm.getStock(blk_stk.market_code()));
+        }
+    }
+
+    /** @arg 原实例仍可继续使用 */
+    CHECK_EQ(stk.getKRecordList(KQuery(0)), expect_klist);
+
+    /** @arg 实时行情更新写入新实例 */
+    KRecord update(d, 10.0, 12.0, 9.0, 11.5, 2000.0, 200.0);
+    sm["sh000001"].realtimeUpdate(update, KQuery::DAY);
+    CHECK_EQ(new_stk.getKRecordList(KQuery(-1)).back(), update);
+    CHECK_EQ(stk.getKRecordList(KQuery(-1)).back(), k);
+
+    // 恢复为数据源中的K线
+    new_stk.loadKDataToBuffer(KQuery::DAY);
+    expect_klist.pop_back();
+    expect_klist.back() = origin_last;
+    CHECK_EQ(new_stk.getKRecordList(KQuery(0)), expect_klist);
+}
+
 /** @} */
@@ -0,0 +1,115 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#include "doctest/doctest.h"
+#include <hikyuu/StockManager.h>
+#include <hikyuu/TradingCalendar.h>
+
+using namespace hku;
+
+/**
+ * @defgroup test_hikyuu_TradingCalendar test_hikyuu_TradingCalendar
+ * @ingroup test_hikyuu_base_suite
+ * @{
+ */
+
+/** @par 检测点 */
+TEST_CASE("test_TradingCalendar") {
+    /** @arg 空日历 */
+    TradingCalendar empty;
+    CHECK_EQ(empty.size(), 0);
+    CHECK_EQ(empty.ordinal(Datetime(20240101)), 0);
+    CHECK_UNARY(empty.getDatetimeList(KQuery(0)).empty());
+
+    DatetimeList dates{Datetime(20240102), Datetime(20240103), Datetime(20240105),
+                       Datetime(20240108), Datetime(20240109)};
+    TradingCalendar calendar(dates);
+    CHECK_EQ(calendar.size(), 5);
+
+    /** @arg 日期早于第一个交易日 */
+    CHECK_EQ(calendar.ordinal(Datetime(20231231)), 0);
+
+    /** @arg 交易日及非交易日 */
+    CHECK_EQ(calendar.ordinal(Datetime(20240102)), 0);
+    CHECK_EQ(calendar.ordinal(Datetime(20240104)), 2);
+    CHECK_EQ(calendar.ordinal(Datetime(20240106)), 3);
+    CHECK_EQ(calendar.ordinal(Datetime(20240107)), 3);
+    CHECK_UNARY(calendar.contains(Datetime(20240105)));
+    CHECK_UNARY_FALSE(calendar.contains(Datetime(20240106)));
+
+    /** @arg 带有时分秒的日期 */
+    CHECK_EQ(calendar.ordinal(Datetime(202401030001)), 2);
+    CHECK_EQ(calendar.ordinal(Datetime(202401091500)), 5);
+
+    /** @arg 日期晚于最后一个交易日及 Null */
+    CHECK_EQ(calendar.ordinal(Datetime(20240110)), 5);
+    CHECK_EQ(calendar.ordinal(Null<Datetime>()), 5);
+
+    /** @arg 按日期查询 */
+    DatetimeList result = calendar.getDatetimeList(
+      KQueryByDate(Datetime(20240103), Datetime(20240108), KQuery::DAY));
+    DatetimeList expect{Datetime(20240103), Datetime(20240105)};
+    CHECK_EQ(result, expect);
+    CHECK_UNARY(
+      calendar.getDatetimeList(KQueryByDate(Datetime(20240106), Datetime(20240107))).empty());
+
+    /** @arg 按索引查询 */
+    result = calendar.getDatetimeList(KQuery(-2));
+    expect = DatetimeList{Datetime(20240108), Datetime(20240109)};
+    CHECK_EQ(result, expect);
+    result = calendar.getDatetimeList(KQuery(1, 3));
+    expect = DatetimeList{Datetime(20240103), Datetime(20240105)};
+    CHECK_EQ(result, expect);
+}
+
+/** @par 检测点 */
+TEST_CASE("test_StockManager_getTradingCalendarIndex") {
+    StockManager& sm = StockManager::instance();
+    Stock stk = sm["sh000001"];
+
+    auto calendar = sm.getTradingCalendarIndex("SH");
+    REQUIRE(calendar);
+    CHECK_EQ(calendar->size(), stk.getCount(KQuery::DAY));
+
+    /** @arg 未发生变化时共享同一实例 */
+    CHECK_EQ(calendar.get(), sm.getTradingCalendarIndex("sh").get());
+
+    /** @arg 与指数日线日期一致 */
+    KQuery query = KQueryByDate(Datetime(201101010000L), Datetime(201201010000L), KQuery::DAY);
+    CHECK_EQ(sm.getTradingCalendar(query), stk.getDatetimeList(query));
+    query = KQuery(-100);
+    CHECK_EQ(sm.getTradingCalendar(query), stk.getDatetimeList(query));
+}
+
+/** @par 检测点 */
+TEST_CASE("test_Stock_getIndexRange_by_day_index") {
+    StockManager& sm = StockManager::instance();
+    Stock stk = sm["sz000001"];
+    KRecordList klist = stk.getKRecordList(KQuery(0));
+    REQUIRE(klist.size() > 100);
+
+    /** @arg 日线日期位置查询与二分查找结果一致 */
+    for (size_t i = 0; i < klist.size(); i += 37) {
+        Datetime start = klist[i].datetime;
+        Datetime end = start + Days(10);
+        size_t out_start = 0, out_end = 0;
+        CHECK_UNARY(stk.getIndexRange(KQueryByDate(start, end, KQuery::DAY), out_start, out_end));
+        auto low = std::lower_bound(
+          klist.begin(), klist.end(), end,
+          [](const KRecord& k, const Datetime& d) { return k.datetime < d; });
+        CHECK_EQ(out_start, i);
+        CHECK_EQ(out_end, size_t(low - klist.begin()));
+
+        /** @arg 带有时分秒的日期 */
+        if (stk.getIndexRange(KQueryByDate(start + Minutes(1), end, KQuery::DAY), out_start,
+                              out_end)) {
+            CHECK_EQ(out_start, i + 1);
+        }
+    }
+}
+
+/** @} */
@@ -187,4 +187,58 @@ TEST_CASE("test_TransList_query_by_date") {
     CHECK_EQ(result[2], TransRecord(Datetime(2019, 2, 11, 15, 0, 0), 11.21, 5794, TransRecord::AUCTION));
 }
 
+/** @par 检测点 */
+TEST_CASE("test_TransList_cursor") {
+    StockManager& sm = StockManager::instance();
+    Stock stock = sm["sz000001"];
+
+    // 按小批量读取全部批次并拼接
+    auto read_all = [&stock](const KQuery& query, size_t batch_size) {
+        auto cursor = stock.getTransListCursor(query, batch_size);
+        TransList result, batch;
+        while (cursor.next(batch)) {
+            CHECK_UNARY(batch.size() <= batch_size);
+            result.insert(result.end(), batch.begin(), batch.end());
+        }
+        CHECK_UNARY(cursor.done());
+        CHECK_EQ(cursor.position(), cursor.total());
+        CHECK_EQ(cursor.total(), result.size());
+        return result;
+    };
+
+    /** @arg 按索引、日期查询，分批读取结果与一次性读取一致 */
+    KQuery queries[] = {KQuery(0), KQuery(10, 1000), KQuery(-500), KQuery(1, 1),
+                        KQueryByDate(Datetime(201902010000)),
+                        KQueryByDate(Datetime(201902010000), Datetime(201902110000)),
+                        KQueryByDate(Datetime(201902120000))};
+    for (const auto& query : queries) {
+        TransList expect = stock.getTransList(query);
+        TransList result = read_all(query, 97);
+        CHECK_UNARY(result == expect);
+    }
+
+    /** @arg 由全部记录构造的游标按批次切分 */
+    TransList all = stock.getTransList(KQuery(0));
+    size_t total = all.size();
+    RecordCursor<TransRecord> cursor(TransList(all), 1000);
+    CHECK_EQ(cursor.total(), total);
+    TransList batch;
+    size_t count = 0;
+    while (cursor.next(batch)) {
+        REQUIRE(count + batch.size() <= total);
+        CHECK_EQ(batch.front(), all[count]);
+        count += batch.size();
+    }
+    CHECK_EQ(count, total);
+    CHECK_UNARY(batch.empty());
+
+    /** @arg 空游标 */
+    RecordCursor<TransRecord> empty_cursor;
+    CHECK_EQ(empty_cursor.total(), 0);
+    CHECK_UNARY(!empty_cursor.next(batch));
+
+    /** @arg 无效证券 */
+    CHECK_EQ(Stock().getTransListCursor(KQuery(0)).total(), 0);
+}
+
 /** @} */
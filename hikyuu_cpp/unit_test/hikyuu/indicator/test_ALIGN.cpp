@@ -318,6 +318,88 @@ TEST_CASE("test_ALIGN_not_fill_null") {
     }
 }
 
+/** @par 检测点 */
+TEST_CASE("test_ALIGN_datetime_index") {
+    Stock stk = getStock("sh000001");
+    KData k = stk.getKData(KQuery(-10));
+    Indicator data = CLOSE(k);
+
+    /** @arg 共享日期索引，结果与按日期列表对齐相同 */
+    DatetimeList ref;
+    ref.push_back(Datetime(201111220000));
+    ref.push_back(Datetime(201111230000));
+    ref.push_back(Datetime(201111260000));
+    ref.push_back(Datetime(201112070000));
+    DatetimeIndexPtr ref_index = makeDatetimeIndex(ref);
+    CHECK_EQ(ref_index->size(), ref.size());
+    for (bool fill_null : {false, true}) {
+        Indicator expect = ALIGN(data, ref, fill_null);
+        Indicator result = ALIGN(data, ref_index, fill_null);
+        Indicator result2 = ALIGN(CLOSE(k) + 1.0, ref_index, fill_null);
+        CHECK_EQ(result.name(), "ALIGN");
+        CHECK_EQ(result.size(), expect.size());
+        CHECK_EQ(result.discard(), expect.discard());
+        CHECK_EQ(result2.discard(), expect.discard());
+        CHECK_UNARY(result.getDatetimeList() == ref);
+        for (size_t i = result.discard(); i < result.size(); i++) {
+            CHECK_EQ(result[i], doctest::Approx(expect[i]));
+            CHECK_EQ(result2[i], doctest::Approx(expect[i] + 1.0));
+        }
+    }
+
+    /** @arg 由日期索引构造时不复制日期至参数，日期查询取自索引 */
+    Indicator result = ALIGN(data, ref_index);
+    CHECK_UNARY(result.getParam<DatetimeList>("align_date_list").empty());
+    CHECK_EQ(result.getDatetime(2), ref[2]);
+    CHECK_EQ(result.getDatetime(ref.size()), Null<Datetime>());
+    CHECK_EQ(result.getPos(ref[3]), 3);
+    CHECK_EQ(result.getPos(Datetime(201111240000)), Null<size_t>());
+    Indicator cloned = result.clone();
+    CHECK_UNARY(cloned.getDatetimeList() == ref);
+
+    /** @arg 以日期索引对齐的结果作为输入再次对齐 */
+    Indicator expect = ALIGN(ALIGN(data, ref), k.getDatetimeList(), false);
+    Indicator realign = ALIGN(result, makeDatetimeIndex(k.getDatetimeList()), false);
+    CHECK_EQ(realign.size(), expect.size());
+    CHECK_EQ(realign.discard(), expect.discard());
+    for (size_t i = realign.discard(); i < realign.size(); i++) {
+        CHECK_EQ(realign[i], doctest::Approx(expect[i]));
+    }
+
+    /** @arg 修改 align_date_list 参数后按新的日期对齐 */
+    result = ALIGN(ref_index);
+    result.setParam<DatetimeList>("align_date_list", k.getDatetimeList());
+    result = result(data);
+    CHECK_EQ(result.size(), k.size());
+    CHECK_EQ(result.discard(), 0);
+    CHECK_UNARY(result.getDatetimeList() == k.getDatetimeList());
+    result.setParam<DatetimeList>("align_date_list", ref);
+    result = result(data);
+    CHECK_EQ(result.size(), ref.size());
+    CHECK_UNARY(result.getDatetimeList() == ref);
+
+    /** @arg 日期与参考日期完全相同 */
+    result = ALIGN(data, makeDatetimeIndex(k.getDatetimeList()));
+    CHECK_EQ(result.size(), data.size());
+    CHECK_EQ(result.discard(), data.discard());
+    for (size_t i = 0; i < result.size(); i++) {
+        CHECK_EQ(result[i], data[i]);
+    }
+
+    /** @arg 参考日期位于两个源日期之间，其后的参考日期仍能对应到下一个源日期 */
+    ref.clear();
+    ref.push_back(k[0].datetime + Hours(1));
+    ref.push_back(k[1].datetime);
+    result = ALIGN(data, ref, true);
+    CHECK_EQ(result.discard(), 1);
+    CHECK_UNARY(std::isnan(result[0]));
+    CHECK_EQ(result[1], doctest::Approx(data[1]));
+    result = ALIGN(data, ref, false);
+    CHECK_EQ(result.discard(), 0);
+    CHECK_EQ(result[0], doctest::Approx(data[0]));
+    CHECK_EQ(result[1], doctest::Approx(data[1]));
+}
+
 //-----------------------------------------------------------------------------
 // test export
 //-----------------------------------------------------------------------------
@@ -331,7 +413,8 @@ TEST_CASE("test_ALIGN_export") {
 
     Stock stock = sm.getStock("sh000001");
     KData kdata = stock.getKData(KQuery(-20));
-    Indicator x1 = ALIGN(CLOSE(kdata), sm.getStock("sh600004").getDatetimeList(KQuery(-20)));
+    DatetimeList ref_dates = sm.getStock("sh600004").getDatetimeList(KQuery(-20));
+    Indicator x1 = ALIGN(CLOSE(kdata), ref_dates);
     {
         std::ofstream ofs(filename);
         boost::archive::xml_oarchive oa(ofs);
@@ -352,6 +435,7 @@ TEST_CASE("test_ALIGN_export") {
     for (size_t i = 0; i < x1.size(); ++i) {
         CHECK_EQ(x1[i], doctest::Approx(x2[i]));
     }
+    CHECK_UNARY(x2.getDatetimeList() == ref_dates);
 }
 #endif /* #if HKU_SUPPORT_SERIALIZATION */
 
@@ -0,0 +1,202 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#include "../test_config.h"
+#include <hikyuu/StockManager.h>
+#include <hikyuu/indicator/BlockPanel.h>
+#include <hikyuu/indicator/crt/ALIGN.h>
+#include <hikyuu/indicator/crt/BLOCKSETNUM.h>
+#include <hikyuu/indicator/crt/INSUM.h>
+#include <hikyuu/indicator/crt/KDATA.h>
+
+using namespace hku;
+
+/**
+ * @defgroup test_indicator_INSUM test_indicator_INSUM
+ * @ingroup test_hikyuu_indicator_suite
+ * @{
+ */
+
+/** @par 检测点 */
+TEST_CASE("test_INSUM") {
+    Block blk;
+    blk.add("sh600000");
+    blk.add("sh600004");
+    blk.add("sz000001");
+    blk.add("sh000001");
+
+    KData k = getStock("sh600004").getKData(KQuery(-100));
+    DatetimeList dates = k.getDatetimeList();
+    size_t total = dates.size();
+    REQUIRE(total == 100);
+
+    // 逐证券对齐后的收盘价，作为逐元素计算的参照
+    vector<Indicator> inds;
+    for (const auto& stk : blk.getStockList()) {
+        inds.push_back(ALIGN(CLOSE(), dates, true)(stk.getKData(k.getQuery())));
+    }
+    Indicator self = CLOSE()(k);
+
+    auto check = [&](int mode, const std::function<Indicator::value_t(size_t)>& expect) {
+        Indicator result = INSUM(blk, CLOSE(), mode)(k);
+        REQUIRE(result.size() == total);
+        for (size_t i = 0; i < total; i++) {
+            Indicator::value_t e = expect(i);
+            if (std::isnan(e)) {
+                CHECK_UNARY(std::isnan(result[i]));
+            } else {
+                CHECK_EQ(result[i], doctest::Approx(e));
+            }
+        }
+    };
+
+    auto sum_count = [&](size_t i, Indicator::value_t& sum) {
+        size_t count = 0;
+        sum = 0.0;
+        for (const auto& ind : inds) {
+            if (!std::isnan(ind[i])) {
+                sum += ind[i];
+                count++;
+            }
+        }
+        return count;
+    };
+
+    /** @arg 累加、平均、最大、最小 */
+    check(0, [&](size_t i) {
+        Indicator::value_t sum;
+        return sum_count(i, sum) > 0 ? sum : Null<Indicator::value_t>();
+    });
+    check(1, [&](size_t i) {
+        Indicator::value_t sum;
+        size_t count = sum_count(i, sum);
+        return count > 0 ? sum / count : Null<Indicator::value_t>();
+    });
+    check(2, [&](size_t i) {
+        Indicator::value_t ret = Null<Indicator::value_t>();
+        for (const auto& ind : inds) {
+            if (!std::isnan(ind[i]) && (std::isnan(ret) || ind[i] > ret)) {
+                ret = ind[i];
+            }
+        }
+        return ret;
+    });
+    check(3, [&](size_t i) {
+        Indicator::value_t ret = Null<Indicator::value_t>();
+        for (const auto& ind : inds) {
+            if (!std::isnan(ind[i]) && (std::isnan(ret) || ind[i] < ret)) {
+                ret = ind[i];
+            }
+        }
+        return ret;
+    });
+
+    /** @arg 排名、百分位、去均值 */
+    check(4, [&](size_t i) {
+        Indicator::value_t rank = 1.0;
+        for (const auto& ind : inds) {
+            rank += ind[i] > self[i] ? 1.0 : 0.0;
+        }
+        return rank;
+    });
+    check(5, [&](size_t i) {
+        Indicator::value_t le = 0.0, sum;
+        size_t count = sum_count(i, sum);
+        for (const auto& ind : inds) {
+            le += ind[i] <= self[i] ? 1.0 : 0.0;
+        }
+        return le / count;
+    });
+    check(6, [&](size_t i) {
+        Indicator::value_t sum;
+        size_t count = sum_count(i, sum);
+        return self[i] - sum / count;
+    });
+
+    /** @arg 无上下文时排名无效 */
+    Indicator result = INSUM(blk, KQuery(-10), CLOSE(), 4);
+    CHECK_EQ(result.size(), 10);
+    CHECK_EQ(result.discard(), 10);
+
+    /** @arg 非法模式 */
+    CHECK_THROWS_AS(INSUM(blk, CLOSE(), 7), std::exception);
+}
+
+/** @par 检测点 */
+TEST_CASE("test_BLOCKSETNUM") {
+    Block blk;
+    blk.add("sh600000");
+    blk.add("sh600004");
+    blk.add("sz000001");
+
+    KQuery query = KQueryByIndex(-100);
+    DatetimeList dates = StockManager::instance().getTradingCalendar(query, "SH");
+    Indicator result = BLOCKSETNUM(blk, query);
+    REQUIRE(result.size() == dates.size());
+
+    /** @arg 每日成分数量与逐日判断上市区间一致 */
+    BlockMembership membership(blk.getStockList(), dates);
+    StockList stks = blk.getStockList();
+    for (size_t i = 0; i < dates.size(); i++) {
+        size_t count = 0;
+        for (size_t s = 0; s < stks.size(); s++) {
+            Datetime last = stks[s].lastDatetime().isNull() ? Datetime::max()
+                                                            : stks[s].lastDatetime();
+            bool in = dates[i] >= stks[s].startDatetime() && dates[i] <= last;
+            CHECK_EQ(membership.isMember(s, i), in);
+            count += in ? 1 : 0;
+        }
+        CHECK_EQ(result[i], count);
+    }
+}
+
+/** @par 检测点 */
+TEST_CASE("test_BlockPanel") {
+    StockList stks{getStock("sh600000"), getStock("sh600004")};
+    DatetimeList dates{Datetime(20111201), Datetime(20111202), Datetime(20111205)};
+    BlockPanel panel(stks, dates);
+    REQUIRE(panel.stockCount() == 2);
+    REQUIRE(panel.dateCount() == 3);
+
+    /** @arg 未加载时全部为 Null */
+    vector<Indicator::value_t> dst(3);
+    panel.sum(dst.data());
+    CHECK_UNARY(std::isnan(dst[0]));
+
+    /** @arg 缺失值被忽略 */
+    Indicator::value_t* row0 = panel.row(0);
+    Indicator::value_t* row1 = panel.row(1);
+    row0[0] = 1.0;
+    row0[1] = 2.0;
+    row1[1] = 4.0;
+    panel.sum(dst.data());
+    CHECK_EQ(dst[0], 1.0);
+    CHECK_EQ(dst[1], 6.0);
+    CHECK_UNARY(std::isnan(dst[2]));
+    panel.mean(dst.data());
+    CHECK_EQ(dst[1], 3.0);
+    panel.max(dst.data());
+    CHECK_EQ(dst[0], 1.0);
+    CHECK_EQ(dst[1], 4.0);
+    panel.min(dst.data());
+    CHECK_EQ(dst[1], 2.0);
+
+    vector<Indicator::value_t> x{1.0, 3.0, 1.0};
+    panel.rank(x.data(), dst.data());
+    CHECK_EQ(dst[0], 1.0);
+    CHECK_EQ(dst[1], 2.0);
+    CHECK_UNARY(std::isnan(dst[2]));
+    panel.percentile(x.data(), dst.data());
+    CHECK_EQ(dst[0], 1.0);
+    CHECK_EQ(dst[1], 0.5);
+    panel.demean(x.data(), dst.data());
+    CHECK_EQ(dst[0], 0.0);
+    CHECK_EQ(dst[1], 0.0);
+    CHECK_UNARY(std::isnan(dst[2]));
+}
+
+/** @} */
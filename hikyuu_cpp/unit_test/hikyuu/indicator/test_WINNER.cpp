@@ -11,7 +11,8 @@
 #include <hikyuu/indicator/crt/WINNER.h>
 #include <hikyuu/indicator/crt/COST.h>
 #include <hikyuu/indicator/crt/KDATA.h>
-#include <hikyuu/indicator/crt/WINNER.h>
+#include <hikyuu/indicator/crt/PRICELIST.h>
+#include <hikyuu/indicator/ChipDistribution.h>
 
 /**
  * @defgroup test_indicator_WINNER test_indicator_WINNER
@@ -19,6 +20,32 @@
  * @{
  */
 
+// 按成本分布的定义 DMA(CLOSE + (HIGH - LOW) * percent / 100, 换手率) 逐根计算，
+// 换手率 = 成交手数 / 当日适用的流通盘（万股） * 0.01，流通盘为 0 的权息被忽略
+static PriceList expectCost(const KData& k, double percent) {
+    size_t total = k.size();
+    PriceList result(total, Null<price_t>());
+    StockWeightList sw_list = k.getStock().getWeight();
+    price_t free_count = 0.0;
+    price_t pre = Null<price_t>();
+    for (size_t i = 0; i < total; i++) {
+        const KRecord& r = k[i];
+        for (const auto& sw : sw_list) {
+            if (sw.datetime() <= r.datetime && sw.freeCount() > 0.0) {
+                free_count = sw.freeCount();
+            }
+        }
+        if (free_count <= 0.0) {
+            continue;
+        }
+        price_t x = r.closePrice + (r.highPrice - r.lowPrice) * percent * 0.01;
+        price_t a = r.transCount / free_count * 0.01;
+        pre = std::isnan(pre) ? x : a * x + (1.0 - a) * pre;
+        result[i] = pre;
+    }
+    return result;
+}
+
 /** @par 检测点 */
 TEST_CASE("test_WINNER") {
     auto k = getKData("sz000001", KQueryByIndex(-50));
@@ -29,6 +56,91 @@ TEST_CASE("test_WINNER") {
 
     auto cost = COST(k, 76);
     CHECK_EQ(k[1].closePrice, doctest::Approx(k[1].closePrice).epsilon(0.01));
+
+    /** @arg 获利盘比例为收盘价在按定义计算的 0%、100% 成本之间的线性插值 */
+    PriceList cost0 = expectCost(k, 0.0);
+    PriceList cost100 = expectCost(k, 100.0);
+    for (size_t i = result.discard(); i < result.size(); i++) {
+        REQUIRE_UNARY(!std::isnan(cost0[i]));
+        price_t close = k[i].closePrice;
+        price_t expect = (close - cost0[i]) / (cost100[i] - cost0[i]);
+        if (close >= cost100[i]) {
+            expect = 1.0;
+        } else if (close <= cost0[i]) {
+            expect = 0.0;
+        }
+        CHECK_EQ(result[i], doctest::Approx(expect).epsilon(0.00001));
+        CHECK_GE(result[i], 0.0);
+        CHECK_LE(result[i], 1.0);
+    }
+
+    /** @arg 无上下文 */
+    result = WINNER(PRICELIST(k.close().getResult(0)));
+    CHECK_EQ(result.size(), k.size());
+    CHECK_EQ(result.discard(), k.size());
+}
+
+/** @par 检测点 */
+TEST_CASE("test_ChipDistribution") {
+    auto k = getKData("sz000001", KQueryByIndex(-50));
+    size_t total = k.size();
+    PriceList base(total), range(total);
+    ChipDistribution::calculate(k, base.data(), range.data());
+
+    /** @arg 与按定义计算的 0%、50%、100% 成本一致 */
+    PriceList cost0 = expectCost(k, 0.0);
+    PriceList cost50 = expectCost(k, 50.0);
+    PriceList cost100 = expectCost(k, 100.0);
+    size_t valid = 0;
+    for (size_t i = 0; i < total; i++) {
+        if (std::isnan(cost0[i])) {
+            CHECK_UNARY(std::isnan(base[i]));
+            continue;
+        }
+        valid++;
+        CHECK_EQ(base[i], doctest::Approx(cost0[i]).epsilon(0.00001));
+        CHECK_EQ(base[i] + range[i] * 0.5, doctest::Approx(cost50[i]).epsilon(0.00001));
+        CHECK_EQ(base[i] + range[i], doctest::Approx(cost100[i]).epsilon(0.00001));
+    }
+    CHECK_EQ(valid, total);
+
+    /** @arg COST 与按定义计算的结果一致 */
+    auto cost = COST(k, 50);
+    for (size_t i = cost.discard(); i < total; i++) {
+        CHECK_EQ(cost[i], doctest::Approx(cost50[i]).epsilon(0.00001));
+    }
+
+    /** @arg 增量更新与批量计算一致 */
+    ChipDistribution chip;
+    CHECK_UNARY(chip.empty());
+    CHECK_UNARY(std::isnan(chip.winner(10.0)));
+    price_t free_count = 100000.0;
+    PriceList turnover(total);
+    for (size_t i = 0; i < total; i++) {
+        turnover[i] = k[i].transCount / free_count * 0.01;
+        chip.update(k[i], turnover[i]);
+    }
+    CHECK_UNARY(!chip.empty());
+    price_t expect_base = k[0].closePrice;
+    price_t expect_range = k[0].highPrice - k[0].lowPrice;
+    for (size_t i = 1; i < total; i++) {
+        expect_base = turnover[i] * k[i].closePrice + (1.0 - turnover[i]) * expect_base;
+        expect_range =
+          turnover[i] * (k[i].highPrice - k[i].lowPrice) + (1.0 - turnover[i]) * expect_range;
+    }
+    CHECK_EQ(chip.base(), doctest::Approx(expect_base).epsilon(0.00001));
+    CHECK_EQ(chip.range(), doctest::Approx(expect_range).epsilon(0.00001));
+    CHECK_EQ(chip.cost(100), doctest::Approx(expect_base + expect_range).epsilon(0.00001));
+
+    /** @arg 获利盘比例 */
+    CHECK_EQ(chip.winner(chip.base() - 1.0), 0.0);
+    CHECK_EQ(chip.winner(chip.cost(100) + 1.0), 1.0);
+    CHECK_EQ(chip.winner(chip.cost(30)), doctest::Approx(0.3).epsilon(0.00001));
+    CHECK_UNARY(std::isnan(chip.winner(Null<price_t>())));
+
+    /** @arg reset */
+    chip.reset();
+    CHECK_UNARY(chip.empty());
 }
 
 //-----------------------------------------------------------------------------
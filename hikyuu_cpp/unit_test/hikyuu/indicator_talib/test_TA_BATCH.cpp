@@ -0,0 +1,134 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#include "../test_config.h"
+#include <hikyuu/StockManager.h>
+#include <hikyuu/indicator_talib/ta_crt.h>
+#include <hikyuu/indicator/crt/KDATA.h>
+#include <hikyuu/indicator/crt/PRICELIST.h>
+
+using namespace hku;
+
+/**
+ * @defgroup test_indicator_TA_BATCH test_indicator_TA_BATCH
+ * @ingroup test_hikyuu_indicator_suite
+ * @{
+ */
+
+static void check_same_indicator(const Indicator& result, const Indicator& expect) {
+    CHECK_EQ(result.name(), expect.name());
+    REQUIRE_EQ(result.size(), expect.size());
+    REQUIRE_EQ(result.getResultNumber(), expect.getResultNumber());
+    CHECK_EQ(result.discard(), expect.discard());
+    for (size_t r = 0; r < result.getResultNumber(); r++) {
+        for (size_t i = result.discard(); i < result.size(); i++) {
+            CHECK_EQ(result.get(i, r), doctest::Approx(expect.get(i, r)));
+        }
+    }
+}
+
+/** @par 检测点 */
+TEST_CASE("test_TA_BATCH") {
+    vector<KData> ks;
+    for (auto& code : {"sz000001", "sz000002", "sh600000", "sh600004", "sh000001"}) {
+        ks.emplace_back(getKData(code, KQuery(-100)));
+    }
+
+    /** @arg 输入为空 */
+    CHECK_UNARY(TA_BATCH(TA_OBV(), vector<KData>()).empty());
+    CHECK_UNARY(TA_BATCH(TA_RSI(14), IndicatorList()).empty());
+
+    /** @arg 依赖上下文的指标（K线输入、整数输出） */
+    IndicatorList result = TA_BATCH(TA_OBV(), ks);
+    REQUIRE_EQ(result.size(), ks.size());
+    for (size_t i = 0; i < ks.size(); i++) {
+        check_same_indicator(result[i], TA_OBV(ks[i]));
+    }
+
+    result = TA_BATCH(TA_CDL3INSIDE(), ks);
+    REQUIRE_EQ(result.size(), ks.size());
+    for (size_t i = 0; i < ks.size(); i++) {
+        check_same_indicator(result[i], TA_CDL3INSIDE(ks[i]));
+    }
+
+    /** @arg 指标公式 */
+    result = TA_BATCH(TA_RSI(CLOSE(), 14), ks);
+    REQUIRE_EQ(result.size(), ks.size());
+    for (size_t i = 0; i < ks.size(); i++) {
+        check_same_indicator(result[i], TA_RSI(CLOSE(ks[i]), 14));
+    }
+
+    /** @arg 多个输入指标 */
+    IndicatorList inputs;
+    for (const auto& k : ks) {
+        inputs.emplace_back(CLOSE(k));
+    }
+    result = TA_BATCH(TA_MINMAX(10), inputs);
+    REQUIRE_EQ(result.size(), inputs.size());
+    for (size_t i = 0; i < inputs.size(); i++) {
+        check_same_indicator(result[i], TA_MINMAX(inputs[i], 10));
+    }
+
+    /** @arg 参数变化后 lookback 随之变化 */
+    result = TA_BATCH(TA_RSI(CLOSE(), 5), ks);
+    REQUIRE_EQ(result.size(), ks.size());
+    for (size_t i = 0; i < ks.size(); i++) {
+        check_same_indicator(result[i], TA_RSI(CLOSE(ks[i]), 5));
+    }
+
+    /** @arg 超过线程内缓存保留上限的长序列，其后的计算不受影响 */
+    PriceList values(300000);
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = double(i % 1000);
+    }
+    result = TA_BATCH(TA_MINMAXINDEX(10), IndicatorList{PRICELIST(values)});
+    REQUIRE_EQ(result.size(), 1);
+    check_same_indicator(result[0], TA_MINMAXINDEX(PRICELIST(values), 10));
+    result = TA_BATCH(TA_MINMAXINDEX(10), inputs);
+    for (size_t i = 0; i < inputs.size(); i++) {
+        check_same_indicator(result[i], TA_MINMAXINDEX(inputs[i], 10));
+    }
+}
+
+//-----------------------------------------------------------------------------
+// benchmark
+//-----------------------------------------------------------------------------
+#if ENABLE_BENCHMARK_TEST
+TEST_CASE("test_TA_BATCH_benchmark") {
+    StockManager& sm = StockManager::instance();
+    vector<KData> ks;
+    for (const auto& stk : sm) {
+        ks.emplace_back(stk.getKData(KQuery(0)));
+    }
+
+    int cycle = 10;  // 测试循环次数
+
+    {
+        BENCHMARK_TIME_MSG(test_TA_BATCH_benchmark_one_by_one, cycle,
+                           fmt::format("stock num: {}", ks.size()));
+        SPEND_TIME_CONTROL(false);
+        for (int i = 0; i < cycle; i++) {
+            IndicatorList result;
+            Indicator ind = TA_RSI(CLOSE(), 14);
+            for (const auto& k : ks) {
+                result.emplace_back(ind(k));
+            }
+        }
+    }
+
+    {
+        BENCHMARK_TIME_MSG(test_TA_BATCH_benchmark_batch, cycle,
+                           fmt::format("stock num: {}", ks.size()));
+        SPEND_TIME_CONTROL(false);
+        for (int i = 0; i < cycle; i++) {
+            IndicatorList result = TA_BATCH(TA_RSI(CLOSE(), 14), ks);
+        }
+    }
+}
+#endif
+
+/** @} */
@@ -0,0 +1,247 @@
+/*
+ * test_CompactArchive.cpp
+ *
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#include "../test_config.h"
+#include <sstream>
+#include <hikyuu/StockManager.h>
+#include <hikyuu/serialization/compact_archive.h>
+#include <hikyuu/serialization/KQuery_serialization.h>
+#include <hikyuu/indicator/crt/MA.h>
+#include <hikyuu/indicator/crt/KDATA.h>
+#include <hikyuu/indicator/crt/PRICELIST.h>
+#include <hikyuu/trade_manage/crt/crtTM.h>
+#include <hikyuu/trade_sys/signal/build_in.h>
+#include <hikyuu/trade_sys/moneymanager/build_in.h>
+#include <hikyuu/trade_sys/system/build_in.h>
+
+using namespace hku;
+
+#if HKU_SUPPORT_SERIALIZATION && HKU_SUPPORT_BINARY_ARCHIVE && HKU_SUPPORT_XML_ARCHIVE
+
+/**
+ * @defgroup test_CompactArchive test_CompactArchive
+ * @ingroup test_hikyuu_serialize_suite
+ * @{
+ */
+
+template <typename T>
+static void xmlRoundTrip(const T& src, T& dst) {
+    std::stringstream buf;
+    {
+        boost::archive::xml_oarchive oa(buf);
+        oa << boost::serialization::make_nvp("obj", src);
+    }
+    boost::archive::xml_iarchive ia(buf);
+    ia >> boost::serialization::make_nvp("obj", dst);
+}
+
+template <typename T>
+static void compactRoundTrip(const T& src, T& dst) {
+    string buf;
+    CompactArchive::save(buf, src);
+    CHECK_UNARY(CompactArchive::isCompact(buf.data(), buf.size()));
+    CompactArchive::load(buf.data(), buf.size(), dst);
+}
+
+static void checkSameValue(Indicator::value_t a, Indicator::value_t b) {
+    if (std::isnan(a)) {
+        CHECK_UNARY(std::isnan(b));
+    } else {
+        CHECK_EQ(a, b);
+    }
+}
+
+/** @par 检测点 */
+TEST_CASE("test_CompactArchive_KQuery") {
+    KQuery q1 = KQueryByDate(Datetime(200101010000), Datetime(200102100000), KQuery::MIN5,
+                             KQuery::FORWARD);
+    KQuery q2, q3;
+    compactRoundTrip(q1, q2);
+    xmlRoundTrip(q1, q3);
+    CHECK_EQ(q2, q1);
+    CHECK_EQ(q2, q3);
+    CHECK_EQ(q2.kType(), KQuery::MIN5);
+    CHECK_EQ(q2.recoverType(), KQuery::FORWARD);
+
+    q1 = KQuery(-100);
+    compactRoundTrip(q1, q2);
+    CHECK_EQ(q2, q1);
+}
+
+/** @par 检测点 */
+TEST_CASE("test_CompactArchive_Indicator") {
+    const auto nan = Null<Indicator::value_t>();
+    const auto inf = std::numeric_limits<Indicator::value_t>::infinity();
+
+    /** @arg 包含 NaN/Inf 的指标结果按位保存，与 XML 存档结果一致 */
+    PriceList data{1.0, nan, inf, -inf, 5.125, 1.0 / 3.0};
+    Indicator ind1 = PRICELIST(data);
+    Indicator ind2, ind3;
+    compactRoundTrip(ind1, ind2);
+    xmlRoundTrip(ind1, ind3);
+    CHECK_EQ(ind2.name(), ind1.name());
+    CHECK_EQ(ind2.size(), ind1.size());
+    CHECK_EQ(ind3.size(), ind1.size());
+    CHECK_EQ(ind2.discard(), ind1.discard());
+    for (size_t i = 0; i < ind1.size(); i++) {
+        checkSameValue(ind2[i], ind1[i]);
+        checkSameValue(ind2[i], ind3[i]);
+    }
+
+    /** @arg 多结果集及指标参数 */
+    Stock stk = getStock("sh000001");
+    KData k = stk.getKData(KQuery(-100));
+    Indicator ma1 = MA(CLOSE(k), 10);
+    Indicator ma2;
+    compactRoundTrip(ma1, ma2);
+    CHECK_EQ(ma2.name(), "MA");
+    CHECK_EQ(ma2.getParam<int>("n"), 10);
+    CHECK_EQ(ma2.size(), ma1.size());
+    CHECK_EQ(ma2.discard(), ma1.discard());
+    CHECK_EQ(ma2.getResultNumber(), ma1.getResultNumber());
+    for (size_t i = ma1.discard(); i < ma1.size(); i++) {
+        CHECK_EQ(ma2[i], ma1[i]);
+    }
+
+    /** @arg 带文件头的 boost 二进制存档同样按内存块读写 */
+    std::stringstream buf;
+    {
+        boost::archive::binary_oarchive oa(buf);
+        oa << ind1;
+    }
+    Indicator ind4;
+    {
+        boost::archive::binary_iarchive ia(buf);
+        ia >> ind4;
+    }
+    CHECK_EQ(ind4.size(), ind1.size());
+    for (size_t i = 0; i < ind1.size(); i++) {
+        checkSameValue(ind4[i], ind1[i]);
+    }
+}
+
+/** @par 检测点 */
+TEST_CASE("test_CompactArchive_PriceList") {
+    PriceList src{1.0, Null<price_t>(), 3.0};
+    PriceList dst, xml_dst;
+    compactRoundTrip(src, dst);
+    xmlRoundTrip(src, xml_dst);
+    CHECK_EQ(dst.size(), 3);
+    CHECK_EQ(xml_dst.size(), 3);
+    CHECK_EQ(dst[0], 1.0);
+    CHECK_UNARY(std::isnan(dst[1]));
+    CHECK_EQ(dst[2], 3.0);
+}
+
+/** @par 检测点 */
+TEST_CASE("test_CompactArchive_TradeManager") {
+    Stock stk = getStock("sz000001");
+    TradeManagerPtr tm1 = crtTM(Datetime(199101010000), 100000);
+    tm1->buy(Datetime(199911170000), stk, 27.18, 1000);
+    tm1->sell(Datetime(200001040000), stk, 28.0, 500);
+
+    TradeManagerPtr tm2, tm3;
+    compactRoundTrip(tm1, tm2);
+    xmlRoundTrip(tm1, tm3);
+    REQUIRE(tm2);
+    REQUIRE(tm3);
+    CHECK_EQ(tm2->name(), tm1->name());
+    CHECK_EQ(tm2->initCash(), tm1->initCash());
+    CHECK_EQ(tm2->currentCash(), tm1->currentCash());
+    CHECK_EQ(tm2->currentCash(), tm3->currentCash());
+    CHECK_EQ(tm2->getTradeList().size(), tm1->getTradeList().size());
+    CHECK_EQ(tm2->getPositionList().size(), tm1->getPositionList().size());
+    CHECK_EQ(tm2->getHoldNumber(Datetime(200001050000), stk), 500);
+}
+
+/** @par 检测点 */
+TEST_CASE("test_CompactArchive_System") {
+    Stock stk = getStock("sz000001");
+    SystemPtr sys1 = SYS_Simple();
+    sys1->setTM(crtTM(Datetime(199101010000), 100000));
+    sys1->setSG(SG_Cross(MA(CLOSE(), 5), MA(CLOSE(), 10)));
+    sys1->setMM(MM_FixedCount(100));
+    sys1->setParam<bool>("buy_delay", false);
+    sys1->run(stk, KQuery(-200));
+
+    SystemPtr sys2, sys3;
+    compactRoundTrip(sys1, sys2);
+    xmlRoundTrip(sys1, sys3);
+    REQUIRE(sys2);
+    REQUIRE(sys3);
+    CHECK_EQ(sys2->name(), sys1->name());
+    CHECK_EQ(sys2->getParam<bool>("buy_delay"), false);
+    REQUIRE(sys2->getSG());
+    CHECK_EQ(sys2->getSG()->name(), sys1->getSG()->name());
+    REQUIRE(sys2->getMM());
+    CHECK_EQ(sys2->getMM()->getParam<double>("n"), 100.0);
+    REQUIRE(sys2->getTM());
+    CHECK_EQ(sys2->getTM()->currentCash(), sys1->getTM()->currentCash());
+    CHECK_EQ(sys2->getTM()->currentCash(), sys3->getTM()->currentCash());
+    CHECK_EQ(sys2->getTM()->getTradeList().size(), sys1->getTM()->getTradeList().size());
+    CHECK_EQ(sys2->getTradeRecordList().size(), sys1->getTradeRecordList().size());
+}
+
+/** @par 检测点 */
+TEST_CASE("test_CompactArchive_invalid") {
+    KQuery q(-10), result;
+    string buf;
+    CompactArchive::save(buf, q);
+
+    /** @arg 非紧凑存档 */
+    CHECK_UNARY_FALSE(CompactArchive::isCompact(buf.data(), 4));
+    CHECK_UNARY_FALSE(CompactArchive::isCompact(nullptr, 0));
+    CHECK_THROWS(CompactArchive::load(buf.data(), 4, result));
+
+    /** @arg 格式版本不匹配 */
+    string bad(buf);
+    bad[4] = char(CompactArchive::FORMAT_VERSION + 1);
+    CHECK_THROWS(CompactArchive::load(bad.data(), bad.size(), result));
+
+    /** @arg 平台标识不匹配 */
+    bad = buf;
+    bad[5] = char(bad[5] ^ 0x80);
+    CHECK_THROWS(CompactArchive::load(bad.data(), bad.size(), result));
+
+    /** @arg 截断的存档 */
+    CHECK_THROWS(CompactArchive::load(buf.data(), CompactArchive::HEADER_SIZE + 2, result));
+}
+
+/** @} */
+
+#if ENABLE_BENCHMARK_TEST
+TEST_CASE("test_CompactArchive_benchmark") {
+    PriceList data(100000);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = i % 97 == 0 ? Null<price_t>() : price_t(i) / 7.0;
+    }
+    Indicator ind = PRICELIST(data);
+    int cycle = 20;
+
+    {
+        BENCHMARK_TIME_MSG(test_CompactArchive_benchmark, cycle, "compact archive");
+        string buf;
+        for (int i = 0; i < cycle; i++) {
+            Indicator result;
+            CompactArchive::save(buf, ind);
+            CompactArchive::load(buf.data(), buf.size(), result);
+        }
+    }
+
+    {
+        BENCHMARK_TIME_MSG(test_CompactArchive_benchmark, cycle, "xml archive");
+        for (int i = 0; i < cycle; i++) {
+            Indicator result;
+            xmlRoundTrip(ind, result);
+        }
+    }
+}
+#endif
+
+#endif /* HKU_SUPPORT_SERIALIZATION && HKU_SUPPORT_BINARY_ARCHIVE && HKU_SUPPORT_XML_ARCHIVE */
@@ -0,0 +1,258 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#include "../test_config.h"
+#include <mutex>
+#include <hikyuu/trade_manage/crt/OB_Loopback.h>
+#include <hikyuu/trade_manage/imp/LoopbackOrderBroker.h>
+#include <hikyuu/trade_manage/OrderDispatcher.h>
+
+using namespace hku;
+
+/**
+ * @defgroup test_OrderBroker test_OrderBroker
+ * @ingroup test_hikyuu_trade_manage_suite
+ * @{
+ */
+
+// 仅用于测试：卖出时抛出异常
+class ErrorOrderBroker : public OrderBrokerBase {
+public:
+    ErrorOrderBroker() : OrderBrokerBase("ErrorOrderBroker") {}
+
+    virtual void _buy(Datetime datetime, const string& market, const string& code, price_t price,
+                      double num, price_t stoploss, price_t goalPrice, SystemPart from) override {
+    }
+
+    virtual void _sell(Datetime datetime, const string& market, const string& code,
+                       price_t price, double num, price_t stoploss, price_t goalPrice,
+                       SystemPart from) override {
+        HKU_THROW("test sell error");
+    }
+};
+
+// 仅用于测试：批量执行委托
+class BatchOrderBroker : public OrderBrokerBase {
+public:
+    BatchOrderBroker() : OrderBrokerBase("BatchOrderBroker") {}
+
+    virtual void _buy(Datetime datetime, const string& market, const string& code, price_t price,
+                      double num, price_t stoploss, price_t goalPrice, SystemPart from) override {
+    }
+
+    virtual void _sell(Datetime datetime, const string& market, const string& code,
+                       price_t price, double num, price_t stoploss, price_t goalPrice,
+                       SystemPart from) override {}
+
+    virtual void _sendOrders(BrokerOrderList& orders) override {
+        batch_sizes.push_back(orders.size());
+        for (auto& order : orders) {
+            order.success = true;
+        }
+    }
+
+    vector<size_t> batch_sizes;
+};
+
+/** @par 检测点 */
+TEST_CASE("test_OrderBroker_sync") {
+    auto broker = OB_Loopback(10000.0);
+    auto* loopback = dynamic_cast<LoopbackOrderBroker*>(broker.get());
+    REQUIRE(loopback);
+    CHECK_EQ(broker->name(), "OB_Loopback");
+    CHECK_UNARY_FALSE(broker->getParam<bool>("async"));
+
+    vector<BrokerOrder> orders;
+    broker->setOrderCallback([&orders](const BrokerOrder& order) { orders.push_back(order); });
+
+    /** @arg 同步模式下在当前线程中执行完毕 */
+    Datetime d(202401020000LL);
+    broker->buy(d, "SH", "600000", 10.0, 200.0, 9.0, 12.0, PART_SIGNAL);
+    broker->sell(d, "SH", "600000", 11.0, 100.0, 9.5, 12.5, PART_SIGNAL);
+    CHECK_EQ(broker->pendingOrders(), 0);
+    CHECK_EQ(loopback->getOrderCount(), 2);
+    CHECK_EQ(loopback->getCash(), doctest::Approx(10000.0 - 2000.0 + 1100.0));
+    CHECK_EQ(loopback->getPositionNumber("SH", "600000"), 100.0);
+
+    /** @arg 回调获取委托内容及各阶段时间戳 */
+    REQUIRE(orders.size() == 2);
+    CHECK_EQ(orders[0].business, BrokerOrder::BUY);
+    CHECK_EQ(orders[0].datetime, d);
+    CHECK_EQ(orders[0].market, "SH");
+    CHECK_EQ(orders[0].code, "600000");
+    CHECK_EQ(orders[0].price, 10.0);
+    CHECK_EQ(orders[0].num, 200.0);
+    CHECK_EQ(orders[0].stoploss, 9.0);
+    CHECK_EQ(orders[0].goalPrice, 12.0);
+    CHECK_EQ(orders[0].from, PART_SIGNAL);
+    CHECK_UNARY(orders[0].success);
+    CHECK_EQ(orders[1].business, BrokerOrder::SELL);
+    for (const auto& order : orders) {
+        CHECK_GT(order.signal_ns, 0);
+        CHECK_LE(order.signal_ns, order.submit_ns);
+        CHECK_LE(order.submit_ns, order.ack_ns);
+    }
+
+    /** @arg 耗时统计 */
+    CHECK_EQ(broker->getQueueLatency().count(), 2);
+    CHECK_EQ(broker->getAckLatency().count(), 2);
+    CHECK_EQ(broker->getTotalLatency().count(), 2);
+    broker->resetLatency();
+    CHECK_EQ(broker->getTotalLatency().count(), 0);
+
+    /** @arg 资产信息 */
+    string asset = broker->getAssetInfo();
+    CHECK_NE(asset.find("\"cash\":9100.0"), string::npos);
+    CHECK_NE(asset.find("\"code\":\"600000\""), string::npos);
+
+    /** @arg 代理接口异常时记录错误信息，不向外抛出 */
+    orders.clear();
+    broker->sell(d, "SH", "600001", 11.0, 100.0, 0.0, 0.0, PART_SIGNAL);
+    REQUIRE(orders.size() == 1);
+    CHECK_UNARY_FALSE(orders[0].success);
+    CHECK_UNARY_FALSE(orders[0].error.empty());
+    CHECK_EQ(loopback->getOrderCount(), 2);
+}
+
+/** @par 检测点 */
+TEST_CASE("test_OrderBroker_async") {
+    auto broker = OB_Loopback(0.0, 0, true);
+    auto* loopback = dynamic_cast<LoopbackOrderBroker*>(broker.get());
+    REQUIRE(loopback);
+
+    std::mutex mutex;
+    vector<BrokerOrder> orders;
+    std::thread::id callback_thread_id;
+    broker->setOrderCallback([&](const BrokerOrder& order) {
+        std::lock_guard<std::mutex> lock(mutex);
+        callback_thread_id = std::this_thread::get_id();
+        orders.push_back(order);
+    });
+
+    /** @arg 异步模式下由分发线程执行，同一代理的委托保持顺序 */
+    const int total = 1000;
+    Datetime d(202401020000LL);
+    for (int i = 0; i < total; i++) {
+        broker->buy(d, "SZ", "000001", 10.0, double(i + 1), 0.0, 0.0, PART_SIGNAL);
+    }
+    broker->waitOrders();
+    CHECK_EQ(broker->pendingOrders(), 0);
+    CHECK_EQ(loopback->getOrderCount(), total);
+    CHECK_EQ(loopback->getPositionNumber("SZ", "000001"), double(total * (total + 1) / 2));
+
+    REQUIRE(orders.size() == total);
+    CHECK_NE(callback_thread_id, std::this_thread::get_id());
+    size_t errors = 0;
+    for (int i = 0; i < total; i++) {
+        if (orders[i].num != double(i + 1) || !orders[i].success ||
+            orders[i].submit_ns < orders[i].signal_ns || orders[i].ack_ns < orders[i].submit_ns) {
+            errors++;
+        }
+    }
+    CHECK_EQ(errors, 0);
+    CHECK_EQ(broker->getTotalLatency().count(), total);
+    CHECK_GE(broker->getTotalLatency().percentile(99.0),
+             broker->getTotalLatency().percentile(50.0));
+
+    /** @arg 未由 shared_ptr 管理的实例同步执行 */
+    LoopbackOrderBroker local;
+    local.setParam<bool>("async", true);
+    local.buy(d, "SZ", "000001", 10.0, 100.0, 0.0, 0.0, PART_SIGNAL);
+    CHECK_EQ(local.pendingOrders(), 0);
+    CHECK_EQ(local.getOrderCount(), 1);
+}
+
+/** @par 检测点 */
+TEST_CASE("test_OrderBroker_async_error") {
+    auto broker = std::make_shared<ErrorOrderBroker>();
+    broker->setParam<bool>("async", true);
+
+    std::mutex mutex;
+    vector<BrokerOrder> orders;
+    broker->setOrderCallback([&](const BrokerOrder& order) {
+        std::lock_guard<std::mutex> lock(mutex);
+        orders.push_back(order);
+    });
+
+    /** @arg 代理接口异常不影响后续委托 */
+    Datetime d(202401020000LL);
+    broker->sell(d, "SZ", "000001", 10.0, 100.0, 0.0, 0.0, PART_SIGNAL);
+    broker->buy(d, "SZ", "000001", 10.0, 100.0, 0.0, 0.0, PART_SIGNAL);
+    broker->waitOrders();
+    REQUIRE(orders.size() == 2);
+    CHECK_UNARY_FALSE(orders[0].success);
+    CHECK_NE(orders[0].error.find("test sell error"), string::npos);
+    CHECK_UNARY(orders[1].success);
+}
+
+/** @par 检测点 */
+TEST_CASE("test_OrderDispatcher") {
+    OrderDispatcher dispatcher;
+    auto broker = std::make_shared<BatchOrderBroker>();
+
+    /** @arg 按代理分批执行，停止时执行完已接收的委托 */
+    const int total = 1000;
+    for (int i = 0; i < total; i++) {
+        BrokerOrder order;
+        order.broker = broker;
+        order.signal_ns = BrokerOrder::now();
+        CHECK_UNARY(dispatcher.submit(std::move(order)));
+    }
+    dispatcher.stop();
+    CHECK_UNARY_FALSE(dispatcher.isRunning());
+
+    size_t count = 0;
+    for (auto n : broker->batch_sizes) {
+        CHECK_LE(n, OrderDispatcher::MAX_BATCH);
+        count += n;
+    }
+    CHECK_EQ(count, total);
+    CHECK_EQ(broker->getAckLatency().count(), total);
+
+    /** @arg 停止后不再接收委托 */
+    BrokerOrder order;
+    order.broker = broker;
+    CHECK_UNARY_FALSE(dispatcher.submit(std::move(order)));
+}
+
+//-----------------------------------------------------------------------------
+// benchmark
+//-----------------------------------------------------------------------------
+#if ENABLE_BENCHMARK_TEST
+// 模拟每个委托确认耗时 20 微秒的订单代理，比较发出指令线程的阻塞时间
+TEST_CASE("test_OrderBroker_benchmark") {
+    const int total = 10000;
+    Datetime d(202401020000LL);
+
+    {
+        auto broker = OB_Loopback(0.0, 20, false);
+        {
+            BENCHMARK_TIME_MSG(test_OrderBroker_sync, total,
+                               fmt::format("sync broker, orders: {}", total));
+            for (int i = 0; i < total; i++) {
+                broker->buy(d, "SZ", "000001", 10.0, 100.0, 0.0, 0.0, PART_SIGNAL);
+            }
+        }
+        HKU_INFO("sync latency:\n{}", broker->getLatencyInfo());
+    }
+
+    {
+        auto broker = OB_Loopback(0.0, 20, true);
+        {
+            BENCHMARK_TIME_MSG(test_OrderBroker_async, total,
+                               fmt::format("async broker submit, orders: {}", total));
+            for (int i = 0; i < total; i++) {
+                broker->buy(d, "SZ", "000001", 10.0, 100.0, 0.0, 0.0, PART_SIGNAL);
+            }
+        }
+        broker->waitOrders();
+        HKU_INFO("async latency:\n{}", broker->getLatencyInfo());
+    }
+}
+#endif
+
+/** @} */
@@ -0,0 +1,183 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#include "../test_config.h"
+#include <hikyuu/trade_manage/TradeLedger.h>
+
+using namespace hku;
+
+/**
+ * @defgroup test_hikyuu_TradeLedger test_hikyuu_TradeLedger
+ * @ingroup test_hikyuu_trade_manage_suite
+ * @{
+ */
+
+static TradeRecord makeLedgerTestRecord(const Stock& stk, const Datetime& d, BUSINESS business,
+                                        price_t price, double number) {
+    return TradeRecord(stk, d, business, price, price, 0.0, number, CostRecord(), 0.0, 0.0,
+                       PART_INVALID);
+}
+
+// 按顺序遍历交易记录计算多头持仓，作为对照
+static double linearHoldNumber(const TradeRecordList& trades, const Datetime& datetime,
+                               const Stock& stk) {
+    double number = 0.0;
+    for (const auto& tr : trades) {
+        if (tr.datetime > datetime) {
+            break;
+        }
+        if (tr.stock == stk) {
+            if (BUSINESS_BUY == tr.business || BUSINESS_GIFT == tr.business ||
+                BUSINESS_CHECKIN_STOCK == tr.business) {
+                number += tr.number;
+            } else if (BUSINESS_SELL == tr.business || BUSINESS_CHECKOUT_STOCK == tr.business) {
+                number -= tr.number;
+            }
+        }
+    }
+    return number;
+}
+
+/** @par 检测点 */
+TEST_CASE("test_TradeLedger") {
+    Stock stk1("SH", "600000", "test1");
+    Stock stk2("SZ", "000001", "test2");
+    Stock stk3("SH", "600004", "test3");
+
+    TradeRecordList trades;
+    TradeLedger ledger;
+    auto add = [&](const TradeRecord& record) {
+        trades.push_back(record);
+        ledger.push_back(record);
+    };
+
+    CHECK_UNARY(ledger.empty());
+    add(makeLedgerTestRecord(Null<Stock>(), Datetime(20200101), BUSINESS_INIT, 100000.0, 0.0));
+    CHECK_EQ(ledger.size(), 1);
+    CHECK_EQ(ledger.getHoldNumber(stk1, ledger.countUntil(Datetime(20200101))), 0.0);
+
+    /** @arg 多只证券交替交易，与顺序遍历结果一致 */
+    add(makeLedgerTestRecord(stk1, Datetime(20200102), BUSINESS_BUY, 10.0, 100));
+    add(makeLedgerTestRecord(stk2, Datetime(20200102), BUSINESS_BUY, 20.0, 200));
+    add(makeLedgerTestRecord(stk1, Datetime(20200103), BUSINESS_GIFT, 0.0, 10));
+    add(makeLedgerTestRecord(Null<Stock>(), Datetime(20200103), BUSINESS_BORROW_CASH, 5000.0, 0));
+    add(makeLedgerTestRecord(stk1, Datetime(20200106), BUSINESS_SELL, 11.0, 50));
+    add(makeLedgerTestRecord(stk3, Datetime(20200106), BUSINESS_BORROW_STOCK, 5.0, 300));
+    add(makeLedgerTestRecord(stk3, Datetime(20200106), BUSINESS_SELL_SHORT, 5.0, 300));
+    add(makeLedgerTestRecord(stk2, Datetime(20200107), BUSINESS_SELL, 21.0, 200));
+    add(makeLedgerTestRecord(Null<Stock>(), Datetime(20200108), BUSINESS_RETURN_CASH, 2000.0, 0));
+    add(makeLedgerTestRecord(stk3, Datetime(20200108), BUSINESS_BUY_SHORT, 4.0, 100));
+    add(makeLedgerTestRecord(stk3, Datetime(20200108), BUSINESS_RETURN_STOCK, 4.0, 100));
+    CHECK_EQ(ledger.size(), trades.size());
+
+    DatetimeList dates = {Datetime(20191231), Datetime(20200101), Datetime(20200102),
+                          Datetime(202001021500), Datetime(20200103), Datetime(20200106),
+                          Datetime(20200107), Datetime(20200108), Datetime(20200301)};
+    for (const auto& d : dates) {
+        size_t count = ledger.countUntil(d);
+        CHECK_EQ(ledger.getHoldNumber(stk1, count), linearHoldNumber(trades, d, stk1));
+        CHECK_EQ(ledger.getHoldNumber(stk2, count), linearHoldNumber(trades, d, stk2));
+        CHECK_EQ(ledger.getHoldNumber(stk3, count), 0.0);
+    }
+
+    size_t count = ledger.countUntil(Datetime(20200106));
+    CHECK_EQ(count, 8);
+    CHECK_EQ(ledger.getHoldNumber(stk1, count), 60.0);
+    CHECK_EQ(ledger.getShortHoldNumber(stk3, count), 300.0);
+    CHECK_EQ(ledger.getDebtNumber(stk3, count), 300.0);
+    CHECK_EQ(ledger.getDebtCash(count), 5000.0);
+
+    count = ledger.countUntil(Datetime(20200108));
+    CHECK_EQ(ledger.getShortHoldNumber(stk3, count), 200.0);
+    CHECK_EQ(ledger.getDebtNumber(stk3, count), 200.0);
+    CHECK_EQ(ledger.getDebtCash(count), 3000.0);
+
+    /** @arg 相同证券的不同实例视为同一证券 */
+    Stock other_stk1("SH", "600000", "test1");
+    CHECK_EQ(ledger.getHoldNumber(other_stk1, count), 60.0);
+    CHECK_EQ(ledger.getHoldNumber(Null<Stock>(), count), 0.0);
+
+    /** @arg 按位置生成的交易记录与加入时一致 */
+    CostRecord cost(1.0, 2.0, 3.0, 4.0, 10.0);
+    add(TradeRecord(stk2, Datetime(20200109), BUSINESS_BUY, 20.5, 20.6, 25.0, 300, cost, 19.0,
+                    1234.5, PART_SIGNAL));
+    TradeRecord last = ledger.back();
+    CHECK_EQ(last, trades.back());
+    CHECK_EQ(last.stock, stk2);
+    CHECK_EQ(last.goalPrice, 25.0);
+    CHECK_EQ(last.cost, cost);
+    CHECK_EQ(last.stoploss, 19.0);
+    CHECK_EQ(last.cash, 1234.5);
+    CHECK_EQ(last.from, PART_SIGNAL);
+    CHECK_UNARY(ledger[0].stock.isNull());
+    CHECK_EQ(ledger.datetime(1), Datetime(20200102));
+    CHECK_EQ(ledger.business(1), BUSINESS_BUY);
+
+    TradeRecordList result = ledger.getTradeList();
+    CHECK_EQ(result.size(), trades.size());
+    for (size_t i = 0; i < trades.size(); i++) {
+        CHECK_EQ(result[i], trades[i]);
+    }
+
+    /** @arg 按日期范围获取交易记录 */
+    size_t start = ledger.lowerBound(Datetime(20200103));
+    size_t end = ledger.lowerBound(Datetime(20200107));
+    CHECK_EQ(start, 3);
+    CHECK_EQ(end, 8);
+    result = ledger.getTradeList(start, end);
+    CHECK_EQ(result.size(), 5);
+    CHECK_EQ(result.front(), trades[3]);
+    CHECK_EQ(result.back(), trades[7]);
+    CHECK_UNARY(ledger.getTradeList(end, start).empty());
+    CHECK_EQ(ledger.getTradeList(start, 100).size(), trades.size() - start);
+
+    /** @arg 清空后重新加入 */
+    ledger.clear();
+    CHECK_UNARY(ledger.empty());
+    CHECK_EQ(ledger.getHoldNumber(stk1, ledger.countUntil(Datetime(20200301))), 0.0);
+    trades.resize(3);
+    for (const auto& record : trades) {
+        ledger.push_back(record);
+    }
+    CHECK_EQ(ledger.size(), 3);
+    CHECK_EQ(ledger.getHoldNumber(stk1, ledger.countUntil(Datetime(20200301))), 100.0);
+    CHECK_EQ(ledger.getDebtCash(ledger.countUntil(Datetime(20200301))), 0.0);
+
+    /** @arg 交易日期无序时，遇到首个大于查询时刻的记录即停止累计 */
+    add(makeLedgerTestRecord(stk1, Datetime(20200110), BUSINESS_BUY, 10.0, 100));
+    add(makeLedgerTestRecord(stk1, Datetime(20200109), BUSINESS_BUY, 10.0, 100));
+    count = ledger.countUntil(Datetime(20200109));
+    CHECK_EQ(count, 3);
+    CHECK_EQ(ledger.getHoldNumber(stk1, count),
+             linearHoldNumber(trades, Datetime(20200109), stk1));
+
+    /** @arg 持仓历史记录索引 */
+    PositionRecordList history;
+    CHECK_EQ(ledger.getLastHistoryPos(stk1), Null<size_t>());
+    PositionRecord pos1;
+    pos1.stock = stk1;
+    pos1.number = 1;
+    history.push_back(pos1);
+    PositionRecord pos2;
+    pos2.stock = stk2;
+    history.push_back(pos2);
+    ledger.updateHistory(history);
+    CHECK_EQ(ledger.getLastHistoryPos(stk1), 0);
+    CHECK_EQ(ledger.getLastHistoryPos(stk2), 1);
+    pos1.number = 2;
+    history.push_back(pos1);
+    ledger.updateHistory(history);
+    CHECK_EQ(ledger.getLastHistoryPos(other_stk1), 2);
+    CHECK_EQ(ledger.getLastHistoryPos(stk3), Null<size_t>());
+
+    /** @arg 清空 */
+    ledger.clear();
+    CHECK_EQ(ledger.size(), 0);
+    CHECK_EQ(ledger.getLastHistoryPos(stk1), Null<size_t>());
+}
+
+/** @} */
@@ -14,6 +14,9 @@
 #include <hikyuu/indicator/crt/IC.h>
 #include <hikyuu/indicator/crt/ROCR.h>
 #include <hikyuu/indicator/crt/KDATA.h>
+#include <hikyuu/indicator/crt/ALIGN.h>
+#include <hikyuu/indicator/crt/PRICELIST.h>
+#include <hikyuu/indicator/crt/ZSCORE.h>
 #include <hikyuu/trade_sys/multifactor/crt/MF_EqualWeight.h>
 
 using namespace hku;
@@ -147,6 +150,140 @@ TEST_CASE("test_MF_EqualWeight") {
     }
 }
 
+/** @par 检测点 */
+TEST_CASE("test_MF_getAllSrcFactors") {
+    StockManager& sm = StockManager::instance();
+    StockList stks{sm["sh600004"], sm["sh600005"], sm["sz000001"], sm["sz000002"]};
+    Stock ref_stk = sm["sh000001"];
+    KQuery query = KQuery(-50);
+    IndicatorList src_inds{MA(CLOSE()), ROCR(CLOSE(), 3)};
+    auto mf = MF_EqualWeight(src_inds, stks, query, ref_stk);
+    const DatetimeList& ref_dates = mf->getDatetimeList();
+    size_t stk_count = stks.size();
+    size_t ind_count = src_inds.size();
+    size_t days_total = ref_dates.size();
+
+    /** @arg 未启用归一化及标准化，与逐个证券计算并对齐的原始因子一致 */
+    auto raw = mf->getAllSrcFactors();
+    CHECK_EQ(raw.size(), stk_count);
+    for (size_t si = 0; si < stk_count; si++) {
+        CHECK_EQ(raw[si].size(), ind_count);
+        for (size_t ii = 0; ii < ind_count; ii++) {
+            auto expect = ALIGN(src_inds[ii](stks[si].getKData(query)), ref_dates);
+            CHECK_UNARY(raw[si][ii].equal(expect));
+            CHECK_EQ(raw[si][ii].name(), src_inds[ii].name());
+        }
+    }
+
+    /** @arg 每日截面最小最大值归一化 */
+    mf->setParam<bool>("enable_min_max_normalize", true);
+    auto normalized = mf->getAllSrcFactors();
+    for (size_t ii = 0; ii < ind_count; ii++) {
+        for (size_t di = 0; di < days_total; di++) {
+            price_t min_value = Null<price_t>(), max_value = Null<price_t>();
+            for (size_t si = 0; si < stk_count; si++) {
+                price_t value = raw[si][ii][di];
+                if (!std::isnan(value)) {
+                    min_value = std::isnan(min_value) ? value : std::min(min_value, value);
+                    max_value = std::isnan(max_value) ? value : std::max(max_value, value);
+                }
+            }
+            for (size_t si = 0; si < stk_count; si++) {
+                if (std::isnan(min_value) || min_value == max_value ||
+                    std::isnan(raw[si][ii][di])) {
+                    CHECK_UNARY(std::isnan(normalized[si][ii][di]));
+                } else {
+                    CHECK_EQ(normalized[si][ii][di],
+                             doctest::Approx((raw[si][ii][di] - min_value) /
+                                             (max_value - min_value)));
+                }
+            }
+        }
+    }
+
+    /** @arg 每日截面标准化，与 ZSCORE 指标计算结果一致 */
+    mf->setParam<bool>("enable_min_max_normalize", false);
+    mf->setParam<bool>("enable_zscore", true);
+    mf->setParam<bool>("zscore_out_extreme", true);
+    mf->setParam<double>("zscore_nsigma", 1.0);
+    mf->setParam<bool>("zscore_recursive", false);
+    auto zscores = mf->getAllSrcFactors();
+    PriceList one_day(stk_count);
+    for (size_t ii = 0; ii < ind_count; ii++) {
+        for (size_t di = 0; di < days_total; di++) {
+            for (size_t si = 0; si < stk_count; si++) {
+                one_day[si] = raw[si][ii][di];
+            }
+            auto expect = ZSCORE(PRICELIST(one_day), true, 1.0, false);
+            for (size_t si = 0; si < stk_count; si++) {
+                if (std::isnan(expect[si])) {
+                    CHECK_UNARY(std::isnan(zscores[si][ii][di]));
+                } else {
+                    CHECK_EQ(zscores[si][ii][di], doctest::Approx(expect[si]));
+                }
+            }
+        }
+    }
+}
+
+/** @par 检测点 */
+TEST_CASE("test_MF_getScoreSpan") {
+    StockManager& sm = StockManager::instance();
+    StockList stks{sm["sh600000"], sm["sh600004"], sm["sh600005"], sm["sz000001"],
+                   sm["sz000002"]};
+    Stock ref_stk = sm["sh000001"];
+    KQuery query = KQuery(-30);
+    auto mf = MF_EqualWeight({MA(ROCR(CLOSE(), 3)), EMA(CLOSE())}, stks, query, ref_stk);
+    const auto& dates = mf->getDatetimeList();
+    const auto& all_factors = mf->getAllFactors();
+
+    /** @arg 不存在的日期 */
+    CHECK_UNARY(mf->getScoreSpan(Datetime(19000101)).empty());
+
+    /** @arg 先取部分再取全部，均降序排列且与原始因子值一致 */
+    for (size_t di = 0; di < dates.size(); di++) {
+        auto top2 = mf->getScoreSpan(dates[di], 2);
+        CHECK_EQ(top2.size(), 2);
+        auto cross = mf->getScoreSpan(dates[di]);
+        CHECK_EQ(cross.size(), stks.size());
+        CHECK_EQ(top2.data(), cross.data());
+        for (size_t i = 0; i < cross.size(); i++) {
+            CHECK_UNARY(
+              (std::isnan(cross[i].value) && std::isnan(all_factors[cross[i].index][di])) ||
+              cross[i].value == all_factors[cross[i].index][di]);
+            if (i > 0 && !std::isnan(cross[i].value)) {
+                CHECK_GE(cross[i - 1].value, cross[i].value);
+            }
+            if (i > 0 && std::isnan(cross[i - 1].value)) {
+                CHECK_UNARY(std::isnan(cross[i].value));
+            }
+        }
+
+        /** @arg 与 getScores、getAllScores 结果一致 */
+        auto scores = mf->getScores(dates[di], 1, 3);
+        CHECK_EQ(scores.size(), 2);
+        for (size_t i = 0; i < scores.size(); i++) {
+            CHECK_EQ(scores[i].stock, stks[cross[i + 1].index]);
+        }
+        const auto& all_scores = mf->getAllScores();
+        CHECK_EQ(all_scores.size(), dates.size());
+        CHECK_EQ(all_scores[di].size(), stks.size());
+        for (size_t i = 0; i < cross.size(); i++) {
+            CHECK_EQ(all_scores[di][i].stock, stks[cross[i].index]);
+        }
+    }
+
+    /** @arg 修改参数重新计算后缓存失效 */
+    mf->setParam<bool>("enable_min_max_normalize", true);
+    auto cross = mf->getScoreSpan(dates.back());
+    CHECK_EQ(cross.size(), stks.size());
+    const auto& new_factors = mf->getAllFactors();
+    for (size_t i = 0; i < cross.size(); i++) {
+        CHECK_EQ(cross[i].value, new_factors[cross[i].index][dates.size() - 1]);
+        CHECK_LE(cross[i].value, 1.0);
+    }
+}
+
 //-----------------------------------------------------------------------------
 // benchmark
 //-----------------------------------------------------------------------------
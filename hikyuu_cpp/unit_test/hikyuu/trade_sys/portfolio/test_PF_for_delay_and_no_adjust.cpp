@@ -15,6 +15,7 @@
 #include <hikyuu/trade_sys/system/crt/SYS_Simple.h>
 #include <hikyuu/trade_sys/signal/crt/SG_CrossGold.h>
 #include <hikyuu/trade_sys/moneymanager/crt/MM_FixedCount.h>
+#include <hikyuu/trade_sys/environment/crt/EV_TwoLine.h>
 #include <hikyuu/indicator/crt/KDATA.h>
 #include <hikyuu/indicator/crt/EMA.h>
 
@@ -47,4 +48,58 @@ TEST_CASE("test_PF_for_delay_and_no_adjust") {
     /** @arg */
 }
 
+// 分别以串行、并行方式运行同一组子系统，比较交易记录及最终资产
+static void checkParallelSameAsSerial(const SYSPtr& sys) {
+    StockManager& sm = StockManager::instance();
+    KQuery query = KQueryByDate(Datetime(201101010000L), Null<Datetime>(), KQuery::DAY);
+    StockList stks{sm["sz000001"], sm["sz000063"], sm["sz000651"], sm["sh600000"]};
+
+    SEPtr se = SE_Fixed();
+    se->addStockList(stks, sys);
+    PFPtr pf = PF_Simple(crtTM(Datetime(199001010000L), 500000), se, AF_EqualWeight());
+    pf->run(query);
+
+    SEPtr parallel_se = SE_Fixed();
+    parallel_se->addStockList(stks, sys);
+    PFPtr parallel_pf =
+      PF_Simple(crtTM(Datetime(199001010000L), 500000), parallel_se, AF_EqualWeight());
+    parallel_pf->setParam<bool>("parallel", true);
+
+    Datetime last_date = sm.getTradingCalendar(query).back();
+    auto tr_list = pf->getTM()->getTradeList();
+    auto funds = pf->getTM()->getFunds(last_date);
+
+    // 第二次强制重新运行，检查 reset 后线程池重建
+    for (int n = 0; n < 2; n++) {
+        parallel_pf->run(query, true);
+        auto parallel_tr_list = parallel_pf->getTM()->getTradeList();
+        REQUIRE_EQ(tr_list.size(), parallel_tr_list.size());
+        for (size_t i = 0; i < tr_list.size(); i++) {
+            CHECK_EQ(tr_list[i].datetime, parallel_tr_list[i].datetime);
+            CHECK_EQ(tr_list[i].stock, parallel_tr_list[i].stock);
+            CHECK_EQ(tr_list[i].business, parallel_tr_list[i].business);
+            CHECK_EQ(tr_list[i].number, doctest::Approx(parallel_tr_list[i].number));
+        }
+
+        auto parallel_funds = parallel_pf->getTM()->getFunds(last_date);
+        CHECK_EQ(funds.cash, doctest::Approx(parallel_funds.cash));
+        CHECK_EQ(funds.market_value, doctest::Approx(parallel_funds.market_value));
+    }
+}
+
+/** @par 检测点 并行执行子系统与串行执行结果一致 */
+TEST_CASE("test_PF_parallel") {
+    SYSPtr sys = SYS_Simple();
+    sys->setSG(SG_CrossGold(EMA(CLOSE(), 12), EMA(CLOSE(), 26)));
+    sys->setMM(MM_FixedCount(100));
+
+    /** @arg 子系统无共享部件，交易记录逐条一致，多次运行结果一致 */
+    checkParallelSameAsSerial(sys);
+
+    /** @arg 子系统共享 EV（shared_ev=true）时退化为串行，结果仍一致 */
+    sys->setEV(EV_TwoLine(EMA(CLOSE(), 5), EMA(CLOSE(), 20)));
+    CHECK_UNARY(sys->getParam<bool>("shared_ev"));
+    checkParallelSameAsSerial(sys);
+}
+
 /** @} */
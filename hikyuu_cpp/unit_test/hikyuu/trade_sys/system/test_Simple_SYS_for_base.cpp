@@ -5,7 +5,7 @@
  *      Author: fasiondog
  */
 
-#include "doctest/doctest.h"
+#include "../../test_config.h"
 #include "test_sys.h"
 #include <hikyuu/StockManager.h>
 #include <hikyuu/indicator/crt/MA.h>
@@ -172,4 +172,86 @@ TEST_CASE("test_SYS_Simple_for_base") {
     }*/
 }
 
+/** @par 检测点（批量预计算部件状态与逐K线查询结果一致）  */
+TEST_CASE("test_SYS_Simple_run_with_bar_flags") {
+    StockManager& sm = StockManager::instance();
+    Stock stk = sm["sh600000"];
+    KQuery query = KQueryByDate(Datetime(199911100000LL), Datetime(200002250000LL), KQuery::DAY);
+
+    auto make_sys = [&]() {
+        TMPtr tm = crtTM(Datetime(199001010000LL), 100000, TC_Zero(), "TEST_TM");
+        SYSPtr sys = SYS_Simple(tm, MM_FixedCount(100));
+        sys->setSG(SG_Cross(MA(CLOSE(), 5), MA(CLOSE(), 10)));
+        sys->setST(ST_FixedPercent(0.01));
+        EVPtr ev = make_shared<TestEV2>();
+        ev->setQuery(query);
+        sys->setEV(ev);
+        sys->setCN(make_shared<TestCN2>());
+        sys->setParam<bool>("ev_open_position", true);
+        sys->setParam<bool>("cn_open_position", true);
+        sys->setParam<bool>("buy_delay", false);
+        sys->setParam<bool>("sell_delay", false);
+        return sys;
+    };
+
+    /** @arg run 使用批量预计算的部件状态 */
+    SYSPtr sys1 = make_sys();
+    sys1->run(stk, query);
+    const TradeRecordList& expect_list = sys1->getTradeRecordList();
+
+    /** @arg runMoment 逐K线查询部件状态 */
+    SYSPtr sys2 = make_sys();
+    sys2->readyForRun();
+    sys2->setTO(stk.getKData(query));
+    for (const auto& d : sys2->getTO().getDatetimeList()) {
+        sys2->runMoment(d);
+    }
+    const TradeRecordList& tr_list = sys2->getTradeRecordList();
+
+    CHECK_UNARY(!expect_list.empty());
+    REQUIRE_EQ(tr_list.size(), expect_list.size());
+    for (size_t i = 0; i < tr_list.size(); i++) {
+        CHECK_EQ(tr_list[i].datetime, expect_list[i].datetime);
+        CHECK_EQ(tr_list[i].business, expect_list[i].business);
+        CHECK_EQ(tr_list[i].number, expect_list[i].number);
+        CHECK_EQ(tr_list[i].from, expect_list[i].from);
+    }
+
+    /** @arg 修改参数后重新运行，使用新的参数 */
+    sys1->setParam<bool>("buy_delay", true);
+    sys1->run(stk, query, true);
+    CHECK_UNARY(!sys1->getTradeRecordList().empty());
+    CHECK_NE(sys1->getTradeRecordList()[0].datetime, expect_list[0].datetime);
+}
+
+//-----------------------------------------------------------------------------
+// benchmark
+//-----------------------------------------------------------------------------
+#if ENABLE_BENCHMARK_TEST
+TEST_CASE("test_SYS_Simple_run_benchmark") {
+    StockManager& sm = StockManager::instance();
+    Stock stk = sm["sh600000"];
+    KQuery query = KQuery(0);
+    KData kdata = stk.getKData(query);
+
+    TMPtr tm = crtTM(Datetime(199001010000LL), 10000000, TC_Zero(), "TEST_TM");
+    SYSPtr sys = SYS_Simple(tm, MM_FixedCount(100));
+    sys->setSG(SG_Cross(MA(CLOSE(), 5), MA(CLOSE(), 10)));
+    sys->setST(ST_FixedPercent(0.01));
+    sys->run(kdata, true);
+
+    int cycle = 100;  // 测试循环次数
+    {
+        // 按 K 线总数计算平均耗时，即每根K线的平均耗时
+        BENCHMARK_TIME_MSG(test_SYS_Simple_run_benchmark, cycle * int(kdata.size()),
+                           fmt::format("data len: {}, trades: {}", kdata.size(),
+                                       sys->getTradeRecordList().size()));
+        SPEND_TIME_CONTROL(false);
+        for (int i = 0; i < cycle; i++) {
+            sys->run(kdata, true);
+        }
+    }
+}
+#endif
+
 /** @} */
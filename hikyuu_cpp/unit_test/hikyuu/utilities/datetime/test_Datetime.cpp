@@ -449,6 +449,30 @@ TEST_CASE("test_Datetime") {
     CHECK_EQ(Datetime::max().ticks(), (Datetime::max() - Datetime::min()).ticks());
 }
 
+/** @par 检测点 */
+TEST_CASE("test_Datetime_boundary_table") {
+    /** @arg 预计算日期边界表的上下边界，与公历换算结果一致 */
+    CHECK_EQ(Datetime(189912310000).startOfMonth(), Datetime(189912010000));
+    CHECK_EQ(Datetime(189912310000).nextDay(), Datetime(190001010000));
+    CHECK_EQ(Datetime(190001010000).preDay(), Datetime(189912310000));
+    CHECK_EQ(Datetime(190001010000).preMonth(), Datetime(189912010000));
+    CHECK_EQ(Datetime(190001010000).startOfWeek(), Datetime(190001010000));
+    CHECK_EQ(Datetime(190001020000).preWeek(), Datetime(189912250000));
+    CHECK_EQ(Datetime(219912310000).nextDay(), Datetime(220001010000));
+    CHECK_EQ(Datetime(219912310000).nextMonth(), Datetime(220001010000));
+    CHECK_EQ(Datetime(219912310000).endOfYear(), Datetime(219912310000));
+    CHECK_EQ(Datetime(219912310000).endOfWeek(), Datetime(220001050000));
+    CHECK_EQ(Datetime(220001010000).endOfMonth(), Datetime(220001310000));
+
+    /** @arg 带有时分秒的日期 */
+    CHECK_EQ(Datetime(202402291435).startOfMonth(), Datetime(202402010000));
+    CHECK_EQ(Datetime(202402291435).endOfMonth(), Datetime(202402290000));
+    CHECK_EQ(Datetime(202402291435).startOfQuarter(), Datetime(202401010000));
+    CHECK_EQ(Datetime(202402291435).nextHalfyear(), Datetime(202407010000));
+    CHECK_EQ(Datetime(202402291435).nextWeek(), Datetime(202403040000));
+    CHECK_EQ(Datetime(202402291435).nextDay(), Datetime(202403010000));
+}
+
 /** @par 检测点 */
 TEST_CASE("test_Datetime_related_operator") {
     /** @arg 小于比较 */
@@ -11,9 +11,65 @@
 #include <hikyuu/utilities/ConnectPool.h>
 #include <hikyuu/utilities/db_connect/DBConnect.h>
 #include <hikyuu/utilities/db_connect/sqlite/SQLiteConnect.h>
+#include <hikyuu/utilities/db_connect/sqlite/SQLiteStatement.h>
+#include <hikyuu/data_driver/kdata/KRecordTableReader.h>
 
 using namespace hku;
 
+namespace {
+
+/** 模拟可断线重连的连接，断线或重连后，重连前创建的语句执行失败 */
+class ReconnectSQLiteConnect : public SQLiteConnect {
+    class Statement : public SQLiteStatement {
+    public:
+        Statement(ReconnectSQLiteConnect* connect, const std::string& sql)
+        : SQLiteStatement(connect, sql), m_connect(connect), m_generation(connect->generation()) {}
+
+        virtual void sub_exec() override {
+            HKU_CHECK(!m_connect->lost && m_generation == m_connect->generation(),
+                      "Lost connection");
+            SQLiteStatement::sub_exec();
+        }
+
+    private:
+        ReconnectSQLiteConnect* m_connect;
+        uint64_t m_generation;
+    };
+
+public:
+    using SQLiteConnect::SQLiteConnect;
+
+    virtual bool ping() override {
+        if (lost) {
+            reconnect();
+        }
+        return SQLiteConnect::ping();
+    }
+
+    virtual SQLStatementPtr getStatement(const std::string& sql_statement) override {
+        return std::make_shared<Statement>(this, sql_statement);
+    }
+
+    void reconnect() {
+        lost = false;
+        m_generation++;
+    }
+
+    bool lost{false};
+};
+
+/** 模拟无法提供数据版本的连接（如 MySQL） */
+class NoVersionSQLiteConnect : public SQLiteConnect {
+public:
+    using SQLiteConnect::SQLiteConnect;
+
+    virtual int64_t dataVersion(const std::string& tablename) override {
+        return DBConnectBase::dataVersion(tablename);
+    }
+};
+
+}  // namespace
+
 TEST_CASE("test_sqlite") {
     Parameter param;
     param.set<string>("db", "test.db");
@@ -189,3 +245,169 @@ TEST_CASE("test_sqlite") {
         con->exec("drop table perf_test");
     }*/
 }
+
+TEST_CASE("test_sqlite_KRecordTableReader") {
+    Parameter param;
+    param.set<string>("db", "test.db");
+    param.set<int>("flags", SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+    auto con = std::make_shared<SQLiteConnect>(param);
+    if (con->tableExist("000001")) {
+        con->exec("drop table `000001`");
+    }
+    con->exec(
+      "create table `000001` (date INTEGER PRIMARY KEY, open REAL, high REAL, low REAL, "
+      "close REAL, amount REAL, count REAL)");
+
+    const size_t total = 3 * KRecordTableReader::INDEX_STEP + 10;
+    KRecordList expect;
+    Datetime d(202001020930LL);
+    con->transaction();
+    SQLStatementPtr st = con->getStatement("insert into `000001` values (?,?,?,?,?,?,?)");
+    for (size_t i = 0; i < total; i++) {
+        d = d + Minutes(1);
+        price_t v = price_t(i);
+        expect.emplace_back(d, v, v, v, v, v, v);
+        st->bind(0, int64_t(d.number()), v, v, v, v, v, v);
+        st->exec();
+    }
+    con->commit();
+
+    KRecordTableReader reader;
+    CHECK_EQ(reader.getCount(con.get(), "sh_min", "`000001`"), total);
+
+    /** @arg 按位置查询，与位置索引对齐及跨越索引点 */
+    for (size_t start : {size_t(0), size_t(5), KRecordTableReader::INDEX_STEP - 1,
+                         KRecordTableReader::INDEX_STEP, 2 * KRecordTableReader::INDEX_STEP + 7,
+                         total - 3}) {
+        KRecordList result = reader.getKRecordList(con.get(), "sh_min", "`000001`", start,
+                                                   start + 20);
+        size_t end = std::min(start + 20, total);
+        CHECK_EQ(result, KRecordList(expect.begin() + start, expect.begin() + end));
+    }
+
+    /** @arg 起始位置超出记录数 */
+    CHECK_UNARY(reader.getKRecordList(con.get(), "sh_min", "`000001`", total, total + 5).empty());
+
+    /** @arg 结束位置为 Null */
+    KRecordList result =
+      reader.getKRecordList(con.get(), "sh_min", "`000001`", 100, Null<size_t>());
+    CHECK_EQ(result.size(), total - 100);
+
+    /** @arg 追加记录后按位置读取尾部 */
+    d = d + Minutes(1);
+    expect.emplace_back(d, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0);
+    con->exec(fmt::format("insert into `000001` values ({},1,1,1,1,1,1)", d.number()));
+    result = reader.getKRecordList(con.get(), "sh_min", "`000001`", total - 1, total + 1);
+    CHECK_EQ(result, KRecordList(expect.end() - 2, expect.end()));
+
+    /** @arg 按日期查询 */
+    result = reader.getKRecordList(con.get(), "sh_min", "`000001`", expect[10].datetime,
+                                   expect[30].datetime);
+    CHECK_EQ(result, KRecordList(expect.begin() + 10, expect.begin() + 30));
+    result =
+      reader.getKRecordList(con.get(), "sh_min", "`000001`", expect[10].datetime, Null<Datetime>());
+    CHECK_EQ(result.size(), expect.size() - 10);
+    CHECK_EQ(reader.getCountBefore(con.get(), "sh_min", "`000001`", expect[1000].datetime), 1000);
+
+    /** @arg 删除中间的记录后，位置索引重建 */
+    size_t start = 2 * KRecordTableReader::INDEX_STEP + 7;
+    result = reader.getKRecordList(con.get(), "sh_min", "`000001`", start, start + 20);
+    CHECK_EQ(result, KRecordList(expect.begin() + start, expect.begin() + start + 20));
+    con->exec(fmt::format("delete from `000001` where date={}", expect[100].datetime.number()));
+    expect.erase(expect.begin() + 100);
+    result = reader.getKRecordList(con.get(), "sh_min", "`000001`", start, start + 20);
+    CHECK_EQ(result, KRecordList(expect.begin() + start, expect.begin() + start + 20));
+
+    /** @arg 其他连接在表头插入记录后，位置索引重建 */
+    {
+        auto other = std::make_shared<SQLiteConnect>(param);
+        Datetime first = expect.front().datetime - Minutes(1);
+        other->exec(fmt::format("insert into `000001` values ({},2,2,2,2,2,2)", first.number()));
+        expect.insert(expect.begin(), KRecord(first, 2.0, 2.0, 2.0, 2.0, 2.0, 2.0));
+    }
+    result = reader.getKRecordList(con.get(), "sh_min", "`000001`", start, start + 20);
+    CHECK_EQ(result, KRecordList(expect.begin() + start, expect.begin() + start + 20));
+
+    /** @arg 表不存在时抛出异常 */
+    CHECK_THROWS(reader.getKRecordList(con.get(), "sh_min", "`nothing`", 0, 10));
+
+    reader.clear();
+    st.reset();
+    con->exec("drop table `000001`");
+}
+
+TEST_CASE("test_sqlite_KRecordTableReader_reconnect") {
+    Parameter param;
+    param.set<string>("db", "test.db");
+    param.set<int>("flags", SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+    auto con = std::make_shared<ReconnectSQLiteConnect>(param);
+    if (con->tableExist("000002")) {
+        con->exec("drop table `000002`");
+    }
+    con->exec(
+      "create table `000002` (date INTEGER PRIMARY KEY, open REAL, high REAL, low REAL, "
+      "close REAL, amount REAL, count REAL)");
+    con->exec("insert into `000002` values (202001020931,1,1,1,1,1,1)");
+
+    KRecordTableReader reader;
+    CHECK_EQ(reader.getCount(con.get(), "sh_min", "`000002`"), 1);
+
+    /** @arg 连接重新建立后，不再使用原连接上缓存的预编译语句 */
+    con->reconnect();
+    CHECK_EQ(reader.getCount(con.get(), "sh_min", "`000002`"), 1);
+
+    /** @arg 执行时连接已断开，重连后重试 */
+    con->lost = true;
+    CHECK_EQ(reader.getCount(con.get(), "sh_min", "`000002`"), 1);
+    CHECK_EQ(reader.getKRecordList(con.get(), "sh_min", "`000002`", 0, 10).size(), 1);
+
+    reader.clear();
+    con->exec("drop table `000002`");
+}
+
+TEST_CASE("test_sqlite_KRecordTableReader_no_version") {
+    Parameter param;
+    param.set<string>("db", "test.db");
+    param.set<int>("flags", SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+    auto con = std::make_shared<NoVersionSQLiteConnect>(param);
+    if (con->tableExist("000003")) {
+        con->exec("drop table `000003`");
+    }
+    con->exec(
+      "create table `000003` (date INTEGER PRIMARY KEY, open REAL, high REAL, low REAL, "
+      "close REAL, amount REAL, count REAL)");
+
+    const size_t total = 2 * KRecordTableReader::INDEX_STEP + 10;
+    KRecordList expect;
+    Datetime d(202001020930LL);
+    con->transaction();
+    SQLStatementPtr st = con->getStatement("insert into `000003` values (?,?,?,?,?,?,?)");
+    for (size_t i = 0; i < total; i++) {
+        d = d + Minutes(1);
+        price_t v = price_t(i);
+        expect.emplace_back(d, v, v, v, v, v, v);
+        st->bind(0, int64_t(d.number()), v, v, v, v, v, v);
+        st->exec();
+    }
+    con->commit();
+    st.reset();
+
+    /** @arg 默认的数据版本表示无法获取 */
+    CHECK_EQ(con->dataVersion("`000003`"), DBConnectBase::NO_DATA_VERSION);
+
+    /** @arg 无数据版本时按偏移查询，结果与有位置索引时一致 */
+    KRecordTableReader reader;
+    size_t start = KRecordTableReader::INDEX_STEP + 7;
+    KRecordList result = reader.getKRecordList(con.get(), "sh_min", "`000003`", start, start + 20);
+    CHECK_EQ(result, KRecordList(expect.begin() + start, expect.begin() + start + 20));
+    CHECK_UNARY(reader.getKRecordList(con.get(), "sh_min", "`000003`", total, total + 5).empty());
+
+    /** @arg 删除中间的记录后结果仍正确 */
+    con->exec(fmt::format("delete from `000003` where date={}", expect[100].datetime.number()));
+    expect.erase(expect.begin() + 100);
+    result = reader.getKRecordList(con.get(), "sh_min", "`000003`", start, start + 20);
+    CHECK_EQ(result, KRecordList(expect.begin() + start, expect.begin() + start + 20));
+
+    reader.clear();
+    con->exec("drop table `000003`");
+}
@@ -0,0 +1,87 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#include "../test_config.h"
+#include <thread>
+#include <hikyuu/utilities/LatencyHistogram.h>
+
+using namespace hku;
+
+/**
+ * @defgroup test_hikyuu_LatencyHistogram test_hikyuu_LatencyHistogram
+ * @ingroup test_hikyuu_utilities
+ * @{
+ */
+
+/** @par 检测点 */
+TEST_CASE("test_LatencyHistogram") {
+    LatencyHistogram hist;
+
+    /** @arg 无记录 */
+    CHECK_EQ(hist.count(), 0);
+    CHECK_EQ(hist.min(), 0);
+    CHECK_EQ(hist.max(), 0);
+    CHECK_EQ(hist.mean(), 0.0);
+    CHECK_EQ(hist.percentile(50.0), 0);
+
+    /** @arg 小于 32 的值精确记录，负值按 0 记录 */
+    for (int64_t i = 1; i <= 20; i++) {
+        hist.record(i);
+    }
+    hist.record(-5);
+    CHECK_EQ(hist.count(), 21);
+    CHECK_EQ(hist.min(), 0);
+    CHECK_EQ(hist.max(), 20);
+    CHECK_EQ(hist.percentile(0.0), 0);
+    CHECK_EQ(hist.percentile(50.0), 10);
+    CHECK_EQ(hist.percentile(100.0), 20);
+
+    /** @arg 较大的值相对误差不超过 1/16，且不超过最大值 */
+    hist.reset();
+    CHECK_EQ(hist.count(), 0);
+    for (int64_t i = 1; i <= 100000; i++) {
+        hist.record(i * 1000);
+    }
+    CHECK_EQ(hist.max(), 100000000);
+    CHECK_EQ(hist.mean(), doctest::Approx(50000500.0));
+    for (double p : {1.0, 50.0, 90.0, 99.0, 99.9}) {
+        double expect = p / 100.0 * 100000000.0;
+        double value = double(hist.percentile(p));
+        CHECK_GE(value, expect * (1.0 - 1.0 / 16.0));
+        CHECK_LE(value, expect * (1.0 + 1.0 / 16.0));
+    }
+    CHECK_EQ(hist.percentile(100.0), 100000000);
+
+    /** @arg 极大值 */
+    hist.record((std::numeric_limits<int64_t>::max)());
+    CHECK_EQ(hist.max(), (std::numeric_limits<int64_t>::max)());
+    CHECK_EQ(hist.percentile(100.0), (std::numeric_limits<int64_t>::max)());
+}
+
+/** @par 检测点 */
+TEST_CASE("test_LatencyHistogram_concurrent") {
+    LatencyHistogram hist;
+
+    /** @arg 多线程同时记录 */
+    vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&hist]() {
+            for (int64_t i = 1; i <= 10000; i++) {
+                hist.record(i);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    CHECK_EQ(hist.count(), 40000);
+    CHECK_EQ(hist.min(), 1);
+    CHECK_EQ(hist.max(), 10000);
+    CHECK_EQ(hist.mean(), doctest::Approx(5000.5));
+}
+
+/** @} */
@@ -0,0 +1,96 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#include "../../test_config.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <hikyuu/utilities/thread/MPSCQueue.h>
+
+using namespace hku;
+
+/**
+ * @defgroup test_hikyuu_MPSCQueue test_hikyuu_MPSCQueue
+ * @ingroup test_hikyuu_utilities
+ * @{
+ */
+
+/** @par 检测点 */
+TEST_CASE("test_MPSCQueue") {
+    MPSCQueue<std::unique_ptr<int>> queue;
+    std::unique_ptr<int> value;
+
+    /** @arg 空队列 */
+    CHECK_UNARY(queue.empty());
+    CHECK_UNARY_FALSE(queue.try_pop(value));
+
+    /** @arg 先进先出，支持仅可移动的类型 */
+    for (int i = 0; i < 10; i++) {
+        queue.push(std::make_unique<int>(i));
+    }
+    CHECK_UNARY_FALSE(queue.empty());
+    for (int i = 0; i < 10; i++) {
+        REQUIRE(queue.try_pop(value));
+        CHECK_EQ(*value, i);
+    }
+    CHECK_UNARY(queue.empty());
+
+    /** @arg 析构时释放未出队的元素 */
+    auto shared = std::make_shared<int>(0);
+    {
+        MPSCQueue<std::shared_ptr<int>> tmp;
+        tmp.push(std::shared_ptr<int>(shared));
+        tmp.push(std::shared_ptr<int>(shared));
+        CHECK_EQ(shared.use_count(), 3);
+    }
+    CHECK_EQ(shared.use_count(), 1);
+}
+
+/** @par 检测点 */
+TEST_CASE("test_MPSCQueue_concurrent") {
+    MPSCQueue<int64_t> queue;
+    const int producer_num = 4;
+    const int64_t total = 50000;
+
+    /** @arg 多个生产者同时入队，每个元素恰好出队一次，且同一生产者的元素保持顺序 */
+    vector<std::thread> producers;
+    for (int p = 0; p < producer_num; p++) {
+        producers.emplace_back([&queue, p, total]() {
+            for (int64_t i = 0; i < total; i++) {
+                queue.push(p * total + i);
+            }
+        });
+    }
+
+    vector<int64_t> last(producer_num, -1);
+    int64_t count = 0, sum = 0;
+    size_t errors = 0;
+    int64_t value = 0;
+    while (count < producer_num * total) {
+        if (!queue.try_pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        int p = int(value / total);
+        if (value % total <= last[p]) {
+            errors++;
+        }
+        last[p] = value % total;
+        sum += value;
+        count++;
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+
+    int64_t n = producer_num * total;
+    CHECK_EQ(errors, 0);
+    CHECK_EQ(sum, n * (n - 1) / 2);
+    CHECK_UNARY(queue.empty());
+}
+
+/** @} */
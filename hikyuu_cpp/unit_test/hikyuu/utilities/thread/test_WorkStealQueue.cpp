@@ -0,0 +1,361 @@
+/*
+ *  Copyright (c) 2026 hikyuu.org
+ *
+ *  Created on: 2026-10-19
+ *      Author: fasiondog
+ */
+
+#include "../../test_config.h"
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <hikyuu/utilities/thread/algorithm.h>
+
+using namespace hku;
+
+/**
+ * @defgroup test_hikyuu_WorkStealQueue test_hikyuu_WorkStealQueue
+ * @ingroup test_hikyuu_utilities
+ * @{
+ */
+
+/** @par 检测点 */
+TEST_CASE("test_FuncWrapper") {
+    int count = 0;
+
+    /** @arg 空任务 */
+    FuncWrapper empty;
+    CHECK_UNARY(empty.isNullTask());
+    CHECK_UNARY_FALSE(empty.isInline());
+
+    /** @arg 小对象直接存放于包装器内部 */
+    CHECK_EQ(sizeof(FuncWrapper), 64);
+    FuncWrapper small([&count]() { count++; });
+    CHECK_UNARY(small.isInline());
+    small();
+    CHECK_EQ(count, 1);
+
+    /** @arg 超出内部空间的对象存放于堆中 */
+    std::array<int, 32> data;
+    data.fill(1);
+    FuncWrapper big([&count, data]() { count += data[31]; });
+    CHECK_UNARY_FALSE(big.isInline());
+    big();
+    CHECK_EQ(count, 2);
+
+    /** @arg 移动后原包装器为空任务 */
+    auto shared = std::make_shared<int>(0);
+    FuncWrapper task([shared]() { (*shared)++; });
+    CHECK_EQ(shared.use_count(), 2);
+    FuncWrapper moved(std::move(task));
+    CHECK_UNARY(task.isNullTask());
+    moved();
+    CHECK_EQ(*shared, 1);
+    big = std::move(moved);
+    CHECK_UNARY(big.isInline());
+    big();
+    CHECK_EQ(*shared, 2);
+
+    /** @arg 析构时释放被包装对象 */
+    big = FuncWrapper();
+    CHECK_EQ(shared.use_count(), 1);
+}
+
+/** @par 检测点 */
+TEST_CASE("test_WorkStealQueue") {
+    WorkStealQueue queue(4);
+    CHECK_EQ(queue.capacity(), 4);
+    CHECK_UNARY(queue.empty());
+
+    vector<int> result;
+    FuncWrapper task;
+    CHECK_UNARY_FALSE(queue.try_pop(task));
+    CHECK_UNARY_FALSE(queue.try_steal(task));
+
+    /** @arg 队列已满时插入失败，任务保持不变 */
+    for (int i = 0; i < 4; i++) {
+        CHECK_UNARY(queue.push_front([&result, i]() { result.push_back(i); }));
+    }
+    FuncWrapper overflow([&result]() { result.push_back(100); });
+    CHECK_UNARY_FALSE(queue.push_front(std::move(overflow)));
+    CHECK_UNARY_FALSE(overflow.isNullTask());
+    CHECK_EQ(queue.size(), 4);
+
+    /** @arg 所属线程后进先出，偷取者先进先出 */
+    CHECK_UNARY(queue.try_pop(task));
+    task();
+    CHECK_UNARY(queue.try_steal(task));
+    task();
+    CHECK_UNARY(queue.try_steal(task));
+    task();
+    CHECK_UNARY(queue.try_pop(task));
+    task();
+    vector<int> expect{3, 0, 1, 2};
+    CHECK_EQ(result, expect);
+    CHECK_UNARY(queue.empty());
+
+    /** @arg 循环使用槽位 */
+    result.clear();
+    for (int i = 0; i < 10; i++) {
+        CHECK_UNARY(queue.push_front([&result, i]() { result.push_back(i); }));
+        CHECK_UNARY(queue.try_steal(task));
+        task();
+    }
+    CHECK_EQ(result.size(), 10);
+    CHECK_EQ(result.back(), 9);
+
+    /** @arg 清空队列 */
+    CHECK_UNARY(queue.push_front([]() {}));
+    queue.clear();
+    CHECK_UNARY(queue.empty());
+    CHECK_UNARY_FALSE(queue.try_pop(task));
+}
+
+/** @par 检测点 */
+TEST_CASE("test_WorkStealQueue_concurrent") {
+    WorkStealQueue queue(64);
+    const int total = 100000;
+    std::atomic<int64_t> sum{0};
+    std::atomic<int> executed{0};
+    std::atomic<bool> stop{false};
+
+    /** @arg 所属线程入队及出队的同时多个线程偷取，每个任务恰好执行一次 */
+    vector<std::thread> thieves;
+    for (int i = 0; i < 3; i++) {
+        thieves.emplace_back([&]() {
+            FuncWrapper task;
+            while (!stop) {
+                if (queue.try_steal(task)) {
+                    task();
+                }
+            }
+        });
+    }
+
+    int64_t expect = 0;
+    FuncWrapper task;
+    for (int i = 0; i < total; i++) {
+        expect += i;
+        FuncWrapper one([&sum, &executed, i]() {
+            sum += i;
+            executed++;
+        });
+        if (!queue.push_front(std::move(one))) {
+            one();
+        }
+        if (i % 3 == 0 && queue.try_pop(task)) {
+            task();
+        }
+    }
+    while (queue.try_pop(task)) {
+        task();
+    }
+    stop = true;
+    for (auto& t : thieves) {
+        t.join();
+    }
+
+    CHECK_EQ(executed, total);
+    CHECK_EQ(sum, expect);
+}
+
+// 外部线程提交 total 个任务，其中一个任务在工作线程内再提交 total 个任务
+template <class ThreadPoolType>
+static int runSubmitVoid(size_t worker_num, int total) {
+    std::atomic<int> count{0};
+    ThreadPoolType tg(worker_num);
+    auto nested = tg.submit([&count, &tg, total]() {
+        for (int i = 0; i < total; i++) {
+            tg.submit_void([&count]() { count++; });
+        }
+        return true;
+    });
+    for (int i = 0; i < total; i++) {
+        tg.submit_void([&count, i]() {
+            count++;
+            if (i % 100 == 0) {
+                throw std::runtime_error("test");
+            }
+        });
+    }
+    nested.get();
+    tg.join();
+    return count;
+}
+
+/** @par 检测点 */
+TEST_CASE("test_StealThreadPool_submit_void") {
+    /** @arg 外部及工作线程内提交的任务全部执行，任务异常不影响线程池 */
+    CHECK_EQ(runSubmitVoid<StealThreadPool>(4, 10000), 20000);
+    CHECK_EQ(runSubmitVoid<MQStealThreadPool>(4, 10000), 20000);
+
+    /** @arg 工作线程内提交超出本地队列容量的任务 */
+    const int total = int(WorkStealQueue::DEFAULT_CAPACITY * 3);
+    CHECK_EQ(runSubmitVoid<StealThreadPool>(1, total), total * 2);
+    CHECK_EQ(runSubmitVoid<MQStealThreadPool>(1, total), total * 2);
+}
+
+//-----------------------------------------------------------------------------
+// benchmark
+//-----------------------------------------------------------------------------
+#if ENABLE_BENCHMARK_TEST
+
+// 原有实现方式：互斥锁保护的 std::deque
+class LockedStealQueue {
+public:
+    void push_front(FuncWrapper&& data) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_front(std::move(data));
+    }
+
+    bool try_pop(FuncWrapper& res) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_queue.empty()) {
+            return false;
+        }
+        res = std::move(m_queue.front());
+        m_queue.pop_front();
+        return true;
+    }
+
+    bool try_steal(FuncWrapper& res) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_queue.empty()) {
+            return false;
+        }
+        res = std::move(m_queue.back());
+        m_queue.pop_back();
+        return true;
+    }
+
+private:
+    std::deque<FuncWrapper> m_queue;
+    std::mutex m_mutex;
+};
+
+template <class Queue>
+static void runStealQueue(Queue& queue, int total, int thief_num) {
+    std::atomic<bool> stop{false};
+    std::atomic<int> count{0};
+    vector<std::thread> thieves;
+    for (int i = 0; i < thief_num; i++) {
+        thieves.emplace_back([&]() {
+            FuncWrapper task;
+            while (!stop) {
+                if (queue.try_steal(task)) {
+                    task();
+                }
+            }
+        });
+    }
+
+    FuncWrapper task;
+    for (int i = 0; i < total; i++) {
+        queue.push_front([&count]() { count++; });
+        if (queue.try_pop(task)) {
+            task();
+        }
+    }
+    while (queue.try_pop(task)) {
+        task();
+    }
+    stop = true;
+    for (auto& t : thieves) {
+        t.join();
+    }
+}
+
+TEST_CASE("test_WorkStealQueue_benchmark") {
+    const int total = 1000000;
+    const int thief_num = std::max(1, int(std::thread::hardware_concurrency()) - 1);
+
+    {
+        LockedStealQueue queue;
+        BENCHMARK_TIME_MSG(test_WorkStealQueue_locked, 1,
+                           fmt::format("mutex deque, tasks: {}, thieves: {}", total, thief_num));
+        runStealQueue(queue, total, thief_num);
+    }
+
+    {
+        WorkStealQueue queue;
+        BENCHMARK_TIME_MSG(test_WorkStealQueue_lock_free, 1,
+                           fmt::format("lock-free deque, tasks: {}, thieves: {}", total,
+                                       thief_num));
+        runStealQueue(queue, total, thief_num);
+    }
+}
+
+// 细粒度任务：每个任务仅做一次累加
+TEST_CASE("test_ThreadPool_fine_grained_benchmark") {
+    const int total = 200000;
+    std::atomic<int64_t> sum{0};
+
+    {
+        ThreadPool tg;
+        BENCHMARK_TIME_MSG(test_ThreadPool_submit, 1, fmt::format("ThreadPool submit: {}", total));
+        for (int i = 0; i < total; i++) {
+            tg.submit([&sum, i]() { sum += i; });
+        }
+        tg.join();
+    }
+
+    {
+        StealThreadPool tg;
+        BENCHMARK_TIME_MSG(test_StealThreadPool_submit, 1,
+                           fmt::format("StealThreadPool submit: {}", total));
+        for (int i = 0; i < total; i++) {
+            tg.submit([&sum, i]() { sum += i; });
+        }
+        tg.join();
+    }
+
+    {
+        StealThreadPool tg;
+        BENCHMARK_TIME_MSG(test_StealThreadPool_submit_void, 1,
+                           fmt::format("StealThreadPool submit_void: {}", total));
+        for (int i = 0; i < total; i++) {
+            tg.submit_void([&sum, i]() { sum += i; });
+        }
+        tg.join();
+    }
+
+    {
+        MQStealThreadPool tg;
+        BENCHMARK_TIME_MSG(test_MQStealThreadPool_submit, 1,
+                           fmt::format("MQStealThreadPool submit: {}", total));
+        for (int i = 0; i < total; i++) {
+            tg.submit([&sum, i]() { sum += i; });
+        }
+        tg.join();
+    }
+
+    {
+        MQStealThreadPool tg;
+        BENCHMARK_TIME_MSG(test_MQStealThreadPool_submit_void, 1,
+                           fmt::format("MQStealThreadPool submit_void: {}", total));
+        for (int i = 0; i < total; i++) {
+            tg.submit_void([&sum, i]() { sum += i; });
+        }
+        tg.join();
+    }
+
+    // 工作线程内递归提交，走无锁本地队列
+    {
+        StealThreadPool tg;
+        BENCHMARK_TIME_MSG(test_StealThreadPool_nested_submit_void, 1,
+                           fmt::format("StealThreadPool nested submit_void: {}", total));
+        const int group = 100;
+        for (int g = 0; g < group; g++) {
+            tg.submit_void([&sum, &tg, total, group]() {
+                for (int i = 0; i < total / group; i++) {
+                    tg.submit_void([&sum, i]() { sum += i; });
+                }
+            });
+        }
+        tg.join();
+    }
+}
+#endif
+
+/** @} */
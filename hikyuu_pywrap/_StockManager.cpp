@@ -36,6 +36,22 @@ void export_StockManager(py::module& m) {
 
       .def("reload", &StockManager::reload, "重新加载所有证券数据")
 
+      .def("save_snapshot", &StockManager::saveSnapshot, py::arg("filename"),
+           R"(save_snapshot(self, filename)
+
+    将当前数据（含已缓存的K线数据）保存为快照文件，需在数据加载完毕后调用
+
+    :param str filename: 快照文件名
+    :rtype: bool)")
+
+      .def("load_snapshot", &StockManager::loadSnapshot, py::arg("filename"),
+           R"(load_snapshot(self, filename)
+
+    从快照文件恢复数据，将替换全部证券实例，仅建议在初始化时使用
+
+    :param str filename: 快照文件名
+    :rtype: bool)")
+
       .def("tmpdir", &StockManager::tmpdir, R"(tmpdir(self) -> str
 
     获取用于保存零时变量等的临时目录，如未配置则为当前目录 由m_config中的“tmpdir”指定)")
@@ -687,6 +687,28 @@ void export_Indicator_ta_lib(py::module& m) {
     
 :param Indicator data: input data
 :param int n: Number of period (From 2 to 100000))")
+
+    m.def(
+      "TA_BATCH",
+      [](const Indicator& ind, const py::sequence& data) {
+          IndicatorList ret;
+          if (len(data) > 0 && py::isinstance<KData>(data[0])) {
+              auto ks = python_list_to_vector<KData>(data);
+              py::gil_scoped_release release;
+              ret = TA_BATCH(ind, ks);
+          } else {
+              auto inputs = python_list_to_vector<Indicator>(data);
+              py::gil_scoped_release release;
+              ret = TA_BATCH(ind, inputs);
+          }
+          return vector_to_python_list<Indicator>(ret);
+      },
+      py::arg("ind"), py::arg("data"),
+      R"(TA_BATCH - Compute the same indicator for a list of KData (or Indicator) in parallel
+
+:param Indicator ind: indicator formula, e.g. TA_RSI(CLOSE(), 14) or TA_OBV()
+:param list data: list of KData or Indicator
+:rtype: list)");
 }
 
 #endif /* HKU_ENABLE_TA_LIB */
\ No newline at end of file
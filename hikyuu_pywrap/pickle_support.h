@@ -43,18 +43,112 @@
 #include <string>
 #include <sstream>
 #include <pybind11/pybind11.h>
+#include <hikyuu/serialization/compact_archive.h>
 
 namespace py = pybind11;
 
+namespace hku {
+
+/**
+ * 序列化后长度超过该值时，pickle 协议 5 下以 pickle.PickleBuffer 返回状态，
+ * 调用方可通过 buffer_callback 带外传输（如共享内存），避免复制进 pickle 流
+ */
+constexpr size_t PICKLE_OUT_OF_BAND_THRESHOLD = 64 * 1024;
+
+template <typename T>
+py::bytes pickle_dumps(const T& obj) {
+#if HKU_SUPPORT_BINARY_ARCHIVE
+    // 复用线程内缓存，避免重复分配
+    thread_local std::string buf;
+    CompactArchive::save(buf, obj);
+    py::bytes result(buf.data(), buf.size());
+    if (buf.capacity() > 16 * PICKLE_OUT_OF_BAND_THRESHOLD) {
+        std::string().swap(buf);
+    }
+    return result;
+#else
+    std::ostringstream os;
+    {
+        OUTPUT_ARCHIVE oa(os);
+        oa << obj;
+    }
+    std::string tmp(os.str());
+    return py::bytes(tmp.data(), tmp.size());
+#endif
+}
+
+template <typename T>
+void pickle_loads_legacy(const char* data, size_t len, T& obj) {
+    std::istringstream is(std::string(data, len));
+    INPUT_ARCHIVE ia(is);
+    ia >> obj;
+}
+
+/** 支持 str、bytes 及其他支持缓冲协议的对象（如 bytearray、memoryview），兼容旧格式 */
+template <typename T>
+void pickle_loads(const py::handle& state, T& obj) {
+    if (py::isinstance<py::str>(state)) {
+        std::string st = state.cast<std::string>();
+        pickle_loads_legacy(st.data(), st.size(), obj);
+        return;
+    }
+
+    if (PyBytes_Check(state.ptr())) {
+        const char* data = PyBytes_AS_STRING(state.ptr());
+        size_t len = size_t(PyBytes_GET_SIZE(state.ptr()));
+#if HKU_SUPPORT_BINARY_ARCHIVE
+        if (CompactArchive::isCompact(data, len)) {
+            CompactArchive::load(data, len, obj);
+            return;
+        }
+#endif
+        pickle_loads_legacy(data, len, obj);
+        return;
+    }
+
+    HKU_CHECK(PyObject_CheckBuffer(state.ptr()), "Unable to unpickle, error in input file.");
+    Py_buffer view;
+    if (PyObject_GetBuffer(state.ptr(), &view, PyBUF_SIMPLE) != 0) {
+        throw py::error_already_set();
+    }
+    try {
+        const char* data = static_cast<const char*>(view.buf);
+        size_t len = size_t(view.len);
+#if HKU_SUPPORT_BINARY_ARCHIVE
+        if (CompactArchive::isCompact(data, len)) {
+            CompactArchive::load(data, len, obj);
+        } else {
+            pickle_loads_legacy(data, len, obj);
+        }
+#else
+        pickle_loads_legacy(data, len, obj);
+#endif
+    } catch (...) {
+        PyBuffer_Release(&view);
+        throw;
+    }
+    PyBuffer_Release(&view);
+}
+
+/** 协议 5 下对较大的状态使用 PickleBuffer，其余情况与默认的 __reduce_ex__ 一致 */
+inline py::tuple pickle_reduce_ex(const py::object& self, int protocol) {
+    py::tuple state = self.attr("__getstate__")();
+    if (protocol >= 5 && state.size() == 1 && PyBytes_Check(state[0].ptr()) &&
+        size_t(PyBytes_GET_SIZE(state[0].ptr())) > PICKLE_OUT_OF_BAND_THRESHOLD) {
+        py::module_ pickle = py::module_::import("pickle");
+        if (py::hasattr(pickle, "PickleBuffer")) {
+            state = py::make_tuple(pickle.attr("PickleBuffer")(state[0]));
+        }
+    }
+    py::object newobj = py::module_::import("copyreg").attr("__newobj__");
+    return py::make_tuple(newobj, py::make_tuple(py::type::of(self)), state);
+}
+
+}  // namespace hku
+
 #define DEF_PICKLE(classname)                                                                      \
     .def(py::pickle(                                                                               \
-      [](const classname& p) {                                                                     \
-          std::ostringstream os;                                                                   \
-          OUTPUT_ARCHIVE oa(os);                                                                   \
-          oa << p;                                                                                 \
-          std::string tmp(os.str());                                                               \
-          return py::make_tuple(py::handle(PyBytes_FromStringAndSize(tmp.data(), tmp.size())));    \
-      },                                                                                           \
+      [](const classname& p) { return py::make_tuple(hku::pickle_dumps(p)); },                     \
       [](py::tuple t) {                                                                            \
           classname result;                                                                        \
           if (len(t) != 1) {                                                                       \
@@ -63,25 +157,11 @@ namespace py = pybind11;
                 py::str("expected 1-item tuple in call to __setstate__; got {}").format(t).ptr()); \
               throw py::error_already_set();                                                       \
           }                                                                                        \
-          py::object obj = t[0];                                                                   \
-          if (py::isinstance<py::str>(obj)) {                                                      \
-              std::string st = obj.cast<py::str>();                                                \
-              std::istringstream is(st);                                                           \
-              INPUT_ARCHIVE ia(is);                                                                \
-              ia >> result;                                                                        \
-          } else if (PyBytes_Check(py::object(t[0]).ptr())) {                                      \
-              py::object obj = t[0];                                                               \
-              char* data = PyBytes_AsString(obj.ptr());                                            \
-              auto num = PyBytes_Size(obj.ptr());                                                  \
-              std::istringstream sin(std::string(data, num));                                      \
-              INPUT_ARCHIVE ia(sin);                                                               \
-              ia >> result;                                                                        \
-              return result;                                                                       \
-          } else {                                                                                 \
-              throw std::runtime_error("Unable to unpickle, error in input file.");                \
-          }                                                                                        \
+          py::object state = t[0];                                                                 \
+          hku::pickle_loads(state, result);                                                        \
           return result;                                                                           \
-      }))
+      }))                                                                                          \
+      .def("__reduce_ex__", &hku::pickle_reduce_ex)
 
 #else
 #define DEF_PICKLE(classname)
@@ -5,6 +5,7 @@
  *      Author: fasiondog
  */
 
+#include <pybind11/functional.h>
 #include <hikyuu/trade_manage/OrderBrokerBase.h>
 #include "../pybind_utils.h"
 
@@ -42,12 +43,49 @@ void export_OrderBroker(py::module& m) {
       .def_readwrite("number", &BrokerPositionRecord::number, "持仓数量")
       .def_readwrite("money", &BrokerPositionRecord::money, "买入花费总资金");
 
+    py::class_<LatencyHistogram>(m, "LatencyHistogram", "延迟直方图，时间单位为纳秒")
+      .def("__str__", &LatencyHistogram::str)
+      .def("__repr__", &LatencyHistogram::str)
+      .def_property_readonly("count", &LatencyHistogram::count, "记录次数")
+      .def_property_readonly("min", &LatencyHistogram::min, "最小值")
+      .def_property_readonly("max", &LatencyHistogram::max, "最大值")
+      .def_property_readonly("mean", &LatencyHistogram::mean, "平均值")
+      .def("percentile", &LatencyHistogram::percentile, R"(percentile(self, percent)
+
+    获取分位数
+
+    :param float percent: 百分比 [0, 100]，如 99.9
+    :rtype: int)");
+
+    py::enum_<BrokerOrder::Business>(m, "BrokerOrderBusiness")
+      .value("BUY", BrokerOrder::BUY)
+      .value("SELL", BrokerOrder::SELL);
+
+    py::class_<BrokerOrder>(m, "BrokerOrder", "订单代理委托记录")
+      .def("__str__", &BrokerOrder::str)
+      .def("__repr__", &BrokerOrder::str)
+      .def_readonly("business", &BrokerOrder::business, "买入/卖出")
+      .def_readonly("datetime", &BrokerOrder::datetime, "策略指示时间")
+      .def_readonly("market", &BrokerOrder::market, "市场标识")
+      .def_readonly("code", &BrokerOrder::code, "证券代码")
+      .def_readonly("price", &BrokerOrder::price, "委托价格")
+      .def_readonly("num", &BrokerOrder::num, "委托数量")
+      .def_readonly("stoploss", &BrokerOrder::stoploss, "预期的止损价")
+      .def_readonly("goal_price", &BrokerOrder::goalPrice, "预期的目标价位")
+      .def_readonly("part_from", &BrokerOrder::from, "系统部件来源")
+      .def_readonly("signal_ns", &BrokerOrder::signal_ns, "发出指令的时间戳（纳秒）")
+      .def_readonly("submit_ns", &BrokerOrder::submit_ns, "开始调用代理接口的时间戳（纳秒）")
+      .def_readonly("ack_ns", &BrokerOrder::ack_ns, "代理接口返回的时间戳（纳秒）")
+      .def_readonly("success", &BrokerOrder::success, "代理接口是否正常返回")
+      .def_readonly("error", &BrokerOrder::error, "代理接口抛出的异常信息");
+
     py::class_<OrderBrokerBase, OrderBrokerPtr, PyOrderBrokerBase>(
       m, "OrderBrokerBase",
       R"(订单代理包装基类，用户可以参考自定义自己的订单代理，加入额外的处理
       
     :param bool real: 下单前是否重新实时获取实时分笔数据
-    :param float slip: 如果当前的卖一价格和指示买入的价格绝对差值不超过slip则下单，否则忽略; 对卖出操作无效，立即以当前价卖出)")
+    :param float slip: 如果当前的卖一价格和指示买入的价格绝对差值不超过slip则下单，否则忽略; 对卖出操作无效，立即以当前价卖出
+    :param bool async: 为 True 时 buy/sell 仅将委托放入全局订单分发队列，由分发线程调用 _buy/_sell (默认 False))")
 
       .def(py::init<>())
       .def(py::init<const string&>(), R"(
@@ -64,6 +102,28 @@ void export_OrderBroker(py::module& m) {
       .def("sell", &OrderBrokerBase::sell, "详情见子类实现接口: _sell")
       .def("get_asset_info", &OrderBrokerBase::getAssetInfo, "详情见子类实现接口: _get_asset_info")
 
+      .def("set_order_callback", &OrderBrokerBase::setOrderCallback,
+           R"(set_order_callback(self, callback)
+
+    设置订单执行完毕后的回调，异步模式（参数 async 为 True）下在分发线程中调用
+
+    :param callback: 形如 callback(order: BrokerOrder) 的可调用对象)")
+      .def("wait_orders", &OrderBrokerBase::waitOrders,
+           py::call_guard<py::gil_scoped_release>(), "等待已异步提交的订单全部执行完毕")
+      .def_property_readonly("pending_orders", &OrderBrokerBase::pendingOrders,
+                             "尚未执行完毕的异步订单数")
+      .def_property_readonly("queue_latency", &OrderBrokerBase::getQueueLatency,
+                             py::return_value_policy::reference_internal,
+                             "排队耗时统计：发出指令至开始调用代理接口")
+      .def_property_readonly("ack_latency", &OrderBrokerBase::getAckLatency,
+                             py::return_value_policy::reference_internal,
+                             "确认耗时统计：调用代理接口至接口返回")
+      .def_property_readonly("total_latency", &OrderBrokerBase::getTotalLatency,
+                             py::return_value_policy::reference_internal,
+                             "总耗时统计：发出指令至代理接口返回")
+      .def("reset_latency", &OrderBrokerBase::resetLatency, "清除耗时统计")
+      .def("get_latency_info", &OrderBrokerBase::getLatencyInfo, "获取耗时统计摘要")
+
       .def("_buy", &OrderBrokerBase::_buy,
            R"(_buy(self, datetime, market, code, price, num, stoploss, goal_price, part_from)
 
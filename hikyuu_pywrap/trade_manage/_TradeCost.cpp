@@ -17,6 +17,10 @@ class PyTradeCostBase : public TradeCostBase {
 public:
     using TradeCostBase::TradeCostBase;
 
+    bool isPythonObject() const override {
+        return true;
+    }
+
     CostRecord getBuyCost(const Datetime& datetime, const Stock& stock, price_t price,
                           double num) const override {
         PYBIND11_OVERLOAD_PURE(CostRecord, TradeCostBase, getBuyCost, datetime, stock, price, num);
@@ -17,6 +17,10 @@ class PyTradeManagerBase : public TradeManagerBase {
 public:
     using TradeManagerBase::TradeManagerBase;
 
+    bool isPythonObject() const override {
+        return true;
+    }
+
     void _reset() override {
         PYBIND11_OVERLOAD(void, TradeManagerBase, _reset, );
     }
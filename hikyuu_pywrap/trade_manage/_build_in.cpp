@@ -71,4 +71,15 @@ void export_build_in(py::module& m) {
     :return: :py:class:`TradeCostBase` 子类实例)");
 
     m.def("TC_Zero", TC_Zero, "零交易成本算法");
+
+    m.def("OB_Loopback", OB_Loopback, py::arg("cash") = 0.0, py::arg("latency_us") = 0,
+          py::arg("async") = false,
+          R"(OB_Loopback([cash=0.0, latency_us=0, async=False])
+
+    进程内回环订单代理，委托按指示价格立即全部成交，用于测试及性能评估
+
+    :param float cash: 初始可用资金
+    :param int latency_us: 每个委托模拟的确认耗时（微秒）
+    :param bool async: 是否通过全局订单分发线程异步执行
+    :return: :py:class:`OrderBrokerBase` 子类实例)");
 }
@@ -18,6 +18,10 @@ public:
     using ConditionBase::ConditionBase;
     PyConditionBase(const ConditionBase& base) : ConditionBase(base) {}
 
+    bool isPythonObject() const override {
+        return true;
+    }
+
     void _calculate() override {
         PYBIND11_OVERLOAD_PURE(void, ConditionBase, _calculate, );
     }
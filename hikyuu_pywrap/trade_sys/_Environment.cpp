@@ -26,6 +26,10 @@ public:
     using EnvironmentBase::EnvironmentBase;
     PyEnvironmentBase(const EnvironmentBase& base) : EnvironmentBase(base) {}
 
+    bool isPythonObject() const override {
+        return true;
+    }
+
     void _calculate() override {
         PYBIND11_OVERLOAD_PURE(void, EnvironmentBase, _calculate, );
     }
@@ -18,6 +18,10 @@ public:
     using MoneyManagerBase::MoneyManagerBase;
     PyMoneyManagerBase(const MoneyManagerBase& base) : MoneyManagerBase(base) {}
 
+    bool isPythonObject() const override {
+        return true;
+    }
+
     void _reset() override {
         PYBIND11_OVERLOAD(void, MoneyManagerBase, _reset, );
     }
@@ -18,6 +18,10 @@ public:
     using ProfitGoalBase::ProfitGoalBase;
     PyProfitGoalBase(const ProfitGoalBase& base) : ProfitGoalBase(base) {}
 
+    bool isPythonObject() const override {
+        return true;
+    }
+
     void buyNotify(const TradeRecord& tr) override {
         PYBIND11_OVERLOAD_NAME(void, ProfitGoalBase, "buy_notify", buyNotify, tr);
     }
@@ -18,6 +18,10 @@ public:
     using SignalBase::SignalBase;
     PySignalBase(const SignalBase& base) : SignalBase(base) {}
 
+    bool isPythonObject() const override {
+        return true;
+    }
+
     void _calculate(const KData& kdata) override {
         PYBIND11_OVERLOAD_PURE(void, SignalBase, _calculate, kdata);
     }
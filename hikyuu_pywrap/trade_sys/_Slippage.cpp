@@ -19,6 +19,10 @@ public:
     using SlippageBase::SlippageBase;
     PySlippageBase(const SlippageBase& base) : SlippageBase(base) {}
 
+    bool isPythonObject() const override {
+        return true;
+    }
+
     void _calculate() override {
         PYBIND11_OVERLOAD_PURE(void, SlippageBase, _calculate, );
     }
@@ -18,6 +18,10 @@ public:
     using StoplossBase::StoplossBase;
     PyStoplossBase(const StoplossBase& base) : StoplossBase(base) {}
 
+    bool isPythonObject() const override {
+        return true;
+    }
+
     void _calculate() override {
         PYBIND11_OVERLOAD_PURE(void, StoplossBase, _calculate, );
     }
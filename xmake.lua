@@ -218,4 +218,5 @@ includes("./copy_dependents.lua")
 includes("./hikyuu_cpp/hikyuu")
 includes("./hikyuu_pywrap")
 includes("./hikyuu_cpp/unit_test")
-includes("./hikyuu_cpp/demo")
\ No newline at end of file
+includes("./hikyuu_cpp/demo")
+includes("./hikyuu_cpp/benchmark")
\ No newline at end of file